@@ -3,8 +3,20 @@
 
 using namespace CHIP8Demo;
 
-Chip8Test::Chip8Test()
- : display(std::make_shared<Display>()), keyboard(std::make_shared<Keyboard>()), cpu(CHIP8::CPU(keyboard, display))
+Chip8Test::Chip8Test(bool recordInput, bool serveFrames)
+ : display(std::make_shared<Display>()), keyboard(std::make_shared<Keyboard>()),
+   remoteKeypad(serveFrames ? std::make_shared<CHIP8::RemoteKeypad>(keyboard) : nullptr),
+   // The recording keypad is not set yet, so it wraps the remote keypad or the keyboard
+   recordingKeypad(recordInput ? std::make_shared<CHIP8::RecordingKeypad>(inputKeypad()) : nullptr),
+#if defined(USE_XOCHIP)
+   cpu(CHIP8::CPU(inputKeypad(), display,
+   	CHIP8::XOCHIP::CreateDecoder(), CHIP8::XOCHIP::CreateMemory()))
+#elif defined(USE_SCHIP)
+   cpu(CHIP8::CPU(inputKeypad(), display,
+   	CHIP8::SCHIP8::CreateDecoder()))
+#else
+   cpu(CHIP8::CPU(inputKeypad(), display))
+#endif
 {
 	//display = std::make_shared<Display>();		// Create our inherited Display object
 	//keyboard = std::make_shared<Keyboard>();	// Create our inherited Keyboard object
@@ -19,7 +31,7 @@ Chip8Test::Chip8Test()
 std::optional<std::string> Chip8Test::loadRom(const std::string &filename)
 {
 	// Load the ROM file
-	auto romResult = cpu.GetMemory()->LoadRomFile(filename);
+	auto romResult = CHIP8::RomCache::Global().Load(filename, *cpu.GetMemory());
 	if (!romResult)
 	{
 		// Return an error message if the ROM file could not be loaded
@@ -29,6 +41,23 @@ std::optional<std::string> Chip8Test::loadRom(const std::string &filename)
 	return {};
 }
 
+std::optional<std::string> Chip8Test::loadRomFromArchive(const std::string &archivePath, const std::string &name)
+{
+	CHIP8::RomArchive archive;
+	auto archiveResult = archive.Open(archivePath);
+	if (!archiveResult)
+	{
+		return ("Error opening archive: " + archiveResult.error());
+	}
+
+	auto romResult = archive.LoadRom(name, *cpu.GetMemory());
+	if (!romResult)
+	{
+		return ("Error loading ROM file: " + romResult.error());
+	}
+	return {};
+}
+
 void Chip8Test::playRom()
 {
 	// Timer update time constant
@@ -36,13 +65,20 @@ void Chip8Test::playRom()
 	// Last timer update time
 	auto lastTimerUpdate = std::chrono::steady_clock::now();
 	// Cycle status containing the result of the cycle execution
-	std::expected<bool, std::string> CycleStatus;
+	std::expected<bool, CHIP8::TrapCode> CycleStatus;
+	// Trace recorder, nullptr if tracing is disabled
+	CHIP8::TraceRecorder *trace = tracer.get();
+	// Frame hash and beeper state of the frame on screen, nothing is shown yet
+	std::optional<std::pair<uint64_t, bool>> shownFrame;
 
 	// Run the emulator
 	while (true)
 	{
 		// Execute a cycle
-		CycleStatus = cpu.RunCycle();
+		{
+			CHIP8::ScopedTrace scope(trace, "execute", "emulation");
+			CycleStatus = (gdbServer != nullptr) ? gdbServer->RunCycle() : cpu.RunCycle();
+		}
 
 		// Check if the cycle was successful
 		if (!CycleStatus)
@@ -50,7 +86,7 @@ void Chip8Test::playRom()
 			// Print the error message and break the loop
 			// as a CPU exception occurred
 			std::cout << std::endl << "Emulator aborted! Reason:\n" << CH8_ARROW
-				" CPU Exception: " CH8_ARROW " " << CycleStatus.error() << std::endl;
+				" CPU Exception: " CH8_ARROW " " << cpu.GetCycleError() << std::endl;
 			break;
 		}
 		else if (CycleStatus.value() == false)
@@ -62,9 +98,9 @@ void Chip8Test::playRom()
 				lastInstruction->GetMnemonic() << " "  CH8_ARROW " " <<
 				lastInstruction->GetAbortReason() << std::endl;
 
-			// Check if the error was caused by the loop quirk - that one is allowed to 
-			// directly abort the emulation
-			if (lastInstruction->GetAbortReason().find("Quirk") != std::string::npos)
+			// Check if the error was caused by the loop quirk or the exit instruction - 
+			// those are allowed to directly abort the emulation
+			if (cpu.GetTrap() == CHIP8::TrapCode::EndlessLoop || cpu.GetTrap() == CHIP8::TrapCode::Exit)
 			{
 				break;
 			}
@@ -99,24 +135,212 @@ void Chip8Test::playRom()
 		}
 
 		// Update the keyboard by reading in key presses
-		keyboard->UpdateKeys();
+		{
+			CHIP8::ScopedTrace scope(trace, "UpdateKeys", "input");
+			cpu.GetKeypad()->UpdateKeys();
+		}
+
+		// Draws that cancel each other out leave the frame as it is on screen
+		const std::pair<uint64_t, bool> frame(cpu.GetDisplay()->GetFrameHash(), cpu.GetTimers()->GetBeeperState());
+		if (cpu.GetDisplay()->IsUpdateRequired() && shownFrame == frame)
+		{
+			cpu.GetDisplay()->ClearUpdateRequired();
+		}
 
 		// Check if the display needs to be updated
 		if (cpu.GetDisplay()->IsUpdateRequired())
 		{
+			shownFrame = frame;
 			// Update the display
-			display->Update(cpu.GetTimers()->GetBeeperState());
+			{
+				CHIP8::ScopedTrace scope(trace, "Display::Update", "render");
+				display->Update(cpu.GetTimers()->GetBeeperState());
+			}
+			CHIP8::ScopedTrace scope(trace, "sleep", "idle");
 			std::this_thread::sleep_for(std::chrono::milliseconds(15));
 		}
 
 		// Update the timers
 		if (std::chrono::steady_clock::now() - lastTimerUpdate > timerUpdateTime)
 		{
-			cpu.GetTimers()->DecrementTimers();
-			lastTimerUpdate = std::chrono::steady_clock::now();
+			CHIP8::ScopedTrace scope(trace, "timer tick", "emulation");
+			auto now = std::chrono::steady_clock::now();
+			if (trace != nullptr)
+			{
+				// Frame interval, shows the jitter of the 60Hz timer tick
+				trace->AddCounter("frame interval (us)",
+					std::chrono::duration_cast<std::chrono::microseconds>(now - lastTimerUpdate).count());
+			}
+			if (recorder != nullptr)
+			{
+				// Decrement the timers and pin the tick to the current cycle
+				recorder->TickTimers();
+			}
+			else
+			{
+				cpu.GetTimers()->DecrementTimers();
+			}
+			cpu.GetDisplay()->VBlank();
+			lastTimerUpdate = now;
 		}
 
 		// Sleep for a short time to prevent the CPU from running too fast
-		std::this_thread::sleep_for(std::chrono::microseconds(500));
+		{
+			CHIP8::ScopedTrace scope(trace, "sleep", "idle");
+			std::this_thread::sleep_for(std::chrono::microseconds(500));
+		}
+	}
+}
+
+void Chip8Test::enableTracing()
+{
+	tracer = std::make_unique<CHIP8::TraceRecorder>();
+}
+
+std::optional<std::string> Chip8Test::writeTrace(const std::string &filename)
+{
+	if (tracer == nullptr)
+	{
+		return "Tracing was not enabled";
+	}
+
+	auto traceResult = tracer->WriteJson(filename);
+	if (!traceResult)
+	{
+		return traceResult.error();
+	}
+	return {};
+}
+
+void Chip8Test::startRecording(uint64_t seed)
+{
+	if (recordingKeypad == nullptr)
+	{
+		return;
+	}
+
+	recorder = std::make_unique<CHIP8::MovieRecorder>(cpu, seed);
+	recordingKeypad->SetRecorder(recorder.get());
+}
+
+std::optional<std::string> Chip8Test::saveRecording(const std::string &filename)
+{
+	if (recorder == nullptr)
+	{
+		return "Recording was not started";
+	}
+
+	auto saveResult = recorder->Finish().Save(filename);
+	if (!saveResult)
+	{
+		return saveResult.error();
 	}
-}
\ No newline at end of file
+	return {};
+}
+
+std::optional<std::string> Chip8Test::enableGdb(uint16_t port)
+{
+	gdbServer = std::make_unique<CHIP8::GdbServer>(cpu);
+	auto startResult = gdbServer->Start(port);
+	if (!startResult)
+	{
+		gdbServer.reset();
+		return startResult.error();
+	}
+	return {};
+}
+
+std::optional<std::string> Chip8Test::enableFrameServer(const std::string &address)
+{
+	if (remoteKeypad == nullptr)
+	{
+		return "The emulator was not constructed to serve frames";
+	}
+
+	frameServer = std::make_shared<CHIP8::FrameServer>(cpu.GetTimers());
+	const bool isPort = !address.empty() && std::all_of(address.begin(), address.end(), [](char c) { return c >= '0' && c <= '9'; });
+	std::optional<std::string> error;
+	if (isPort)
+	{
+		auto startResult = frameServer->Start(uint16_t(std::stoi(address)));
+		if (!startResult)
+		{
+			error = startResult.error();
+		}
+	}
+	else
+	{
+		auto startResult = frameServer->StartUnix(address);
+		if (!startResult)
+		{
+			error = startResult.error();
+		}
+	}
+	if (error)
+	{
+		frameServer.reset();
+		return error;
+	}
+
+	cpu.GetDisplay()->SetFrameSink(frameServer);
+	remoteKeypad->SetServer(frameServer.get());
+	return {};
+}
+
+std::shared_ptr<CHIP8::Keypad> Chip8Test::inputKeypad() const
+{
+	if (recordingKeypad != nullptr)
+	{
+		return recordingKeypad;
+	}
+	if (remoteKeypad != nullptr)
+	{
+		return remoteKeypad;
+	}
+	return keyboard;
+}
+
+std::optional<std::string> Chip8Test::applyRomProfile(const std::string &databasePath, const std::string &romPath,
+	const std::string &archivePath)
+{
+	CHIP8::RomDatabase database;
+	auto openResult = database.Open(databasePath);
+	if (!openResult)
+	{
+		return openResult.error();
+	}
+
+	std::expected<std::optional<CHIP8::RomProfile_t>, std::string> profile;
+	if (archivePath.empty())
+	{
+		profile = database.FindRomFile(romPath);
+	}
+	else
+	{
+		// Hash the ROM as stored in the archive
+		CHIP8::RomArchive archive;
+		auto archiveResult = archive.Open(archivePath);
+		const CHIP8::RomArchive::Entry_t *entry = archiveResult ? archive.Find(romPath) : nullptr;
+		if (entry == nullptr)
+		{
+			return archiveResult ? "ROM not found in archive: " + romPath : archiveResult.error();
+		}
+		std::vector<uint8_t> rom(entry->size);
+		auto extractResult = archive.Extract(*entry, rom);
+		if (!extractResult)
+		{
+			return extractResult.error();
+		}
+		profile = database.FindRom(rom);
+	}
+
+	if (!profile)
+	{
+		return profile.error();
+	}
+	if (profile->has_value())
+	{
+		CHIP8::RomDatabase::Apply(profile->value(), cpu);
+	}
+	return {};
+}
@@ -8,10 +8,23 @@
 #include <thread>
 #include <chrono>
 #include <map>
+#include <algorithm>
 #include <optional>
 #include "cpu.hpp"
 #include "Instructions/Instruction.hpp"
+#include "trace.hpp"
+#include "movie.hpp"
+#include "gdbstub.hpp"
+#include "frameserver.hpp"
+#include "romdb.hpp"
+#include "romcache.hpp"
+#include "archive.hpp"
 #include "ch8_platform_specific.h"
+#if defined(USE_XOCHIP)
+#include "extensions/XOCHIP/xochip.hpp"
+#elif defined(USE_SCHIP)
+#include "extensions/SCHIP8/schip8.hpp"
+#endif
 
 namespace CHIP8Demo
 {
@@ -131,12 +144,21 @@ namespace CHIP8Demo
 		}
 	};
 	
+	/** @brief Display the demo draws on, the 128x64 SCHIP-8 or XO-CHIP one if an extension is built in */
+#if defined(USE_XOCHIP)
+	using BaseDisplay = CHIP8::XOCHIP::XOCHIPDisplay;
+#elif defined(USE_SCHIP)
+	using BaseDisplay = CHIP8::SCHIP8::SCHIP8Display;
+#else
+	using BaseDisplay = CHIP8::Display;
+#endif
+
 	/**
 	 * @brief Display
 	 * 
 	 * This class represents a display.
 	 */
-	class Display : public CHIP8::Display
+	class Display : public BaseDisplay
 	{
 		// Psuedo beeper, will be used since we can't beep with the console nicely
 		bool beep = false;
@@ -215,16 +237,20 @@ namespace CHIP8Demo
 				textScreen.append(screenBorder[LEFT]);
 				for (int x = 0; x < Width; x++)
 				{
+					// Any set bit plane lights the pixel, the terminal has no colours to tell them apart
+					const bool upper = GetColor(uint8_t(x), uint8_t(y)) != 0;
+					const bool lower = (y + 1 < Height) && GetColor(uint8_t(x), uint8_t(y + 1)) != 0;
+
 					// Draw the pixel using the following characters: █▀▄ 
-					if ((screenBuffer[y * Width + x]) && (screenBuffer[(y+1) * Width + x]))
+					if (upper && lower)
 					{
 						textScreen.append(CH8_BOTHPIXEL);
 					}
-					else if (screenBuffer[y * Width + x])
+					else if (upper)
 					{
 						textScreen.append(CH8_UPPERPIXEL);
 					}
-					else if (screenBuffer[(y+1) * Width + x])
+					else if (lower)
 					{
 						textScreen.append(CH8_LOWERPIXEL);
 					}
@@ -277,6 +303,20 @@ namespace CHIP8Demo
 		 * This variable represents the keyboard of the CHIP-8 system.
 		 */
 		std::shared_ptr<Keyboard> keyboard;
+
+		/**
+		 * @brief Remote Keypad
+		 * 
+		 * This variable adds the keys of the frame server viewers to the keyboard if serving, nullptr otherwise.
+		 */
+		std::shared_ptr<CHIP8::RemoteKeypad> remoteKeypad;
+
+		/**
+		 * @brief Recording Keypad
+		 * 
+		 * This variable wraps the keyboard if the input gets recorded, nullptr otherwise.
+		 */
+		std::shared_ptr<CHIP8::RecordingKeypad> recordingKeypad;
 		
 		/**
 		 * @brief CPU
@@ -284,13 +324,51 @@ namespace CHIP8Demo
 		 * This variable represents the CPU of the CHIP-8 system.
 		 */
 		CHIP8::CPU cpu;
+
+		/**
+		 * @brief Trace Recorder
+		 * 
+		 * Records the host loop phases if tracing was enabled, nullptr otherwise.
+		 */
+		std::unique_ptr<CHIP8::TraceRecorder> tracer;
+
+		/**
+		 * @brief Movie Recorder
+		 * 
+		 * Records the input of the session if recording was started, nullptr otherwise.
+		 */
+		std::unique_ptr<CHIP8::MovieRecorder> recorder;
+
+		/**
+		 * @brief GDB Server
+		 * 
+		 * Executes the cycles on behalf of a remote debugger if enabled, nullptr otherwise.
+		 */
+		std::unique_ptr<CHIP8::GdbServer> gdbServer;
+
+		/**
+		 * @brief Frame Server
+		 * 
+		 * Streams the frames to remote viewers if enabled, nullptr otherwise.
+		 */
+		std::shared_ptr<CHIP8::FrameServer> frameServer;
+
+		/**
+		 * @brief Get the keypad the CPU reads
+		 * 
+		 * @return std::shared_ptr<CHIP8::Keypad> : The outermost keypad wrapping the keyboard.
+		 */
+		std::shared_ptr<CHIP8::Keypad> inputKeypad() const;
 	public:
 		/**
 		 * @brief Chip8Test
 		 * 
 		 * This constructor initializes the CHIP-8 test.
+		 * 
+		 * @param recordInput Route the keyboard through a recording keypad, see startRecording().
+		 * @param serveFrames Add the keys of remote viewers to the keyboard, see enableFrameServer().
 		 */
-		Chip8Test();
+		Chip8Test(bool recordInput = false, bool serveFrames = false);
 
 		/**
 		 * @brief Load a ROM file
@@ -302,12 +380,97 @@ namespace CHIP8Demo
 		 */
 		std::optional<std::string> loadRom(const std::string &filename);
 
+		/**
+		 * @brief Load a ROM out of an archive
+		 * 
+		 * This function loads a ROM stored in a zip or tar archive without extracting it.
+		 * 
+		 * @param archivePath The filename of the archive.
+		 * @param name The path of the ROM inside the archive.
+		 * @return std::optional<std::string> : An error message if the ROM could not be loaded.
+		 */
+		std::optional<std::string> loadRomFromArchive(const std::string &archivePath, const std::string &name);
+
 		/**
 		 * @brief Play the ROM file
 		 * 
 		 * This function plays the ROM file.
 		 */
 		void playRom();
+
+		/**
+		 * @brief Enable tracing of the host loop
+		 * 
+		 * This function enables recording of the host loop phases, which can
+		 * be written out as Chrome trace JSON after playing the ROM.
+		 */
+		void enableTracing();
+
+		/**
+		 * @brief Write the recorded trace
+		 * 
+		 * This function writes the recorded host loop phases as Chrome trace JSON
+		 * that can be opened in Perfetto.
+		 * 
+		 * @param filename The filename of the JSON file.
+		 * @return std::optional<std::string> : An error message if the trace could not be written.
+		 */
+		std::optional<std::string> writeTrace(const std::string &filename);
+
+		/**
+		 * @brief Start recording the input
+		 * 
+		 * This function starts recording key changes and timer ticks into a movie,
+		 * the emulator has to be constructed with recordInput set.
+		 * 
+		 * @param seed The random seed the session is played with.
+		 */
+		void startRecording(uint64_t seed);
+
+		/**
+		 * @brief Save the recorded input
+		 * 
+		 * @param filename The filename of the movie file.
+		 * @return std::optional<std::string> : An error message if the movie could not be written.
+		 */
+		std::optional<std::string> saveRecording(const std::string &filename);
+
+		/**
+		 * @brief Enable the GDB server
+		 * 
+		 * This function starts a GDB remote serial protocol server on localhost,
+		 * a connecting debugger halts the emulation.
+		 * 
+		 * @param port The TCP port to listen on.
+		 * @return std::optional<std::string> : An error message if the server could not be started.
+		 */
+		std::optional<std::string> enableGdb(uint16_t port);
+
+		/**
+		 * @brief Enable the frame server
+		 * 
+		 * This function streams the frames and the beeper state to remote viewers
+		 * and takes their key presses, the emulator has to be constructed with
+		 * serveFrames set.
+		 * 
+		 * @param address A localhost TCP port number or the path of a Unix domain socket.
+		 * @return std::optional<std::string> : An error message if the server could not be started.
+		 */
+		std::optional<std::string> enableFrameServer(const std::string &address);
+
+		/**
+		 * @brief Apply the known profile of a ROM
+		 * 
+		 * This function looks up the ROM file in a ROM database and sets the quirks
+		 * the ROM is known to run with. Unknown ROMs keep the default quirks.
+		 * 
+		 * @param databasePath The filename of the ROM database.
+		 * @param romPath The filename of the ROM file, or its path inside the archive.
+		 * @param archivePath The filename of the archive holding the ROM, empty if none.
+		 * @return std::optional<std::string> : An error message if the database or the ROM could not be read.
+		 */
+		std::optional<std::string> applyRomProfile(const std::string &databasePath, const std::string &romPath,
+			const std::string &archivePath = "");
 	};
 }
 
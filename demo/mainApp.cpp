@@ -1,15 +1,211 @@
 #include <iostream>
+#include <string>
+#include <chrono>
 #include "chip8.hpp"
+#include "audio.hpp"
+#include "video.hpp"
 
-int main(int argc, char *argv[]) 
+/**
+ * @brief Replay a recorded movie headlessly
+ * 
+ * Runs the ROM with the recorded input at maximum speed and shows the final frame.
+ * The audio of every recorded frame is written to a WAV file and the frames to
+ * a video file if a path is given, the video format follows the file extension
+ * (.y4m, .ppm or raw bit planes for anything else).
+ * 
+ * @param romPath Path to the ROM file
+ * @param moviePath Path to the movie file
+ * @param wavPath Path to the WAV file, empty for no audio
+ * @param videoPath Path to the video file, empty for no video
+ * @param videoScale Pixel size of the video
+ * @return int : Exit code
+ */
+static int replayMovie(const std::string &romPath, const std::string &moviePath, const std::string &wavPath,
+	const std::string &videoPath, int videoScale)
 {
+	auto movie = CHIP8::Movie::Load(moviePath);
+	if (!movie)
+	{
+		std::cout << "Error: " << movie.error() << std::endl;
+		return 1;
+	}
+
+	auto keypad = std::make_shared<CHIP8::HeadlessKeypad>();
+	auto display = std::make_shared<CHIP8Demo::Display>();
+#if defined(USE_XOCHIP)
+	CHIP8::CPU cpu(keypad, display, CHIP8::XOCHIP::CreateDecoder(), CHIP8::XOCHIP::CreateMemory());
+#elif defined(USE_SCHIP)
+	CHIP8::CPU cpu(keypad, display, CHIP8::SCHIP8::CreateDecoder());
+#else
+	CHIP8::CPU cpu(keypad, display);
+#endif
+
+	auto romResult = CHIP8::RomCache::Global().Load(romPath, *cpu.GetMemory());
+	if (!romResult)
+	{
+		std::cout << "Error: Error loading ROM file: " << romResult.error() << std::endl;
+		return 1;
+	}
+
+	CHIP8::AudioSynthesizer synthesizer;
+	CHIP8::WavWriter wav;
+	if (!wavPath.empty())
+	{
+		auto opened = wav.Open(wavPath, synthesizer.GetSampleRate());
+		if (!opened)
+		{
+			std::cout << "Error: " << opened.error() << std::endl;
+			return 1;
+		}
+	}
+
+	std::shared_ptr<CHIP8::VideoSink> video;
+	if (!videoPath.empty())
+	{
+		if (videoPath.ends_with(".y4m"))
+		{
+			video = std::make_shared<CHIP8::Y4MSink>(videoScale);
+		}
+		else if (videoPath.ends_with(".ppm"))
+		{
+			video = std::make_shared<CHIP8::PPMSink>(videoScale);
+		}
+		else
+		{
+			video = std::make_shared<CHIP8::RawSink>();
+		}
+		auto opened = video->Open(videoPath);
+		if (!opened)
+		{
+			std::cout << "Error: " << opened.error() << std::endl;
+			return 1;
+		}
+		display->SetFrameSink(video);
+	}
+
+	std::function<void(CHIP8::CPU &)> onTimerTick = [&](CHIP8::CPU &replayCpu) {
+		if (!wavPath.empty())
+		{
+			(void)wav.Write(synthesizer.RenderFrame(*replayCpu.GetTimers()));
+		}
+		replayCpu.GetDisplay()->VBlank();
+	};
+
+	auto cycles = CHIP8::MoviePlayer(movie.value()).Play(cpu, *keypad, onTimerTick);
+	if (!cycles)
+	{
+		std::cout << "Error: " << cycles.error() << std::endl;
+		return 1;
+	}
+
+	// Show the final frame
+	std::cout << "\x1B[2J\x1B[H";
+	display->Update(cpu.GetTimers()->GetBeeperState());
+	std::cout << std::endl << "Replayed " << cycles.value() << " cycles" << std::endl;
+
+	auto closed = wav.Close();
+	if (!closed)
+	{
+		std::cout << "Error: " << closed.error() << std::endl;
+		return 1;
+	}
+	if (video)
+	{
+		display->SetFrameSink(nullptr);
+		closed = video->Close();
+		if (!closed)
+		{
+			std::cout << "Error: " << closed.error() << std::endl;
+			return 1;
+		}
+		std::cout << "Wrote " << video->GetFrameCount() << " frames to " << videoPath << std::endl;
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	std::string romPath;
+	std::string tracePath;
+	std::string recordPath;
+	std::string replayPath;
+	std::string wavPath;
+	std::string videoPath;
+	int videoScale = 1;
+	std::string romDatabasePath;
+	std::string archivePath;
+	int gdbPort = -1;
+	std::string serveAddress;
+
+	// Parse the arguments, the last non-option argument is the ROM file
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--trace" && i + 1 < argc)
+		{
+			tracePath = argv[++i];
+		}
+		else if (arg == "--record" && i + 1 < argc)
+		{
+			recordPath = argv[++i];
+		}
+		else if (arg == "--replay" && i + 1 < argc)
+		{
+			replayPath = argv[++i];
+		}
+		else if (arg == "--wav" && i + 1 < argc)
+		{
+			wavPath = argv[++i];
+		}
+		else if (arg == "--video" && i + 1 < argc)
+		{
+			videoPath = argv[++i];
+		}
+		else if (arg == "--scale" && i + 1 < argc)
+		{
+			videoScale = std::stoi(argv[++i]);
+		}
+		else if (arg == "--archive" && i + 1 < argc)
+		{
+			archivePath = argv[++i];
+		}
+		else if (arg == "--romdb" && i + 1 < argc)
+		{
+			romDatabasePath = argv[++i];
+		}
+		else if (arg == "--gdb" && i + 1 < argc)
+		{
+			gdbPort = std::stoi(argv[++i]);
+		}
+		else if (arg == "--serve" && i + 1 < argc)
+		{
+			serveAddress = argv[++i];
+		}
+		else
+		{
+			romPath = arg;
+		}
+	}
+
 	// Check if a ROM file path was provided
-	if (argc > 1)
+	if (!romPath.empty() && !replayPath.empty())
 	{
-		CHIP8Demo::Chip8Test emu;
+		try
+		{
+			return replayMovie(romPath, replayPath, wavPath, videoPath, videoScale);
+		}
+		catch (const std::invalid_argument &e)
+		{
+			std::cout << "Error: " << e.what() << std::endl;
+			return 1;
+		}
+	}
+	else if (!romPath.empty())
+	{
+		CHIP8Demo::Chip8Test emu(!recordPath.empty(), !serveAddress.empty());
 
 		// Load the ROM file
-		auto result = emu.loadRom(argv[1]);
+		auto result = archivePath.empty() ? emu.loadRom(romPath) : emu.loadRomFromArchive(archivePath, romPath);
 
 		// Check if the ROM file was loaded successfully
 		if (result.has_value())
@@ -17,19 +213,77 @@ int main(int argc, char *argv[])
 			std::cout << "Error: " << result.value() << std::endl;
 			return 1;
 		}
-		else 
+		else
 		{
+			if (!romDatabasePath.empty())
+			{
+				auto profileResult = emu.applyRomProfile(romDatabasePath, romPath, archivePath);
+				if (profileResult.has_value())
+				{
+					std::cout << "Error: " << profileResult.value() << std::endl;
+					return 1;
+				}
+			}
+			if (!tracePath.empty())
+			{
+				emu.enableTracing();
+			}
+			if (gdbPort >= 0)
+			{
+				auto gdbResult = emu.enableGdb(uint16_t(gdbPort));
+				if (gdbResult.has_value())
+				{
+					std::cout << "Error: " << gdbResult.value() << std::endl;
+					return 1;
+				}
+			}
+			if (!serveAddress.empty())
+			{
+				auto serveResult = emu.enableFrameServer(serveAddress);
+				if (serveResult.has_value())
+				{
+					std::cout << "Error: " << serveResult.value() << std::endl;
+					return 1;
+				}
+			}
+			if (!recordPath.empty())
+			{
+				emu.startRecording(uint64_t(std::chrono::steady_clock::now().time_since_epoch().count()));
+			}
+
 			// Clear the screen
 			std::cout << "\x1B[2J\x1B[H";
 			// Play the ROM file
 			emu.playRom();
+
+			// Write the trace of the host loop phases
+			if (!tracePath.empty())
+			{
+				auto traceResult = emu.writeTrace(tracePath);
+				if (traceResult.has_value())
+				{
+					std::cout << "Error: " << traceResult.value() << std::endl;
+					return 1;
+				}
+			}
+
+			// Write the recorded input
+			if (!recordPath.empty())
+			{
+				auto recordResult = emu.saveRecording(recordPath);
+				if (recordResult.has_value())
+				{
+					std::cout << "Error: " << recordResult.value() << std::endl;
+					return 1;
+				}
+			}
 			return 0;
 		}
 	}
 	else
 	{
 		// Print usage information
-		std::cout << "Usage: " << argv[0] << " <path to rom file>" << std::endl;
+		std::cout << "Usage: " << argv[0] << " [--trace <trace.json>] [--record <movie> | --replay <movie> [--wav <audio.wav>] [--video <video.y4m|.ppm|.raw> [--scale <n>]]] [--gdb <port>] [--serve <port|socket>] [--romdb <database>] [--archive <zip/tar>] <path to rom file>" << std::endl;
 	}
 	return 0;
 }
@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <span>
+#include "memory.hpp"
+#include "archive.hpp"
+
+/**
+ * Fuzzer of the ROM archive reader
+ *
+ * Every input is opened as a zip or tar archive and every entry is loaded into
+ * a memory of the default size and one of 64 KiB. Malformed archives have to
+ * fail with an error message, the sanitizers catch any access out of bounds.
+ */
+
+namespace
+{
+	/** @brief Memory sizes the entries are loaded into */
+	constexpr size_t MEMORY_SIZES[] = {4096, 65536};
+
+	void LoadEntries(const CHIP8::RomArchive &archive)
+	{
+		for (size_t size : MEMORY_SIZES)
+		{
+			CHIP8::Memory memory(size);
+			for (const auto &entry : archive.GetEntries())
+			{
+				(void)archive.LoadRom(entry.name, memory);
+			}
+		}
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	CHIP8::RomArchive archive;
+	if (archive.Open(std::span<const uint8_t>(data, size)))
+	{
+		LoadEntries(archive);
+	}
+	return 0;
+}
+
+#ifdef CHIP8PP_FUZZ_STANDALONE
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+/**
+ * Standalone driver for compilers without libFuzzer: checks the built-in
+ * malformed archives, replays the given input files (or every file of a given
+ * directory), and runs random mutations of small valid archives with
+ * --random <count> [--seed <seed>].
+ */
+namespace
+{
+	void PutLittle(std::vector<uint8_t> &out, uint32_t value, size_t bytes)
+	{
+		for (size_t i = 0; i < bytes; i++)
+		{
+			out.push_back(uint8_t(value >> (8 * i)));
+		}
+	}
+
+	/**
+	 * @brief Build a zip with one stored entry
+	 *
+	 * @param storedSize : Stored size written to both headers
+	 * @param size : Uncompressed size written to both headers
+	 */
+	std::vector<uint8_t> MakeZip(const std::string &name, std::span<const uint8_t> content, uint32_t storedSize, uint32_t size)
+	{
+		std::vector<uint8_t> zip;
+		PutLittle(zip, 0x04034B50, 4);
+		PutLittle(zip, 20, 2);
+		PutLittle(zip, 0, 2);
+		PutLittle(zip, 0, 2);
+		PutLittle(zip, 0, 4);
+		PutLittle(zip, 0, 4);
+		PutLittle(zip, storedSize, 4);
+		PutLittle(zip, size, 4);
+		PutLittle(zip, uint32_t(name.size()), 2);
+		PutLittle(zip, 0, 2);
+		zip.insert(zip.end(), name.begin(), name.end());
+		zip.insert(zip.end(), content.begin(), content.end());
+
+		const size_t directory = zip.size();
+		PutLittle(zip, 0x02014B50, 4);
+		PutLittle(zip, 20, 2);
+		PutLittle(zip, 20, 2);
+		PutLittle(zip, 0, 2);
+		PutLittle(zip, 0, 2);
+		PutLittle(zip, 0, 4);
+		PutLittle(zip, 0, 4);
+		PutLittle(zip, storedSize, 4);
+		PutLittle(zip, size, 4);
+		PutLittle(zip, uint32_t(name.size()), 2);
+		PutLittle(zip, 0, 2);
+		PutLittle(zip, 0, 2);
+		PutLittle(zip, 0, 2);
+		PutLittle(zip, 0, 2);
+		PutLittle(zip, 0, 4);
+		PutLittle(zip, 0, 4);
+		zip.insert(zip.end(), name.begin(), name.end());
+		const size_t directorySize = zip.size() - directory;
+
+		PutLittle(zip, 0x06054B50, 4);
+		PutLittle(zip, 0, 2);
+		PutLittle(zip, 0, 2);
+		PutLittle(zip, 1, 2);
+		PutLittle(zip, 1, 2);
+		PutLittle(zip, uint32_t(directorySize), 4);
+		PutLittle(zip, uint32_t(directory), 4);
+		PutLittle(zip, 0, 2);
+		return zip;
+	}
+
+	/**
+	 * @brief Build a tar block header
+	 */
+	std::vector<uint8_t> MakeTarHeader(const std::string &name, size_t size, char type)
+	{
+		std::vector<uint8_t> header(512, 0);
+		std::copy_n(name.begin(), std::min<size_t>(name.size(), 100), header.begin());
+		const std::string sizeField = std::format("{:011o}", size);
+		std::copy(sizeField.begin(), sizeField.end(), header.begin() + 124);
+		header[156] = uint8_t(type);
+		std::copy_n("ustar", 5, header.begin() + 257);
+		std::fill_n(header.begin() + 148, 8, ' ');
+		size_t sum = 0;
+		for (uint8_t byte : header)
+		{
+			sum += byte;
+		}
+		const std::string checksum = std::format("{:06o}", sum);
+		std::copy(checksum.begin(), checksum.end(), header.begin() + 148);
+		header[154] = 0;
+		return header;
+	}
+
+	void AppendTarEntry(std::vector<uint8_t> &tar, const std::string &name, std::span<const uint8_t> content, char type)
+	{
+		auto header = MakeTarHeader(name, content.size(), type);
+		tar.insert(tar.end(), header.begin(), header.end());
+		tar.insert(tar.end(), content.begin(), content.end());
+		tar.resize((tar.size() + 511) / 512 * 512, 0);
+	}
+
+	void Check(bool condition, const char *what)
+	{
+		if (!condition)
+		{
+			std::cerr << "Archive check failed: " << what << std::endl;
+			std::abort();
+		}
+	}
+
+	/**
+	 * @brief Built-in cases with known outcomes
+	 */
+	void RunChecks(std::vector<std::vector<uint8_t>> &seeds)
+	{
+		const std::vector<uint8_t> rom = {0x60, 0x01, 0x12, 0x02};
+		CHIP8::RomArchive archive;
+
+		auto zip = MakeZip("rom.ch8", rom, uint32_t(rom.size()), uint32_t(rom.size()));
+		Check(archive.Open(zip).has_value(), "stored zip opens");
+		CHIP8::Memory memory;
+		Check(archive.LoadRom("rom.ch8", memory).has_value(), "stored zip entry loads");
+		seeds.push_back(zip);
+
+		// The central directory claims more stored bytes than the file has, they must never be copied
+		std::vector<uint8_t> stored(8000, 0xAA);
+		auto oversized = MakeZip("rom.ch8", stored, uint32_t(stored.size()), 100);
+		Check(!archive.Open(oversized).has_value(), "stored zip with stored size != size is rejected");
+		LLVMFuzzerTestOneInput(oversized.data(), oversized.size());
+
+		auto truncated = MakeZip("rom.ch8", rom, 4000, 4000);
+		Check(!archive.Open(truncated).has_value(), "truncated zip is rejected");
+
+		// A pax path replaces the name of the header
+		std::vector<uint8_t> tar;
+		const std::string longPath = std::string(120, 'd') + "/rom.ch8";
+		std::string record = "path=" + longPath + "\n";
+		record = std::format("{} {}", record.size() + 4, record);
+		AppendTarEntry(tar, "PaxHeaders/rom.ch8", std::span(reinterpret_cast<const uint8_t *>(record.data()), record.size()), 'x');
+		AppendTarEntry(tar, "truncated-name.ch8", rom, '0');
+		tar.resize(tar.size() + 1024, 0);
+		Check(archive.Open(tar).has_value(), "pax tar opens");
+		Check(archive.Find(longPath) != nullptr, "pax path is used");
+		seeds.push_back(tar);
+	}
+
+	void RunFile(const std::filesystem::path &path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		LLVMFuzzerTestOneInput(data.data(), data.size());
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	uint64_t randomInputs = 0;
+	uint64_t seed = 1;
+	std::vector<std::filesystem::path> paths;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--random" && i + 1 < argc)
+		{
+			randomInputs = std::stoull(argv[++i]);
+		}
+		else if (arg == "--seed" && i + 1 < argc)
+		{
+			seed = std::stoull(argv[++i]);
+		}
+		else if (arg[0] != '-')
+		{
+			paths.push_back(arg);
+		}
+		else
+		{
+			std::cout << "Usage: " << argv[0] << " [--random <count>] [--seed <seed>] [input files or directories]" << std::endl;
+			return 0;
+		}
+	}
+
+	std::vector<std::vector<uint8_t>> seeds;
+	RunChecks(seeds);
+
+	for (const auto &path : paths)
+	{
+		if (std::filesystem::is_directory(path))
+		{
+			for (const auto &entry : std::filesystem::directory_iterator(path))
+			{
+				RunFile(entry.path());
+			}
+		}
+		else
+		{
+			RunFile(path);
+		}
+	}
+
+	// Overwrite a few random bytes of a valid archive, biased towards the headers
+	std::mt19937_64 random(seed);
+	std::vector<uint8_t> input;
+	for (uint64_t run = 0; run < randomInputs; run++)
+	{
+		input = seeds[random() % seeds.size()];
+		const size_t mutations = 1 + random() % 8;
+		for (size_t i = 0; i < mutations; i++)
+		{
+			const size_t position = (random() % 2 == 0) ? random() % std::min<size_t>(input.size(), 64) : random() % input.size();
+			input[position] = (random() % 4 == 0) ? uint8_t(0xFF) : uint8_t(random());
+		}
+		LLVMFuzzerTestOneInput(input.data(), input.size());
+	}
+	std::cout << paths.size() << " inputs replayed, " << randomInputs << " random inputs run, checks passed" << std::endl;
+	return 0;
+}
+#endif
@@ -0,0 +1,354 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <span>
+#include <array>
+#include <exception>
+#include "cpu.hpp"
+#include "engine.hpp"
+#include "Instructions/Instruction.hpp"
+
+/**
+ * Differential fuzzer of the execution engines
+ *
+ * Every input is run on two CPUs in lockstep, one through the reference
+ * CPU::RunCycle() and one through the PredecodedEngine. After every
+ * instruction the result, trap, registers, stack, timers, memory and framebuffer of
+ * both have to be identical, the first difference is reported and aborts.
+ *
+ * Input layout:
+ *   2 bytes    quirk bits (Quirks::FromBits), little endian
+ *   1 byte     number of key events (modulo 9)
+ *   3 bytes    per key event: instructions since the last event, key mask little endian
+ *   rest       ROM, loaded to 0x200
+ */
+
+/** @brief Instructions run per input at most */
+static constexpr uint64_t MAX_INSTRUCTIONS = 4096;
+
+/** @brief Instructions executed per 60Hz timer tick */
+static constexpr uint64_t INSTRUCTIONS_PER_FRAME = 15;
+
+/** @brief Most key events an input can carry */
+static constexpr size_t MAX_KEY_EVENTS = 8;
+
+namespace
+{
+	/**
+	 * @brief Machine
+	 *
+	 * A CPU with headless peripherals, owned by the fuzzer.
+	 */
+	struct Machine
+	{
+		std::shared_ptr<CHIP8::HeadlessKeypad> keypad = std::make_shared<CHIP8::HeadlessKeypad>();
+		std::shared_ptr<CHIP8::HeadlessDisplay> display = std::make_shared<CHIP8::HeadlessDisplay>();
+		CHIP8::CPU cpu{keypad, display};
+	};
+
+	/**
+	 * @brief Outcome of a cycle
+	 */
+	typedef struct
+	{
+		enum { Success, Abort, Error, Exception } kind;
+		std::string message;
+	} Outcome_t;
+
+	Outcome_t RunReference(Machine &machine)
+	{
+		try
+		{
+			auto result = machine.cpu.RunCycle();
+			if (!result)
+			{
+				return {Outcome_t::Error, machine.cpu.GetCycleError()};
+			}
+			if (!result.value())
+			{
+				return {Outcome_t::Abort, machine.cpu.GetCurrentInstruction()->GetAbortReason()};
+			}
+			return {Outcome_t::Success, ""};
+		}
+		catch (const std::exception &exception)
+		{
+			return {Outcome_t::Exception, exception.what()};
+		}
+	}
+
+	Outcome_t RunEngine(Machine &machine, CHIP8::PredecodedEngine &engine)
+	{
+		try
+		{
+			auto result = engine.RunCycle();
+			if (!result)
+			{
+				return {Outcome_t::Error, machine.cpu.GetCycleError()};
+			}
+			if (!result.value())
+			{
+				return {Outcome_t::Abort, engine.GetAbortReason()};
+			}
+			return {Outcome_t::Success, ""};
+		}
+		catch (const std::exception &exception)
+		{
+			return {Outcome_t::Exception, exception.what()};
+		}
+	}
+
+	/**
+	 * @brief Compare the state of both machines
+	 *
+	 * @return std::string : Description of the first difference, empty if identical
+	 */
+	std::string Compare(Machine &reference, Machine &engine)
+	{
+		CHIP8::CPU &a = reference.cpu;
+		CHIP8::CPU &b = engine.cpu;
+
+		for (uint8_t reg = 0; reg < 16; reg++)
+		{
+			if (a.GetRegister(reg) != b.GetRegister(reg))
+			{
+				return "V" + std::to_string(reg) + ": " + std::to_string(a.GetRegister(reg)) + " != " + std::to_string(b.GetRegister(reg));
+			}
+		}
+		if (a.GetIndex() != b.GetIndex())
+		{
+			return "I: " + std::to_string(a.GetIndex()) + " != " + std::to_string(b.GetIndex());
+		}
+		if (a.GetPC() != b.GetPC())
+		{
+			return "PC: " + std::to_string(a.GetPC()) + " != " + std::to_string(b.GetPC());
+		}
+		if (a.GetStackPointer() != b.GetStackPointer())
+		{
+			return "SP: " + std::to_string(a.GetStackPointer()) + " != " + std::to_string(b.GetStackPointer());
+		}
+		for (size_t entry = 0; entry < a.GetStackPointer(); entry++)
+		{
+			if (a.GetStackEntry(entry) != b.GetStackEntry(entry))
+			{
+				return "Stack entry " + std::to_string(entry);
+			}
+		}
+		if (a.GetTrap() != b.GetTrap() || a.GetTrapPC() != b.GetTrapPC())
+		{
+			return std::string("Trap: ") + std::string(CHIP8::TRAP_NAMES[size_t(a.GetTrap())]) + " != " + std::string(CHIP8::TRAP_NAMES[size_t(b.GetTrap())]);
+		}
+		if (a.GetCycleCount() != b.GetCycleCount())
+		{
+			return "Cycle count";
+		}
+		if (a.GetTimers()->GetDelayTimer() != b.GetTimers()->GetDelayTimer() ||
+			a.GetTimers()->GetSoundTimer() != b.GetTimers()->GetSoundTimer())
+		{
+			return "Timers";
+		}
+
+		std::vector<uint8_t> memoryA(a.GetMemory()->GetSize()), memoryB(b.GetMemory()->GetSize());
+		(void)a.GetMemory()->GetBytes(0, memoryA);
+		(void)b.GetMemory()->GetBytes(0, memoryB);
+		if (memoryA != memoryB)
+		{
+			return "Memory";
+		}
+
+		std::vector<uint8_t> screenA(reference.display->GetPackedSize()), screenB(engine.display->GetPackedSize());
+		reference.display->PackBuffer(screenA);
+		engine.display->PackBuffer(screenB);
+		if (screenA != screenB)
+		{
+			return "Framebuffer";
+		}
+		if (reference.display->GetFrameHash() != engine.display->GetFrameHash())
+		{
+			return "Frame hash";
+		}
+		return "";
+	}
+
+	[[noreturn]] void Diverged(Machine &reference, uint64_t instruction, uint16_t pc, const std::string &what)
+	{
+		std::cerr << "Engines diverged after instruction " << instruction << " at PC 0x" << std::hex << pc
+			<< " (opcode 0x" << reference.cpu.GetMemory()->GetWord(pc).value_or(0) << std::dec << "): " << what << std::endl;
+		std::abort();
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	std::span<const uint8_t> input(data, size);
+	if (input.size() < 3)
+	{
+		return 0;
+	}
+
+	const uint16_t quirks = uint16_t(input[0] | (input[1] << 8));
+	const size_t keyEvents = input[2] % (MAX_KEY_EVENTS + 1);
+	input = input.subspan(3);
+	if (input.size() < keyEvents * 3)
+	{
+		return 0;
+	}
+
+	// Key events as absolute instruction counts
+	std::array<std::pair<uint64_t, uint16_t>, MAX_KEY_EVENTS> keys;
+	uint64_t when = 0;
+	for (size_t i = 0; i < keyEvents; i++)
+	{
+		when += input[i * 3];
+		keys[i] = {when, uint16_t(input[i * 3 + 1] | (input[i * 3 + 2] << 8))};
+	}
+	input = input.subspan(keyEvents * 3);
+
+	Machine reference, engineMachine;
+	const size_t romSpace = reference.cpu.GetMemory()->GetSize() - reference.cpu.GetMemory()->GetRomStart();
+	const auto rom = input.first(std::min(input.size(), romSpace));
+	for (Machine *machine : {&reference, &engineMachine})
+	{
+		machine->cpu.GetQuirks().FromBits(quirks);
+		if (!machine->cpu.GetMemory()->LoadRom(rom))
+		{
+			return 0;
+		}
+	}
+	CHIP8::PredecodedEngine engine(engineMachine.cpu);
+
+	size_t nextKey = 0;
+	for (uint64_t instruction = 0; instruction < MAX_INSTRUCTIONS; instruction++)
+	{
+		while (nextKey < keyEvents && keys[nextKey].first <= instruction)
+		{
+			reference.keypad->SetKeyMask(keys[nextKey].second);
+			engineMachine.keypad->SetKeyMask(keys[nextKey].second);
+			nextKey++;
+		}
+		if (instruction % INSTRUCTIONS_PER_FRAME == 0 && instruction != 0)
+		{
+			reference.cpu.GetTimers()->DecrementTimers();
+			engineMachine.cpu.GetTimers()->DecrementTimers();
+		}
+
+		const uint16_t pc = reference.cpu.GetPC();
+		const Outcome_t expected = RunReference(reference);
+		const Outcome_t actual = RunEngine(engineMachine, engine);
+		if (expected.kind != actual.kind || expected.message != actual.message)
+		{
+			Diverged(reference, instruction, pc, "outcome \"" + expected.message + "\" != \"" + actual.message + "\"");
+		}
+
+		const std::string difference = Compare(reference, engineMachine);
+		if (!difference.empty())
+		{
+			Diverged(reference, instruction, pc, difference);
+		}
+		if (expected.kind != Outcome_t::Success)
+		{
+			break;
+		}
+	}
+	return 0;
+}
+
+#ifdef CHIP8PP_FUZZ_STANDALONE
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+/**
+ * Standalone driver for compilers without libFuzzer: replays the given input
+ * files (or every file of a given directory), or runs random inputs biased
+ * towards valid opcodes with --random <count> [--seed <seed>].
+ */
+static void RunFile(const std::filesystem::path &path)
+{
+	std::ifstream file(path, std::ios::binary);
+	std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	LLVMFuzzerTestOneInput(data.data(), data.size());
+}
+
+int main(int argc, char *argv[])
+{
+	uint64_t randomInputs = 0;
+	uint64_t seed = 1;
+	std::vector<std::filesystem::path> paths;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--random" && i + 1 < argc)
+		{
+			randomInputs = std::stoull(argv[++i]);
+		}
+		else if (arg == "--seed" && i + 1 < argc)
+		{
+			seed = std::stoull(argv[++i]);
+		}
+		else if (arg[0] != '-')
+		{
+			paths.push_back(arg);
+		}
+		else
+		{
+			std::cout << "Usage: " << argv[0] << " [--random <count>] [--seed <seed>] [input files or directories]" << std::endl;
+			return 0;
+		}
+	}
+
+	for (const auto &path : paths)
+	{
+		if (std::filesystem::is_directory(path))
+		{
+			for (const auto &entry : std::filesystem::directory_iterator(path))
+			{
+				RunFile(entry.path());
+			}
+		}
+		else
+		{
+			RunFile(path);
+		}
+	}
+
+	// Opcode templates of the base instruction set, the random bits fill the zeros
+	static constexpr uint16_t TEMPLATES[][2] = {
+		{0x00E0, 0x0000}, {0x00EE, 0x0000}, {0x1200, 0x01FE}, {0x2200, 0x01FE}, {0x3000, 0x0FFF},
+		{0x4000, 0x0FFF}, {0x5000, 0x0FF0}, {0x6000, 0x0FFF}, {0x7000, 0x0FFF}, {0x8000, 0x0FF7},
+		{0x800E, 0x0FF0}, {0x9000, 0x0FF0}, {0xA000, 0x0FFF}, {0xB000, 0x0FFF}, {0xC000, 0x0FFF},
+		{0xD000, 0x0FFF}, {0xE09E, 0x0F00}, {0xE0A1, 0x0F00}, {0xF007, 0x0F00}, {0xF00A, 0x0F00},
+		{0xF015, 0x0F00}, {0xF018, 0x0F00}, {0xF01E, 0x0F00}, {0xF029, 0x0F00}, {0xF033, 0x0F00},
+		{0xF055, 0x0F00}, {0xF065, 0x0F00},
+	};
+	std::mt19937_64 random(seed);
+	std::vector<uint8_t> input;
+	for (uint64_t run = 0; run < randomInputs; run++)
+	{
+		input.clear();
+		const size_t keyEvents = random() % (MAX_KEY_EVENTS + 1);
+		input.push_back(uint8_t(random()));
+		input.push_back(uint8_t(random()));
+		input.push_back(uint8_t(keyEvents));
+		for (size_t i = 0; i < keyEvents * 3; i++)
+		{
+			input.push_back(uint8_t(random()));
+		}
+		const size_t opcodes = 1 + random() % 256;
+		for (size_t i = 0; i < opcodes; i++)
+		{
+			const auto &entry = TEMPLATES[random() % std::size(TEMPLATES)];
+			const uint16_t opcode = (random() % 16 == 0) ? uint16_t(random()) : uint16_t(entry[0] | (random() & entry[1]));
+			input.push_back(uint8_t(opcode >> 8));
+			input.push_back(uint8_t(opcode));
+		}
+		LLVMFuzzerTestOneInput(input.data(), input.size());
+	}
+	std::cout << paths.size() << " inputs replayed, " << randomInputs << " random inputs run without divergence" << std::endl;
+	return 0;
+}
+#endif
@@ -6,6 +6,7 @@
 #include <memory>
 #include <expected>
 #include "Instructions/Instruction.hpp"
+#include "display.hpp"
 
 namespace CHIP8
 {
@@ -27,6 +28,12 @@ namespace CHIP8
 		 * This pointer stores the illegal instruction object.
 		 */
 		std::shared_ptr<Instructions::Instruction> badInstruction;
+
+		/** @brief Required Display
+		 * 
+		 * The display capability the registered instructions rely on.
+		 */
+		DisplayCapability requiredDisplay = DisplayCapability::Chip8;
 	public:
 		/**
 		 * @brief Construct a new Instruction Decoder object
@@ -84,6 +91,27 @@ namespace CHIP8
 			return InstructionTable[opcode]->Update(opcode);
 		}
 
+		/**
+		 * @brief Require a display capability
+		 * 
+		 * Extensions whose instructions access their display class call this, a CPU
+		 * only accepts a display with at least this capability together with the decoder.
+		 * 
+		 * @param capability 	Display capability the instructions rely on
+		 */
+		void RequireDisplay(DisplayCapability capability) {
+			requiredDisplay = std::max(requiredDisplay, capability);
+		}
+
+		/**
+		 * @brief Get the required display capability
+		 * 
+		 * @return DisplayCapability 	Display capability the registered instructions rely on
+		 */
+		DisplayCapability GetRequiredDisplay() const {
+			return requiredDisplay;
+		}
+
 		/**
 		 * @brief Get the bad instruction
 		 * 
@@ -22,12 +22,27 @@ namespace CHIP8::Instructions
 		 * 
 		 * @param CPU 	Pointer to the CPU object
 		 * @return bool (true) : Notify the CPU that the instruction was executed
+		 * @return bool (false) : The stack was empty, TrapCode::StackUnderflow is raised
 		 */
 		bool Execute(CPU *cpu) override {
-			cpu->SetPC(cpu->PopStack());
+			auto address = cpu->PopStack();
+			if (!address)
+			{
+				return false;
+			}
+			cpu->SetPC(address.value());
 			return true;
 		};
 
+		/**
+		 * @brief Returns the reason for the abort of the return from a subroutine instruction
+		 * 
+		 * @return std::string : Returns the reason for the abort
+		 */
+		std::string GetAbortReason() override {
+			return "Stack underflow, return without a subroutine call";
+		}
+
 		/**
 		 * @brief Returns the mnemonic for the return from a subroutine instruction
 		 * 
@@ -30,6 +30,7 @@ namespace CHIP8::Instructions
 			{
 				if (address == (cpu->GetPC() - 2))
 				{
+					cpu->RaiseTrap(TrapCode::EndlessLoop);
 					return false;
 				}
 			}
@@ -23,13 +23,26 @@ namespace CHIP8::Instructions
 		 * 
 		 * @param CPU 	Pointer to the CPU object
 		 * @return bool (true) : Notify the CPU that the instruction was executed
+		 * @return bool (false) : The stack was full, TrapCode::StackOverflow is raised
 		 */
 		bool Execute(CPU *cpu) override {
-			cpu->PushStack(cpu->GetPC());
+			if (!cpu->PushStack(cpu->GetPC()))
+			{
+				return false;
+			}
 			cpu->SetPC(address);
 			return true;
 		};
 
+		/**
+		 * @brief Returns the reason for the abort of the call a subroutine at NNN instruction
+		 * 
+		 * @return std::string : Returns the reason for the abort
+		 */
+		std::string GetAbortReason() override {
+			return std::format("Stack overflow, call to 0x{:X} exceeds the stack depth of {}", address, CPU::GetStackDepth());
+		}
+
 		/**
 		 * @brief Returns the mnemonic for the call a subroutine at NNN instruction
 		 * 
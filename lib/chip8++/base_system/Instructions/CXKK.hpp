@@ -2,7 +2,6 @@
 #define _CHIP8_INSTRUCTIONS_CXKK_HPP_
 
 #include "Instruction.hpp"
-#include <cstdlib>
 
 namespace CHIP8::Instructions
 {
@@ -27,7 +26,7 @@ namespace CHIP8::Instructions
 		 * @return bool (true) : Notify the CPU that the instruction was executed
 		 */
 		bool Execute(CPU *cpu) override {
-			uint8_t randomByte = std::rand() % 256;
+			uint8_t randomByte = cpu->GetRandomByte();
 			cpu->SetRegister(registerVX, randomByte & valueKK);
 			return true;
 		};
@@ -17,7 +17,7 @@ namespace CHIP8::Instructions
 		uint8_t RegX;
 		uint8_t RegY;
 		uint8_t SpritesN;
-		std::expected<uint8_t, std::string> retValMemory;
+		std::expected<uint8_t, MemoryFault_t> retValMemory;
 	public:
 		/**
 		 * @brief Execute the instruction to draw a sprite at position (VX, VY) with N bytes of sprite data starting at the address stored in I
@@ -36,7 +36,7 @@ namespace CHIP8::Instructions
 			bool WrapQuirk = cpu->GetQuirks().WrapSprite;
 			
 			// Reset the error message variable
-			// retValMemory = std::expected<uint8_t, std::string>(0);
+			retValMemory = std::expected<uint8_t, MemoryFault_t>(0);
 
 			for (int iy = 0; iy < SpritesN; iy++)
 			{
@@ -48,38 +48,30 @@ namespace CHIP8::Instructions
 					break;
 				}
 
-				for(int ix = 0; ix < 8; ix++)
+				int SpriteY = (DisplayY + iy);
+				if (WrapQuirk)
 				{
-					int SpriteX = (DisplayX + ix);
-					int SpriteY = (DisplayY + iy);
-
-					if (WrapQuirk)
-					{
-						SpriteX = SpriteX % Display->GetWidth();
-						SpriteY = SpriteY % Display->GetHeight();
-					}
-					else
-					{
-						if (SpriteX >= Display->GetWidth() || SpriteY >= Display->GetHeight())
-						{
-							continue;
-						}
-					}
+					SpriteY = SpriteY % Display->GetHeight();
+				}
+				else if (SpriteY >= Display->GetHeight())
+				{
+					continue;
+				}
 
-					if ((retValMemory.value() & (0x80 >> ix)) != 0)
-					{
-						if (Display->at(SpriteX, SpriteY))
-						{
-							collision = true;
-						}
-						Display->at(SpriteX, SpriteY) = Display->at(SpriteX, SpriteY) ^ true;
-					}
+				// XOR the whole sprite row onto the packed display at once
+				if (Display->XorRow(DisplayX, SpriteY, retValMemory.value(), 8, WrapQuirk))
+				{
+					collision = true;
 				}
 			}
 
 			Display->SetUpdateRequired();
 			cpu->SetRegister(0xF, collision ? 1 : 0);
 
+			if (!retValMemory)
+			{
+				cpu->RaiseTrap(TrapCode::MemoryFault);
+			}
 			return retValMemory ? true : false;
 		};
 
@@ -119,7 +111,7 @@ namespace CHIP8::Instructions
 		 * @return std::string : Returns the error report for the instruction
 		 */
 		std::string GetAbortReason() override {
-			return retValMemory.error();
+			return DescribeMemoryFault(retValMemory.error());
 		}
 
 		/**
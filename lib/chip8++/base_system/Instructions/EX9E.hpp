@@ -26,7 +26,7 @@ namespace CHIP8::Instructions
 		 */
 		bool Execute(CPU *cpu) override {
 
-			if (cpu->GetKeypad()->IsKeyPressed((CHIP8::Keypad::Key)cpu->GetRegister(registerVX)) == true)
+			if (cpu->GetKeypad()->IsKeyPressed((CHIP8::Keypad::Key)(cpu->GetRegister(registerVX) & 0x0F)) == true)
 			{
 				cpu->SetPC(cpu->GetPC() + 2);
 			}
@@ -25,7 +25,7 @@ namespace CHIP8::Instructions
 		 * @return bool (true) : Notify the CPU that the instruction was executed
 		 */
 		bool Execute(CPU *cpu) override {
-			if (cpu->GetKeypad()->IsKeyPressed((CHIP8::Keypad::Key)cpu->GetRegister(registerVX)) == false)
+			if (cpu->GetKeypad()->IsKeyPressed((CHIP8::Keypad::Key)(cpu->GetRegister(registerVX) & 0x0F)) == false)
 			{
 				cpu->SetPC(cpu->GetPC() + 2);
 			}
@@ -16,7 +16,7 @@ namespace CHIP8::Instructions
 	{
 		uint8_t registerVX;
 		uint16_t registerI;
-		std::expected<void, std::string> retValMemory;
+		std::expected<void, MemoryFault_t> retValMemory;
 	public:
 		/**
 		 * @brief Execute the instruction to store BCD representation of VX in memory locations I, I+1, and I+2
@@ -41,6 +41,10 @@ namespace CHIP8::Instructions
 				}
 			}
 			
+			if (!retValMemory)
+			{
+				cpu->RaiseTrap(TrapCode::MemoryFault);
+			}
 			return retValMemory ? true : false;
 		};
 
@@ -79,7 +83,7 @@ namespace CHIP8::Instructions
 		 * @return std::string : Returns the error report for the instruction
 		 */
 		std::string GetAbortReason() override {
-			return retValMemory.error();
+			return DescribeMemoryFault(retValMemory.error());
 		}
 
 		/**
@@ -15,6 +15,7 @@ namespace CHIP8::Instructions
 		public std::enable_shared_from_this<IFX55>
 	{
 		uint8_t registerVX;
+		std::expected<void, MemoryFault_t> retValMemory;
 	public:
 		/**
 		 * @brief Execute the instruction to store registers V0 through VX in memory starting at location I
@@ -23,10 +24,22 @@ namespace CHIP8::Instructions
 		 * 
 		 * @param CPU 	Pointer to the CPU object
 		 * @return bool (true) : Notify the CPU that the instruction was executed
+		 * @return bool (false) : A register could not be stored, I points past the memory
 		 */
 		bool Execute(CPU *cpu) override {
+			retValMemory = std::expected<void, MemoryFault_t>();
 			for (uint8_t i = 0; i <= registerVX; i++) {
-				cpu->GetMemory()->SetByte(cpu->GetIndex() + i, cpu->GetRegister(i));
+				auto address = cpu->GetMemory()->GetAddress(cpu->GetIndex(), i);
+				if (!address)
+				{
+					retValMemory = std::unexpected(address.error());
+					break;
+				}
+				retValMemory = cpu->GetMemory()->SetByte(address.value(), cpu->GetRegister(i));
+				if (!retValMemory)
+				{
+					break;
+				}
 			}
 
 			if (cpu->GetQuirks().MemoryLeaveIunchanged == false)
@@ -41,7 +54,11 @@ namespace CHIP8::Instructions
 				}
 			}
 			
-			return true;
+			if (!retValMemory)
+			{
+				cpu->RaiseTrap(TrapCode::MemoryFault);
+			}
+			return retValMemory ? true : false;
 		};
 
 		/**
@@ -71,6 +88,17 @@ namespace CHIP8::Instructions
 			return {0xF055, 0xF0FF};
 		}
 
+		/**
+		 * @brief Get the reason why the function returned false in Execute
+		 * 
+		 * This function provides a string that describes the reason why it failed or aborted
+		 * 
+		 * @return std::string : Returns the error report for the instruction
+		 */
+		std::string GetAbortReason() override {
+			return DescribeMemoryFault(retValMemory.error());
+		}
+
 		/**
 		 * @brief Update the instruction with the opcode
 		 * 
@@ -15,7 +15,7 @@ namespace CHIP8::Instructions
 		public std::enable_shared_from_this<IFX65>
 	{
 		uint8_t registerVX;
-		std::expected<uint8_t, std::string> retValMemory;
+		std::expected<uint8_t, MemoryFault_t> retValMemory;
 	public:
 		/**
 		 * @brief Execute the instruction to fill registers V0 through VX with values from memory starting at address I
@@ -28,7 +28,13 @@ namespace CHIP8::Instructions
 		bool Execute(CPU *cpu) override {
 			for (uint8_t i = 0; i <= registerVX; i++)
 			{
-				retValMemory = cpu->GetMemory()->GetByte(cpu->GetIndex() + i);
+				auto address = cpu->GetMemory()->GetAddress(cpu->GetIndex(), i);
+				if (!address)
+				{
+					retValMemory = std::unexpected(address.error());
+					break;
+				}
+				retValMemory = cpu->GetMemory()->GetByte(address.value());
 
 				if (retValMemory)
 				{
@@ -45,6 +51,10 @@ namespace CHIP8::Instructions
 				cpu->SetIndex(cpu->GetIndex() + registerVX + 1);
 			}
 			
+			if (!retValMemory)
+			{
+				cpu->RaiseTrap(TrapCode::MemoryFault);
+			}
 			return retValMemory ? true : false;
 		};
 
@@ -83,7 +93,7 @@ namespace CHIP8::Instructions
 		 * @return std::string : Returns the error report for the instruction
 		 */
 		std::string GetAbortReason() override {
-			return retValMemory.error();
+			return DescribeMemoryFault(retValMemory.error());
 		}
 
 		/**
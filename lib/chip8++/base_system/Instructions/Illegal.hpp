@@ -25,6 +25,7 @@ namespace CHIP8::Instructions
 		 */
 		bool Execute(CPU *cpu) override { 
 			address = cpu->GetPC() - 2;
+			cpu->RaiseTrap(TrapCode::IllegalInstruction);
 			return false;
 		};
 
@@ -3,9 +3,111 @@
 #include "Instructions/Illegal.hpp"
 #include "Instructions/InstructionList.hpp"
 #include <memory>
+#include <algorithm>
 
 using namespace CHIP8;
 
+namespace
+{
+	/**
+	 * @brief Save state writer
+	 * 
+	 * Little endian writer into a caller provided buffer, bounds are checked
+	 * once up front by SaveState().
+	 */
+	struct StateWriter
+	{
+		std::span<uint8_t> buffer;
+		size_t position = 0;
+
+		void Put8(uint8_t value)
+		{
+			buffer[position++] = value;
+		}
+
+		void Put16(uint16_t value)
+		{
+			Put8(uint8_t(value));
+			Put8(uint8_t(value >> 8));
+		}
+
+		void Put32(uint32_t value)
+		{
+			Put16(uint16_t(value));
+			Put16(uint16_t(value >> 16));
+		}
+
+		void Put64(uint64_t value)
+		{
+			Put32(uint32_t(value));
+			Put32(uint32_t(value >> 32));
+		}
+
+		std::span<uint8_t> Take(size_t length)
+		{
+			auto block = buffer.subspan(position, length);
+			position += length;
+			return block;
+		}
+	};
+
+	/**
+	 * @brief Save state reader
+	 * 
+	 * Counterpart to StateWriter, bounds are checked once up front by LoadState().
+	 */
+	struct StateReader
+	{
+		std::span<const uint8_t> buffer;
+		size_t position = 0;
+
+		uint8_t Get8()
+		{
+			return buffer[position++];
+		}
+
+		uint16_t Get16()
+		{
+			uint16_t low = Get8();
+			return uint16_t(low | (Get8() << 8));
+		}
+
+		uint32_t Get32()
+		{
+			uint32_t low = Get16();
+			return low | (uint32_t(Get16()) << 16);
+		}
+
+		uint64_t Get64()
+		{
+			uint64_t low = Get32();
+			return low | (uint64_t(Get32()) << 32);
+		}
+
+		std::span<const uint8_t> Take(size_t length)
+		{
+			auto block = buffer.subspan(position, length);
+			position += length;
+			return block;
+		}
+	};
+
+	/** @brief Size of the save state header: magic, version, flags, memory size, display size */
+	constexpr size_t SAVESTATE_HEADER_SIZE = 4 + 2 + 2 + 4 + 2 + 2;
+
+	/** @brief Size of the CPU part: V, I, PC, SP, Stack, timers, quirks, random state, RPL flags, audio pattern, pitch */
+	constexpr size_t SAVESTATE_CPU_SIZE = 16 + 2 + 2 + 1 + 16 * 2 + 1 + 1 + 2 + 8 + 16 + Timers::AUDIO_PATTERN_SIZE + 1;
+
+	/** @brief Save state flag: display is in high resolution mode */
+	constexpr uint16_t SAVESTATE_FLAG_HIGHRES = 1 << 0;
+
+	/** @brief Save state flags: selected bit planes of the display */
+	constexpr int SAVESTATE_FLAG_PLANES_SHIFT = 8;
+
+	/** @brief Save state flags: number of bit planes of the display */
+	constexpr int SAVESTATE_FLAG_PLANECOUNT_SHIFT = 12;
+}
+
 CPU::CPU(std::shared_ptr<Keypad> keypad, std::shared_ptr<Display> display, std::shared_ptr<InstructionDecoder> decoder,
 	std::shared_ptr<Memory> memory, std::shared_ptr<Timers> timers)
  : memory(memory), keypad(keypad), display(display), timers(timers)
@@ -20,7 +122,16 @@ CPU::CPU(std::shared_ptr<Keypad> keypad, std::shared_ptr<Display> display, std::
 		}
 	}
 
+	if (display->GetCapability() < decoder->GetRequiredDisplay())
+	{
+		throw std::invalid_argument(std::format("CPU: The instructions require display capability {}, the display only has {}",
+			uint8_t(decoder->GetRequiredDisplay()), uint8_t(display->GetCapability())));
+	}
+
 	this->decoder = decoder;
+	SeedRandom(DEFAULT_RANDOM_SEED);
+	// The RPL flags model persistent storage, only a new CPU starts with them cleared
+	RPL.fill({0});
 	Reset();
 }
 
@@ -31,6 +142,7 @@ void CPU::Reset(bool fullSystemReset)
 	SP = 0;
 	I = 0;
 	PC = 0x200;
+	trap = TrapCode::None;
 
 	if (fullSystemReset)
 	{
@@ -39,28 +151,56 @@ void CPU::Reset(bool fullSystemReset)
 	}
 }
 
-std::expected<bool, std::string> CPU::RunCycle()
+std::expected<bool, TrapCode> CPU::RunCycle()
 {
 	bool successfulInstruction;
+	trap = TrapCode::None;
+	instructionPC = PC;
 	auto opcode = memory->GetWord(PC);
 
 	if (!opcode)
 	{
-		return std::unexpected(std::format("CHIP8: Memory access error!\x1A {}", opcode.error()));
+		fetchFault = opcode.error();
+		RaiseTrap(TrapCode::MemoryFault);
+		return std::unexpected(TrapCode::MemoryFault);
 	}
 
 	currentInstruction = decoder->DecodeInstruction(opcode.value());
 
 	if (currentInstruction == nullptr)
 	{
-		return std::unexpected(std::format("CHIP8: Nullptr instruction at address 0x{:04X}", PC));
+		RaiseTrap(TrapCode::IllegalInstruction);
+		return std::unexpected(TrapCode::IllegalInstruction);
 	}
 	
 	PC += 2;
 	successfulInstruction = currentInstruction->Execute(this);
+	if (!successfulInstruction)
+	{
+		RaiseTrap(TrapCode::InstructionAbort);
+	}
+	cycleCount++;
 	return successfulInstruction;
 }
 
+std::string CPU::GetCycleError() const
+{
+	switch (trap)
+	{
+		case TrapCode::MemoryFault:
+			return std::format("CHIP8: Memory access error!\x1A {}", DescribeMemoryFault(fetchFault));
+		case TrapCode::IllegalInstruction:
+			return std::format("CHIP8: Nullptr instruction at address 0x{:04X}", instructionPC);
+		default:
+			return std::string(TRAP_NAMES[size_t(trap)]);
+	}
+}
+
+uint64_t CPU::GetCycleCount()
+{
+	return cycleCount;
+}
+
 void CPU::SetRegister(uint8_t reg, uint8_t value)
 {
 	V.at(reg) = value;
@@ -91,20 +231,245 @@ uint16_t CPU::GetPC()
 	return PC;
 }
 
-void CPU::PushStack(uint16_t value)
+size_t CPU::GetStackPointer()
+{
+	return SP;
+}
+
+uint16_t CPU::GetStackEntry(size_t index)
+{
+	return Stack.at(index);
+}
+
+std::expected<void, TrapCode> CPU::PushStack(uint16_t value)
 {
 	if (SP >= STACKDEPTH) {
-		throw std::overflow_error("CHIP8: Stack overflow");
+		RaiseTrap(TrapCode::StackOverflow);
+		return std::unexpected(TrapCode::StackOverflow);
 	}
-	Stack.at(SP++) = value;
+	Stack[SP++] = value;
+	return std::expected<void, TrapCode>();
 }
 
-uint16_t CPU::PopStack()
+std::expected<uint16_t, TrapCode> CPU::PopStack()
 {
 	if (SP == 0) {
-		throw std::underflow_error("CHIP8: Stack underflow");
+		RaiseTrap(TrapCode::StackUnderflow);
+		return std::unexpected(TrapCode::StackUnderflow);
+	}
+	return Stack[--SP];
+}
+
+void CPU::RaiseTrap(TrapCode code)
+{
+	if (trap == TrapCode::None)
+	{
+		trap = code;
+		trapPC = instructionPC;
+	}
+}
+
+void CPU::SetRPLFlag(uint8_t flag, uint8_t value)
+{
+	RPL.at(flag) = value;
+}
+
+uint8_t CPU::GetRPLFlag(uint8_t flag)
+{
+	return RPL.at(flag);
+}
+
+void CPU::SeedRandom(uint64_t seed)
+{
+	randomState = (seed != 0) ? seed : DEFAULT_RANDOM_SEED;
+}
+
+uint8_t CPU::GetRandomByte()
+{
+	// xorshift64*, the upper bits have the best quality
+	randomState ^= randomState >> 12;
+	randomState ^= randomState << 25;
+	randomState ^= randomState >> 27;
+	return uint8_t((randomState * 0x2545F4914F6CDD1DULL) >> 56);
+}
+
+size_t CPU::GetSaveStateSize()
+{
+	return SAVESTATE_HEADER_SIZE + SAVESTATE_CPU_SIZE + memory->GetSize() + display->GetPackedSize();
+}
+
+std::expected<size_t, std::string> CPU::SaveState(std::span<uint8_t> buffer)
+{
+	const size_t stateSize = GetSaveStateSize();
+	if (buffer.size() < stateSize)
+	{
+		return std::unexpected(std::format("Save state buffer too small: {} < {}", buffer.size(), stateSize));
+	}
+
+	StateWriter writer{buffer};
+
+	// Header
+	writer.Put32(SAVESTATE_MAGIC);
+	writer.Put16(SAVESTATE_VERSION);
+	writer.Put16(uint16_t((display->GetHighRes() ? SAVESTATE_FLAG_HIGHRES : 0) |
+		((display->GetSelectedPlanes() & 0x0F) << SAVESTATE_FLAG_PLANES_SHIFT) |
+		((display->GetPlanes() - 1) << SAVESTATE_FLAG_PLANECOUNT_SHIFT)));
+	writer.Put32(uint32_t(memory->GetSize()));
+	writer.Put16(uint16_t(display->GetWidth()));
+	writer.Put16(uint16_t(display->GetHeight()));
+
+	// CPU, timers and quirks
+	for (uint8_t reg : V)
+	{
+		writer.Put8(reg);
+	}
+	writer.Put16(I);
+	writer.Put16(PC);
+	writer.Put8(uint8_t(SP));
+	for (uint16_t entry : Stack)
+	{
+		writer.Put16(entry);
+	}
+	writer.Put8(timers->GetDelayTimer());
+	writer.Put8(timers->GetSoundTimer());
+	writer.Put16(quirks.ToBits());
+	writer.Put64(randomState);
+	for (uint8_t flag : RPL)
+	{
+		writer.Put8(flag);
+	}
+	std::ranges::copy(timers->GetAudioPattern(), writer.Take(Timers::AUDIO_PATTERN_SIZE).begin());
+	writer.Put8(timers->GetPitch());
+
+	// Memory and display buffer
+	auto memResult = memory->GetBytes(0, writer.Take(memory->GetSize()));
+	if (!memResult)
+	{
+		return std::unexpected(DescribeMemoryFault(memResult.error()));
+	}
+	display->PackBuffer(writer.Take(display->GetPackedSize()));
+
+	return writer.position;
+}
+
+std::expected<void, std::string> CPU::LoadState(std::span<const uint8_t> buffer)
+{
+	if (buffer.size() < SAVESTATE_HEADER_SIZE)
+	{
+		return std::unexpected(std::format("Save state too small: {} bytes", buffer.size()));
+	}
+
+	StateReader reader{buffer};
+
+	// Validate the header before touching any state
+	if (reader.Get32() != SAVESTATE_MAGIC)
+	{
+		return std::unexpected("Save state has an invalid magic");
 	}
-	return Stack.at(--SP);
+	uint16_t version = reader.Get16();
+	if (version != SAVESTATE_VERSION)
+	{
+		return std::unexpected(std::format("Unsupported save state version: {} != {}", version, SAVESTATE_VERSION));
+	}
+	uint16_t flags = reader.Get16();
+	uint32_t memorySize = reader.Get32();
+	uint16_t width = reader.Get16();
+	uint16_t height = reader.Get16();
+	const int planes = ((flags >> SAVESTATE_FLAG_PLANECOUNT_SHIFT) & 0x0F) + 1;
+	if (memorySize != memory->GetSize() || width != display->GetWidth() || height != display->GetHeight() ||
+		planes != display->GetPlanes())
+	{
+		return std::unexpected(std::format("Save state configuration mismatch: memory {} / display {}x{}x{}, "
+			"expected memory {} / display {}x{}x{}", memorySize, width, height, planes,
+			memory->GetSize(), display->GetWidth(), display->GetHeight(), display->GetPlanes()));
+	}
+	if (buffer.size() < GetSaveStateSize())
+	{
+		return std::unexpected(std::format("Save state truncated: {} < {}", buffer.size(), GetSaveStateSize()));
+	}
+	const uint8_t savedSP = buffer[SAVESTATE_HEADER_SIZE + WORK_REGS + 2 + 2];
+	if (savedSP > STACKDEPTH)
+	{
+		return std::unexpected(std::format("Save state has an invalid stack pointer: {}", savedSP));
+	}
+
+	// CPU, timers and quirks
+	for (uint8_t &reg : V)
+	{
+		reg = reader.Get8();
+	}
+	I = reader.Get16();
+	PC = reader.Get16();
+	SP = reader.Get8();
+	for (uint16_t &entry : Stack)
+	{
+		entry = reader.Get16();
+	}
+	timers->SetDelayTimer(reader.Get8());
+	timers->SetSoundTimer(reader.Get8());
+	quirks.FromBits(reader.Get16());
+	randomState = reader.Get64();
+	for (uint8_t &flag : RPL)
+	{
+		flag = reader.Get8();
+	}
+	timers->SetAudioPattern(reader.Take(Timers::AUDIO_PATTERN_SIZE).first<Timers::AUDIO_PATTERN_SIZE>());
+	timers->SetPitch(reader.Get8());
+
+	// Memory and display buffer
+	auto memResult = memory->SetBytes(0, reader.Take(memory->GetSize()));
+	if (!memResult)
+	{
+		return std::unexpected(DescribeMemoryFault(memResult.error()));
+	}
+	display->SetHighRes(flags & SAVESTATE_FLAG_HIGHRES);
+	display->SelectPlanes(uint8_t((flags >> SAVESTATE_FLAG_PLANES_SHIFT) & 0x0F));
+	display->UnpackBuffer(reader.Take(display->GetPackedSize()));
+
+	return std::expected<void, std::string>();
+}
+
+std::unique_ptr<CPU> CPU::Clone(std::shared_ptr<InstructionDecoder> decoder, std::shared_ptr<Keypad> keypad,
+	std::shared_ptr<Display> display, std::shared_ptr<Timers> timers)
+{
+	if (decoder == nullptr)
+	{
+		decoder = this->decoder;
+	}
+	if (keypad == nullptr)
+	{
+		keypad = std::make_shared<HeadlessKeypad>();
+	}
+	if (display == nullptr)
+	{
+		display = this->display->CreateHeadless();
+	}
+	if (timers == nullptr)
+	{
+		timers = std::make_shared<Timers>();
+	}
+
+	auto clone = std::make_unique<CPU>(keypad, display, std::move(decoder), memory->Clone(), timers);
+
+	clone->V = V;
+	clone->Stack = Stack;
+	clone->SP = SP;
+	clone->I = I;
+	clone->PC = PC;
+	clone->quirks = quirks;
+	clone->RPL = RPL;
+	clone->randomState = randomState;
+	clone->cycleCount = cycleCount;
+
+	display->SetHighRes(this->display->GetHighRes());
+	display->SelectPlanes(this->display->GetSelectedPlanes());
+	display->ShareBufferFrom(*this->display);
+	timers->SetDelayTimer(this->timers->GetDelayTimer());
+	timers->SetSoundTimer(this->timers->GetSoundTimer());
+	timers->SetAudioPattern(this->timers->GetAudioPattern());
+	timers->SetPitch(this->timers->GetPitch());
+
+	return clone;
 }
 
 std::shared_ptr<Display> CPU::GetDisplay()
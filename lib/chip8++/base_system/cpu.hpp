@@ -6,6 +6,8 @@
 #include <stdexcept>
 #include <expected>
 #include <memory>
+#include <span>
+#include <string_view>
 #include "memory.hpp"
 #include "display.hpp"
 #include "keypad.hpp"
@@ -20,6 +22,30 @@ namespace CHIP8
 		class Instruction;
 	}
 	class InstructionDecoder;
+	class PredecodedEngine;
+
+	/**
+	 * @brief Trap Code
+	 * 
+	 * Guest faults the CPU records instead of throwing. The instruction raising a
+	 * trap aborts, RunCycle() returns false and the host stops the current frame.
+	 */
+	enum class TrapCode : uint8_t
+	{
+		None = 0,
+		StackOverflow,			/**< Call with a full stack */
+		StackUnderflow,			/**< Return with an empty stack */
+		MemoryFault,			/**< Access outside of the memory */
+		IllegalInstruction,		/**< Opcode without an instruction */
+		EndlessLoop,			/**< Jump to itself caught by the CatchEndlessJump quirk */
+		InstructionAbort,		/**< Any other instruction returning false */
+		Exit					/**< SCHIP-8 exit instruction 00FD */
+	};
+
+	/** @brief Names of the trap codes, indexed by TrapCode */
+	inline constexpr std::string_view TRAP_NAMES[] = {
+		"none", "stack overflow", "stack underflow", "memory fault", "illegal instruction", "endless loop", "instruction abort", "exit"
+	};
 
 	/**
 	 * @brief CPU
@@ -44,6 +70,18 @@ namespace CHIP8
 		 */
 		static constexpr int WORK_REGS	= 16;
 
+		/** @brief Number of RPL user flags
+		 * 
+		 * This constant represents the number of RPL user flags (8 on SCHIP, 16 on XO-CHIP).
+		 */
+		static constexpr int RPL_FLAGS	= 16;
+
+		/** @brief Default random seed
+		 * 
+		 * This constant is used to seed the random number generator if no seed is provided.
+		 */
+		static constexpr uint64_t DEFAULT_RANDOM_SEED = 0x9E3779B97F4A7C15;
+
 		/** @brief Work registers
 		 * 
 		 * This array stores the work registers.
@@ -115,8 +153,55 @@ namespace CHIP8
 		 * This variable contains the quirks of the Chip8 platform
 		 */
 		Quirks quirks;
+
+		/** @brief RPL user flags
+		 * 
+		 * This array stores the RPL user flags of the SCHIP and XO-CHIP extensions.
+		 * They are cleared on construction only and survive Reset().
+		 */
+		std::array<uint8_t, RPL_FLAGS> RPL;
+
+		/** @brief Random number generator state
+		 * 
+		 * This variable contains the xorshift64* state used by the `CXKK` opcode.
+		 * Keeping it in the CPU makes runs reproducible and lets save states restore it.
+		 */
+		uint64_t randomState;
+
+		/** @brief Cycle Counter
+		 * 
+		 * This variable counts the cycles executed since construction.
+		 * Used by hosts to pin events like key changes to an exact point in the instruction stream.
+		 */
+		uint64_t cycleCount = 0;
+
+		/** @brief Pending trap, cleared when the next cycle starts */
+		TrapCode trap = TrapCode::None;
+
+		/** @brief Address of the instruction being executed, reported as the faulting PC */
+		uint16_t instructionPC = 0;
+
+		/** @brief Address of the instruction that raised the pending trap */
+		uint16_t trapPC = 0;
+
+		/** @brief Out of bounds access of the last failed opcode fetch */
+		MemoryFault_t fetchFault = {};
+
+		/** @brief The predecoded engine executes directly on the CPU state */
+		friend class PredecodedEngine;
 	public:
-		
+		/** @brief Save state magic
+		 * 
+		 * This constant identifies a save state blob ("C8ST").
+		 */
+		static constexpr uint32_t SAVESTATE_MAGIC	= 0x54533843;
+
+		/** @brief Save state version
+		 * 
+		 * This constant is increased whenever the save state layout changes.
+		 */
+		static constexpr uint16_t SAVESTATE_VERSION	= 2;
+
 		CPU(std::shared_ptr<Keypad> keypad, std::shared_ptr<Display> display,
 			std::shared_ptr<InstructionDecoder> decoder = nullptr,
 			std::shared_ptr<Memory> memory = std::make_shared<Memory>(),
@@ -126,7 +211,7 @@ namespace CHIP8
 		 * @brief Reset the CPU
 		 * 
 		 * This function resets the CPU. If a full system reset is performed,
-		 * the memory, display and timers are also reset.
+		 * the memory, display and timers are also reset. The RPL user flags are kept.
 		 * 
 		 * @param fullSystemReset : Perform a full system reset
 		 */
@@ -137,11 +222,30 @@ namespace CHIP8
 		 * 
 		 * This function runs a cycle of the CPU.
 		 * 
-		 * @return std::expected<bool, std::string> : Returns true if the cycle was successful
-		 *                                            and false if an error occurred in a command,
-		 * 								OR returns an error message if an critical error occurred.
+		 * @return std::expected<bool, TrapCode> : Returns true if the cycle was successful
+		 *                                         and false if an error occurred in a command,
+		 * 								OR returns the trap if the instruction could not be fetched or decoded,
+		 * 								GetCycleError() describes it.
 		 */
-		std::expected<bool, std::string> RunCycle();
+		std::expected<bool, TrapCode> RunCycle();
+
+		/**
+		 * @brief Get the error of the last cycle
+		 * 
+		 * This function builds the message for the trap RunCycle() returned as error.
+		 * 
+		 * @return std::string : Message for the user
+		 */
+		std::string GetCycleError() const;
+
+		/**
+		 * @brief Get the cycle count
+		 * 
+		 * This function returns the number of cycles executed since construction.
+		 * 
+		 * @return uint64_t : The number of cycles executed
+		 */
+		uint64_t GetCycleCount();
 
 		/**
 		 * @brief Set the Register
@@ -199,23 +303,176 @@ namespace CHIP8
 		 */
 		uint16_t GetPC();
 
+		/**
+		 * @brief Get the Stack Pointer
+		 * 
+		 * This function returns the number of entries on the stack.
+		 * 
+		 * @return size_t : The value of the stack pointer
+		 */
+		size_t GetStackPointer();
+
+		/**
+		 * @brief Get the Stack Depth
+		 * 
+		 * This function returns the maximum number of entries on the stack.
+		 * 
+		 * @return size_t : The depth of the stack
+		 */
+		static constexpr size_t GetStackDepth() {
+			return STACKDEPTH;
+		}
+
+		/**
+		 * @brief Get a stack entry
+		 * 
+		 * This function returns an entry of the stack without popping it.
+		 * 
+		 * @param index : Index of the entry, 0 is the bottom of the stack
+		 * @return uint16_t : The value of the stack entry
+		 */
+		uint16_t GetStackEntry(size_t index);
+
 		/**
 		 * @brief Push a value onto the stack
 		 * 
-		 * This function pushes a value onto the stack.
+		 * This function pushes a value onto the stack. A full stack raises
+		 * TrapCode::StackOverflow and leaves the stack unchanged.
 		 * 
 		 * @param value : The value to push onto the stack
+		 * @return std::expected<void, TrapCode> : The trap raised if the stack is full
 		 */
-		void PushStack(uint16_t value);
+		std::expected<void, TrapCode> PushStack(uint16_t value);
 
 		/**
 		 * @brief Pop a value from the stack
 		 * 
-		 * This function pops a value from the stack.
+		 * This function pops a value from the stack. An empty stack raises
+		 * TrapCode::StackUnderflow.
 		 * 
-		 * @return uint16_t : The value popped from the stack
+		 * @return std::expected<uint16_t, TrapCode> : The value popped from the stack, the trap raised if the stack is empty
 		 */
-		uint16_t PopStack();
+		std::expected<uint16_t, TrapCode> PopStack();
+
+		/**
+		 * @brief Raise a trap
+		 * 
+		 * This function records a guest fault of the instruction being executed.
+		 * The first trap of a cycle is kept.
+		 * 
+		 * @param code : The fault
+		 */
+		void RaiseTrap(TrapCode code);
+
+		/**
+		 * @brief Get the pending trap
+		 * 
+		 * This function returns the trap raised by the last cycle, valid until
+		 * the next cycle starts.
+		 * 
+		 * @return TrapCode : The trap, TrapCode::None if the last cycle did not fault
+		 */
+		TrapCode GetTrap() const {
+			return trap;
+		}
+
+		/**
+		 * @brief Get the faulting PC
+		 * 
+		 * This function returns the address of the instruction that raised the pending trap.
+		 * 
+		 * @return uint16_t : The address of the faulting instruction
+		 */
+		uint16_t GetTrapPC() const {
+			return trapPC;
+		}
+
+		/**
+		 * @brief Set a RPL user flag
+		 * 
+		 * @param flag : The flag to set
+		 * @param value : The value to set the flag to
+		 */
+		void SetRPLFlag(uint8_t flag, uint8_t value);
+
+		/**
+		 * @brief Get a RPL user flag
+		 * 
+		 * @param flag : The flag to get the value of
+		 * @return uint8_t : The value of the flag
+		 */
+		uint8_t GetRPLFlag(uint8_t flag);
+
+		/**
+		 * @brief Seed the random number generator
+		 * 
+		 * @param seed : The seed, zero selects the default seed
+		 */
+		void SeedRandom(uint64_t seed);
+
+		/**
+		 * @brief Get a random byte
+		 * 
+		 * This function advances the random number generator and returns a random byte.
+		 * 
+		 * @return uint8_t : The random byte
+		 */
+		uint8_t GetRandomByte();
+
+		/**
+		 * @brief Get the size of a save state
+		 * 
+		 * This function returns the number of bytes SaveState() writes for the
+		 * current memory and display configuration.
+		 * 
+		 * @return size_t : Size of a save state in bytes
+		 */
+		size_t GetSaveStateSize();
+
+		/**
+		 * @brief Save the machine state
+		 * 
+		 * This function serializes the registers, stack, memory, bit-packed display buffer,
+		 * timers, quirks, random number generator state and RPL flags into a versioned
+		 * binary blob. It does not allocate, the caller provides the buffer.
+		 * 
+		 * @param buffer : Buffer of at least GetSaveStateSize() bytes
+		 * @return std::expected<size_t, std::string> : Number of bytes written or an error message
+		 */
+		std::expected<size_t, std::string> SaveState(std::span<uint8_t> buffer);
+
+		/**
+		 * @brief Load the machine state
+		 * 
+		 * This function restores a machine state written by SaveState(). The memory and
+		 * display configuration has to match the one the state was saved with.
+		 * 
+		 * @param buffer : Save state blob
+		 * @return std::expected<void, std::string> : Error message if the state could not be loaded
+		 */
+		std::expected<void, std::string> LoadState(std::span<const uint8_t> buffer);
+
+		/**
+		 * @brief Clone the CPU
+		 * 
+		 * This function creates a new CPU with the same state as this one. Memory pages
+		 * and the display buffer are shared copy-on-write, so only registers, stack,
+		 * timers and quirks are copied up front.
+		 * 
+		 * Decoding updates the operands held by the instruction objects, so a decoder
+		 * must only be used by one thread. Leave it nullptr to share the decoder of this
+		 * CPU if the clone runs on the same thread, and pass one of its own otherwise.
+		 * 
+		 * @param decoder : Decoder of the clone with the same instructions, GetDecoder() if nullptr
+		 * @param keypad : Keypad of the clone, a HeadlessKeypad if nullptr
+		 * @param display : Display of the clone (same dimensions), a HeadlessDisplay if nullptr
+		 * @param timers : Timers of the clone, new Timers if nullptr, the timer values are copied over
+		 * @return std::unique_ptr<CPU> : The cloned CPU
+		 */
+		std::unique_ptr<CPU> Clone(std::shared_ptr<InstructionDecoder> decoder = nullptr,
+			std::shared_ptr<Keypad> keypad = nullptr,
+			std::shared_ptr<Display> display = nullptr,
+			std::shared_ptr<Timers> timers = nullptr);
 
 		/**
 		 * @brief Get the Display object
@@ -226,6 +483,22 @@ namespace CHIP8
 		 */
 		std::shared_ptr<Display> GetDisplay();
 
+		/**
+		 * @brief Get the display as the display class of an extension
+		 * 
+		 * Instructions of extensions use this in place of a dynamic_pointer_cast.
+		 * The CPU checked on construction that the display has the capability the
+		 * decoder requires, so this is a plain static_cast without a reference count.
+		 * 
+		 * @tparam ExtensionDisplay : Display class of the extension
+		 * @return ExtensionDisplay& : The display object
+		 */
+		template <class ExtensionDisplay>
+		ExtensionDisplay &GetExtensionDisplay()
+		{
+			return static_cast<ExtensionDisplay &>(*display);
+		}
+
 		/**
 		 * @brief Get the Keypad object
 		 * 
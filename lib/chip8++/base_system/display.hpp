@@ -4,9 +4,95 @@
 #include <cstdint>
 #include <memory>
 #include <format>
+#include <span>
+#include <bit>
+#include <array>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
 
 namespace CHIP8
 {
+	/**
+	 * @brief Display Capability
+	 * 
+	 * Identifies what a display class supports, every capability includes the ones
+	 * before it. Instructions of extensions rely on it to access their display type
+	 * with a static_cast instead of RTTI.
+	 */
+	enum class DisplayCapability : uint8_t
+	{
+		Chip8 = 0,		/**< CHIP8::Display */
+		SCHIP8,			/**< CHIP8::SCHIP8::SCHIP8Display */
+		XOCHIP			/**< CHIP8::XOCHIP::XOCHIPDisplay */
+	};
+
+	/**
+	 * @brief Frame Sink
+	 * 
+	 * Receives the frames of a display at every vertical blank, e.g. to write
+	 * them into a video file. Frames come in the PackBuffer() layout.
+	 */
+	class FrameSink
+	{
+	public:
+		virtual ~FrameSink() = default;
+
+		/**
+		 * @brief Receive a frame
+		 * 
+		 * @param packed : Bit-packed frame, valid until the call returns
+		 * @param width : Width of the frame in pixels
+		 * @param height : Height of the frame in pixels
+		 * @param planes : Number of bit planes following each other in the frame
+		 */
+		virtual void WriteFrame(std::span<const uint8_t> packed, int width, int height, int planes) = 0;
+
+		/**
+		 * @brief Receive a frame identical to the previous one
+		 * 
+		 * Called instead of WriteFrame() when the frame hash did not change since
+		 * the last frame. Sinks that keep a constant frame rate repeat their last
+		 * frame, the default drops the duplicate.
+		 */
+		virtual void RepeatFrame()
+		{
+		}
+	};
+
+	/**
+	 * @brief Compute the hash key of a pixel
+	 * 
+	 * Every pixel of a display buffer has its own random 64 bit key, SplitMix64
+	 * of its bit index in the buffer. The frame hash is the XOR of the keys of
+	 * the set pixels.
+	 * 
+	 * @param bit  Index of the bit in the display buffer
+	 * @return uint64_t : The key of the pixel
+	 */
+	inline constexpr uint64_t PixelHashKey(uint64_t bit)
+	{
+		uint64_t key = bit + 0x9E3779B97F4A7C15;
+		key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9;
+		key = (key ^ (key >> 27)) * 0x94D049BB133111EB;
+		return key ^ (key >> 31);
+	}
+
+	/** @brief Words of the largest built-in display buffer, 128x64 pixels with 2 planes */
+	inline constexpr size_t PIXEL_HASH_WORDS = 256;
+
+	/** @brief Keys of the pixels of the built-in displays, computed at compile time */
+	inline constexpr std::array<uint64_t, PIXEL_HASH_WORDS * 64> PIXEL_HASH_KEYS = []()
+	{
+		std::array<uint64_t, PIXEL_HASH_WORDS * 64> keys{};
+		for (size_t bit = 0; bit < keys.size(); bit++)
+		{
+			keys[bit] = PixelHashKey(bit);
+		}
+		return keys;
+	}();
+
 	/**
 	 * @brief Display
 	 * 
@@ -33,12 +119,43 @@ namespace CHIP8
 		*/
 		int Width, Height;
 
+		/** @brief Words per Row
+		 * 
+		 * Number of 64 bit words a row of a plane takes.
+		 */
+		int RowWords;
+
+		/** @brief Bit Planes
+		 * 
+		 * Number of bit planes, every pixel has a bit in each of them.
+		 */
+		int Planes;
+
+		/** @brief Capability
+		 * 
+		 * The display class this display is an instance of.
+		 */
+		DisplayCapability Capability;
+
 		/** @brief Display Buffer
 		 * 
-		 * This vector stores the display buffer.
+		 * This buffer stores the display bit-packed, row by row. Every row starts
+		 * at a new word, the most significant bit of a word is the leftmost pixel
+		 * and bits past the width stay zero. With more than one bit plane, a row
+		 * holds the words of plane 0 followed by the ones of the next planes, so
+		 * a sprite row is drawn to every plane within the same few words. It can
+		 * be shared with the display of a cloned CPU, writes have to call
+		 * DetachBuffer() first.
+		 */
+		std::shared_ptr<uint64_t []> screenBuffer;
+
+		/** @brief Shared Buffer
+		 * 
+		 * Set on both displays by ShareBufferFrom(), a shared buffer is never written
+		 * again. Unlike the reference count, it cannot change while the other display
+		 * runs on another thread.
 		 */
-		//std::array<bool, WIDTH * HEIGHT> screenBuffer;
-		std::unique_ptr<bool []> screenBuffer;
+		bool sharedBuffer = false;
 
 
 		/** @brief Update Required
@@ -47,6 +164,31 @@ namespace CHIP8
 		 */
 		bool UpdateRequired = false;
 
+		/** @brief Frame Hash
+		 * 
+		 * XOR of the keys of every set pixel, see HashWord(). Drawing updates it
+		 * with the pixels it toggled, an empty buffer hashes to zero.
+		 */
+		uint64_t frameHash = 0;
+
+		/** @brief Frame Hash of the last frame handed to the frame sink */
+		uint64_t sinkHash = 0;
+
+		/** @brief Frame Sink has received a frame */
+		bool sinkHasFrame = false;
+
+		/** @brief Frame Sink
+		 * 
+		 * Receives a frame at every VBlank(), none if null.
+		 */
+		std::shared_ptr<FrameSink> frameSink;
+
+		/** @brief Frame Buffer of the Frame Sink
+		 * 
+		 * The packed frame handed to the frame sink, allocated once.
+		 */
+		std::vector<uint8_t> sinkFrame;
+
 		/**
 		 * @brief Construct a new Display object
 		 * 
@@ -54,23 +196,125 @@ namespace CHIP8
 		 * 
 		 * @param height	Height in Pixels of the display buffer
 		 * @param width		Width in Pixels of the display buffer
+		 * @param capability	Display class the derived display is an instance of
+		 * @param planes	Number of bit planes
 		 */
-		Display(int height, int width) : Width(width), Height(height)
+		Display(int height, int width, DisplayCapability capability = DisplayCapability::Chip8, int planes = 1)
+		 : Width(width), Height(height), RowWords((width + 63) / 64), Planes(planes), Capability(capability)
 		{
-			screenBuffer = std::make_unique<bool[]>(Height * Width);
+			screenBuffer = std::make_shared<uint64_t[]>(GetBufferWords());
 			Clear();
 		};
+
+		/**
+		 * @brief Get the number of words of the display buffer
+		 * 
+		 * @return size_t : Number of 64 bit words of the display buffer
+		 */
+		size_t GetBufferWords() const
+		{
+			return size_t(RowWords) * size_t(Planes) * size_t(Height);
+		}
+
+		/**
+		 * @brief Get a row of a plane of the display buffer
+		 * 
+		 * @param y  Y coordinate of the row
+		 * @param plane  Bit plane
+		 * @return uint64_t* : First word of the row
+		 */
+		uint64_t *GetRow(int y, int plane = 0)
+		{
+			return &screenBuffer[size_t((y * Planes + plane) * RowWords)];
+		}
+
+		/**
+		 * @brief Get a row of a plane of the display buffer
+		 * 
+		 * @param y  Y coordinate of the row
+		 * @param plane  Bit plane
+		 * @return const uint64_t* : First word of the row
+		 */
+		const uint64_t *GetRow(int y, int plane = 0) const
+		{
+			return &screenBuffer[size_t((y * Planes + plane) * RowWords)];
+		}
+
+		/**
+		 * @brief Hash the set bits of a word of the display buffer
+		 * 
+		 * The hash of a word is the XOR of the keys of its set bits, looked up in
+		 * PIXEL_HASH_KEYS. XOR-ing a word with a mask therefore changes the frame
+		 * hash by the hash of the mask, no matter what the word held before.
+		 * 
+		 * @param index  Index of the word in the display buffer
+		 * @param bits  Set bits of the word
+		 * @return uint64_t : The hash of the bits
+		 */
+		static uint64_t HashWord(size_t index, uint64_t bits)
+		{
+			uint64_t hash = 0;
+			if (index >= PIXEL_HASH_WORDS) [[unlikely]]
+			{
+				// Custom headless displays can be larger than the table
+				for (; bits != 0; bits &= bits - 1)
+				{
+					hash ^= PixelHashKey(uint64_t(index) * 64 + uint64_t(std::countr_zero(bits)));
+				}
+				return hash;
+			}
+
+			const uint64_t *keys = &PIXEL_HASH_KEYS[index * 64];
+			for (; bits != 0; bits &= bits - 1)
+			{
+				hash ^= keys[std::countr_zero(bits)];
+			}
+			return hash;
+		}
+
+		/**
+		 * @brief Recompute the frame hash from the whole display buffer
+		 * 
+		 * Has to be called after changing the buffer other than through XorRow(),
+		 * SetPixel() or Clear(), e.g. after scrolling.
+		 */
+		void RehashBuffer()
+		{
+			frameHash = 0;
+			for (size_t i = 0; i < GetBufferWords(); i++)
+			{
+				frameHash ^= HashWord(i, screenBuffer[i]);
+			}
+		}
+
+		/**
+		 * @brief Detach a shared display buffer
+		 * 
+		 * This function gives this display its own copy of the buffer if it was
+		 * shared with another display. Has to be called before writing to it.
+		 * 
+		 * @param keepContent : Copy the content, can be skipped if the buffer gets overwritten
+		 */
+		void DetachBuffer(bool keepContent = true)
+		{
+			if (sharedBuffer) [[unlikely]]
+			{
+				auto ownBuffer = std::make_shared<uint64_t[]>(GetBufferWords());
+				if (keepContent)
+				{
+					std::copy_n(screenBuffer.get(), GetBufferWords(), ownBuffer.get());
+				}
+				screenBuffer = ownBuffer;
+				sharedBuffer = false;
+			}
+		}
 	public:
 		/**
 		 * @brief Construct a new Display object
 		 * 
 		 * This constructor initializes the display buffer and clears it.
 		 */
-		Display() : Width(DEFAULT_WIDTH), Height(DEFAULT_HEIGHT)
-		{
-			screenBuffer = std::make_unique<bool[]>(Height * Width);
-			Clear();
-		};
+		Display() : Display(DEFAULT_HEIGHT, DEFAULT_WIDTH) {};
 
 		/**
 		 * @brief Destroy the Display object
@@ -79,6 +323,25 @@ namespace CHIP8
 		 */
 		virtual ~Display() = default;
 
+		/**
+		 * @brief Get the capability of the display
+		 * 
+		 * @return DisplayCapability : The display class this display is an instance of
+		 */
+		DisplayCapability GetCapability() const
+		{
+			return Capability;
+		}
+
+		/**
+		 * @brief Create a headless display of the same class and dimensions
+		 * 
+		 * Used to clone a CPU without a display of its own.
+		 * 
+		 * @return std::shared_ptr<Display> : The headless display
+		 */
+		virtual std::shared_ptr<Display> CreateHeadless() const;
+
 		/**
 		 * @brief Get the value of the Update Required flag
 		 * 
@@ -99,6 +362,80 @@ namespace CHIP8
 			UpdateRequired = true;
 		}
 
+		/**
+		 * @brief Clear the Update Required flag
+		 * 
+		 * Lets a host skip a frame it does not have to show, e.g. because the
+		 * frame hash did not change since the last one it showed.
+		 */
+		virtual void ClearUpdateRequired()
+		{
+			UpdateRequired = false;
+		}
+
+		/**
+		 * @brief Get the frame hash
+		 * 
+		 * A 64 bit hash of the pixels of every bit plane, kept up to date while
+		 * drawing. Frames with the same hash are identical with near certainty,
+		 * so hosts and frame sinks can skip duplicate frames without comparing
+		 * the buffers. The hash of an empty display is zero.
+		 * 
+		 * @return uint64_t : Hash of the display buffer
+		 */
+		uint64_t GetFrameHash() const
+		{
+			return frameHash;
+		}
+
+		/**
+		 * @brief Set the frame sink
+		 * 
+		 * Clones of the CPU get a headless display without the sink.
+		 * 
+		 * @param sink : Sink receiving a frame at every VBlank(), nullptr for none
+		 */
+		void SetFrameSink(std::shared_ptr<FrameSink> sink)
+		{
+			frameSink = std::move(sink);
+			sinkFrame.resize(frameSink ? GetPackedSize() : 0);
+			sinkHasFrame = false;
+		}
+
+		/**
+		 * @brief Get the frame sink
+		 * 
+		 * @return std::shared_ptr<FrameSink> : The frame sink, nullptr if none is set
+		 */
+		std::shared_ptr<FrameSink> GetFrameSink() const
+		{
+			return frameSink;
+		}
+
+		/**
+		 * @brief Signal the vertical blank
+		 * 
+		 * Hosts call this once per frame, together with the 60Hz timer tick.
+		 * Hands the current frame to the frame sink, or tells it the frame
+		 * repeats if the frame hash did not change. Does nothing without a sink.
+		 */
+		void VBlank()
+		{
+			if (!frameSink)
+			{
+				return;
+			}
+			if (sinkHasFrame && frameHash == sinkHash)
+			{
+				frameSink->RepeatFrame();
+				return;
+			}
+			PackBuffer(sinkFrame);
+			frameSink->WriteFrame(sinkFrame, Width, Height, Planes);
+			sinkHash = frameHash;
+			sinkHasFrame = true;
+		}
+
 		/**
 		 * @brief Get the width of the display
 		 * 
@@ -120,47 +457,437 @@ namespace CHIP8
 		}
 
 		/**
-		 * @brief Access a pixel on the display
+		 * @brief Get the number of bit planes
 		 * 
-		 * This function accesses a pixel on the display buffer.
+		 * @return int : Number of bit planes of the display
+		 */
+		int GetPlanes() const
+		{
+			return Planes;
+		}
+
+		/**
+		 * @brief Pixel Bytes
+		 * 
+		 * The 8 pixels of a byte of packed pixels spread over the 8 bytes of a
+		 * word, one per byte in memory order, the most significant bit first.
+		 * Copied into a byte array, pixel n of the byte lands in element n.
+		 */
+		static constexpr std::array<uint64_t, 256> PIXEL_BYTES = []()
+		{
+			std::array<uint64_t, 256> table{};
+			for (unsigned byte = 0; byte < 256; byte++)
+			{
+				for (unsigned i = 0; i < 8; i++)
+				{
+					if ((byte >> (7 - i)) & 1)
+					{
+						table[byte] |= uint64_t(1) << (std::endian::native == std::endian::little ? 8 * i : 56 - 8 * i);
+					}
+				}
+			}
+			return table;
+		}();
+
+		/**
+		 * @brief Unpack the display into one byte per pixel
+		 * 
+		 * Row by row, bit n of a pixel is its bit in plane n, like GetColor().
+		 * Works a byte of pixels at a time.
+		 * 
+		 * @param pixels : Buffer of at least width * height bytes
+		 */
+		void UnpackPixels(std::span<uint8_t> pixels) const
+		{
+			std::fill_n(pixels.begin(), size_t(Width) * size_t(Height), 0);
+			for (int y = 0; y < Height; y++)
+			{
+				uint8_t *out = pixels.data() + size_t(y) * size_t(Width);
+				for (int plane = 0; plane < Planes; plane++)
+				{
+					const uint64_t *row = GetRow(y, plane);
+					for (int x = 0; x < Width; x += 8)
+					{
+						const uint8_t bits = uint8_t(row[x >> 6] >> (56 - (x & 63)));
+						const uint64_t spread = PIXEL_BYTES[bits] << plane;
+						if (Width - x >= 8)
+						{
+							uint64_t word;
+							std::memcpy(&word, out + x, 8);
+							word |= spread;
+							std::memcpy(out + x, &word, 8);
+						}
+						else
+						{
+							uint8_t bytes[8];
+							std::memcpy(bytes, &spread, 8);
+							for (int i = 0; i < Width - x; i++)
+							{
+								out[x + i] |= bytes[i];
+							}
+						}
+					}
+				}
+			}
+		}
+
+		/**
+		 * @brief Get the number of words per row of a bit plane
+		 * 
+		 * @return int : Number of 64 bit words a row of a plane takes in GetBuffer()
+		 */
+		int GetRowWords() const
+		{
+			return RowWords;
+		}
+
+		/**
+		 * @brief Get the display buffer
+		 * 
+		 * Gives direct access to the words of the display buffer without copying
+		 * them, laid out as described for screenBuffer. Drawing may move the
+		 * buffer if it is shared with a cloned display, so the span is only
+		 * valid until the next write to the display.
+		 * 
+		 * @return std::span<const uint64_t> : The words of the display buffer
+		 */
+		std::span<const uint64_t> GetBuffer() const
+		{
+			return {screenBuffer.get(), GetBufferWords()};
+		}
+
+		/**
+		 * @brief Read a pixel on the display
+		 * 
+		 * This function reads a pixel of the first bit plane of the display buffer.
 		 * 
 		 * @param x  X coordinate
 		 * @param y  Y coordinate
-		 * @return const bool& : Returns the value of the pixel 
+		 * @return bool : Returns the value of the pixel 
 		 */
-		virtual const bool &at(uint8_t x, uint8_t y) const
+		bool at(uint8_t x, uint8_t y) const
 		{
 			if (x >= Width || y >= Height)
 				throw std::out_of_range(std::format("Display::at() : Out of range access (x={}"
 					" >= WIDTH={} or y={} >= HEIGHT={})", x, Width, y, Height));
-			return screenBuffer[size_t(y * Width + x)];
+			return (GetRow(y)[x >> 6] >> (63 - (x & 63))) & 1;
 		};
 
 		/**
-		 * @brief Access a pixel on the display
+		 * @brief Read the color of a pixel on the display
+		 * 
+		 * @param x  X coordinate
+		 * @param y  Y coordinate
+		 * @return uint8_t : Bit n is the pixel in bit plane n
+		 */
+		uint8_t GetColor(uint8_t x, uint8_t y) const
+		{
+			if (x >= Width || y >= Height)
+				throw std::out_of_range(std::format("Display::GetColor() : Out of range access (x={}"
+					" >= WIDTH={} or y={} >= HEIGHT={})", x, Width, y, Height));
+			uint8_t color = 0;
+			for (int plane = 0; plane < Planes; plane++)
+			{
+				color |= uint8_t(((GetRow(y, plane)[x >> 6] >> (63 - (x & 63))) & 1) << plane);
+			}
+			return color;
+		}
+
+		/**
+		 * @brief Set a pixel on the display
 		 * 
-		 * This function accesses a pixel on the display buffer.
+		 * This function writes a pixel of the first bit plane of the display buffer.
 		 * 
 		 * @param x  X coordinate
 		 * @param y  Y coordinate
-		 * @return bool& : Returns the value of the pixel 
+		 * @param value  Value of the pixel
 		 */
-		virtual bool &at(uint8_t x, uint8_t y)
+		void SetPixel(uint8_t x, uint8_t y, bool value)
 		{
 			if (x >= Width || y >= Height)
-				throw std::out_of_range(std::format("Display::at() : Out of range access (x={}"
+				throw std::out_of_range(std::format("Display::SetPixel() : Out of range access (x={}"
 					" >= WIDTH={} or y={} >= HEIGHT={})", x, Width, y, Height));
-			return screenBuffer[size_t(y * Width + x)];
-		};
+			DetachBuffer();
+			const uint64_t bit = uint64_t(1) << (63 - (x & 63));
+			uint64_t &word = GetRow(y)[x >> 6];
+			if (bool(word & bit) != value)
+			{
+				frameHash ^= HashWord(size_t(&word - screenBuffer.get()), bit);
+				word ^= bit;
+			}
+		}
+
+		/**
+		 * @brief XOR a sprite row onto the display
+		 * 
+		 * This function XORs up to 64 pixels onto a row of the display buffer,
+		 * a word at a time. Pixels past the right edge are clipped or wrap
+		 * around to the left edge.
+		 * 
+		 * @param x  X coordinate of the leftmost pixel, has to be on the display
+		 * @param y  Y coordinate of the row, has to be on the display
+		 * @param bits  Pixels in the lowest `count` bits, the most significant of them is the leftmost pixel
+		 * @param count  Number of pixels, 1 to 64
+		 * @param wrap  Wrap pixels past the right edge instead of clipping them
+		 * @param plane  Bit plane to draw to
+		 * @return bool : Returns true if a set pixel was cleared (collision)
+		 */
+		bool XorRow(int x, int y, uint64_t bits, int count, bool wrap, int plane = 0)
+		{
+			DetachBuffer();
+			uint64_t *row = GetRow(y, plane);
+			const size_t rowIndex = size_t(row - screenBuffer.get());
+			uint64_t collision = 0;
+
+			for (int done = 0; done < count; )
+			{
+				int position = x + done;
+				if (position >= Width)
+				{
+					if (!wrap)
+					{
+						break;
+					}
+					position %= Width;
+				}
+
+				// Pixels that fit into this word and onto this row
+				const int offset = position & 63;
+				const int pixels = std::min({count - done, 64 - offset, Width - position});
+				const uint64_t segment = (bits >> (count - done - pixels)) & (~uint64_t(0) >> (64 - pixels));
+				const uint64_t mask = segment << (64 - offset - pixels);
+
+				collision |= row[position >> 6] & mask;
+				row[position >> 6] ^= mask;
+				frameHash ^= HashWord(rowIndex + size_t(position >> 6), mask);
+				done += pixels;
+			}
+			return collision != 0;
+		}
+
+		/**
+		 * @brief XOR a sprite row onto several bit planes
+		 * 
+		 * This function works like XorRow() for every selected plane, but in one
+		 * pass over the row. The planes of a row are next to each other in the
+		 * display buffer, so the words of all planes at a position are RowWords
+		 * apart and get XORed together after computing the masks once.
+		 * 
+		 * @param x  X coordinate of the leftmost pixel, has to be on the display
+		 * @param y  Y coordinate of the row, has to be on the display
+		 * @param bits  Pixels of plane n in bits[n], in the lowest `count` bits
+		 * @param planeMask  Bit n selects plane n, planes the display lacks are ignored
+		 * @param count  Number of pixels, 1 to 64
+		 * @param wrap  Wrap pixels past the right edge instead of clipping them
+		 * @return bool : Returns true if a set pixel was cleared on any plane (collision)
+		 */
+		bool XorPlaneRows(int x, int y, std::span<const uint64_t> bits, uint8_t planeMask, int count, bool wrap)
+		{
+			DetachBuffer();
+			uint64_t *row = GetRow(y);
+			const size_t rowIndex = size_t(row - screenBuffer.get());
+			const int planes = std::min(Planes, int(bits.size()));
+			uint64_t collision = 0;
+
+			for (int done = 0; done < count; )
+			{
+				int position = x + done;
+				if (position >= Width)
+				{
+					if (!wrap)
+					{
+						break;
+					}
+					position %= Width;
+				}
+
+				const int offset = position & 63;
+				const int pixels = std::min({count - done, 64 - offset, Width - position});
+				const int shift = count - done - pixels;
+				const uint64_t pixelMask = ~uint64_t(0) >> (64 - pixels);
+				for (int plane = 0; plane < planes; plane++)
+				{
+					if (!(planeMask & (1 << plane)))
+					{
+						continue;
+					}
+					const size_t word = size_t(plane * RowWords + (position >> 6));
+					const uint64_t mask = ((bits[size_t(plane)] >> shift) & pixelMask) << (64 - offset - pixels);
+					collision |= row[word] & mask;
+					row[word] ^= mask;
+					frameHash ^= HashWord(rowIndex + word, mask);
+				}
+				done += pixels;
+			}
+			return collision != 0;
+		}
+
+		/**
+		 * @brief Set High Resolution Mode
+		 * 
+		 * Displays of extensions with a high resolution mode override this,
+		 * the base CHIP-8 display has no such mode and ignores the call.
+		 * 
+		 * @param highRes High resolution mode flag
+		 */
+		virtual void SetHighRes(bool highRes)
+		{
+			(void)highRes;
+		}
+
+		/**
+		 * @brief Get High Resolution Mode
+		 * 
+		 * @return bool : High resolution mode flag, always false on the base CHIP-8 display
+		 */
+		virtual bool GetHighRes()
+		{
+			return false;
+		}
+
+		/**
+		 * @brief Select the bit planes instructions draw to
+		 * 
+		 * Displays with more than one bit plane override this, the base CHIP-8
+		 * display always draws to its only plane and ignores the call.
+		 * 
+		 * @param mask Bit n selects bit plane n
+		 */
+		virtual void SelectPlanes(uint8_t mask)
+		{
+			(void)mask;
+		}
+
+		/**
+		 * @brief Get the bit planes instructions draw to
+		 * 
+		 * @return uint8_t : Bit n is set if bit plane n is selected, always 1 on the base CHIP-8 display
+		 */
+		virtual uint8_t GetSelectedPlanes()
+		{
+			return 1;
+		}
+
+		/**
+		 * @brief Get the size of a bit-packed plane
+		 * 
+		 * @return size_t : Number of bytes a plane takes in the PackBuffer() output
+		 */
+		size_t GetPackedPlaneSize() const
+		{
+			return (size_t(Width) * size_t(Height) + 7) / 8;
+		}
+
+		/**
+		 * @brief Get the size of the bit-packed display buffer
+		 * 
+		 * @return size_t : Number of bytes required by PackBuffer()
+		 */
+		size_t GetPackedSize() const
+		{
+			return GetPackedPlaneSize() * size_t(Planes);
+		}
+
+		/**
+		 * @brief Pack the display buffer into bits
+		 * 
+		 * This function packs the display buffer row by row into bits, the most
+		 * significant bit of the first byte is the top left pixel. Additional bit
+		 * planes follow the first one, each starting at a new byte.
+		 * 
+		 * @param buffer : Buffer of at least GetPackedSize() bytes
+		 */
+		void PackBuffer(std::span<uint8_t> buffer) const
+		{
+			std::fill_n(buffer.begin(), GetPackedSize(), 0);
+			for (int plane = 0; plane < Planes; plane++)
+			{
+				auto packed = buffer.subspan(size_t(plane) * GetPackedPlaneSize());
+				if (Width % 8 == 0)
+				{
+					// Rows end on a byte boundary, copy them a byte at a time
+					const size_t rowBytes = size_t(Width) / 8;
+					for (int y = 0; y < Height; y++)
+					{
+						const uint64_t *row = GetRow(y, plane);
+						for (size_t i = 0; i < rowBytes; i++)
+						{
+							packed[size_t(y) * rowBytes + i] = uint8_t(row[i >> 3] >> (56 - 8 * (i & 7)));
+						}
+					}
+					continue;
+				}
+
+				for (size_t y = 0, i = 0; y < size_t(Height); y++)
+				{
+					const uint64_t *row = GetRow(int(y), plane);
+					for (size_t x = 0; x < size_t(Width); x++, i++)
+					{
+						packed[i >> 3] |= uint8_t(((row[x >> 6] >> (63 - (x & 63))) & 1) << (7 - (i & 7)));
+					}
+				}
+			}
+		}
+
+		/**
+		 * @brief Unpack bits into the display buffer
+		 * 
+		 * This function is the counterpart to PackBuffer() and marks the display
+		 * as requiring an update.
+		 * 
+		 * @param buffer : Buffer of at least GetPackedSize() bytes
+		 */
+		void UnpackBuffer(std::span<const uint8_t> buffer)
+		{
+			DetachBuffer(false);
+			std::fill_n(screenBuffer.get(), GetBufferWords(), 0);
+			for (int plane = 0; plane < Planes; plane++)
+			{
+				auto packed = buffer.subspan(size_t(plane) * GetPackedPlaneSize());
+				for (size_t y = 0, i = 0; y < size_t(Height); y++)
+				{
+					uint64_t *row = GetRow(int(y), plane);
+					for (size_t x = 0; x < size_t(Width); x++, i++)
+					{
+						row[x >> 6] |= uint64_t((packed[i >> 3] >> (7 - (i & 7))) & 1) << (63 - (x & 63));
+					}
+				}
+			}
+			RehashBuffer();
+			UpdateRequired = true;
+		}
+
+		/**
+		 * @brief Share the display buffer of another display
+		 * 
+		 * This function makes this display show the buffer of the other display
+		 * without copying it. The buffer is copied once either display writes to it,
+		 * so both can run on different threads afterwards.
+		 * 
+		 * @param other : Display with the same dimensions to share the buffer of
+		 */
+		void ShareBufferFrom(Display &other)
+		{
+			if (other.Width != Width || other.Height != Height || other.Planes != Planes)
+				throw std::invalid_argument(std::format("Display::ShareBufferFrom() : Dimension mismatch "
+					"({}x{}x{} != {}x{}x{})", other.Width, other.Height, other.Planes, Width, Height, Planes));
+			screenBuffer = other.screenBuffer;
+			sharedBuffer = true;
+			other.sharedBuffer = true;
+			frameHash = other.frameHash;
+			UpdateRequired = true;
+		}
 
 		/**
 		 * @brief Clear the display
 		 * 
-		 * This function clears the display buffer.
+		 * This function clears the display buffer and resets the frame hash.
 		 */
 		virtual void Clear()
 		{
-			std::fill(screenBuffer.get(), screenBuffer.get() + Width * Height, false);
+			DetachBuffer(false);
+			std::fill_n(screenBuffer.get(), GetBufferWords(), 0);
+			frameHash = 0;
 			UpdateRequired = true;
 		};
 
@@ -171,6 +898,44 @@ namespace CHIP8
 		 */
 		virtual void Update() = 0;
 	};
+
+	/**
+	 * @brief Headless Display
+	 * 
+	 * This class represents a display without any output, useful for batch runs,
+	 * tree searches over cloned CPUs and other headless hosts.
+	 */
+	class HeadlessDisplay : public Display
+	{
+	public:
+		/**
+		 * @brief Construct a new Headless Display object with the default dimensions
+		 */
+		HeadlessDisplay() : Display() {};
+
+		/**
+		 * @brief Construct a new Headless Display object
+		 * 
+		 * @param height	Height in Pixels of the display buffer
+		 * @param width		Width in Pixels of the display buffer
+		 */
+		HeadlessDisplay(int height, int width) : Display(height, width) {};
+
+		/**
+		 * @brief Update the display
+		 * 
+		 * Nothing to show, only clears the Update Required flag.
+		 */
+		void Update() override
+		{
+			UpdateRequired = false;
+		}
+	};
+
+	inline std::shared_ptr<Display> Display::CreateHeadless() const
+	{
+		return std::make_shared<HeadlessDisplay>(Height, Width);
+	}
 }
 
 #endif /* _DISPLAY_HPP_ */
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define _CHIP8_KEYPAD_HPP_
 
 #include <iostream>
+#include <cstdint>
 #include <array>
 
 namespace CHIP8
@@ -73,7 +74,70 @@ namespace CHIP8
 		}
 
 		virtual void UpdateKeys() = 0;
-	};    
+	};
+
+	/**
+	 * @brief Headless Keypad
+	 * 
+	 * This class represents a keypad that is driven by the host through a
+	 * bitmask of pressed keys instead of real input. Waiting for a key press
+	 * never blocks, `FX0A` repeats until a key is set.
+	 */
+	class HeadlessKeypad : public Keypad
+	{
+	public:
+		/**
+		 * @brief Set the pressed keys
+		 * 
+		 * @param mask : Bit N set means key N is pressed
+		 */
+		void SetKeyMask(uint16_t mask)
+		{
+			for (size_t i = 0; i < keys.size(); i++)
+			{
+				keys[i] = (mask >> i) & 1;
+			}
+		}
+
+		/**
+		 * @brief Get the pressed keys
+		 * 
+		 * @return uint16_t : Bit N set means key N is pressed
+		 */
+		uint16_t GetKeyMask()
+		{
+			uint16_t mask = 0;
+			for (size_t i = 0; i < keys.size(); i++)
+			{
+				mask |= uint16_t(keys[i] << i);
+			}
+			return mask;
+		}
+
+		/**
+		 * @brief Return the lowest pressed key without blocking
+		 * 
+		 * @return enum Key : The pressed key or KEY_INVALID if no key is pressed
+		 */
+		enum Key WaitForKeyPress() override
+		{
+			for (size_t i = 0; i < keys.size(); i++)
+			{
+				if (keys[i])
+				{
+					return static_cast<enum Key>(i);
+				}
+			}
+			return Key::KEY_INVALID;
+		}
+
+		/**
+		 * @brief Update the keys
+		 * 
+		 * The keys are set by the host through SetKeyMask(), nothing to poll.
+		 */
+		void UpdateKeys() override {}
+	};
 } // namespace CHIP8
 
 
@@ -3,14 +3,72 @@
 
 #include <cstdint>
 #include <array>
+#include <vector>
+#include <memory>
 #include <string>
 #include <fstream>
 #include <ios>
 #include <expected>
 #include <format>
+#include <span>
+#include <algorithm>
+#include <stdexcept>
+#include <atomic>
 
 namespace CHIP8
 {
+	/**
+	 * @brief Memory Access Hook Interface
+	 * 
+	 * This class is an interface for observers of the memory accesses done by
+	 * instructions through Memory::GetByte() and Memory::SetByte(), used for
+	 * watchpoints. Memory without a hook only pays a null pointer check.
+	 */
+	class MemoryAccessHook
+	{
+	public:
+		virtual ~MemoryAccessHook() = default;
+
+		/**
+		 * @brief Virtual: A byte was read
+		 * 
+		 * @param address : Address of the byte
+		 * @param value : Value read
+		 */
+		virtual void OnRead(uint16_t address, uint8_t value) = 0;
+
+		/**
+		 * @brief Virtual: A byte was written
+		 * 
+		 * @param address : Address of the byte
+		 * @param value : Value written
+		 */
+		virtual void OnWrite(uint16_t address, uint8_t value) = 0;
+	};
+
+	/**
+	 * @brief Memory Fault
+	 * 
+	 * Error of an out of bounds access. It is trivially copyable, so a faulting
+	 * instruction does not allocate; DescribeMemoryFault() builds the message.
+	 */
+	typedef struct
+	{
+		uint32_t address;	/**< Highest address accessed */
+		uint32_t limit;		/**< Highest valid address */
+	} MemoryFault_t;
+
+	/**
+	 * @brief Describe a memory fault
+	 * 
+	 * @param fault : The fault
+	 * @return std::string : Message for the user
+	 */
+	inline std::string DescribeMemoryFault(const MemoryFault_t &fault)
+	{
+		return std::format("Memory out of bounds: {} > {}", fault.address, fault.limit);
+	}
+
 	/**
 	 * @brief Memory
 	 * 
@@ -18,11 +76,17 @@ namespace CHIP8
 	 */
 	class Memory
 	{
-		/** @brief Memory Size
+		/** @brief Default Memory Size
 		 * 
-		 * This constant represents the size of the memory.
+		 * This constant represents the size of the CHIP-8 memory.
 		 */
-		static constexpr size_t MEMORY_SIZE				= 4096;
+		static constexpr size_t DEFAULT_MEMORY_SIZE		= 4096;
+
+		/** @brief Maximum Memory Size
+		 * 
+		 * This constant represents the largest memory 16 bit addresses can reach.
+		 */
+		static constexpr size_t MAX_MEMORY_SIZE			= 65536;
 
 		/** @brief Default ROM start address
 		 * 
@@ -60,29 +124,149 @@ namespace CHIP8
 			0xF0, 0x80, 0xF0, 0x80, 0x80 	// F
 		}};
 
+		/** @brief Default big font start address
+		 * 
+		 * This constant represents the start address of the default SCHIP-8 big font,
+		 * directly after the CHIP-8 font.
+		 */
+		static constexpr size_t DEFAULT_BIG_FONT_START	= 0xA0;
+
+		/** @brief Default SCHIP-8 big font
+		 * 
+		 * This array stores the default SCHIP-8 big font, 8x10 pixels per digit.
+		 */
+		static constexpr std::array<uint8_t, 160> DEFAULT_BIG_FONT = 
+		{{
+			0xFF, 0xFF, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF,	// 0
+			0x18, 0x78, 0x78, 0x18, 0x18, 0x18, 0x18, 0x18, 0xFF, 0xFF,	// 1
+			0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF,	// 2
+			0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF,	// 3
+			0xC3, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0x03, 0x03, 0x03, 0x03,	// 4
+			0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF,	// 5
+			0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF,	// 6
+			0xFF, 0xFF, 0x03, 0x03, 0x06, 0x0C, 0x18, 0x18, 0x18, 0x18,	// 7
+			0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF,	// 8
+			0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF,	// 9
+			0x7E, 0xFF, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0xC3, 0xC3, 0xC3,	// A
+			0xFC, 0xFC, 0xC3, 0xC3, 0xFC, 0xFC, 0xC3, 0xC3, 0xFC, 0xFC,	// B
+			0x3C, 0xFF, 0xC3, 0xC0, 0xC0, 0xC0, 0xC0, 0xC3, 0xFF, 0x3C,	// C
+			0xFC, 0xFE, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xFE, 0xFC,	// D
+			0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF,	// E
+			0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC0, 0xC0, 0xC0, 0xC0 	// F
+		}};
+
+		/** @brief Page Size
+		 * 
+		 * This constant represents the size of a copy-on-write memory page.
+		 */
+		static constexpr size_t PAGE_SIZE				= 256;
+
+		/** @brief Memory Page
+		 * 
+		 * A page of memory, pages are shared between cloned memories until written to.
+		 * Once a page is handed to another memory it is marked shared and never written
+		 * again, writers copy it first. The flag only goes from false to true, so unlike
+		 * a reference count it cannot change under a writer running on another thread.
+		 */
+		typedef struct
+		{
+			std::array<uint8_t, PAGE_SIZE> bytes;
+			std::atomic<bool> shared;
+		} Page_t;
+
+		/** @brief Memory Size
+		 * 
+		 * Size of this memory in bytes, a power of two of at least a page.
+		 */
+		size_t memorySize;
+
 		/** @brief Memory
 		 * 
-		 * This array stores the memory of the CHIP-8 system.
+		 * This vector stores the pages making up the memory of the CHIP-8 system.
+		 */
+		std::vector<std::shared_ptr<Page_t>> pages;
+
+		/** @brief Page Table
+		 * 
+		 * Raw pointers to the pages, kept in sync with the pages vector. Accesses
+		 * index this table inside the memory object, so they only load the page
+		 * pointer instead of going through the vector and the shared_ptr.
+		 */
+		std::array<Page_t *, MAX_MEMORY_SIZE / PAGE_SIZE> pageTable = {};
+
+		/** @brief Access Hook
+		 * 
+		 * Observer of byte reads and writes, nullptr if none is attached.
 		 */
-		std::array<uint8_t, MEMORY_SIZE> memory;
+		MemoryAccessHook *accessHook = nullptr;
+
+		/**
+		 * @brief Get a page for writing
+		 * 
+		 * This function copies the page first if it was shared with another memory.
+		 * 
+		 * @param page : Index of the page
+		 * @return std::array<uint8_t, PAGE_SIZE>& : The bytes of the page, owned exclusively by this memory
+		 */
+		std::array<uint8_t, PAGE_SIZE> &GetWritablePage(size_t page) {
+			if (pageTable[page]->shared.load(std::memory_order_acquire)) [[unlikely]]
+			{
+				auto copy = std::make_shared<Page_t>();
+				copy->bytes = pageTable[page]->bytes;
+				pages[page] = copy;
+				pageTable[page] = copy.get();
+			}
+			return pageTable[page]->bytes;
+		};
+
+		/**
+		 * @brief Point the page table at the pages
+		 * 
+		 * Called whenever the pages vector is replaced as a whole.
+		 */
+		void UpdatePageTable() {
+			pageTable.fill(nullptr);
+			for (size_t page = 0; page < pages.size(); page++)
+			{
+				pageTable[page] = pages[page].get();
+			}
+		};
+
+		/**
+		 * @brief Mark all pages as shared
+		 * 
+		 * Called whenever another memory takes over the pages, neither side writes them afterwards.
+		 */
+		void MarkShared() const {
+			for (const auto &page : pages)
+			{
+				page->shared.store(true, std::memory_order_release);
+			}
+		};
 		
 		/**
 		 * @brief Load the default font into memory
 		 * 
-		 * This function loads the default font into memory.
+		 * This function loads the default font and big font into memory.
 		 */
 		void LoadFont() {
-			std::copy(DEFAULT_FONT.begin(), DEFAULT_FONT.end(), 
-				std::next(memory.begin(), DEFAULT_FONT_START));
+			SetBytes(DEFAULT_FONT_START, DEFAULT_FONT);
+			SetBytes(DEFAULT_BIG_FONT_START, DEFAULT_BIG_FONT);
 		};
 	public:
 		/**
 		 * @brief Construct a new Memory object
 		 * 
 		 * This constructor initializes the memory with the default font.
+		 * 
+		 * @param size : Size of the memory in bytes, the platform defines it
 		 */
-		Memory() : memory({{0}}) {
-			LoadFont();
+		explicit Memory(size_t size = DEFAULT_MEMORY_SIZE) : memorySize(size) {
+			if (size < PAGE_SIZE || size > MAX_MEMORY_SIZE || (size & (size - 1)) != 0)
+				throw std::invalid_argument(std::format("Memory: Unsupported size {}, has to be a power of two "
+					"between {} and {}", size, PAGE_SIZE, MAX_MEMORY_SIZE));
+			pages.resize(memorySize / PAGE_SIZE);
+			Reset();
 		};
 
 		/**
@@ -91,10 +275,42 @@ namespace CHIP8
 		 * This function resets the memory to its initial state.
 		 */
 		void Reset() {
-			memory.fill({0});
+			for (auto &page : pages)
+			{
+				page = std::make_shared<Page_t>();
+				page->bytes.fill({0});
+			}
+			UpdatePageTable();
 			LoadFont();
 		};
 
+		/**
+		 * @brief Clone the memory
+		 * 
+		 * This function returns a copy of the memory which shares all pages with
+		 * this memory. A page is only copied once either side writes to it, so the
+		 * clone can run on another thread. Cloning must not overlap writes to this memory.
+		 * 
+		 * @return std::shared_ptr<Memory> : The cloned memory
+		 */
+		std::shared_ptr<Memory> Clone() const {
+			MarkShared();
+			auto clone = std::make_shared<Memory>(*this);
+			clone->accessHook = nullptr;
+			return clone;
+		};
+
+		/**
+		 * @brief Set the access hook
+		 * 
+		 * This function attaches an observer to byte reads and writes.
+		 * 
+		 * @param hook : The observer, nullptr to detach it
+		 */
+		void SetAccessHook(MemoryAccessHook *hook) {
+			accessHook = hook;
+		};
+
 		/**
 		 * @brief Set a byte in memory
 		 * 
@@ -103,13 +319,18 @@ namespace CHIP8
 		 * @param address : Address to set the byte
 		 * @param value : Value to set
 		 */
-		std::expected<uint8_t, std::string> GetByte(uint16_t address) {
-			if (address > MEMORY_SIZE - 1)
+		std::expected<uint8_t, MemoryFault_t> GetByte(uint16_t address) {
+			if (address > memorySize - 1)
 			{
-				return std::unexpected(std::format("Memory out of bounds: {} > {}", address, MEMORY_SIZE - 1));
+				return std::unexpected(MemoryFault_t{address, uint32_t(memorySize - 1)});
 			}
 
-			return memory.at(address & (MEMORY_SIZE - 1));
+			const uint8_t value = pageTable[address / PAGE_SIZE]->bytes[address % PAGE_SIZE];
+			if (accessHook != nullptr) [[unlikely]]
+			{
+				accessHook->OnRead(address, value);
+			}
+			return value;
 		};
 
 		/**
@@ -120,15 +341,19 @@ namespace CHIP8
 		 * @param address : Address to set the byte
 		 * @param value : Value to set
 		 */
-		std::expected<void, std::string> SetByte(uint16_t address, uint8_t value) {
-			if (address > MEMORY_SIZE - 1)
+		std::expected<void, MemoryFault_t> SetByte(uint16_t address, uint8_t value) {
+			if (address > memorySize - 1)
 			{
-				return std::unexpected(std::format("Memory out of bounds: {} > {}", address, MEMORY_SIZE - 1));
+				return std::unexpected(MemoryFault_t{address, uint32_t(memorySize - 1)});
 			}
 
-			memory.at(address & (MEMORY_SIZE - 1)) = value;
+			GetWritablePage(address / PAGE_SIZE)[address % PAGE_SIZE] = value;
+			if (accessHook != nullptr) [[unlikely]]
+			{
+				accessHook->OnWrite(address, value);
+			}
 
-			return std::expected<void, std::string>();
+			return std::expected<void, MemoryFault_t>();
 		};
 
 		/**
@@ -139,13 +364,136 @@ namespace CHIP8
 		 * @param address : Address to set the word
 		 * @param value : Value to set
 		 */
-		std::expected<uint16_t, std::string> GetWord(uint16_t address) {
-			if (address > MEMORY_SIZE - 2)
+		std::expected<uint16_t, MemoryFault_t> GetWord(uint16_t address) {
+			if (address > memorySize - 2)
 			{
-				return std::unexpected(std::format("Memory out of bounds: {} > {}", address, MEMORY_SIZE - 1));
+				return std::unexpected(MemoryFault_t{address, uint32_t(memorySize - 1)});
 			}
 			
-			return (memory.at(address & (MEMORY_SIZE - 1)) << 8) | memory.at((address + 1) & (MEMORY_SIZE - 1));
+			const uint16_t high = address;
+			const uint16_t low = uint16_t(address + 1);
+			return (pageTable[high / PAGE_SIZE]->bytes[high % PAGE_SIZE] << 8) | pageTable[low / PAGE_SIZE]->bytes[low % PAGE_SIZE];
+		};
+
+		/**
+		 * @brief Copy a block of memory
+		 * 
+		 * This function copies memory starting at the specified address into the buffer.
+		 * 
+		 * @param address : Address to start copying from
+		 * @param buffer : Buffer to copy into, its size defines the number of bytes copied
+		 */
+		std::expected<void, MemoryFault_t> GetBytes(uint16_t address, std::span<uint8_t> buffer) {
+			if (address + buffer.size() > memorySize)
+			{
+				return std::unexpected(MemoryFault_t{uint32_t(address + buffer.size() - 1), uint32_t(memorySize - 1)});
+			}
+
+			for (size_t done = 0; done < buffer.size(); )
+			{
+				const size_t offset = (address + done) % PAGE_SIZE;
+				const size_t length = std::min(PAGE_SIZE - offset, buffer.size() - done);
+				std::copy_n(pageTable[(address + done) / PAGE_SIZE]->bytes.begin() + offset, length, buffer.begin() + done);
+				done += length;
+			}
+			return std::expected<void, MemoryFault_t>();
+		};
+
+		/**
+		 * @brief Write a block of memory
+		 * 
+		 * This function copies the buffer into memory starting at the specified address.
+		 * 
+		 * @param address : Address to start writing to
+		 * @param buffer : Data to write into memory
+		 */
+		std::expected<void, MemoryFault_t> SetBytes(uint16_t address, std::span<const uint8_t> buffer) {
+			if (address + buffer.size() > memorySize)
+			{
+				const size_t last = address + std::max<size_t>(buffer.size(), 1) - 1;
+				return std::unexpected(MemoryFault_t{uint32_t(std::min<size_t>(last, UINT32_MAX)), uint32_t(memorySize - 1)});
+			}
+
+			for (size_t done = 0; done < buffer.size(); )
+			{
+				const size_t offset = (address + done) % PAGE_SIZE;
+				const size_t length = std::min(PAGE_SIZE - offset, buffer.size() - done);
+				std::copy_n(buffer.begin() + done, length, GetWritablePage((address + done) / PAGE_SIZE).begin() + offset);
+				done += length;
+			}
+			return std::expected<void, MemoryFault_t>();
+		};
+
+		/**
+		 * @brief Get the address at an offset from another address
+		 * 
+		 * Addresses do not wrap around: an offset past the end of the memory is a
+		 * fault, also if the memory fills the whole 16 bit address space.
+		 * 
+		 * @param address : Base address, like the index register
+		 * @param offset : Offset from the base address
+		 * @return std::expected<uint16_t, MemoryFault_t> : The address, or the fault if it is out of bounds
+		 */
+		std::expected<uint16_t, MemoryFault_t> GetAddress(uint16_t address, size_t offset) const {
+			if (address + offset > memorySize - 1)
+			{
+				return std::unexpected(MemoryFault_t{uint32_t(address + offset), uint32_t(memorySize - 1)});
+			}
+			return uint16_t(address + offset);
+		};
+
+		/**
+		 * @brief Get the size of the memory
+		 * 
+		 * @return size_t : Size of the memory in bytes
+		 */
+		size_t GetSize(void) const {
+			return memorySize;
+		};
+
+		/**
+		 * @brief Get the size of a memory page
+		 * 
+		 * @return size_t : Size of a page in bytes
+		 */
+		static constexpr size_t GetPageSize(void) {
+			return PAGE_SIZE;
+		};
+
+		/**
+		 * @brief Get a page for reading
+		 * 
+		 * Gives direct access to the bytes of a page without copying them. The
+		 * access hook does not see these reads. A write to the memory can replace
+		 * a page shared with a cloned memory, so the span is only valid until then.
+		 * 
+		 * @param page : Index of the page, below GetSize() / GetPageSize()
+		 * @return std::span<const uint8_t, PAGE_SIZE> : The bytes of the page
+		 */
+		std::span<const uint8_t, PAGE_SIZE> GetPage(size_t page) const {
+			return pageTable[page]->bytes;
+		};
+
+		/**
+		 * @brief Get the address ROMs are loaded to
+		 * 
+		 * @return uint16_t : Start address of the ROM
+		 */
+		constexpr uint16_t GetRomStart(void) const {
+			return DEFAULT_ROM_START;
+		};
+
+		/**
+		 * @brief Load a ROM into memory
+		 * 
+		 * This function copies a ROM image into memory, by default to the ROM start address.
+		 * 
+		 * @param rom : Content of the ROM file
+		 * @param loadAddress : Address to load the ROM to
+		 * @return std::expected<void, MemoryFault_t> : The fault of the last ROM byte if it does not fit
+		 */
+		std::expected<void, MemoryFault_t> LoadRom(std::span<const uint8_t> rom, uint16_t loadAddress = DEFAULT_ROM_START) {
+			return SetBytes(loadAddress, rom);
 		};
 
 		/**
@@ -160,15 +508,22 @@ namespace CHIP8
 			if (file.is_open())
 			{
 				std::ifstream::pos_type pos = file.tellg();
-				if (size_t(pos) <= MEMORY_SIZE - DEFAULT_ROM_START)
+				if (size_t(pos) <= memorySize - DEFAULT_ROM_START)
 				{
+					std::vector<uint8_t> rom(static_cast<size_t>(pos));
 					file.seekg(0, std::ios::beg);
-					file.read(reinterpret_cast<char*>(&memory[DEFAULT_ROM_START]), pos);
+					file.read(reinterpret_cast<char*>(rom.data()), pos);
+					auto loaded = LoadRom(std::span<const uint8_t>(rom.data(), size_t(pos)));
+					if (!loaded)
+					{
+						return std::unexpected(DescribeMemoryFault(loaded.error()));
+					}
+					return std::expected<void, std::string>();
 				}
 				else
 				{
 					file.close();
-					return std::unexpected(std::format("ROM too large for memory: {} > {}", size_t(pos), MEMORY_SIZE - DEFAULT_ROM_START));
+					return std::unexpected(std::format("ROM too large for memory: {} > {}", size_t(pos), memorySize - DEFAULT_ROM_START));
 				}
 			}
 			else
@@ -179,6 +534,24 @@ namespace CHIP8
 			return std::expected<void, std::string>();
 		};
 
+		/**
+		 * @brief Load the content of another memory
+		 * 
+		 * This function replaces the whole memory with the content of a prepared image,
+		 * like a ROM with the font. The pages are shared copy-on-write, so loading only
+		 * copies the page references and a page is only copied once it is written to.
+		 * The access hook is kept, the size is taken over from the image. Several memories
+		 * can load the same image at once.
+		 * 
+		 * @param image : Memory to load the content of
+		 */
+		void LoadImage(const Memory &image) {
+			image.MarkShared();
+			memorySize = image.memorySize;
+			pages = image.pages;
+			UpdatePageTable();
+		};
+
 		/**
 		 * @brief Get the starting address of the font
 		 * 
@@ -189,6 +562,17 @@ namespace CHIP8
 		uint16_t GetFontStart(void) {
 			return DEFAULT_FONT_START;
 		};
+
+		/**
+		 * @brief Get the starting address of the big font
+		 * 
+		 * This function returns the starting address of the SCHIP-8 big font.
+		 * 
+		 * @return uint16_t : Starting address of the big font 
+		 */
+		uint16_t GetBigFontStart(void) {
+			return DEFAULT_BIG_FONT_START;
+		};
 	};
 }
 
@@ -1,6 +1,8 @@
 #ifndef _CHIP8_QUIRKS_HPP_
 #define _CHIP8_QUIRKS_HPP_
 
+#include <cstdint>
+
 namespace CHIP8
 {
 	/**
@@ -112,6 +114,38 @@ namespace CHIP8
 		 *           (unless `vF` is the parameter `X`)
 		 */
 		bool VFreset = true;
+
+		/**
+		 * @brief Pack the quirks into a bit field
+		 * 
+		 * Used by save states and movie files to store the quirks compactly.
+		 * 
+		 * @return uint16_t : One bit per quirk, in declaration order
+		 */
+		uint16_t ToBits() const
+		{
+			return uint16_t(CatchEndlessJump << 0 | Shift << 1 | MemoryIncrementByX << 2 |
+				MemoryLeaveIunchanged << 3 | WrapSprite << 4 | Jump << 5 | vBlank << 6 | VFreset << 7);
+		}
+
+		/**
+		 * @brief Unpack the quirks from a bit field
+		 * 
+		 * Counterpart to ToBits().
+		 * 
+		 * @param bits : One bit per quirk, in declaration order
+		 */
+		void FromBits(uint16_t bits)
+		{
+			CatchEndlessJump		= bits & (1 << 0);
+			Shift					= bits & (1 << 1);
+			MemoryIncrementByX		= bits & (1 << 2);
+			MemoryLeaveIunchanged	= bits & (1 << 3);
+			WrapSprite				= bits & (1 << 4);
+			Jump					= bits & (1 << 5);
+			vBlank					= bits & (1 << 6);
+			VFreset					= bits & (1 << 7);
+		}
 	};
 }
 
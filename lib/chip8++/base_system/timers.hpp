@@ -2,6 +2,10 @@
 #define _CHIP8_TIMERS_HPP_
 
 #include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <array>
+#include <span>
 
 namespace CHIP8
 {
@@ -16,20 +20,39 @@ namespace CHIP8
 	 * Both timers count down at 60Hz. 
 	 * When the sound timer is non-zero, a sound is played. 
 	 * The timers can be set and read.
+	 * 
+	 * The sound played is the XO-CHIP audio pattern, 128 one bit samples
+	 * played back at a rate set by the pitch. Programs that never change them
+	 * get a square wave of 500Hz.
 	 */
     class Timers
 	{
+	public:
+		/** @brief Size of the audio pattern in bytes */
+		static constexpr size_t AUDIO_PATTERN_SIZE = 16;
+
+		/** @brief Pitch after a reset, plays the audio pattern at 4000 bits per second */
+		static constexpr uint8_t DEFAULT_PITCH = 64;
+
+		/** @brief Audio pattern after a reset, a square wave of 500Hz at the default pitch */
+		static constexpr std::array<uint8_t, AUDIO_PATTERN_SIZE> DEFAULT_AUDIO_PATTERN = {
+			0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0,
+			0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0
+		};
 	protected:
         uint8_t delayTimer;
         uint8_t soundTimer;
 		bool beeperState;
+		std::array<uint8_t, AUDIO_PATTERN_SIZE> audioPattern;
+		uint8_t pitch;
     public:
 		/**
 		 * @brief Construct a new Timers object
 		 * 
 		 * This constructor initializes the delay and sound timers to zero.
 		 */
-		Timers() : delayTimer(0), soundTimer(0), beeperState(false) {};
+		Timers() : delayTimer(0), soundTimer(0), beeperState(false), audioPattern(DEFAULT_AUDIO_PATTERN),
+			pitch(DEFAULT_PITCH) {};
 
 		// Virtual destructor
 		virtual ~Timers() {};
@@ -37,12 +60,15 @@ namespace CHIP8
 		/**
 		 * @brief Reset the timers
 		 * 
-		 * This function resets the delay and sound timers to zero.
+		 * This function resets the delay and sound timers to zero
+		 * and restores the default audio pattern and pitch.
 		 */
 		void Reset()
 		{
 			delayTimer = 0;
 			soundTimer = 0;
+			audioPattern = DEFAULT_AUDIO_PATTERN;
+			pitch = DEFAULT_PITCH;
 		}
 
 		/**
@@ -76,6 +102,19 @@ namespace CHIP8
 		 * 
 		 * @return uint8_t : The value of the sound timer
 		 */
+		uint8_t GetSoundTimer()
+		{
+			return soundTimer;
+		}
+
+		/**
+		 * @brief Set the sound timer
+		 * 
+		 * This function sets the sound timer to the value provided
+		 * and updates the beeper accordingly.
+		 * 
+		 * @param value : The value to set the sound timer to
+		 */
 		void SetSoundTimer(uint8_t value)
 		{
 			soundTimer = value;
@@ -86,13 +125,12 @@ namespace CHIP8
 		}
 
 		/**
-		 * @brief Get the sound timer
+		 * @brief Decrement the timers
 		 * 
-		 * This function returns the value of the sound timer.
-		 * 
-		 * @return uint8_t : The value of the sound timer
+		 * This function counts both timers down by one, it is called at 60Hz.
+		 * The beeper is turned off when the sound timer reaches zero.
 		 */
-		void DecrementTimers()
+		virtual void DecrementTimers()
 		{
 			if (delayTimer > 0) {
 				delayTimer--;
@@ -128,6 +166,56 @@ namespace CHIP8
 		{
 			return beeperState;
 		}
+
+		/**
+		 * @brief Set the audio pattern
+		 * 
+		 * @param pattern : 128 one bit samples, the most significant bit of the first byte plays first
+		 */
+		void SetAudioPattern(std::span<const uint8_t, AUDIO_PATTERN_SIZE> pattern)
+		{
+			std::copy(pattern.begin(), pattern.end(), audioPattern.begin());
+		}
+
+		/**
+		 * @brief Get the audio pattern
+		 * 
+		 * @return const std::array<uint8_t, AUDIO_PATTERN_SIZE>& : The audio pattern
+		 */
+		const std::array<uint8_t, AUDIO_PATTERN_SIZE> &GetAudioPattern() const
+		{
+			return audioPattern;
+		}
+
+		/**
+		 * @brief Set the pitch of the audio pattern
+		 * 
+		 * @param value : The pitch, 64 plays the pattern at 4000 bits per second
+		 */
+		void SetPitch(uint8_t value)
+		{
+			pitch = value;
+		}
+
+		/**
+		 * @brief Get the pitch of the audio pattern
+		 * 
+		 * @return uint8_t : The pitch
+		 */
+		uint8_t GetPitch() const
+		{
+			return pitch;
+		}
+
+		/**
+		 * @brief Get the playback rate of the audio pattern
+		 * 
+		 * @return double : Bits of the audio pattern played per second, 4000 * 2^((pitch - 64) / 48)
+		 */
+		double GetPlaybackRate() const
+		{
+			return 4000.0 * std::exp2((double(pitch) - 64.0) / 48.0);
+		}
     };
 }
 
@@ -26,8 +26,8 @@ namespace CHIP8::SCHIP8::Instructions
 		 * @return bool (true) : Notify the CPU that the instruction was executed
 		 */
 		bool Execute(CPU *cpu) override {
-			auto display = std::dynamic_pointer_cast<SCHIP8Display>(cpu->GetDisplay());
-			display->ScrollDown(LinesToScroll);
+			auto &display = cpu->GetExtensionDisplay<SCHIP8Display>();
+			display.ScrollDown(LinesToScroll, display.GetSelectedPlanes());
 			return true;
 		}
 
@@ -66,10 +66,11 @@ namespace CHIP8::SCHIP8::Instructions
 		 * @param opcode The opcode
 		 * @return std::shared_ptr<CHIP8::Instructions::Instruction> : Returns the instruction
 		 */
-		std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) {
+		std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) override {
 			LinesToScroll = opcode & 0x000F;
+			return shared_from_this();
 		}
 	};
 }
 
-#endif /* SCHIP8_INSTRUCTIONS_00CN_HPP */
\ No newline at end of file
+#endif /* SCHIP8_INSTRUCTIONS_00CN_HPP */
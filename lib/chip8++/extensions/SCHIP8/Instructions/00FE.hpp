@@ -7,33 +7,34 @@
 
 namespace CHIP8::SCHIP8::Instructions
 {
-    class I00FE :
-        public CHIP8::Instructions::Instruction,
-        public std::enable_shared_from_this<I00FE>
-    {
-    public:
-        bool Execute(CHIP8::CPU *cpu) override {
-            auto display = std::dynamic_pointer_cast<SCHIP8Display>(cpu->GetDisplay());
-            display->SetHighRes(false);
-            return true;
-        }
+	class I00FE :
+		public CHIP8::Instructions::Instruction,
+		public std::enable_shared_from_this<I00FE>
+	{
+	public:
+		bool Execute(CHIP8::CPU *cpu) override {
+			auto &display = cpu->GetExtensionDisplay<SCHIP8Display>();
+			display.SetHighRes(false);
+			return true;
+		}
 
-        std::string GetMnemonic() override {
-            return "LRS";
-        }
+		std::string GetMnemonic() override {
+			return "LRS";
+		}
 
-        std::string GetDescription() override {
-            return "Disable extended screen mode";
-        }
+		std::string GetDescription() override {
+			return "Disable extended screen mode";
+		}
 
-        InstructionInfo_t GetInfo() override {
-            return {0x00FE, 0xFFFF};
-        }
+		InstructionInfo_t GetInfo() override {
+			return {0x00FE, 0xFFFF};
+		}
 
-        std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) {
-            (void)opcode;
-        }
-    };
+		std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) override {
+			(void)opcode;
+			return shared_from_this();
+		}
+	};
 }
 
-#endif /* SCHIP8_INSTRUCTIONS_00FE_HPP */
\ No newline at end of file
+#endif /* SCHIP8_INSTRUCTIONS_00FE_HPP */
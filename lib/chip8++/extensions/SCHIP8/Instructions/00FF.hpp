@@ -13,8 +13,8 @@ namespace CHIP8::SCHIP8::Instructions
 	{
 	public:
 		bool Execute(CHIP8::CPU *cpu) override {
-			auto display = std::dynamic_pointer_cast<SCHIP8Display>(cpu->GetDisplay());
-			display->SetHighRes(true);
+			auto &display = cpu->GetExtensionDisplay<SCHIP8Display>();
+			display.SetHighRes(true);
 			return true;
 		}
 
@@ -30,11 +30,11 @@ namespace CHIP8::SCHIP8::Instructions
 			return {0x00FF, 0xFFFF};
 		}
 
-		std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) {
+		std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) override {
 			(void)opcode;
+			return shared_from_this();
 		}
 	};
 }
 
-
-#endif /* SCHIP8_INSTRUCTIONS_00FF_HPP */
\ No newline at end of file
+#endif /* SCHIP8_INSTRUCTIONS_00FF_HPP */
@@ -1,4 +1,4 @@
-// Show N-byte sprite from M(I) at coords (VX,VY), VF := collision. If N=0 and extended mode, show 16x16 sprite.
+// Show N-byte sprite from M(I) at coords (VX,VY), VF := collision. If N=0, show 16x16 sprite.
 #ifndef SCHIP8_INSTRUCTIONS_DXYN_HPP
 #define SCHIP8_INSTRUCTIONS_DXYN_HPP
 
@@ -20,28 +20,45 @@ namespace CHIP8::SCHIP8::Instructions
 		uint8_t RegX;
 		uint8_t RegY;
 		uint8_t SpritesN;
-		std::expected<uint8_t, std::string> retValMemory;
+		std::expected<uint8_t, MemoryFault_t> retValMemory;
 	public:
 		/**
 		 * @brief Execute the instruction to draw a sprite at position (VX, VY) with N bytes of sprite data starting at the address stored in I
 		 * 
 		 * This function draws a sprite at position (VX, VY) with N bytes of sprite data starting at the address stored in I.
-		 * A sprite has a fixed width of 8 pixels and a variable height of N pixels between 1 and 15.
+		 * A sprite has a fixed width of 8 pixels and a variable height of N pixels between 1 and 15, with N = 0 it
+		 * is a 16x16 sprite of 32 bytes instead. The coordinates are in the pixels of the current display mode.
 		 * 
 		 * @param CPU 	Pointer to the CPU object
 		 * @return bool (true) : Notify the CPU that the instruction was executed
 		 */
 		bool Execute(CPU *cpu) override {
-			auto Display = std::dynamic_pointer_cast<SCHIP8Display>(cpu->GetDisplay());
-			uint8_t DisplayX = cpu->GetRegister(RegX) % Display->GetWidth();
-			uint8_t DisplayY = cpu->GetRegister(RegY) % Display->GetHeight();
+			auto &Display = cpu->GetExtensionDisplay<SCHIP8Display>();
+			const int Width = Display.GetLogicalWidth();
+			const int Height = Display.GetLogicalHeight();
+			const int DisplayX = cpu->GetRegister(RegX) % Width;
+			const int DisplayY = cpu->GetRegister(RegY) % Height;
+			const bool BigSprite = (SpritesN == 0);
+			const int Rows = BigSprite ? 16 : SpritesN;
+			const int BytesPerRow = BigSprite ? 2 : 1;
 			bool collision = false;
-            bool highResMode = Display->GetHighRes();
 			bool WrapQuirk = cpu->GetQuirks().WrapSprite;
 
-			for (int iy = 0; iy < SpritesN; iy++)
+			// Reset the error message variable
+			retValMemory = std::expected<uint8_t, MemoryFault_t>(0);
+
+			for (int iy = 0; iy < Rows; iy++)
 			{
-				retValMemory = cpu->GetMemory()->GetByte(cpu->GetIndex() + iy);
+				uint16_t spriteRow = 0;
+				for (int i = 0; i < BytesPerRow; i++)
+				{
+					retValMemory = cpu->GetMemory()->GetByte(uint16_t(cpu->GetIndex() + iy * BytesPerRow + i));
+					if (!retValMemory)
+					{
+						break;
+					}
+					spriteRow = uint16_t((spriteRow << 8) | retValMemory.value());
+				}
 
 				// On error, break the loop
 				if (!retValMemory)
@@ -49,38 +66,29 @@ namespace CHIP8::SCHIP8::Instructions
 					break;
 				}
 
-				for(int ix = 0; ix < 8; ix++)
+				int SpriteY = (DisplayY + iy);
+				if (WrapQuirk)
 				{
-					int SpriteX = (DisplayX + ix);
-					int SpriteY = (DisplayY + iy);
-
-					if (WrapQuirk)
-					{
-						SpriteX = SpriteX % Display->GetWidth();
-						SpriteY = SpriteY % Display->GetHeight();
-					}
-					else
-					{
-						if (SpriteX >= Display->GetWidth() || SpriteY >= Display->GetHeight())
-						{
-							continue;
-						}
-					}
+					SpriteY = SpriteY % Height;
+				}
+				else if (SpriteY >= Height)
+				{
+					continue;
+				}
 
-					if ((retValMemory.value() & (0x80 >> ix)) != 0)
-					{
-						if (Display->at(SpriteX, SpriteY))
-						{
-							collision = true;
-						}
-						Display->at(SpriteX, SpriteY) = Display->at(SpriteX, SpriteY) ^ true;
-					}
+				if (Display.XorSpriteRow(DisplayX, SpriteY, spriteRow, BytesPerRow * 8, WrapQuirk))
+				{
+					collision = true;
 				}
 			}
 
-			Display->SetUpdateRequired();
+			Display.SetUpdateRequired();
 			cpu->SetRegister(0xF, collision ? 1 : 0);
 
+			if (!retValMemory)
+			{
+				cpu->RaiseTrap(TrapCode::MemoryFault);
+			}
 			return retValMemory ? true : false;
 		};
 
@@ -99,9 +107,14 @@ namespace CHIP8::SCHIP8::Instructions
 		 * @return std::string (Draw a sprite at position (VX, VY) with N bytes of sprite data starting at the address stored in I) : Returns the description for the draw sprite instruction
 		 */
 		std::string GetDescription() override {
+			if (SpritesN == 0)
+			{
+				return std::format("Draw a 16x16 sprite at position (V{:X}, V{:X}) with 32 "
+					"bytes of sprite data starting at the address stored in I", RegX, RegY);
+			}
 			return std::format("Draw a sprite at position (V{:X}, V{:X}) with {} "
 				"bytes of sprite data starting at the address stored in I", RegX, RegY, SpritesN);
-			}
+		}
 
 		/**
 		 * @brief Returns the opcode and mask for the draw sprite instruction
@@ -120,7 +133,7 @@ namespace CHIP8::SCHIP8::Instructions
 		 * @return std::string : Returns the error report for the instruction
 		 */
 		std::string GetAbortReason() override {
-			return retValMemory.error();
+			return DescribeMemoryFault(retValMemory.error());
 		}
 
 		/**
@@ -1 +1,75 @@
-// Point I to 10-byte font sprite for digit VX (0..9)
\ No newline at end of file
+// Point I to 10-byte font sprite for digit VX (0..9)
+#ifndef SCHIP8_INSTRUCTIONS_FX30_HPP
+#define SCHIP8_INSTRUCTIONS_FX30_HPP
+
+#include "base_system/Instructions/Instruction.hpp"
+
+namespace CHIP8::SCHIP8::Instructions
+{
+	/**
+	 * @brief Set I to the location of the big font sprite for the character in VX
+	 * 
+	 * This class represents the instruction to set I to the location of the big font sprite for the character in VX.
+	 */
+	class IFX30 :
+		public CHIP8::Instructions::Instruction,
+		public std::enable_shared_from_this<IFX30>
+	{
+		uint8_t registerVX;
+	public:
+		/**
+		 * @brief Execute the instruction to set I to the location of the big font sprite for the character in VX
+		 * 
+		 * This function sets I to the location of the 8x10 big font sprite for the character in VX.
+		 * 
+		 * @param CPU 	Pointer to the CPU object
+		 * @return bool (true) : Notify the CPU that the instruction was executed
+		 */
+		bool Execute(CHIP8::CPU *cpu) override {
+			cpu->SetIndex(uint16_t((cpu->GetRegister(registerVX) & 0x0F) * 10 + cpu->GetMemory()->GetBigFontStart()));
+			return true;
+		}
+
+		/**
+		 * @brief Returns the mnemonic for the set I to the location of the big font sprite instruction
+		 * 
+		 * @return std::string (LD HF, Vx) : Returns the mnemonic for the set I to the location of the big font sprite instruction
+		 */
+		std::string GetMnemonic() override {
+			return std::format("LD HF, V{:X}", registerVX);
+		}
+
+		/**
+		 * @brief Returns the description for the set I to the location of the big font sprite instruction
+		 * 
+		 * @return std::string (Set I = location of big sprite for digit Vx) : Returns the description for the set I to the location of the big font sprite instruction
+		 */
+		std::string GetDescription() override {
+			return std::format("Set I = location of big sprite for digit V{:X}", registerVX);
+		}
+
+		/**
+		 * @brief Returns the opcode and mask for the set I to the location of the big font sprite instruction
+		 * 
+		 * @return InstructionInfo_t (0xF030, 0xF0FF) : Returns the opcode and mask for the set I to the location of the big font sprite instruction
+		 */
+		InstructionInfo_t GetInfo() override {
+			return {0xF030, 0xF0FF};
+		}
+
+		/**
+		 * @brief Update the instruction with the opcode
+		 * 
+		 * This function updates the instruction with the opcode.
+		 * 
+		 * @param opcode : The opcode to update the instruction with
+		 * @return std::shared_ptr<CHIP8::Instructions::Instruction> : Returns the updated instruction
+		 */
+		std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) override {
+			registerVX = (opcode & 0x0F00) >> 8;
+			return shared_from_this();
+		}
+	};
+}
+
+#endif /* SCHIP8_INSTRUCTIONS_FX30_HPP */
@@ -1 +1,78 @@
-// Store V0..VX in RPL user flags (X <= 7)
\ No newline at end of file
+// Store V0..VX in RPL user flags
+#ifndef SCHIP8_INSTRUCTIONS_FX75_HPP
+#define SCHIP8_INSTRUCTIONS_FX75_HPP
+
+#include "base_system/Instructions/Instruction.hpp"
+
+namespace CHIP8::SCHIP8::Instructions
+{
+	/**
+	 * @brief Store registers V0 to VX in the RPL user flags
+	 * 
+	 * This class represents the instruction to store registers V0 to VX in the RPL user flags.
+	 */
+	class IFX75 :
+		public CHIP8::Instructions::Instruction,
+		public std::enable_shared_from_this<IFX75>
+	{
+		uint8_t registerVX;
+	public:
+		/**
+		 * @brief Execute the instruction to store registers V0 to VX in the RPL user flags
+		 * 
+		 * This function copies the registers V0 to VX into the RPL user flags, which survive a reset of the CPU.
+		 * 
+		 * @param CPU 	Pointer to the CPU object
+		 * @return bool (true) : Notify the CPU that the instruction was executed
+		 */
+		bool Execute(CHIP8::CPU *cpu) override {
+			for (uint8_t i = 0; i <= registerVX; i++)
+			{
+				cpu->SetRPLFlag(i, cpu->GetRegister(i));
+			}
+			return true;
+		}
+
+		/**
+		 * @brief Returns the mnemonic for the store registers in the RPL user flags instruction
+		 * 
+		 * @return std::string (LD R, Vx) : Returns the mnemonic for the store registers in the RPL user flags instruction
+		 */
+		std::string GetMnemonic() override {
+			return std::format("LD R, V{:X}", registerVX);
+		}
+
+		/**
+		 * @brief Returns the description for the store registers in the RPL user flags instruction
+		 * 
+		 * @return std::string (Store V0 to Vx in the RPL user flags) : Returns the description for the store registers in the RPL user flags instruction
+		 */
+		std::string GetDescription() override {
+			return std::format("Store V0 to V{:X} in the RPL user flags", registerVX);
+		}
+
+		/**
+		 * @brief Returns the opcode and mask for the store registers in the RPL user flags instruction
+		 * 
+		 * @return InstructionInfo_t (0xF075, 0xF0FF) : Returns the opcode and mask for the store registers in the RPL user flags instruction
+		 */
+		InstructionInfo_t GetInfo() override {
+			return {0xF075, 0xF0FF};
+		}
+
+		/**
+		 * @brief Update the instruction with the opcode
+		 * 
+		 * This function updates the instruction with the opcode.
+		 * 
+		 * @param opcode : The opcode to update the instruction with
+		 * @return std::shared_ptr<CHIP8::Instructions::Instruction> : Returns the updated instruction
+		 */
+		std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) override {
+			registerVX = (opcode & 0x0F00) >> 8;
+			return shared_from_this();
+		}
+	};
+}
+
+#endif /* SCHIP8_INSTRUCTIONS_FX75_HPP */
@@ -1 +1,78 @@
-// Read V0..VX from RPL user flags (X <= 7) 
\ No newline at end of file
+// Read V0..VX from RPL user flags
+#ifndef SCHIP8_INSTRUCTIONS_FX85_HPP
+#define SCHIP8_INSTRUCTIONS_FX85_HPP
+
+#include "base_system/Instructions/Instruction.hpp"
+
+namespace CHIP8::SCHIP8::Instructions
+{
+	/**
+	 * @brief Read registers V0 to VX from the RPL user flags
+	 * 
+	 * This class represents the instruction to read registers V0 to VX from the RPL user flags.
+	 */
+	class IFX85 :
+		public CHIP8::Instructions::Instruction,
+		public std::enable_shared_from_this<IFX85>
+	{
+		uint8_t registerVX;
+	public:
+		/**
+		 * @brief Execute the instruction to read registers V0 to VX from the RPL user flags
+		 * 
+		 * This function copies the RPL user flags into the registers V0 to VX.
+		 * 
+		 * @param CPU 	Pointer to the CPU object
+		 * @return bool (true) : Notify the CPU that the instruction was executed
+		 */
+		bool Execute(CHIP8::CPU *cpu) override {
+			for (uint8_t i = 0; i <= registerVX; i++)
+			{
+				cpu->SetRegister(i, cpu->GetRPLFlag(i));
+			}
+			return true;
+		}
+
+		/**
+		 * @brief Returns the mnemonic for the read registers from the RPL user flags instruction
+		 * 
+		 * @return std::string (LD Vx, R) : Returns the mnemonic for the read registers from the RPL user flags instruction
+		 */
+		std::string GetMnemonic() override {
+			return std::format("LD V{:X}, R", registerVX);
+		}
+
+		/**
+		 * @brief Returns the description for the read registers from the RPL user flags instruction
+		 * 
+		 * @return std::string (Read V0 to Vx from the RPL user flags) : Returns the description for the read registers from the RPL user flags instruction
+		 */
+		std::string GetDescription() override {
+			return std::format("Read V0 to V{:X} from the RPL user flags", registerVX);
+		}
+
+		/**
+		 * @brief Returns the opcode and mask for the read registers from the RPL user flags instruction
+		 * 
+		 * @return InstructionInfo_t (0xF085, 0xF0FF) : Returns the opcode and mask for the read registers from the RPL user flags instruction
+		 */
+		InstructionInfo_t GetInfo() override {
+			return {0xF085, 0xF0FF};
+		}
+
+		/**
+		 * @brief Update the instruction with the opcode
+		 * 
+		 * This function updates the instruction with the opcode.
+		 * 
+		 * @param opcode : The opcode to update the instruction with
+		 * @return std::shared_ptr<CHIP8::Instructions::Instruction> : Returns the updated instruction
+		 */
+		std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) override {
+			registerVX = (opcode & 0x0F00) >> 8;
+			return shared_from_this();
+		}
+	};
+}
+
+#endif /* SCHIP8_INSTRUCTIONS_FX85_HPP */
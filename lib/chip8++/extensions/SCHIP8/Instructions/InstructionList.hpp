@@ -0,0 +1,54 @@
+#ifndef SCHIP8_INSTRUCTIONS_INSTRUCTIONLIST_HPP
+#define SCHIP8_INSTRUCTIONS_INSTRUCTIONLIST_HPP
+
+/** @brief SCHIP-8 instruction list
+ *
+ * This file contains a list of all SCHIP-8 instructions
+ * that extend or replace the CHIP-8 instructions.
+ */
+
+#include "base_system/Instructions/Instruction.hpp"
+#include "00CN.hpp"
+#include "00FB.hpp"
+#include "00FC.hpp"
+#include "00FD.hpp"
+#include "00FE.hpp"
+#include "00FF.hpp"
+#include "DXYN.hpp"
+#include "FX30.hpp"
+#include "FX75.hpp"
+#include "FX85.hpp"
+
+namespace CHIP8::SCHIP8::Instructions
+{
+	class InstructionList
+	{
+	public:
+		/** @brief Number of instructions in the list */
+		static constexpr int INSTRUCTION_COUNT = 10;
+
+		/** @brief Get an instruction by its index
+		 *
+		 * @param instr Index of the instruction
+		 * @return Pointer to the instruction
+		 */
+		static std::shared_ptr<CHIP8::Instructions::Instruction> GetInstruction(int instr) {
+			if (instr >= INSTRUCTION_COUNT) return nullptr;
+			switch(instr) {
+				case 0: return std::make_shared<I00CN>();
+				case 1: return std::make_shared<I00FB>();
+				case 2: return std::make_shared<I00FC>();
+				case 3: return std::make_shared<I00FD>();
+				case 4: return std::make_shared<I00FE>();
+				case 5: return std::make_shared<I00FF>();
+				case 6: return std::make_shared<IDXYN>();
+				case 7: return std::make_shared<IFX30>();
+				case 8: return std::make_shared<IFX75>();
+				case 9: return std::make_shared<IFX85>();
+			}
+			return nullptr;
+		}
+	};
+}
+
+#endif /* SCHIP8_INSTRUCTIONS_INSTRUCTIONLIST_HPP */
@@ -4,120 +4,337 @@
 #include <cstdint>
 #include <memory>
 #include <algorithm>
+#include <array>
+#include <span>
 #include "base_system/display.hpp"
 
 namespace CHIP8::SCHIP8
 {
 	/**
 	 * @brief SCHIP-8 Display
-	 * 
+	 *
 	 * This class represents the display of the SCHIP-8 system.
 	 * The SCHIP-8 system has a display of 128x64 pixels.
-	 * 
-	 * Only the display buffer allocation is overridden, as the
-	 * other display base class functions are sufficient.
-	 * 
+	 *
+	 * The display buffer always holds the full 128x64 pixels, two words per
+	 * row. In low resolution mode the 64x32 pixels the program sees are drawn
+	 * as 2x2 blocks, so switching modes and scrolling never has to rescale the
+	 * buffer and every scroll is a shift of whole words.
+	 *
 	 * @see CHIP8::Display
 	 */
 	class SCHIP8Display : public CHIP8::Display
 	{
 	protected:
 		/** @brief Display Width
-		 * 
+		 *
 		 * This constant represents the width of the display.
 		 */
 		static constexpr int WIDTH = 128;
 
 		/** @brief Display Height
-		 * 
+		 *
 		 * This constant represents the height of the display.
 		 */
 		static constexpr int HEIGHT = 64;
 
 		/** @brief High Resolution Mode
-		 * 
+		 *
 		 * This flag indicates if the high resolution mode is enabled.
 		 */
 		bool highResMode = false;
+
+		/**
+		 * @brief Double every bit of a sprite row
+		 *
+		 * @param bits  Sprite row of up to 16 pixels
+		 * @return uint32_t : Sprite row with every pixel two pixels wide
+		 */
+		static constexpr uint32_t DoubleBits(uint32_t bits)
+		{
+			bits = (bits | (bits << 8)) & 0x00FF00FF;
+			bits = (bits | (bits << 4)) & 0x0F0F0F0F;
+			bits = (bits | (bits << 2)) & 0x33333333;
+			bits = (bits | (bits << 1)) & 0x55555555;
+			return bits | (bits << 1);
+		}
+
+		/**
+		 * @brief Get the pixel size of the current mode
+		 *
+		 * @return int : 1 in high resolution mode, 2 in low resolution mode
+		 */
+		int GetScale() const
+		{
+			return highResMode ? 1 : 2;
+		}
+
+		/**
+		 * @brief Clear the bits past the right edge of a row
+		 *
+		 * @param row  First word of the row
+		 */
+		void MaskRowTail(uint64_t *row)
+		{
+			if (Width % 64 != 0)
+			{
+				row[RowWords - 1] &= ~uint64_t(0) << (64 - Width % 64);
+			}
+		}
+
+		/**
+		 * @brief Construct a display of the SCHIP-8 size for a derived platform
+		 *
+		 * @param capability	Display class the derived display is an instance of
+		 * @param planes	Number of bit planes
+		 */
+		SCHIP8Display(DisplayCapability capability, int planes) : Display(HEIGHT, WIDTH, capability, planes) {}
 	public:
 		/**
 		 * @brief Construct a new SCHIP-8 Display object
-		 * 
+		 *
 		 * This constructor initializes the display buffer.
 		 */
-		SCHIP8Display()	: Display(HEIGHT, WIDTH) {}
+		SCHIP8Display()	: Display(HEIGHT, WIDTH, DisplayCapability::SCHIP8) {}
+
+		/**
+		 * @brief Create a headless SCHIP-8 display
+		 *
+		 * @return std::shared_ptr<Display> : The headless display
+		 */
+		std::shared_ptr<Display> CreateHeadless() const override;
 
 		/**
 		 * @brief Set High Resolution Mode
-		 * 
+		 *
 		 * This function sets the high resolution mode.
-		 * 
+		 *
 		 * @param highRes High resolution mode flag
 		 */
-		void SetHighRes(bool highRes)
+		void SetHighRes(bool highRes) override
 		{
 			highResMode = highRes;
 		}
 
 		/**
 		 * @brief Get High Resolution Mode
-		 * 
+		 *
 		 * This function returns the high resolution mode.
-		 * 
+		 *
 		 * @return bool : High resolution mode flag
 		 */
-		bool GetHighRes()
+		bool GetHighRes() override
 		{
 			return highResMode;
 		}
 
+		/**
+		 * @brief Get the width the program sees
+		 *
+		 * @return int : 128 in high resolution mode, 64 in low resolution mode
+		 */
+		int GetLogicalWidth() const
+		{
+			return Width / GetScale();
+		}
+
+		/**
+		 * @brief Get the height the program sees
+		 *
+		 * @return int : 64 in high resolution mode, 32 in low resolution mode
+		 */
+		int GetLogicalHeight() const
+		{
+			return Height / GetScale();
+		}
+
+		/**
+		 * @brief XOR a sprite row in the coordinates the program sees
+		 *
+		 * In low resolution mode the row is widened to two pixels per bit and
+		 * drawn onto two rows of the display buffer.
+		 *
+		 * @param x  X coordinate of the leftmost pixel, has to be below GetLogicalWidth()
+		 * @param y  Y coordinate of the row, has to be below GetLogicalHeight()
+		 * @param bits  Sprite row, the most significant of the `count` bits is the leftmost pixel
+		 * @param count  Number of pixels, 8 or 16
+		 * @param wrap  Wrap pixels past the right edge instead of clipping them
+		 * @param plane  Bit plane to draw to
+		 * @return bool : Returns true if a set pixel was cleared (collision)
+		 */
+		bool XorSpriteRow(int x, int y, uint16_t bits, int count, bool wrap, int plane = 0)
+		{
+			if (highResMode)
+			{
+				return XorRow(x, y, bits, count, wrap, plane);
+			}
+
+			const uint32_t wide = DoubleBits(bits);
+			bool collision = XorRow(x * 2, y * 2, wide, count * 2, wrap, plane);
+			collision |= XorRow(x * 2, y * 2 + 1, wide, count * 2, wrap, plane);
+			return collision;
+		}
+
+		/**
+		 * @brief XOR a sprite row onto several bit planes in the coordinates the program sees
+		 *
+		 * Like XorSpriteRow(), but draws the rows of all selected planes in one
+		 * pass with XorPlaneRows().
+		 *
+		 * @param x  X coordinate of the leftmost pixel, has to be below GetLogicalWidth()
+		 * @param y  Y coordinate of the row, has to be below GetLogicalHeight()
+		 * @param bits  Sprite row of plane n in bits[n], the most significant of the `count` bits is the leftmost pixel
+		 * @param planeMask  Bit n selects plane n
+		 * @param count  Number of pixels, 8 or 16
+		 * @param wrap  Wrap pixels past the right edge instead of clipping them
+		 * @return bool : Returns true if a set pixel was cleared on any plane (collision)
+		 */
+		bool XorSpritePlaneRows(int x, int y, std::span<const uint16_t> bits, uint8_t planeMask, int count, bool wrap)
+		{
+			std::array<uint64_t, 8> rows = {};
+			const size_t planes = std::min(bits.size(), rows.size());
+			if (highResMode)
+			{
+				std::copy_n(bits.begin(), planes, rows.begin());
+				return XorPlaneRows(x, y, std::span(rows).first(planes), planeMask, count, wrap);
+			}
+
+			std::transform(bits.begin(), bits.begin() + ptrdiff_t(planes), rows.begin(), [](uint16_t row) { return uint64_t(DoubleBits(row)); });
+			bool collision = XorPlaneRows(x * 2, y * 2, std::span(rows).first(planes), planeMask, count * 2, wrap);
+			collision |= XorPlaneRows(x * 2, y * 2 + 1, std::span(rows).first(planes), planeMask, count * 2, wrap);
+			return collision;
+		}
+
 		/**
 		 * @brief Scroll Down N Lines
-		 * 
-		 * This function scrolls the display down by N lines.
-		 * 
+		 *
+		 * This function scrolls the display down by N lines of the current mode.
+		 *
 		 * @param lines Number of lines to scroll down
+		 * @param planeMask Bit planes to scroll, all of them by default
 		 */
-		void ScrollDown(int lines)
+		void ScrollDown(int lines, uint8_t planeMask = 0xFF)
 		{
-			lines = lines % (highResMode ? 16 : 8);
+			const int rows = std::min(lines * GetScale(), Height);
+			DetachBuffer();
 
-			memmove(screenBuffer.get(), screenBuffer.get() + Width * lines, Width * (Height - lines) * sizeof(bool));
-			std::fill(screenBuffer.get(), screenBuffer.get() + Width * lines, false);
+			const uint8_t allPlanes = uint8_t((1 << Planes) - 1);
+			if ((planeMask & allPlanes) == allPlanes)
+			{
+				// Every plane moves, the rows are continuous words
+				const size_t stride = size_t(Planes * RowWords);
+				std::copy_backward(screenBuffer.get(), screenBuffer.get() + size_t(Height - rows) * stride,
+					screenBuffer.get() + GetBufferWords());
+				std::fill_n(screenBuffer.get(), size_t(rows) * stride, 0);
+				RehashBuffer();
+				UpdateRequired = true;
+				return;
+			}
+
+			for (int plane = 0; plane < Planes; plane++)
+			{
+				if (!(planeMask & (1 << plane)))
+					continue;
+				for (int y = Height - 1; y >= 0; y--)
+				{
+					uint64_t *row = GetRow(y, plane);
+					if (y >= rows)
+						std::copy_n(GetRow(y - rows, plane), RowWords, row);
+					else
+						std::fill_n(row, RowWords, 0);
+				}
+			}
+			RehashBuffer();
+			UpdateRequired = true;
 		}
 
 		/**
 		 * @brief Scroll Left 4 Pixels
-		 * 
-		 * This function scrolls the display left by 4 pixels.
+		 *
+		 * This function scrolls the display left by 4 pixels of the current mode.
+		 *
+		 * @param planeMask Bit planes to scroll, all of them by default
 		 */
-		void ScrollLeft()
+		void ScrollLeft(uint8_t planeMask = 0xFF)
 		{
-			int pixels = highResMode ? 8 : 4;
+			const int pixels = 4 * GetScale();
+			DetachBuffer();
 
-			for (int i = 0; i < Height; i++)
+			for (int plane = 0; plane < Planes; plane++)
 			{
-				memmove(screenBuffer.get() + i * Width, screenBuffer.get() + i * Width + pixels, (Width - pixels) * sizeof(bool));
-				std::fill(screenBuffer.get() + i * Width + Width - pixels, screenBuffer.get() + i * Width + Width, false);
+				if (!(planeMask & (1 << plane)))
+					continue;
+				for (int y = 0; y < Height; y++)
+				{
+					uint64_t *row = GetRow(y, plane);
+					for (int i = 0; i < RowWords - 1; i++)
+					{
+						row[i] = (row[i] << pixels) | (row[i + 1] >> (64 - pixels));
+					}
+					row[RowWords - 1] <<= pixels;
+					MaskRowTail(row);
+				}
 			}
+			RehashBuffer();
+			UpdateRequired = true;
 		}
 
 		/**
 		 * @brief Scroll Right 4 Pixels
-		 * 
-		 * This function scrolls the display right by 4 pixels.
+		 *
+		 * This function scrolls the display right by 4 pixels of the current mode.
+		 *
+		 * @param planeMask Bit planes to scroll, all of them by default
 		 */
-		void ScrollRight()
+		void ScrollRight(uint8_t planeMask = 0xFF)
 		{
-			int pixels = highResMode ? 8 : 4;
+			const int pixels = 4 * GetScale();
+			DetachBuffer();
 
-			for (int i = 0; i < Height; i++)
+			for (int plane = 0; plane < Planes; plane++)
 			{
-				memmove(screenBuffer.get() + i * Width + pixels, screenBuffer.get() + i * Width, (Width - pixels) * sizeof(bool));
-				std::fill(screenBuffer.get() + i * Width, screenBuffer.get() + i * Width + pixels, false);
+				if (!(planeMask & (1 << plane)))
+					continue;
+				for (int y = 0; y < Height; y++)
+				{
+					uint64_t *row = GetRow(y, plane);
+					for (int i = RowWords - 1; i > 0; i--)
+					{
+						row[i] = (row[i] >> pixels) | (row[i - 1] << (64 - pixels));
+					}
+					row[0] >>= pixels;
+					MaskRowTail(row);
+				}
 			}
+			RehashBuffer();
+			UpdateRequired = true;
+		}
+	};
+
+	/**
+	 * @brief Headless SCHIP-8 Display
+	 *
+	 * This class represents a SCHIP-8 display without any output, useful for
+	 * batch runs and other headless hosts.
+	 */
+	class HeadlessSCHIP8Display : public SCHIP8Display
+	{
+	public:
+		/**
+		 * @brief Update the display
+		 *
+		 * Nothing to show, only clears the Update Required flag.
+		 */
+		void Update() override
+		{
+			UpdateRequired = false;
 		}
 	};
+
+	inline std::shared_ptr<Display> SCHIP8Display::CreateHeadless() const
+	{
+		return std::make_shared<HeadlessSCHIP8Display>();
+	}
 }
 
-#endif // SCHIP8_DISPLAY_HPP
\ No newline at end of file
+#endif // SCHIP8_DISPLAY_HPP
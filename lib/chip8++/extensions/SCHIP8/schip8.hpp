@@ -0,0 +1,38 @@
+#ifndef SCHIP8_SCHIP8_HPP
+#define SCHIP8_SCHIP8_HPP
+
+#include <memory>
+#include "base_system/InstructionDecoder.hpp"
+#include "base_system/Instructions/Illegal.hpp"
+#include "base_system/Instructions/InstructionList.hpp"
+#include "extensions/SCHIP8/display.hpp"
+#include "extensions/SCHIP8/Instructions/InstructionList.hpp"
+
+namespace CHIP8::SCHIP8
+{
+	/**
+	 * @brief Create an instruction decoder for SCHIP-8
+	 * 
+	 * This function registers the CHIP-8 instructions first and the SCHIP-8
+	 * instructions on top, replacing DXYN with the 16x16 sprite capable one.
+	 * The CPU using the decoder needs a SCHIP8Display.
+	 * 
+	 * @return std::shared_ptr<InstructionDecoder> : Decoder to construct the CPU with
+	 */
+	inline std::shared_ptr<InstructionDecoder> CreateDecoder()
+	{
+		auto decoder = std::make_shared<InstructionDecoder>(std::make_shared<CHIP8::Instructions::IllegalInstruction>());
+		for (int i = 0; i < CHIP8::Instructions::InstructionList::INSTRUCTION_COUNT; i++)
+		{
+			decoder->RegisterInstruction(CHIP8::Instructions::InstructionList::GetInstruction(i));
+		}
+		for (int i = 0; i < Instructions::InstructionList::INSTRUCTION_COUNT; i++)
+		{
+			decoder->RegisterInstruction(Instructions::InstructionList::GetInstruction(i));
+		}
+		decoder->RequireDisplay(DisplayCapability::SCHIP8);
+		return decoder;
+	}
+}
+
+#endif /* SCHIP8_SCHIP8_HPP */
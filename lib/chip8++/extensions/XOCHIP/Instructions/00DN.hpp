@@ -0,0 +1,75 @@
+// Scroll display N lines up
+#ifndef XOCHIP_INSTRUCTIONS_00DN_HPP
+#define XOCHIP_INSTRUCTIONS_00DN_HPP
+
+#include "extensions/XOCHIP/display.hpp"
+#include "base_system/Instructions/Instruction.hpp"
+
+namespace CHIP8::XOCHIP::Instructions
+{
+	/**
+	 * @brief Scroll display N lines up
+	 * 
+	 * This class represents the instruction to scroll the selected bit planes N lines up.
+	 */
+	class I00DN :
+		public CHIP8::Instructions::Instruction,
+		public std::enable_shared_from_this<I00DN>
+	{
+		uint8_t LinesToScroll;
+	public:
+		/**
+		 * @brief Execute the instruction to scroll the display N lines up
+		 * 
+		 * This function scrolls the selected bit planes N lines up.
+		 * 
+		 * @param CPU 	Pointer to the CPU object
+		 * @return bool (true) : Notify the CPU that the instruction was executed
+		 */
+		bool Execute(CHIP8::CPU *cpu) override {
+			auto &display = cpu->GetExtensionDisplay<XOCHIPDisplay>();
+			display.ScrollUp(LinesToScroll, display.GetSelectedPlanes());
+			return true;
+		}
+
+		/**
+		 * @brief Returns the mnemonic for the scroll display N lines up instruction
+		 * 
+		 * @return std::string (SCU N) : Returns the mnemonic for the scroll display N lines up instruction
+		 */
+		std::string GetMnemonic() override {
+			return std::format("SCU {}", LinesToScroll);
+		}
+
+		/**
+		 * @brief Returns the description for the scroll display N lines up instruction
+		 * 
+		 * @return std::string (Scroll display N lines up) : Returns the description for the scroll display N lines up instruction
+		 */
+		std::string GetDescription() override {
+			return std::format("Scroll display {} lines up", LinesToScroll);
+		}
+
+		/**
+		 * @brief Returns the opcode and mask for the scroll display N lines up instruction
+		 * 
+		 * @return InstructionInfo_t (0x00D0, 0xFFF0) : Returns the opcode and mask for the scroll display N lines up instruction
+		 */
+		InstructionInfo_t GetInfo() override {
+			return {0x00D0, 0xFFF0};
+		}
+
+		/**
+		 * @brief Update the instruction with the opcode
+		 * 
+		 * @param opcode : The opcode to update the instruction with
+		 * @return std::shared_ptr<CHIP8::Instructions::Instruction> : Returns the updated instruction
+		 */
+		std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) override {
+			LinesToScroll = opcode & 0x000F;
+			return shared_from_this();
+		}
+	};
+}
+
+#endif /* XOCHIP_INSTRUCTIONS_00DN_HPP */
@@ -0,0 +1,73 @@
+// Clear the selected bit planes of the display
+#ifndef XOCHIP_INSTRUCTIONS_00E0_HPP
+#define XOCHIP_INSTRUCTIONS_00E0_HPP
+
+#include "extensions/XOCHIP/display.hpp"
+#include "base_system/Instructions/Instruction.hpp"
+
+namespace CHIP8::XOCHIP::Instructions
+{
+	/**
+	 * @brief Clear the display
+	 * 
+	 * This class represents the instruction to clear the selected bit planes of the display.
+	 */
+	class I00E0 :
+		public CHIP8::Instructions::Instruction,
+		public std::enable_shared_from_this<I00E0>
+	{
+	public:
+		/**
+		 * @brief Execute the instruction to clear the display
+		 * 
+		 * This function clears the selected bit planes, the others keep their pixels.
+		 * 
+		 * @param CPU 	Pointer to the CPU object
+		 * @return bool (true) : Notify the CPU that the instruction was executed
+		 */
+		bool Execute(CHIP8::CPU *cpu) override {
+			cpu->GetExtensionDisplay<XOCHIPDisplay>().ClearSelected();
+			return true;
+		}
+
+		/**
+		 * @brief Returns the mnemonic for the clear display instruction
+		 * 
+		 * @return std::string (CLS) : Returns the mnemonic for the clear display instruction
+		 */
+		std::string GetMnemonic() override {
+			return "CLS";
+		}
+
+		/**
+		 * @brief Returns the description for the clear display instruction
+		 * 
+		 * @return std::string (Clear the selected bit planes) : Returns the description for the clear display instruction
+		 */
+		std::string GetDescription() override {
+			return "Clear the selected bit planes";
+		}
+
+		/**
+		 * @brief Returns the opcode and mask for the clear display instruction
+		 * 
+		 * @return InstructionInfo_t (0x00E0, 0xFFFF) : Returns the opcode and mask for the clear display instruction
+		 */
+		InstructionInfo_t GetInfo() override {
+			return {0x00E0, 0xFFFF};
+		}
+
+		/**
+		 * @brief Update the instruction with the opcode
+		 * 
+		 * @param opcode : The opcode to update the instruction with
+		 * @return std::shared_ptr<CHIP8::Instructions::Instruction> : Returns the updated instruction
+		 */
+		std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) override {
+			(void)opcode;
+			return shared_from_this();
+		}
+	};
+}
+
+#endif /* XOCHIP_INSTRUCTIONS_00E0_HPP */
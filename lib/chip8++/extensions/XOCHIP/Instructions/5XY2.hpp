@@ -0,0 +1,98 @@
+// Store VX..VY in memory starting at M(I), I is left unchanged
+#ifndef XOCHIP_INSTRUCTIONS_5XY2_HPP
+#define XOCHIP_INSTRUCTIONS_5XY2_HPP
+
+#include <expected>
+#include "base_system/Instructions/Instruction.hpp"
+
+namespace CHIP8::XOCHIP::Instructions
+{
+	/**
+	 * @brief Store the registers VX to VY in memory starting at the address stored in I
+	 * 
+	 * This class represents the instruction to store a range of registers in memory.
+	 */
+	class I5XY2 :
+		public CHIP8::Instructions::Instruction,
+		public std::enable_shared_from_this<I5XY2>
+	{
+		uint8_t RegX;
+		uint8_t RegY;
+		std::expected<void, MemoryFault_t> retValMemory;
+	public:
+		/**
+		 * @brief Execute the instruction to store the registers VX to VY in memory
+		 * 
+		 * This function writes the registers VX to VY to memory starting at I. The range is
+		 * stored in reverse if X is larger than Y, I is left unchanged.
+		 * 
+		 * @param CPU 	Pointer to the CPU object
+		 * @return bool : Returns false if a register can't be written to memory
+		 */
+		bool Execute(CHIP8::CPU *cpu) override {
+			const int Step = (RegX <= RegY) ? 1 : -1;
+			const int Count = (RegX <= RegY) ? (RegY - RegX + 1) : (RegX - RegY + 1);
+
+			for (int i = 0; i < Count; i++)
+			{
+				retValMemory = cpu->GetMemory()->SetByte(uint16_t(cpu->GetIndex() + i), cpu->GetRegister(uint8_t(RegX + i * Step)));
+				if (!retValMemory)
+				{
+					cpu->RaiseTrap(TrapCode::MemoryFault);
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/**
+		 * @brief Returns the mnemonic for the store register range instruction
+		 * 
+		 * @return std::string (LD [I], Vx - Vy) : Returns the mnemonic for the store register range instruction
+		 */
+		std::string GetMnemonic() override {
+			return std::format("LD [I], V{:X} - V{:X}", RegX, RegY);
+		}
+
+		/**
+		 * @brief Returns the description for the store register range instruction
+		 * 
+		 * @return std::string (Store Vx to Vy in memory starting at I) : Returns the description for the store register range instruction
+		 */
+		std::string GetDescription() override {
+			return std::format("Store V{:X} to V{:X} in memory starting at I", RegX, RegY);
+		}
+
+		/**
+		 * @brief Returns the opcode and mask for the store register range instruction
+		 * 
+		 * @return InstructionInfo_t (0x5002, 0xF00F) : Returns the opcode and mask for the store register range instruction
+		 */
+		InstructionInfo_t GetInfo() override {
+			return {0x5002, 0xF00F};
+		}
+
+		/**
+		 * @brief Get the reason why the function returned false in Execute
+		 * 
+		 * @return std::string : Returns the error report for the instruction
+		 */
+		std::string GetAbortReason() override {
+			return DescribeMemoryFault(retValMemory.error());
+		}
+
+		/**
+		 * @brief Update the instruction with the opcode
+		 * 
+		 * @param opcode : The opcode to update the instruction with
+		 * @return std::shared_ptr<CHIP8::Instructions::Instruction> : Returns the updated instruction
+		 */
+		std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) override {
+			RegX = (opcode & 0x0F00) >> 8;
+			RegY = (opcode & 0x00F0) >> 4;
+			return shared_from_this();
+		}
+	};
+}
+
+#endif /* XOCHIP_INSTRUCTIONS_5XY2_HPP */
@@ -0,0 +1,99 @@
+// Load VX..VY from memory starting at M(I), I is left unchanged
+#ifndef XOCHIP_INSTRUCTIONS_5XY3_HPP
+#define XOCHIP_INSTRUCTIONS_5XY3_HPP
+
+#include <expected>
+#include "base_system/Instructions/Instruction.hpp"
+
+namespace CHIP8::XOCHIP::Instructions
+{
+	/**
+	 * @brief Load the registers VX to VY from memory starting at the address stored in I
+	 * 
+	 * This class represents the instruction to load a range of registers from memory.
+	 */
+	class I5XY3 :
+		public CHIP8::Instructions::Instruction,
+		public std::enable_shared_from_this<I5XY3>
+	{
+		uint8_t RegX;
+		uint8_t RegY;
+		std::expected<uint8_t, MemoryFault_t> retValMemory;
+	public:
+		/**
+		 * @brief Execute the instruction to load the registers VX to VY from memory
+		 * 
+		 * This function reads the registers VX to VY from memory starting at I. The range is
+		 * loaded in reverse if X is larger than Y, I is left unchanged.
+		 * 
+		 * @param CPU 	Pointer to the CPU object
+		 * @return bool : Returns false if a register can't be read from memory
+		 */
+		bool Execute(CHIP8::CPU *cpu) override {
+			const int Step = (RegX <= RegY) ? 1 : -1;
+			const int Count = (RegX <= RegY) ? (RegY - RegX + 1) : (RegX - RegY + 1);
+
+			for (int i = 0; i < Count; i++)
+			{
+				retValMemory = cpu->GetMemory()->GetByte(uint16_t(cpu->GetIndex() + i));
+				if (!retValMemory)
+				{
+					cpu->RaiseTrap(TrapCode::MemoryFault);
+					return false;
+				}
+				cpu->SetRegister(uint8_t(RegX + i * Step), retValMemory.value());
+			}
+			return true;
+		}
+
+		/**
+		 * @brief Returns the mnemonic for the load register range instruction
+		 * 
+		 * @return std::string (LD Vx - Vy, [I]) : Returns the mnemonic for the load register range instruction
+		 */
+		std::string GetMnemonic() override {
+			return std::format("LD V{:X} - V{:X}, [I]", RegX, RegY);
+		}
+
+		/**
+		 * @brief Returns the description for the load register range instruction
+		 * 
+		 * @return std::string (Load Vx to Vy from memory starting at I) : Returns the description for the load register range instruction
+		 */
+		std::string GetDescription() override {
+			return std::format("Load V{:X} to V{:X} from memory starting at I", RegX, RegY);
+		}
+
+		/**
+		 * @brief Returns the opcode and mask for the load register range instruction
+		 * 
+		 * @return InstructionInfo_t (0x5003, 0xF00F) : Returns the opcode and mask for the load register range instruction
+		 */
+		InstructionInfo_t GetInfo() override {
+			return {0x5003, 0xF00F};
+		}
+
+		/**
+		 * @brief Get the reason why the function returned false in Execute
+		 * 
+		 * @return std::string : Returns the error report for the instruction
+		 */
+		std::string GetAbortReason() override {
+			return DescribeMemoryFault(retValMemory.error());
+		}
+
+		/**
+		 * @brief Update the instruction with the opcode
+		 * 
+		 * @param opcode : The opcode to update the instruction with
+		 * @return std::shared_ptr<CHIP8::Instructions::Instruction> : Returns the updated instruction
+		 */
+		std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) override {
+			RegX = (opcode & 0x0F00) >> 8;
+			RegY = (opcode & 0x00F0) >> 4;
+			return shared_from_this();
+		}
+	};
+}
+
+#endif /* XOCHIP_INSTRUCTIONS_5XY3_HPP */
@@ -0,0 +1,167 @@
+// Show N-byte sprite from M(I) at coords (VX,VY) on the selected planes, VF := collision. If N=0, show 16x16 sprite.
+#ifndef XOCHIP_INSTRUCTIONS_DXYN_HPP
+#define XOCHIP_INSTRUCTIONS_DXYN_HPP
+
+#include <expected>
+#include <array>
+#include "extensions/XOCHIP/display.hpp"
+#include "base_system/Instructions/Instruction.hpp"
+
+namespace CHIP8::XOCHIP::Instructions
+{
+	/**
+	 * @brief Draw a sprite at position (VX, VY) with N bytes of sprite data per selected plane starting at the address stored in I
+	 * 
+	 * This class represents the instruction to draw a sprite on the selected bit planes.
+	 */
+	class IDXYN :
+		public CHIP8::Instructions::Instruction,
+		public std::enable_shared_from_this<IDXYN>
+	{
+		/** @brief Number of bit planes of the display */
+		static constexpr int PLANES = 2;
+
+		uint8_t RegX;
+		uint8_t RegY;
+		uint8_t SpritesN;
+		std::expected<uint8_t, MemoryFault_t> retValMemory;
+	public:
+		/**
+		 * @brief Execute the instruction to draw a sprite at position (VX, VY) on the selected bit planes
+		 * 
+		 * This function draws a sprite like the SCHIP-8 one, once for every selected bit plane. The sprite
+		 * data of the second selected plane directly follows the data of the first one. The rows of the
+		 * planes are next to each other in the display buffer, so once the data of both planes of a row
+		 * is read they are XORed in one pass. A cleared pixel on any plane sets VF.
+		 * 
+		 * @param CPU 	Pointer to the CPU object
+		 * @return bool : Returns false if the sprite data can't be read from memory
+		 */
+		bool Execute(CHIP8::CPU *cpu) override {
+			auto &Display = cpu->GetExtensionDisplay<XOCHIPDisplay>();
+			const int Width = Display.GetLogicalWidth();
+			const int Height = Display.GetLogicalHeight();
+			const int DisplayX = cpu->GetRegister(RegX) % Width;
+			const int DisplayY = cpu->GetRegister(RegY) % Height;
+			const bool BigSprite = (SpritesN == 0);
+			const int Rows = BigSprite ? 16 : SpritesN;
+			const int BytesPerRow = BigSprite ? 2 : 1;
+			const uint8_t SelectedPlanes = Display.GetSelectedPlanes();
+			bool collision = false;
+			bool WrapQuirk = cpu->GetQuirks().WrapSprite;
+
+			// Reset the error message variable
+			retValMemory = std::expected<uint8_t, MemoryFault_t>(0);
+
+			for (int iy = 0; iy < Rows && retValMemory; iy++)
+			{
+				int SpriteY = (DisplayY + iy);
+				if (WrapQuirk)
+				{
+					SpriteY = SpriteY % Height;
+				}
+				else if (SpriteY >= Height)
+				{
+					continue;
+				}
+
+				// Offset of the sprite data of the current plane
+				uint16_t PlaneData = 0;
+				std::array<uint16_t, PLANES> spriteRows = {};
+				for (int plane = 0; plane < PLANES && retValMemory; plane++)
+				{
+					if (!(SelectedPlanes & (1 << plane)))
+						continue;
+
+					for (int i = 0; i < BytesPerRow; i++)
+					{
+						retValMemory = cpu->GetMemory()->GetByte(uint16_t(cpu->GetIndex() + PlaneData + iy * BytesPerRow + i));
+						if (!retValMemory)
+						{
+							break;
+						}
+						spriteRows[plane] = uint16_t((spriteRows[plane] << 8) | retValMemory.value());
+					}
+					PlaneData = uint16_t(PlaneData + Rows * BytesPerRow);
+				}
+
+				// On error, break the loop
+				if (!retValMemory)
+				{
+					break;
+				}
+
+				if (Display.XorSpritePlaneRows(DisplayX, SpriteY, spriteRows, SelectedPlanes, BytesPerRow * 8, WrapQuirk))
+				{
+					collision = true;
+				}
+			}
+
+			Display.SetUpdateRequired();
+			cpu->SetRegister(0xF, collision ? 1 : 0);
+
+			if (!retValMemory)
+			{
+				cpu->RaiseTrap(TrapCode::MemoryFault);
+			}
+			return retValMemory ? true : false;
+		};
+
+		/**
+		 * @brief Returns the mnemonic for the draw sprite instruction
+		 * 
+		 * @return std::string (DRW) : Returns the mnemonic for the draw sprite instruction
+		 */
+		std::string GetMnemonic() override {
+			return std::format("DRAW V{:X}, V{:X}, {}", RegX, RegY, SpritesN);
+		}
+
+		/**
+		 * @brief Returns the description for the draw sprite instruction
+		 * 
+		 * @return std::string (Draw a sprite at position (VX, VY) on the selected planes) : Returns the description for the draw sprite instruction
+		 */
+		std::string GetDescription() override {
+			if (SpritesN == 0)
+			{
+				return std::format("Draw a 16x16 sprite at position (V{:X}, V{:X}) on the selected planes with 32 "
+					"bytes of sprite data per plane starting at the address stored in I", RegX, RegY);
+			}
+			return std::format("Draw a sprite at position (V{:X}, V{:X}) on the selected planes with {} "
+				"bytes of sprite data per plane starting at the address stored in I", RegX, RegY, SpritesN);
+		}
+
+		/**
+		 * @brief Returns the opcode and mask for the draw sprite instruction
+		 * 
+		 * @return InstructionInfo_t (0xD000, 0xF000) : Returns the opcode and mask for the draw sprite instruction
+		 */
+		InstructionInfo_t GetInfo() override {
+			return {0xD000, 0xF000};
+		}
+
+		/**
+		 * @brief Get the reason why the function returned false in Execute
+		 * 
+		 * @return std::string : Returns the error report for the instruction
+		 */
+		std::string GetAbortReason() override {
+			return DescribeMemoryFault(retValMemory.error());
+		}
+
+		/**
+		 * @brief Updates the draw sprite instruction
+		 * 
+		 * @param opcode 	Opcode for the draw sprite instruction
+		 * @return Instruction* : Returns the updated draw sprite instruction
+		 */
+		std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) override {
+			RegX = (opcode & 0x0F00) >> 8;
+			RegY = (opcode & 0x00F0) >> 4;
+			SpritesN = opcode & 0x000F;
+			return shared_from_this();
+		}
+	};
+}
+
+#endif /* XOCHIP_INSTRUCTIONS_DXYN_HPP */
@@ -0,0 +1,91 @@
+// Load I with the 16-bit address NNNN in the following word
+#ifndef XOCHIP_INSTRUCTIONS_F000_HPP
+#define XOCHIP_INSTRUCTIONS_F000_HPP
+
+#include <expected>
+#include "base_system/Instructions/Instruction.hpp"
+
+namespace CHIP8::XOCHIP::Instructions
+{
+	/**
+	 * @brief Load I with the 16-bit address following the instruction
+	 * 
+	 * This class represents the only four byte instruction, loading I with an address
+	 * anywhere in the 64 KiB address space.
+	 */
+	class IF000 :
+		public CHIP8::Instructions::Instruction,
+		public std::enable_shared_from_this<IF000>
+	{
+		std::expected<uint16_t, MemoryFault_t> retValMemory;
+	public:
+		/**
+		 * @brief Execute the instruction to load I with a 16-bit address
+		 * 
+		 * This function reads the word following the instruction into I and skips over it.
+		 * 
+		 * @param CPU 	Pointer to the CPU object
+		 * @return bool : Returns false if the address can't be read from memory
+		 */
+		bool Execute(CHIP8::CPU *cpu) override {
+			retValMemory = cpu->GetMemory()->GetWord(cpu->GetPC());
+			if (!retValMemory)
+			{
+				cpu->RaiseTrap(TrapCode::MemoryFault);
+				return false;
+			}
+			cpu->SetIndex(retValMemory.value());
+			cpu->SetPC(cpu->GetPC() + 2);
+			return true;
+		}
+
+		/**
+		 * @brief Returns the mnemonic for the long load index instruction
+		 * 
+		 * @return std::string (LD I, long) : Returns the mnemonic for the long load index instruction
+		 */
+		std::string GetMnemonic() override {
+			return "LD I, long";
+		}
+
+		/**
+		 * @brief Returns the description for the long load index instruction
+		 * 
+		 * @return std::string (Load I with the 16-bit address in the next word) : Returns the description for the long load index instruction
+		 */
+		std::string GetDescription() override {
+			return "Load I with the 16-bit address in the next word";
+		}
+
+		/**
+		 * @brief Returns the opcode and mask for the long load index instruction
+		 * 
+		 * @return InstructionInfo_t (0xF000, 0xFFFF) : Returns the opcode and mask for the long load index instruction
+		 */
+		InstructionInfo_t GetInfo() override {
+			return {0xF000, 0xFFFF};
+		}
+
+		/**
+		 * @brief Get the reason why the function returned false in Execute
+		 * 
+		 * @return std::string : Returns the error report for the instruction
+		 */
+		std::string GetAbortReason() override {
+			return DescribeMemoryFault(retValMemory.error());
+		}
+
+		/**
+		 * @brief Update the instruction with the opcode
+		 * 
+		 * @param opcode : The opcode to update the instruction with
+		 * @return std::shared_ptr<CHIP8::Instructions::Instruction> : Returns the updated instruction
+		 */
+		std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) override {
+			(void)opcode;
+			return shared_from_this();
+		}
+	};
+}
+
+#endif /* XOCHIP_INSTRUCTIONS_F000_HPP */
@@ -0,0 +1,96 @@
+// Load the 16-byte audio pattern from M(I)
+#ifndef XOCHIP_INSTRUCTIONS_F002_HPP
+#define XOCHIP_INSTRUCTIONS_F002_HPP
+
+#include <array>
+#include <expected>
+#include "base_system/Instructions/Instruction.hpp"
+
+namespace CHIP8::XOCHIP::Instructions
+{
+	/**
+	 * @brief Load the audio pattern from the address stored in I
+	 * 
+	 * This class represents the instruction to load the 128 one bit samples the sound timer plays.
+	 */
+	class IF002 :
+		public CHIP8::Instructions::Instruction,
+		public std::enable_shared_from_this<IF002>
+	{
+		std::expected<uint8_t, MemoryFault_t> retValMemory;
+	public:
+		/**
+		 * @brief Execute the instruction to load the audio pattern
+		 * 
+		 * This function copies 16 bytes starting at I into the audio pattern, I is left unchanged.
+		 * The bytes are read one by one so watchpoints see them and the address wraps like I.
+		 * 
+		 * @param CPU 	Pointer to the CPU object
+		 * @return bool : Returns false if the pattern can't be read from memory
+		 */
+		bool Execute(CHIP8::CPU *cpu) override {
+			std::array<uint8_t, Timers::AUDIO_PATTERN_SIZE> pattern;
+			for (size_t i = 0; i < pattern.size(); i++)
+			{
+				retValMemory = cpu->GetMemory()->GetByte(uint16_t(cpu->GetIndex() + i));
+				if (!retValMemory)
+				{
+					cpu->RaiseTrap(TrapCode::MemoryFault);
+					return false;
+				}
+				pattern[i] = retValMemory.value();
+			}
+			cpu->GetTimers()->SetAudioPattern(pattern);
+			return true;
+		}
+
+		/**
+		 * @brief Returns the mnemonic for the load audio pattern instruction
+		 * 
+		 * @return std::string (AUDIO) : Returns the mnemonic for the load audio pattern instruction
+		 */
+		std::string GetMnemonic() override {
+			return "AUDIO";
+		}
+
+		/**
+		 * @brief Returns the description for the load audio pattern instruction
+		 * 
+		 * @return std::string (Load the audio pattern from memory starting at I) : Returns the description for the load audio pattern instruction
+		 */
+		std::string GetDescription() override {
+			return "Load the audio pattern from memory starting at I";
+		}
+
+		/**
+		 * @brief Returns the opcode and mask for the load audio pattern instruction
+		 * 
+		 * @return InstructionInfo_t (0xF002, 0xFFFF) : Returns the opcode and mask for the load audio pattern instruction
+		 */
+		InstructionInfo_t GetInfo() override {
+			return {0xF002, 0xFFFF};
+		}
+
+		/**
+		 * @brief Get the reason why the function returned false in Execute
+		 * 
+		 * @return std::string : Returns the error report for the instruction
+		 */
+		std::string GetAbortReason() override {
+			return DescribeMemoryFault(retValMemory.error());
+		}
+
+		/**
+		 * @brief Update the instruction with the opcode
+		 * 
+		 * @param opcode : The opcode to update the instruction with
+		 * @return std::shared_ptr<CHIP8::Instructions::Instruction> : Returns the updated instruction
+		 */
+		std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) override {
+			(void)opcode;
+			return shared_from_this();
+		}
+	};
+}
+
+#endif /* XOCHIP_INSTRUCTIONS_F002_HPP */
@@ -0,0 +1,74 @@
+// Select the bit planes N for drawing, scrolling and clearing
+#ifndef XOCHIP_INSTRUCTIONS_FN01_HPP
+#define XOCHIP_INSTRUCTIONS_FN01_HPP
+
+#include "extensions/XOCHIP/display.hpp"
+#include "base_system/Instructions/Instruction.hpp"
+
+namespace CHIP8::XOCHIP::Instructions
+{
+	/**
+	 * @brief Select the bit planes the display instructions work on
+	 * 
+	 * This class represents the instruction to select the bit planes with the mask N.
+	 */
+	class IFN01 :
+		public CHIP8::Instructions::Instruction,
+		public std::enable_shared_from_this<IFN01>
+	{
+		uint8_t PlaneMask;
+	public:
+		/**
+		 * @brief Execute the instruction to select the bit planes
+		 * 
+		 * This function selects the bit planes that following draw, scroll and clear instructions affect.
+		 * 
+		 * @param CPU 	Pointer to the CPU object
+		 * @return bool (true) : Notify the CPU that the instruction was executed
+		 */
+		bool Execute(CHIP8::CPU *cpu) override {
+			cpu->GetExtensionDisplay<XOCHIPDisplay>().SelectPlanes(PlaneMask);
+			return true;
+		}
+
+		/**
+		 * @brief Returns the mnemonic for the select bit planes instruction
+		 * 
+		 * @return std::string (PLANE n) : Returns the mnemonic for the select bit planes instruction
+		 */
+		std::string GetMnemonic() override {
+			return std::format("PLANE {}", PlaneMask);
+		}
+
+		/**
+		 * @brief Returns the description for the select bit planes instruction
+		 * 
+		 * @return std::string (Select the bit planes n) : Returns the description for the select bit planes instruction
+		 */
+		std::string GetDescription() override {
+			return std::format("Select the bit planes {} for drawing", PlaneMask);
+		}
+
+		/**
+		 * @brief Returns the opcode and mask for the select bit planes instruction
+		 * 
+		 * @return InstructionInfo_t (0xF001, 0xF0FF) : Returns the opcode and mask for the select bit planes instruction
+		 */
+		InstructionInfo_t GetInfo() override {
+			return {0xF001, 0xF0FF};
+		}
+
+		/**
+		 * @brief Update the instruction with the opcode
+		 * 
+		 * @param opcode : The opcode to update the instruction with
+		 * @return std::shared_ptr<CHIP8::Instructions::Instruction> : Returns the updated instruction
+		 */
+		std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) override {
+			PlaneMask = (opcode & 0x0F00) >> 8;
+			return shared_from_this();
+		}
+	};
+}
+
+#endif /* XOCHIP_INSTRUCTIONS_FN01_HPP */
@@ -0,0 +1,73 @@
+// Set the pitch of the audio pattern to VX
+#ifndef XOCHIP_INSTRUCTIONS_FX3A_HPP
+#define XOCHIP_INSTRUCTIONS_FX3A_HPP
+
+#include "base_system/Instructions/Instruction.hpp"
+
+namespace CHIP8::XOCHIP::Instructions
+{
+	/**
+	 * @brief Set the pitch of the audio pattern to VX
+	 * 
+	 * This class represents the instruction to set the rate the audio pattern is played back at.
+	 */
+	class IFX3A :
+		public CHIP8::Instructions::Instruction,
+		public std::enable_shared_from_this<IFX3A>
+	{
+		uint8_t registerVX;
+	public:
+		/**
+		 * @brief Execute the instruction to set the pitch
+		 * 
+		 * This function sets the pitch to VX, the pattern plays at 4000 * 2^((VX - 64) / 48) bits per second.
+		 * 
+		 * @param CPU 	Pointer to the CPU object
+		 * @return bool (true) : Notify the CPU that the instruction was executed
+		 */
+		bool Execute(CHIP8::CPU *cpu) override {
+			cpu->GetTimers()->SetPitch(cpu->GetRegister(registerVX));
+			return true;
+		}
+
+		/**
+		 * @brief Returns the mnemonic for the set pitch instruction
+		 * 
+		 * @return std::string (PITCH Vx) : Returns the mnemonic for the set pitch instruction
+		 */
+		std::string GetMnemonic() override {
+			return std::format("PITCH V{:X}", registerVX);
+		}
+
+		/**
+		 * @brief Returns the description for the set pitch instruction
+		 * 
+		 * @return std::string (Set the pitch of the audio pattern to Vx) : Returns the description for the set pitch instruction
+		 */
+		std::string GetDescription() override {
+			return std::format("Set the pitch of the audio pattern to V{:X}", registerVX);
+		}
+
+		/**
+		 * @brief Returns the opcode and mask for the set pitch instruction
+		 * 
+		 * @return InstructionInfo_t (0xF03A, 0xF0FF) : Returns the opcode and mask for the set pitch instruction
+		 */
+		InstructionInfo_t GetInfo() override {
+			return {0xF03A, 0xF0FF};
+		}
+
+		/**
+		 * @brief Update the instruction with the opcode
+		 * 
+		 * @param opcode : The opcode to update the instruction with
+		 * @return std::shared_ptr<CHIP8::Instructions::Instruction> : Returns the updated instruction
+		 */
+		std::shared_ptr<CHIP8::Instructions::Instruction> Update(uint16_t opcode) override {
+			registerVX = (opcode & 0x0F00) >> 8;
+			return shared_from_this();
+		}
+	};
+}
+
+#endif /* XOCHIP_INSTRUCTIONS_FX3A_HPP */
@@ -0,0 +1,65 @@
+#ifndef XOCHIP_INSTRUCTIONS_INSTRUCTIONLIST_HPP
+#define XOCHIP_INSTRUCTIONS_INSTRUCTIONLIST_HPP
+
+/** @brief XO-CHIP instruction list
+ *
+ * This file contains a list of all XO-CHIP instructions
+ * that extend or replace the CHIP-8 and SCHIP-8 instructions.
+ */
+
+#include "base_system/Instructions/Instruction.hpp"
+#include "base_system/Instructions/3XKK.hpp"
+#include "base_system/Instructions/4XKK.hpp"
+#include "base_system/Instructions/5XY0.hpp"
+#include "base_system/Instructions/9XY0.hpp"
+#include "base_system/Instructions/EX9E.hpp"
+#include "base_system/Instructions/EXA1.hpp"
+#include "00DN.hpp"
+#include "00E0.hpp"
+#include "5XY2.hpp"
+#include "5XY3.hpp"
+#include "DXYN.hpp"
+#include "F000.hpp"
+#include "F002.hpp"
+#include "FN01.hpp"
+#include "FX3A.hpp"
+#include "LongSkip.hpp"
+
+namespace CHIP8::XOCHIP::Instructions
+{
+	class InstructionList
+	{
+	public:
+		/** @brief Number of instructions in the list */
+		static constexpr int INSTRUCTION_COUNT = 15;
+
+		/** @brief Get an instruction by its index
+		 *
+		 * @param instr Index of the instruction
+		 * @return Pointer to the instruction
+		 */
+		static std::shared_ptr<CHIP8::Instructions::Instruction> GetInstruction(int instr) {
+			if (instr >= INSTRUCTION_COUNT) return nullptr;
+			switch(instr) {
+				case 0: return std::make_shared<I00DN>();
+				case 1: return std::make_shared<I00E0>();
+				case 2: return std::make_shared<I5XY2>();
+				case 3: return std::make_shared<I5XY3>();
+				case 4: return std::make_shared<IDXYN>();
+				case 5: return std::make_shared<IF000>();
+				case 6: return std::make_shared<IFN01>();
+				case 7: return std::make_shared<ILongSkip<CHIP8::Instructions::I3XKK>>();
+				case 8: return std::make_shared<ILongSkip<CHIP8::Instructions::I4XKK>>();
+				case 9: return std::make_shared<ILongSkip<CHIP8::Instructions::I5XY0>>();
+				case 10: return std::make_shared<ILongSkip<CHIP8::Instructions::I9XY0>>();
+				case 11: return std::make_shared<ILongSkip<CHIP8::Instructions::IEX9E>>();
+				case 12: return std::make_shared<ILongSkip<CHIP8::Instructions::IEXA1>>();
+				case 13: return std::make_shared<IF002>();
+				case 14: return std::make_shared<IFX3A>();
+			}
+			return nullptr;
+		}
+	};
+}
+
+#endif /* XOCHIP_INSTRUCTIONS_INSTRUCTIONLIST_HPP */
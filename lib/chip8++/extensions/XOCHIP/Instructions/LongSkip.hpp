@@ -0,0 +1,44 @@
+// Skip instructions stepping over the whole four byte F000 NNNN instruction
+#ifndef XOCHIP_INSTRUCTIONS_LONGSKIP_HPP
+#define XOCHIP_INSTRUCTIONS_LONGSKIP_HPP
+
+#include "base_system/Instructions/Instruction.hpp"
+
+namespace CHIP8::XOCHIP::Instructions
+{
+	/**
+	 * @brief Skip instruction aware of the four byte F000 NNNN instruction
+	 * 
+	 * This class wraps one of the CHIP-8 skip instructions. If the wrapped instruction skips and
+	 * the skipped instruction is F000 NNNN, the address word following it gets skipped as well.
+	 * 
+	 * @tparam SkipInstruction CHIP-8 skip instruction to wrap
+	 */
+	template <class SkipInstruction>
+	class ILongSkip : public SkipInstruction
+	{
+	public:
+		/**
+		 * @brief Execute the wrapped skip instruction
+		 * 
+		 * @param CPU 	Pointer to the CPU object
+		 * @return bool : Returns the result of the wrapped instruction
+		 */
+		bool Execute(CHIP8::CPU *cpu) override {
+			const uint16_t NextPC = cpu->GetPC();
+			const bool result = SkipInstruction::Execute(cpu);
+
+			if (cpu->GetPC() == uint16_t(NextPC + 2))
+			{
+				auto skipped = cpu->GetMemory()->GetWord(NextPC);
+				if (skipped && skipped.value() == 0xF000)
+				{
+					cpu->SetPC(uint16_t(NextPC + 4));
+				}
+			}
+			return result;
+		}
+	};
+}
+
+#endif /* XOCHIP_INSTRUCTIONS_LONGSKIP_HPP */
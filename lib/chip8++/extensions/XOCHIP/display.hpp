@@ -0,0 +1,156 @@
+#ifndef XOCHIP_DISPLAY_HPP
+#define XOCHIP_DISPLAY_HPP
+
+#include <cstdint>
+#include <memory>
+#include <algorithm>
+#include "extensions/SCHIP8/display.hpp"
+
+namespace CHIP8::XOCHIP
+{
+	/**
+	 * @brief XO-CHIP Display
+	 *
+	 * This class represents the display of the XO-CHIP system, the SCHIP-8
+	 * display with two bit planes. The colour of a pixel is made up of its bit
+	 * in both planes, drawing and scrolling only affect the selected planes.
+	 *
+	 * Both planes of a row are next to each other in the display buffer, a
+	 * sprite row gets drawn to the second plane RowWords words after the first.
+	 *
+	 * @see CHIP8::SCHIP8::SCHIP8Display
+	 */
+	class XOCHIPDisplay : public CHIP8::SCHIP8::SCHIP8Display
+	{
+	protected:
+		/** @brief Number of bit planes
+		 *
+		 * This constant represents the number of bit planes of the display.
+		 */
+		static constexpr int PLANES = 2;
+
+		/** @brief Selected Planes
+		 *
+		 * Bit n is set if instructions draw to bit plane n, plane 0 after a reset.
+		 */
+		uint8_t selectedPlanes = 1;
+	public:
+		/**
+		 * @brief Construct a new XO-CHIP Display object
+		 *
+		 * This constructor initializes the display buffer.
+		 */
+		XOCHIPDisplay() : SCHIP8Display(DisplayCapability::XOCHIP, PLANES) {}
+
+		/**
+		 * @brief Create a headless XO-CHIP display
+		 *
+		 * @return std::shared_ptr<Display> : The headless display
+		 */
+		std::shared_ptr<Display> CreateHeadless() const override;
+
+		/**
+		 * @brief Select the bit planes instructions draw to
+		 *
+		 * @param mask Bit n selects bit plane n, bits past the second plane are ignored
+		 */
+		void SelectPlanes(uint8_t mask) override
+		{
+			selectedPlanes = mask & ((1 << PLANES) - 1);
+		}
+
+		/**
+		 * @brief Get the bit planes instructions draw to
+		 *
+		 * @return uint8_t : Bit n is set if bit plane n is selected
+		 */
+		uint8_t GetSelectedPlanes() override
+		{
+			return selectedPlanes;
+		}
+
+		/**
+		 * @brief Clear the selected bit planes
+		 *
+		 * This function clears the selected planes and leaves the others as they are.
+		 */
+		void ClearSelected()
+		{
+			if (selectedPlanes == (1 << PLANES) - 1)
+			{
+				Clear();
+				return;
+			}
+
+			DetachBuffer();
+			for (int plane = 0; plane < PLANES; plane++)
+			{
+				if (!(selectedPlanes & (1 << plane)))
+					continue;
+				for (int y = 0; y < Height; y++)
+				{
+					std::fill_n(GetRow(y, plane), RowWords, 0);
+				}
+			}
+			RehashBuffer();
+			UpdateRequired = true;
+		}
+
+		/**
+		 * @brief Scroll Up N Lines
+		 *
+		 * This function scrolls the display up by N lines of the current mode.
+		 *
+		 * @param lines Number of lines to scroll up
+		 * @param planeMask Bit planes to scroll, all of them by default
+		 */
+		void ScrollUp(int lines, uint8_t planeMask = 0xFF)
+		{
+			const int rows = std::min(lines * GetScale(), Height);
+			DetachBuffer();
+
+			for (int plane = 0; plane < PLANES; plane++)
+			{
+				if (!(planeMask & (1 << plane)))
+					continue;
+				for (int y = 0; y < Height; y++)
+				{
+					uint64_t *row = GetRow(y, plane);
+					if (y + rows < Height)
+						std::copy_n(GetRow(y + rows, plane), RowWords, row);
+					else
+						std::fill_n(row, RowWords, 0);
+				}
+			}
+			RehashBuffer();
+			UpdateRequired = true;
+		}
+	};
+
+	/**
+	 * @brief Headless XO-CHIP Display
+	 *
+	 * This class represents a XO-CHIP display without any output, useful for
+	 * batch runs and other headless hosts.
+	 */
+	class HeadlessXOCHIPDisplay : public XOCHIPDisplay
+	{
+	public:
+		/**
+		 * @brief Update the display
+		 *
+		 * Nothing to show, only clears the Update Required flag.
+		 */
+		void Update() override
+		{
+			UpdateRequired = false;
+		}
+	};
+
+	inline std::shared_ptr<Display> XOCHIPDisplay::CreateHeadless() const
+	{
+		return std::make_shared<HeadlessXOCHIPDisplay>();
+	}
+}
+
+#endif // XOCHIP_DISPLAY_HPP
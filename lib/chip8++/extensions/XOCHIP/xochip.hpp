@@ -0,0 +1,47 @@
+#ifndef XOCHIP_XOCHIP_HPP
+#define XOCHIP_XOCHIP_HPP
+
+#include <memory>
+#include "base_system/memory.hpp"
+#include "extensions/SCHIP8/schip8.hpp"
+#include "extensions/XOCHIP/display.hpp"
+#include "extensions/XOCHIP/Instructions/InstructionList.hpp"
+
+namespace CHIP8::XOCHIP
+{
+	/** @brief XO-CHIP address space, 64 KiB */
+	constexpr size_t MEMORY_SIZE = 0x10000;
+
+	/**
+	 * @brief Create an instruction decoder for XO-CHIP
+	 * 
+	 * This function registers the SCHIP-8 instructions first and the XO-CHIP
+	 * instructions on top, replacing the clear, draw and skip instructions.
+	 * The CPU using the decoder needs a XOCHIPDisplay and the memory from
+	 * CreateMemory().
+	 * 
+	 * @return std::shared_ptr<InstructionDecoder> : Decoder to construct the CPU with
+	 */
+	inline std::shared_ptr<InstructionDecoder> CreateDecoder()
+	{
+		auto decoder = CHIP8::SCHIP8::CreateDecoder();
+		for (int i = 0; i < Instructions::InstructionList::INSTRUCTION_COUNT; i++)
+		{
+			decoder->RegisterInstruction(Instructions::InstructionList::GetInstruction(i));
+		}
+		decoder->RequireDisplay(DisplayCapability::XOCHIP);
+		return decoder;
+	}
+
+	/**
+	 * @brief Create the 64 KiB memory of XO-CHIP
+	 * 
+	 * @return std::shared_ptr<Memory> : Memory to construct the CPU with
+	 */
+	inline std::shared_ptr<Memory> CreateMemory()
+	{
+		return std::make_shared<Memory>(MEMORY_SIZE);
+	}
+}
+
+#endif /* XOCHIP_XOCHIP_HPP */
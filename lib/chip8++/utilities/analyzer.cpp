@@ -0,0 +1,403 @@
+#include <algorithm>
+#include "analyzer.hpp"
+#include "cpu.hpp"
+
+using namespace CHIP8;
+
+namespace
+{
+	/** @brief Highest value of the 16 bit index register */
+	constexpr uint32_t INDEX_MAX = 0xFFFF;
+
+	/** @brief Number of times a block state may grow before it is widened */
+	constexpr unsigned WIDEN_AFTER = 8;
+}
+
+size_t RomAnalyzer::BlockIndex(uint16_t address) const
+{
+	const ControlFlowGraph::BasicBlock_t *block = graph.FindBlock(address);
+	return size_t(block - graph.GetBlocks().data());
+}
+
+void RomAnalyzer::BuildSubroutines()
+{
+	const auto &blocks = graph.GetBlocks();
+	const auto &edges = graph.GetEdges();
+
+	// The entry point is the outermost subroutine, every call target another one
+	std::vector<uint16_t> starts = {uint16_t(romStart)};
+	for (const auto &edge : edges)
+	{
+		if (edge.kind == ControlFlowGraph::EDGE_CALL)
+		{
+			starts.push_back(edge.to);
+		}
+	}
+	std::sort(starts.begin() + 1, starts.end());
+	starts.erase(std::unique(starts.begin() + 1, starts.end()), starts.end());
+	if (starts.size() > 1 && std::binary_search(starts.begin() + 1, starts.end(), starts[0]))
+	{
+		starts.erase(std::lower_bound(starts.begin() + 1, starts.end(), starts[0]));
+	}
+
+	auto findSubroutine = [&starts](uint16_t address) -> uint32_t {
+		if (address == starts[0])
+		{
+			return 0;
+		}
+		return uint32_t(std::lower_bound(starts.begin() + 1, starts.end(), address) - starts.begin());
+	};
+
+	subroutines.resize(starts.size());
+	for (size_t i = 0; i < starts.size(); i++)
+	{
+		subroutines[i].start = starts[i];
+		subroutines[i].blocks.clear();
+		subroutines[i].callees.clear();
+		subroutines[i].returnSites.clear();
+	}
+
+	// Collect the blocks reachable from every start without following calls
+	std::vector<uint32_t> visited(blocks.size(), 0);
+	std::vector<uint32_t> stack;
+	for (uint32_t i = 0; i < subroutines.size(); i++)
+	{
+		Subroutine_t &subroutine = subroutines[i];
+		if (!graph.IsInstruction(subroutine.start))
+		{
+			continue;
+		}
+		stack.assign(1, uint32_t(BlockIndex(subroutine.start)));
+		visited[stack[0]] = i + 1;
+
+		while (!stack.empty())
+		{
+			const uint32_t block = stack.back();
+			stack.pop_back();
+			subroutine.blocks.push_back(block);
+
+			auto edge = std::lower_bound(edges.begin(), edges.end(), block,
+				[](const ControlFlowGraph::Edge_t &entry, uint32_t value) { return entry.fromBlock < value; });
+			for (; edge != edges.end() && edge->fromBlock == block; edge++)
+			{
+				if (edge->kind == ControlFlowGraph::EDGE_CALL)
+				{
+					const uint32_t callee = findSubroutine(edge->to);
+					subroutine.callees.push_back(callee);
+					if (graph.IsInstruction(blocks[block].end))
+					{
+						subroutines[callee].returnSites.push_back(blocks[block].end);
+					}
+					continue;
+				}
+
+				const uint32_t target = uint32_t(BlockIndex(edge->to));
+				if (visited[target] != i + 1)
+				{
+					visited[target] = i + 1;
+					stack.push_back(target);
+				}
+			}
+		}
+	}
+
+	// Successors of every block, returns continue at the return sites of their subroutine
+	successors.resize(blocks.size());
+	for (auto &list : successors)
+	{
+		list.clear();
+	}
+	for (const auto &edge : edges)
+	{
+		successors[edge.fromBlock].push_back(uint32_t(BlockIndex(edge.to)));
+	}
+	for (uint32_t i = 0; i < subroutines.size(); i++)
+	{
+		for (uint32_t block : subroutines[i].blocks)
+		{
+			const auto &last = blocks[block];
+			const DecodedOp op = DecodedOp::Decode(uint16_t((image[last.end - 2] << 8) | image[last.end - 1]));
+			if (op.GetFlow() != DecodedOp::FLOW_RETURN)
+			{
+				continue;
+			}
+			if (i == 0)
+			{
+				report.findings.push_back({FINDING_STACK_UNDERFLOW, uint16_t(last.end - 2), 0, 0});
+			}
+			for (uint16_t site : subroutines[i].returnSites)
+			{
+				successors[block].push_back(uint32_t(BlockIndex(site)));
+			}
+		}
+	}
+}
+
+void RomAnalyzer::CheckCallDepth()
+{
+	enum : uint8_t { UNVISITED = 0, ACTIVE, DONE };
+	std::vector<uint8_t> color(subroutines.size(), UNVISITED);
+	std::vector<unsigned> depth(subroutines.size(), 0);
+	bool recursion = false;
+
+	// Iterative depth first search, frames are (subroutine, next callee)
+	std::vector<std::pair<uint32_t, size_t>> frames = {{0, 0}};
+	color[0] = ACTIVE;
+	while (!frames.empty())
+	{
+		auto &[subroutine, next] = frames.back();
+		if (next < subroutines[subroutine].callees.size())
+		{
+			const uint32_t callee = subroutines[subroutine].callees[next++];
+			if (color[callee] == ACTIVE)
+			{
+				if (!recursion)
+				{
+					report.findings.push_back({FINDING_RECURSION, subroutines[callee].start, 0, 0});
+				}
+				recursion = true;
+			}
+			else if (color[callee] == UNVISITED)
+			{
+				color[callee] = ACTIVE;
+				frames.push_back({callee, 0});
+			}
+			continue;
+		}
+
+		for (uint32_t callee : subroutines[subroutine].callees)
+		{
+			depth[subroutine] = std::max(depth[subroutine], depth[callee] + 1);
+		}
+		color[subroutine] = DONE;
+		frames.pop_back();
+	}
+
+	report.callDepth = depth[0];
+	report.callDepthBounded = !recursion;
+	if (depth[0] > CPU::GetStackDepth())
+	{
+		report.findings.push_back({FINDING_STACK_OVERFLOW, subroutines[0].start, depth[0], 0});
+	}
+}
+
+void RomAnalyzer::CheckAccess(uint16_t address, const Interval_t &state, uint32_t length, bool write)
+{
+	const uint32_t first = state.low;
+	const uint32_t last = state.high + length - 1;
+
+	if (last >= image.size())
+	{
+		report.findings.push_back({FINDING_INDEX_OUT_OF_BOUNDS, address, first, last});
+	}
+	if (write && first < image.size())
+	{
+		const size_t end = std::min<size_t>(last + 1, image.size());
+		if (codePrefix[end] != codePrefix[first])
+		{
+			report.findings.push_back({FINDING_SELF_MODIFYING, address, first, last});
+		}
+	}
+}
+
+RomAnalyzer::Interval_t RomAnalyzer::Transfer(uint32_t block, Interval_t state, const Quirks &quirks, bool check)
+{
+	const auto &range = graph.GetBlocks()[block];
+	for (uint32_t address = range.start; address < range.end; address += 2)
+	{
+		const DecodedOp op = DecodedOp::Decode(uint16_t((image[address] << 8) | image[address + 1]));
+		uint32_t increment = 0;
+
+		switch (op.operation)
+		{
+			case DecodedOp::OP_ANNN:
+				state.low = state.high = op.nnn;
+				break;
+			case DecodedOp::OP_FX1E:
+				state.high += 0xFF;
+				break;
+			case DecodedOp::OP_FX29:
+				state.low = fontStart;
+				state.high = fontStart + 15 * 5;
+				break;
+			case DecodedOp::OP_FX33:
+				if (check)
+				{
+					CheckAccess(uint16_t(address), state, 3, true);
+				}
+				break;
+			case DecodedOp::OP_FX55:
+			case DecodedOp::OP_FX65:
+				if (check)
+				{
+					CheckAccess(uint16_t(address), state, op.x + 1u, op.operation == DecodedOp::OP_FX55);
+				}
+				if (!quirks.MemoryLeaveIunchanged)
+				{
+					increment = quirks.MemoryIncrementByX ? op.x : op.x + 1u;
+				}
+				break;
+			case DecodedOp::OP_DXYN:
+				if (check && op.n > 0)
+				{
+					CheckAccess(uint16_t(address), state, op.n, false);
+				}
+				break;
+			default:
+				break;
+		}
+
+		state.low += increment;
+		state.high += increment;
+		// The register wraps around, any value is possible then
+		if (state.high > INDEX_MAX)
+		{
+			state.low = 0;
+			state.high = INDEX_MAX;
+		}
+	}
+	return state;
+}
+
+const RomAnalyzer::Report_t &RomAnalyzer::Analyze(Memory &memory, size_t romSize, const Quirks &quirks)
+{
+	image.resize(memory.GetSize());
+	memory.GetBytes(0, image);
+	romStart = memory.GetRomStart();
+	fontStart = memory.GetFontStart();
+
+	report.findings.clear();
+	report.unreached.clear();
+	report.codeBytes = 0;
+
+	graph.Analyze(image, romStart);
+	const auto &blocks = graph.GetBlocks();
+
+	codePrefix.resize(image.size() + 1);
+	codePrefix[0] = 0;
+	for (size_t address = 0; address < image.size(); address++)
+	{
+		codePrefix[address + 1] = codePrefix[address] + (graph.IsCode(address) ? 1 : 0);
+	}
+
+	for (uint16_t address : graph.GetIndirectJumps())
+	{
+		report.findings.push_back({FINDING_COMPUTED_JUMP, address, 0, 0});
+	}
+	BuildSubroutines();
+	CheckCallDepth();
+
+	// Propagate the range of I to a fixed point, the CPU starts with I = 0
+	entryStates.assign(blocks.size(), Interval_t{0, 0, false});
+	updates.assign(blocks.size(), 0);
+	std::vector<uint32_t> worklist;
+	if (!blocks.empty() && graph.IsInstruction(romStart))
+	{
+		const uint32_t entry = uint32_t(BlockIndex(uint16_t(romStart)));
+		entryStates[entry] = {0, 0, true};
+		worklist.push_back(entry);
+	}
+	while (!worklist.empty())
+	{
+		const uint32_t block = worklist.back();
+		worklist.pop_back();
+		const Interval_t exit = Transfer(block, entryStates[block], quirks, false);
+
+		for (uint32_t successor : successors[block])
+		{
+			Interval_t &state = entryStates[successor];
+			Interval_t merged = state.reached ? Interval_t{std::min(state.low, exit.low), std::max(state.high, exit.high), true} : exit;
+			if (state.reached && merged.low == state.low && merged.high == state.high)
+			{
+				continue;
+			}
+
+			// Widen growing ranges of loops to the limits
+			if (state.reached && ++updates[successor] > WIDEN_AFTER)
+			{
+				merged.low = (merged.low < state.low) ? 0 : merged.low;
+				merged.high = (merged.high > state.high) ? INDEX_MAX : merged.high;
+			}
+			state = merged;
+			worklist.push_back(successor);
+		}
+	}
+
+	for (uint32_t block = 0; block < blocks.size(); block++)
+	{
+		if (entryStates[block].reached)
+		{
+			Transfer(block, entryStates[block], quirks, true);
+		}
+	}
+	std::stable_sort(report.findings.begin(), report.findings.end(),
+		[](const Finding_t &a, const Finding_t &b) { return a.address < b.address; });
+
+	// Bytes of the ROM never reached as code: data or dead code
+	const size_t romEnd = std::min(romStart + romSize, image.size());
+	for (size_t address = romStart; address < romEnd; address++)
+	{
+		if (graph.IsCode(address))
+		{
+			report.codeBytes++;
+		}
+		else if (!report.unreached.empty() && report.unreached.back().second == address - 1)
+		{
+			report.unreached.back().second = uint16_t(address);
+		}
+		else
+		{
+			report.unreached.push_back({uint16_t(address), uint16_t(address)});
+		}
+	}
+
+	// Code that is written to would keep the predecoded engine decoding it again
+	report.engine = EngineKind::Predecoded;
+	for (const Finding_t &finding : report.findings)
+	{
+		if (finding.kind == FINDING_SELF_MODIFYING)
+		{
+			report.engine = EngineKind::Reference;
+			break;
+		}
+	}
+	return report;
+}
+
+void RomAnalyzer::WriteReport(TextBuffer &out) const
+{
+	static constexpr std::string_view descriptions[] = {
+		"write can modify code", "access can leave memory", "computed jump",
+		"recursive subroutine", "call depth exceeds the stack", "return outside of a subroutine"
+	};
+
+	out.Put("engine: ").Put(ENGINE_NAMES[size_t(report.engine)]).Put('\n');
+	out.Put("code: ").PutDecimal(uint32_t(report.codeBytes)).Put(" bytes, call depth ");
+	if (report.callDepthBounded)
+	{
+		out.PutDecimal(report.callDepth).Put('\n');
+	}
+	else
+	{
+		out.Put("unbounded\n");
+	}
+
+	for (const Finding_t &finding : report.findings)
+	{
+		out.Put("0x").PutHex(finding.address, 3).Put(": ").Put(descriptions[finding.kind]);
+		if (finding.kind == FINDING_SELF_MODIFYING || finding.kind == FINDING_INDEX_OUT_OF_BOUNDS)
+		{
+			out.Put(" (0x").PutHex(finding.first, 3).Put("-0x").PutHex(finding.last, 3).Put(')');
+		}
+		else if (finding.kind == FINDING_STACK_OVERFLOW)
+		{
+			out.Put(" (").PutDecimal(finding.first).Put(')');
+		}
+		out.Put('\n');
+	}
+
+	for (const auto &[first, last] : report.unreached)
+	{
+		out.Put("unreached: 0x").PutHex(first, 3).Put("-0x").PutHex(last, 3).Put('\n');
+	}
+}
@@ -0,0 +1,165 @@
+#ifndef _CHIP8_ANALYZER_HPP_
+#define _CHIP8_ANALYZER_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <string_view>
+#include "memory.hpp"
+#include "quirks.hpp"
+#include "disassembler.hpp"
+
+namespace CHIP8
+{
+	/**
+	 * @brief Engine Kind
+	 *
+	 * Execution engines ordered from the most general to the fastest. A faster
+	 * engine only pays off for some ROMs.
+	 */
+	enum class EngineKind : uint8_t
+	{
+		Reference = 0,	/**< CPU::RunCycle(), runs any ROM */
+		Predecoded		/**< PredecodedEngine, base CHIP-8 only, code that is written to gets decoded again */
+	};
+
+	/** @brief Names of the engine kinds, indexed by EngineKind */
+	inline constexpr std::string_view ENGINE_NAMES[] = { "reference", "predecoded" };
+
+	/**
+	 * @brief ROM Analyzer
+	 *
+	 * This class statically analyzes a ROM loaded into Memory. It recovers the
+	 * control flow graph and tracks the range the index register I can hold at
+	 * every instruction (interval analysis across jumps, calls and returns), to
+	 * find FX33/FX55 writes that can land in code, accesses through I beyond the
+	 * memory, computed BNNN jumps and the call depth. From the findings it picks
+	 * the engine that runs the ROM fastest.
+	 *
+	 * The analysis is conservative: a finding means the ROM may do it, not that it
+	 * does. The storage is reused between ROMs.
+	 */
+	class RomAnalyzer
+	{
+	public:
+		/**
+		 * @brief Finding Kind
+		 *
+		 * Properties of a ROM that restrict the engines it can run on.
+		 */
+		enum FindingKind : uint8_t
+		{
+			FINDING_SELF_MODIFYING = 0,		/**< A write through I can land in code */
+			FINDING_INDEX_OUT_OF_BOUNDS,	/**< An access through I can go beyond the memory */
+			FINDING_COMPUTED_JUMP,			/**< BNNN jumps to a computed address */
+			FINDING_RECURSION,				/**< A subroutine can call itself, the call depth is unbounded */
+			FINDING_STACK_OVERFLOW,			/**< The call depth can exceed the stack depth */
+			FINDING_STACK_UNDERFLOW			/**< RET outside of any subroutine */
+		};
+
+		/**
+		 * @brief Finding
+		 *
+		 * A finding at an instruction.
+		 */
+		typedef struct
+		{
+			FindingKind kind;	/**< What was found */
+			uint16_t address;	/**< Address of the instruction */
+			uint32_t first;		/**< First address the instruction can access, or the call depth */
+			uint32_t last;		/**< Last address the instruction can access */
+		} Finding_t;
+
+		/**
+		 * @brief Report
+		 *
+		 * Result of the analysis of a ROM.
+		 */
+		typedef struct
+		{
+			std::vector<Finding_t> findings;							/**< Findings, sorted by address */
+			std::vector<std::pair<uint16_t, uint16_t>> unreached;		/**< ROM ranges [first, last] never reached as code */
+			size_t codeBytes;											/**< Number of ROM bytes reached as code */
+			unsigned callDepth;											/**< Maximum call depth, if bounded */
+			bool callDepthBounded;										/**< False if subroutines can recurse */
+			EngineKind engine;											/**< Engine that runs the ROM fastest */
+		} Report_t;
+
+		/**
+		 * @brief Analyze a ROM
+		 *
+		 * @param memory : Memory the ROM is loaded in
+		 * @param romSize : Size of the ROM in bytes
+		 * @param quirks : Quirks the ROM runs with, FX55/FX65 change I depending on them
+		 * @return const Report_t& : The report, valid until the next analysis
+		 */
+		const Report_t &Analyze(Memory &memory, size_t romSize, const Quirks &quirks);
+
+		/**
+		 * @brief Get the control flow graph of the last analysis
+		 *
+		 * @return const ControlFlowGraph& : The graph
+		 */
+		const ControlFlowGraph &GetGraph() const
+		{
+			return graph;
+		}
+
+		/**
+		 * @brief Write the report as text
+		 *
+		 * @param out : Buffer to append the report to
+		 */
+		void WriteReport(TextBuffer &out) const;
+	private:
+		/**
+		 * @brief Interval
+		 *
+		 * Range of values the index register can hold.
+		 */
+		typedef struct
+		{
+			uint32_t low;
+			uint32_t high;
+			bool reached;
+		} Interval_t;
+
+		/**
+		 * @brief Subroutine
+		 *
+		 * Code reachable from a call target without following calls.
+		 */
+		typedef struct
+		{
+			uint16_t start;					/**< Address of the subroutine */
+			std::vector<uint32_t> blocks;	/**< Indices of its blocks */
+			std::vector<uint32_t> callees;	/**< Indices of the subroutines it calls */
+			std::vector<uint16_t> returnSites;	/**< Addresses its callers continue at */
+		} Subroutine_t;
+
+		std::vector<uint8_t> image;
+		ControlFlowGraph graph;
+		Report_t report;
+
+		std::vector<Interval_t> entryStates;
+		std::vector<unsigned> updates;
+		std::vector<Subroutine_t> subroutines;
+
+		/** @brief Successor block indices per block, including the returns */
+		std::vector<std::vector<uint32_t>> successors;
+
+		/** @brief Number of code bytes below each address */
+		std::vector<uint32_t> codePrefix;
+
+		uint16_t romStart = 0;
+		uint16_t fontStart = 0;
+
+		size_t BlockIndex(uint16_t address) const;
+		void BuildSubroutines();
+		void CheckCallDepth();
+		Interval_t Transfer(uint32_t block, Interval_t state, const Quirks &quirks, bool check);
+		void CheckAccess(uint16_t address, const Interval_t &state, uint32_t length, bool write);
+	};
+}
+
+#endif /* _CHIP8_ANALYZER_HPP_ */
@@ -0,0 +1,353 @@
+#include "archive.hpp"
+#include "inflate.hpp"
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <format>
+
+using namespace CHIP8;
+
+namespace
+{
+	constexpr uint32_t ZIP_LOCAL_HEADER		= 0x04034B50;
+	constexpr uint32_t ZIP_CENTRAL_HEADER	= 0x02014B50;
+	constexpr uint32_t ZIP_END_OF_DIRECTORY	= 0x06054B50;
+	constexpr size_t ZIP_END_SIZE			= 22;
+	constexpr size_t ZIP_CENTRAL_SIZE		= 46;
+	constexpr size_t ZIP_LOCAL_SIZE			= 30;
+
+	constexpr size_t TAR_BLOCK_SIZE			= 512;
+
+	uint32_t GetLittle(std::span<const uint8_t> data, size_t offset, size_t bytes)
+	{
+		uint32_t value = 0;
+		for (size_t i = 0; i < bytes; i++)
+		{
+			value |= uint32_t(data[offset + i]) << (8 * i);
+		}
+		return value;
+	}
+
+	/**
+	 * @brief Parse a tar octal field, terminated by a space or NUL
+	 */
+	bool GetOctal(std::span<const uint8_t> field, size_t &value)
+	{
+		value = 0;
+		size_t position = 0;
+		while (position < field.size() && field[position] == ' ')
+		{
+			position++;
+		}
+		for (; position < field.size() && field[position] >= '0' && field[position] <= '7'; position++)
+		{
+			value = value * 8 + (field[position] - '0');
+		}
+		return position == field.size() || field[position] == ' ' || field[position] == '\0';
+	}
+
+	std::string GetString(std::span<const uint8_t> field)
+	{
+		const auto end = std::find(field.begin(), field.end(), uint8_t(0));
+		return std::string(field.begin(), end);
+	}
+
+	/**
+	 * @brief Get the path of a pax extended header, empty if it has none
+	 *
+	 * Every record reads "<length> <keyword>=<value>\n", the length counts the whole record.
+	 */
+	std::string GetPaxPath(std::span<const uint8_t> records)
+	{
+		std::string path;
+		for (size_t position = 0; position < records.size(); )
+		{
+			size_t length = 0, digits = position;
+			for (; digits < records.size() && records[digits] >= '0' && records[digits] <= '9'; digits++)
+			{
+				length = length * 10 + (records[digits] - '0');
+			}
+			if (digits == position || digits >= records.size() || records[digits] != ' ' ||
+				length <= digits - position + 1 || length > records.size() - position || records[position + length - 1] != '\n')
+			{
+				break;
+			}
+
+			const std::string_view record(reinterpret_cast<const char *>(records.data()) + digits + 1, length - (digits - position) - 2);
+			if (record.starts_with("path="))
+			{
+				path = record.substr(5);
+			}
+			position += length;
+		}
+		return path;
+	}
+}
+
+std::expected<void, std::string> RomArchive::Open(const std::string &path)
+{
+	auto mapped = file.Open(path);
+	if (!mapped)
+	{
+		data = {};
+		entries.clear();
+		return mapped;
+	}
+
+	auto opened = Open(file.GetData());
+	if (!opened)
+	{
+		return std::unexpected(std::format("{}: {}", path, opened.error()));
+	}
+	return opened;
+}
+
+std::expected<void, std::string> RomArchive::Open(std::span<const uint8_t> content)
+{
+	data = content;
+	entries.clear();
+
+	auto result = (data.size() >= 4 && GetLittle(data, 0, 4) == ZIP_LOCAL_HEADER) ? ReadZip() :
+		(data.size() >= ZIP_END_SIZE && GetLittle(data, data.size() - ZIP_END_SIZE, 4) == ZIP_END_OF_DIRECTORY) ? ReadZip() : ReadTar();
+	if (!result)
+	{
+		entries.clear();
+		return result;
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const Entry_t &a, const Entry_t &b) { return a.name < b.name; });
+	return result;
+}
+
+std::expected<void, std::string> RomArchive::ReadZip()
+{
+	if (data.size() < ZIP_END_SIZE)
+	{
+		return std::unexpected("Zip archive truncated");
+	}
+
+	// The end of central directory record is followed by a comment of up to 64k
+	size_t end = data.size();
+	const size_t searchLimit = (data.size() > ZIP_END_SIZE + 0xFFFF) ? data.size() - ZIP_END_SIZE - 0xFFFF : 0;
+	for (size_t position = data.size() - ZIP_END_SIZE + 1; position-- > searchLimit; )
+	{
+		if (GetLittle(data, position, 4) == ZIP_END_OF_DIRECTORY)
+		{
+			end = position;
+			break;
+		}
+	}
+	if (end == data.size())
+	{
+		return std::unexpected("Zip end of central directory not found");
+	}
+
+	const size_t count = GetLittle(data, end + 10, 2);
+	const size_t directorySize = GetLittle(data, end + 12, 4);
+	size_t position = GetLittle(data, end + 16, 4);
+	if (count == 0xFFFF || position == 0xFFFFFFFF || position + directorySize > end)
+	{
+		return std::unexpected("Zip64 archives are not supported");
+	}
+
+	entries.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		if (position + ZIP_CENTRAL_SIZE > end || GetLittle(data, position, 4) != ZIP_CENTRAL_HEADER)
+		{
+			return std::unexpected("Zip central directory corrupt");
+		}
+
+		const uint32_t flags = GetLittle(data, position + 8, 2);
+		const uint32_t method = GetLittle(data, position + 10, 2);
+		const size_t nameLength = GetLittle(data, position + 28, 2);
+		const size_t extraLength = GetLittle(data, position + 30, 2);
+		const size_t commentLength = GetLittle(data, position + 32, 2);
+		const size_t localOffset = GetLittle(data, position + 42, 4);
+		if (position + ZIP_CENTRAL_SIZE + nameLength > end)
+		{
+			return std::unexpected("Zip central directory corrupt");
+		}
+
+		Entry_t entry;
+		entry.name.assign(data.begin() + std::ptrdiff_t(position + ZIP_CENTRAL_SIZE),
+			data.begin() + std::ptrdiff_t(position + ZIP_CENTRAL_SIZE + nameLength));
+		entry.crc = GetLittle(data, position + 16, 4);
+		entry.storedSize = GetLittle(data, position + 20, 4);
+		entry.size = GetLittle(data, position + 24, 4);
+		entry.deflated = (method == 8);
+		position += ZIP_CENTRAL_SIZE + nameLength + extraLength + commentLength;
+
+		// Stored data is copied as is, both sizes have to agree
+		if (method == 0 && entry.storedSize != entry.size)
+		{
+			return std::unexpected(std::format("Zip entry {} corrupt, stored size {} != size {}", entry.name, entry.storedSize, entry.size));
+		}
+
+		if (entry.name.empty() || entry.name.back() == '/')
+		{
+			continue;
+		}
+		if ((flags & 1) != 0 || (method != 0 && method != 8))
+		{
+			return std::unexpected(std::format("Zip entry {} is encrypted or uses an unsupported method", entry.name));
+		}
+
+		// The data follows the local header, whose extra field may differ from the central one
+		if (localOffset + ZIP_LOCAL_SIZE > data.size() || GetLittle(data, localOffset, 4) != ZIP_LOCAL_HEADER)
+		{
+			return std::unexpected(std::format("Zip local header of {} corrupt", entry.name));
+		}
+		entry.offset = localOffset + ZIP_LOCAL_SIZE + GetLittle(data, localOffset + 26, 2) + GetLittle(data, localOffset + 28, 2);
+		if (entry.offset + entry.storedSize > data.size())
+		{
+			return std::unexpected(std::format("Zip entry {} truncated", entry.name));
+		}
+		entries.push_back(std::move(entry));
+	}
+	return std::expected<void, std::string>();
+}
+
+std::expected<void, std::string> RomArchive::ReadTar()
+{
+	std::string longName;
+	for (size_t position = 0; position + TAR_BLOCK_SIZE <= data.size(); )
+	{
+		const auto header = data.subspan(position, TAR_BLOCK_SIZE);
+		if (std::all_of(header.begin(), header.end(), [](uint8_t byte) { return byte == 0; }))
+		{
+			// End of archive marker
+			return std::expected<void, std::string>();
+		}
+
+		size_t checksum, size;
+		if (!GetOctal(header.subspan(148, 8), checksum) || !GetOctal(header.subspan(124, 12), size))
+		{
+			return std::unexpected("Not a zip or tar archive");
+		}
+		size_t sum = 0;
+		for (size_t i = 0; i < TAR_BLOCK_SIZE; i++)
+		{
+			sum += (i >= 148 && i < 156) ? ' ' : header[i];
+		}
+		if (sum != checksum)
+		{
+			return std::unexpected("Not a zip or tar archive");
+		}
+
+		const size_t content = position + TAR_BLOCK_SIZE;
+		if (content + size > data.size())
+		{
+			return std::unexpected("Tar archive truncated");
+		}
+		position = content + (size + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE;
+
+		const uint8_t type = header[156];
+		if (type == 'L')
+		{
+			// GNU long name of the next entry
+			longName = GetString(data.subspan(content, size));
+			continue;
+		}
+		if (type == 'x')
+		{
+			// pax extended header of the next entry, only its path is used
+			longName = GetPaxPath(data.subspan(content, size));
+			continue;
+		}
+		if (type != '0' && type != '\0' && type != '7')
+		{
+			longName.clear();
+			continue;
+		}
+
+		Entry_t entry;
+		if (!longName.empty())
+		{
+			entry.name = std::move(longName);
+			longName.clear();
+		}
+		else
+		{
+			entry.name = GetString(header.subspan(0, 100));
+			const std::string prefix = GetString(header.subspan(345, 155));
+			if (std::equal(header.begin() + 257, header.begin() + 262, "ustar") && !prefix.empty())
+			{
+				entry.name = prefix + "/" + entry.name;
+			}
+		}
+		entry.offset = content;
+		entry.storedSize = size;
+		entry.size = size;
+		entry.crc = 0;
+		entry.deflated = false;
+		entries.push_back(std::move(entry));
+	}
+	return entries.empty() ? std::unexpected("Not a zip or tar archive") : std::expected<void, std::string>();
+}
+
+const RomArchive::Entry_t *RomArchive::Find(std::string_view name) const
+{
+	auto entry = std::lower_bound(entries.begin(), entries.end(), name,
+		[](const Entry_t &a, std::string_view value) { return a.name < value; });
+	return (entry != entries.end() && entry->name == name) ? &*entry : nullptr;
+}
+
+std::expected<size_t, std::string> RomArchive::Extract(const Entry_t &entry, std::span<uint8_t> out) const
+{
+	if (out.size() < entry.size)
+	{
+		return std::unexpected(std::format("{} too large: {} > {}", entry.name, entry.size, out.size()));
+	}
+
+	const auto stored = data.subspan(entry.offset, entry.storedSize);
+	size_t size = entry.storedSize;
+	if (!entry.deflated && stored.size() > out.size())
+	{
+		return std::unexpected(std::format("{} too large: {} > {}", entry.name, stored.size(), out.size()));
+	}
+	if (entry.deflated)
+	{
+		auto inflated = Inflate(stored, out.first(entry.size));
+		if (!inflated)
+		{
+			return std::unexpected(std::format("{}: {}", entry.name, inflated.error()));
+		}
+		size = inflated.value();
+	}
+	else
+	{
+		std::copy(stored.begin(), stored.end(), out.begin());
+	}
+
+	// Zip entries carry a checksum, tar headers only protect themselves
+	if (size != entry.size || (entry.crc != 0 && Crc32(out.first(size)) != entry.crc))
+	{
+		return std::unexpected(std::format("{} is corrupt", entry.name));
+	}
+	return size;
+}
+
+std::expected<void, std::string> RomArchive::LoadRom(std::string_view name, Memory &memory, uint16_t loadAddress) const
+{
+	const Entry_t *entry = Find(name);
+	if (entry == nullptr)
+	{
+		return std::unexpected(std::format("ROM not found in archive: {}", name));
+	}
+
+	// A ROM can at most fill the whole memory of the platform
+	std::vector<uint8_t> rom(memory.GetSize());
+	auto extracted = Extract(*entry, rom);
+	if (!extracted)
+	{
+		return std::unexpected(extracted.error());
+	}
+	auto loaded = memory.LoadRom(std::span<const uint8_t>(rom.data(), extracted.value()),
+		(loadAddress != 0) ? loadAddress : memory.GetRomStart());
+	if (!loaded)
+	{
+		return std::unexpected(DescribeMemoryFault(loaded.error()));
+	}
+	return std::expected<void, std::string>();
+}
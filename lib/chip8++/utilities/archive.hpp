@@ -0,0 +1,108 @@
+#ifndef _CHIP8_ARCHIVE_HPP_
+#define _CHIP8_ARCHIVE_HPP_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <expected>
+#include "memory.hpp"
+#include "mappedfile.hpp"
+
+namespace CHIP8
+{
+	/**
+	 * @brief ROM Archive
+	 *
+	 * This class reads ROMs straight out of a zip or tar archive. The archive is
+	 * memory-mapped (or given as a buffer) and indexed once, loading a ROM then
+	 * decompresses it into a buffer of the memory's size and copies it into
+	 * Memory, without extracting anything to disk.
+	 *
+	 * Zip archives may use the stored and deflate methods, zip64 and encrypted
+	 * entries are not supported. Tar archives may be ustar, GNU with long names
+	 * or pax, of whose extended headers only the path is used. Directories and
+	 * other non-file entries are skipped.
+	 */
+	class RomArchive
+	{
+	public:
+		/**
+		 * @brief Entry
+		 *
+		 * A file in the archive.
+		 */
+		typedef struct
+		{
+			std::string name;		/**< Path of the file inside the archive */
+			size_t offset;			/**< Offset of the (compressed) data in the archive */
+			size_t storedSize;		/**< Size of the data in the archive */
+			size_t size;			/**< Size of the file */
+			uint32_t crc;			/**< CRC-32 of the file, zip only */
+			bool deflated;			/**< True if the data is deflate compressed */
+		} Entry_t;
+
+		/**
+		 * @brief Open an archive file
+		 *
+		 * @param path : Path of the zip or tar file
+		 * @return std::expected<void, std::string> : Error message if the archive could not be read
+		 */
+		std::expected<void, std::string> Open(const std::string &path);
+
+		/**
+		 * @brief Open an archive in memory
+		 *
+		 * @param data : Content of the zip or tar file, has to outlive the archive
+		 * @return std::expected<void, std::string> : Error message if the archive could not be read
+		 */
+		std::expected<void, std::string> Open(std::span<const uint8_t> data);
+
+		/**
+		 * @brief Get the files in the archive
+		 *
+		 * @return const std::vector<Entry_t>& : The entries, sorted by name
+		 */
+		const std::vector<Entry_t> &GetEntries() const
+		{
+			return entries;
+		}
+
+		/**
+		 * @brief Find a file in the archive
+		 *
+		 * @param name : Path of the file inside the archive
+		 * @return const Entry_t* : The entry, nullptr if the archive has no such file
+		 */
+		const Entry_t *Find(std::string_view name) const;
+
+		/**
+		 * @brief Extract a file
+		 *
+		 * @param entry : Entry of this archive
+		 * @param out : Buffer for the file, at least entry.size bytes
+		 * @return std::expected<size_t, std::string> : Number of bytes extracted, error message if the data is corrupt
+		 */
+		std::expected<size_t, std::string> Extract(const Entry_t &entry, std::span<uint8_t> out) const;
+
+		/**
+		 * @brief Load a ROM from the archive into memory
+		 *
+		 * @param name : Path of the ROM inside the archive
+		 * @param memory : Memory to load the ROM into
+		 * @param loadAddress : Address to load the ROM to, the ROM start address if 0
+		 * @return std::expected<void, std::string> : Error message if the ROM could not be loaded
+		 */
+		std::expected<void, std::string> LoadRom(std::string_view name, Memory &memory, uint16_t loadAddress = 0) const;
+	private:
+		MappedFile file;
+		std::span<const uint8_t> data;
+		std::vector<Entry_t> entries;
+
+		std::expected<void, std::string> ReadZip();
+		std::expected<void, std::string> ReadTar();
+	};
+}
+
+#endif /* _CHIP8_ARCHIVE_HPP_ */
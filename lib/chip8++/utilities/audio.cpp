@@ -0,0 +1,213 @@
+#include "audio.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <format>
+
+using namespace CHIP8;
+
+namespace
+{
+	/** @brief Size of the WAV header up to the sample data */
+	constexpr size_t WAV_HEADER_SIZE = 44;
+
+	/** @brief Fixed point position of one bit of the audio pattern, the 128 bits span 2^32 */
+	constexpr double PHASE_PER_BIT = double(1u << 25);
+
+	void PutLE(uint8_t *buffer, uint32_t value, int bytes)
+	{
+		for (int i = 0; i < bytes; i++)
+		{
+			buffer[i] = uint8_t(value >> (8 * i));
+		}
+	}
+
+	/**
+	 * @brief Build the WAV header of a 16 bit mono file
+	 */
+	void BuildHeader(uint8_t (&header)[WAV_HEADER_SIZE], uint32_t sampleRate, uint64_t samples)
+	{
+		const uint32_t dataSize = uint32_t(std::min<uint64_t>(samples * 2, UINT32_MAX - WAV_HEADER_SIZE));
+		std::copy_n("RIFF", 4, header);
+		PutLE(header + 4, uint32_t(WAV_HEADER_SIZE - 8) + dataSize, 4);
+		std::copy_n("WAVEfmt ", 8, header + 8);
+		PutLE(header + 16, 16, 4);				// fmt chunk size
+		PutLE(header + 20, 1, 2);				// PCM
+		PutLE(header + 22, 1, 2);				// mono
+		PutLE(header + 24, sampleRate, 4);
+		PutLE(header + 28, sampleRate * 2, 4);	// byte rate
+		PutLE(header + 32, 2, 2);				// block align
+		PutLE(header + 34, 16, 2);				// bits per sample
+		std::copy_n("data", 4, header + 36);
+		PutLE(header + 40, dataSize, 4);
+	}
+}
+
+SampleRing::SampleRing(size_t capacity)
+ : samples(std::make_unique<int16_t[]>(std::bit_ceil(std::max<size_t>(capacity, 2)))),
+   mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1)
+{
+}
+
+size_t SampleRing::Write(std::span<const int16_t> input)
+{
+	const size_t writeIndex = head.load(std::memory_order_relaxed);
+	const size_t readIndex = tail.load(std::memory_order_acquire);
+	const size_t count = std::min(input.size(), GetCapacity() - (writeIndex - readIndex));
+
+	// Copy in up to two pieces, around the end of the storage
+	const size_t start = writeIndex & mask;
+	const size_t first = std::min(count, GetCapacity() - start);
+	std::copy_n(input.begin(), first, &samples[start]);
+	std::copy_n(input.begin() + first, count - first, &samples[0]);
+
+	head.store(writeIndex + count, std::memory_order_release);
+	return count;
+}
+
+size_t SampleRing::Read(std::span<int16_t> output)
+{
+	const size_t readIndex = tail.load(std::memory_order_relaxed);
+	const size_t writeIndex = head.load(std::memory_order_acquire);
+	const size_t count = std::min(output.size(), writeIndex - readIndex);
+
+	const size_t start = readIndex & mask;
+	const size_t first = std::min(count, GetCapacity() - start);
+	std::copy_n(&samples[start], first, output.begin());
+	std::copy_n(&samples[0], count - first, output.begin() + first);
+
+	tail.store(readIndex + count, std::memory_order_release);
+	return count;
+}
+
+AudioSynthesizer::AudioSynthesizer(uint32_t sampleRate, uint32_t frameRate, int16_t amplitude)
+ : sampleRate(sampleRate), frameRate(frameRate > 0 ? frameRate : 1), amplitude(amplitude),
+   frameBuffer(sampleRate / this->frameRate + 1)
+{
+}
+
+std::span<const int16_t> AudioSynthesizer::RenderFrame(Timers &timers)
+{
+	// Spread the remainder of sampleRate / frameRate over the frames
+	const size_t count = size_t(((frames + 1) * sampleRate) / frameRate - (frames * sampleRate) / frameRate);
+	frames++;
+	int16_t *out = frameBuffer.data();
+
+	if (!timers.GetBeeperState())
+	{
+		// Silence, the next tone starts at the beginning of the pattern
+		std::fill_n(out, count, 0);
+		phase = 0;
+		return {out, count};
+	}
+
+	// Everything the loop needs is read once per frame
+	const auto &pattern = timers.GetAudioPattern();
+	uint32_t words[4];
+	for (int i = 0; i < 4; i++)
+	{
+		words[i] = (uint32_t(pattern[4 * i]) << 24) | (uint32_t(pattern[4 * i + 1]) << 16) |
+			(uint32_t(pattern[4 * i + 2]) << 8) | uint32_t(pattern[4 * i + 3]);
+	}
+	const uint32_t step = uint32_t(std::lround(timers.GetPlaybackRate() / sampleRate * PHASE_PER_BIT));
+	const int32_t swing = 2 * int32_t(amplitude);
+	const int32_t low = -int32_t(amplitude);
+	const uint32_t start = phase;
+
+	// Branch-free so it vectorizes: the word is picked with selects and the
+	// variable shift is split into constant ones, which every SIMD set has
+	for (uint32_t i = 0; i < uint32_t(count); i++)
+	{
+		const uint32_t bit = (start + i * step) >> 25;
+		uint32_t word = (bit & 64) ? ((bit & 32) ? words[3] : words[2]) : ((bit & 32) ? words[1] : words[0]);
+		word = (bit & 16) ? (word << 16) : word;
+		word = (bit & 8) ? (word << 8) : word;
+		word = (bit & 4) ? (word << 4) : word;
+		word = (bit & 2) ? (word << 2) : word;
+		word = (bit & 1) ? (word << 1) : word;
+		const int32_t set = int32_t(word) >> 31;
+		out[i] = int16_t((set & swing) + low);
+	}
+
+	phase = start + uint32_t(count) * step;
+	return {out, count};
+}
+
+size_t AudioSynthesizer::RenderFrame(Timers &timers, SampleRing &ring)
+{
+	auto samples = RenderFrame(timers);
+	return samples.size() - ring.Write(samples);
+}
+
+WavWriter::~WavWriter()
+{
+	(void)Close();
+}
+
+std::expected<void, std::string> WavWriter::Open(const std::string &path, uint32_t sampleRate)
+{
+	(void)Close();
+	file.open(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return std::unexpected(std::format("Failed to create WAV file: {}", path));
+	}
+
+	this->sampleRate = sampleRate;
+	samplesWritten = 0;
+
+	// Placeholder header, the sizes are filled in on close
+	uint8_t header[WAV_HEADER_SIZE];
+	BuildHeader(header, sampleRate, 0);
+	file.write(reinterpret_cast<const char *>(header), WAV_HEADER_SIZE);
+	return std::expected<void, std::string>();
+}
+
+std::expected<void, std::string> WavWriter::Write(std::span<const int16_t> samples)
+{
+	if (!file.is_open())
+	{
+		return std::unexpected("WAV file is not open");
+	}
+
+	if constexpr (std::endian::native == std::endian::little)
+	{
+		file.write(reinterpret_cast<const char *>(samples.data()), std::streamsize(samples.size() * 2));
+	}
+	else
+	{
+		for (int16_t sample : samples)
+		{
+			const char bytes[2] = {char(uint16_t(sample) & 0xFF), char(uint16_t(sample) >> 8)};
+			file.write(bytes, 2);
+		}
+	}
+
+	if (!file)
+	{
+		return std::unexpected("Failed to write to the WAV file");
+	}
+	samplesWritten += samples.size();
+	return std::expected<void, std::string>();
+}
+
+std::expected<void, std::string> WavWriter::Close()
+{
+	if (!file.is_open())
+	{
+		return std::expected<void, std::string>();
+	}
+
+	uint8_t header[WAV_HEADER_SIZE];
+	BuildHeader(header, sampleRate, samplesWritten);
+	file.seekp(0);
+	file.write(reinterpret_cast<const char *>(header), WAV_HEADER_SIZE);
+	const bool written = bool(file);
+	file.close();
+
+	if (!written)
+	{
+		return std::unexpected("Failed to write the WAV header");
+	}
+	return std::expected<void, std::string>();
+}
@@ -0,0 +1,208 @@
+#ifndef _CHIP8_AUDIO_HPP_
+#define _CHIP8_AUDIO_HPP_
+
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <string>
+#include <span>
+#include <fstream>
+#include <expected>
+#include "timers.hpp"
+
+namespace CHIP8
+{
+	/**
+	 * @brief Sample Ring
+	 *
+	 * Lock-free ring buffer of 16 bit PCM samples between exactly one producer
+	 * (the emulation thread) and one consumer (the audio callback). Each side
+	 * only writes its own index, the other one is read with acquire ordering,
+	 * so neither side ever waits for the other. The capacity is rounded up to
+	 * a power of two.
+	 */
+	class SampleRing
+	{
+		/** @brief Sample storage, capacity is a power of two */
+		std::unique_ptr<int16_t[]> samples;
+
+		/** @brief Capacity minus one, masks an index into the storage */
+		size_t mask;
+
+		/** @brief Number of samples written so far, only written by the producer */
+		alignas(64) std::atomic<size_t> head{0};
+
+		/** @brief Number of samples read so far, only written by the consumer */
+		alignas(64) std::atomic<size_t> tail{0};
+	public:
+		/**
+		 * @brief Construct a new Sample Ring object
+		 *
+		 * @param capacity : Minimum number of samples the ring holds
+		 */
+		explicit SampleRing(size_t capacity);
+
+		/**
+		 * @brief Write samples, producer side
+		 *
+		 * @param input : Samples to write
+		 * @return size_t : Number of samples written, less than requested if the ring is full
+		 */
+		size_t Write(std::span<const int16_t> input);
+
+		/**
+		 * @brief Read samples, consumer side
+		 *
+		 * @param output : Buffer to read into
+		 * @return size_t : Number of samples read, less than requested if the ring runs empty
+		 */
+		size_t Read(std::span<int16_t> output);
+
+		/**
+		 * @brief Get the number of samples waiting to be read
+		 *
+		 * @return size_t : Number of samples in the ring
+		 */
+		size_t GetAvailable() const
+		{
+			return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+		}
+
+		/**
+		 * @brief Get the capacity of the ring
+		 *
+		 * @return size_t : Number of samples the ring holds
+		 */
+		size_t GetCapacity() const
+		{
+			return mask + 1;
+		}
+	};
+
+	/**
+	 * @brief Audio Synthesizer
+	 *
+	 * This class renders the audio pattern of the timers to 16 bit mono PCM,
+	 * one frame (timer tick) at a time. The pattern, pitch and sound timer are
+	 * read once per frame and the whole frame is generated in a single
+	 * branch-free loop, which optimizing compilers vectorize.
+	 *
+	 * The position in the pattern is a 32 bit fixed point value covering the
+	 * 128 bits of the pattern, so it wraps around on its own.
+	 */
+	class AudioSynthesizer
+	{
+		/** @brief Output sample rate in Hz */
+		uint32_t sampleRate;
+
+		/** @brief Timer ticks per second */
+		uint32_t frameRate;
+
+		/** @brief Amplitude of a set pattern bit, a cleared bit plays the negative amplitude */
+		int16_t amplitude;
+
+		/** @brief Position in the audio pattern, 2^25 per pattern bit */
+		uint32_t phase = 0;
+
+		/** @brief Number of frames rendered, keeps the sample count exact for rates not divisible by the frame rate */
+		uint64_t frames = 0;
+
+		/** @brief Samples of the last rendered frame, allocated once */
+		std::vector<int16_t> frameBuffer;
+	public:
+		/**
+		 * @brief Construct a new Audio Synthesizer object
+		 *
+		 * @param sampleRate : Output sample rate in Hz
+		 * @param frameRate : Timer ticks per second
+		 * @param amplitude : Amplitude of the square wave
+		 */
+		AudioSynthesizer(uint32_t sampleRate = 48000, uint32_t frameRate = 60, int16_t amplitude = 8192);
+
+		/**
+		 * @brief Render the samples of one frame
+		 *
+		 * Call once per timer tick, the frame is silent while the sound timer is zero.
+		 *
+		 * @param timers : Timers holding the sound timer, audio pattern and pitch
+		 * @return std::span<const int16_t> : Samples of the frame, valid until the next call
+		 */
+		std::span<const int16_t> RenderFrame(Timers &timers);
+
+		/**
+		 * @brief Render the samples of one frame into a sample ring
+		 *
+		 * @param timers : Timers holding the sound timer, audio pattern and pitch
+		 * @param ring : Ring the samples are written to
+		 * @return size_t : Number of samples dropped because the ring was full
+		 */
+		size_t RenderFrame(Timers &timers, SampleRing &ring);
+
+		/**
+		 * @brief Get the output sample rate
+		 *
+		 * @return uint32_t : Sample rate in Hz
+		 */
+		uint32_t GetSampleRate() const
+		{
+			return sampleRate;
+		}
+	};
+
+	/**
+	 * @brief WAV Writer
+	 *
+	 * Writes 16 bit mono PCM into a WAV file, for headless runs. The sizes in
+	 * the header are filled in by Close().
+	 */
+	class WavWriter
+	{
+		std::ofstream file;
+		uint32_t sampleRate = 0;
+		uint64_t samplesWritten = 0;
+	public:
+		WavWriter() = default;
+
+		/**
+		 * @brief Destroy the WAV Writer object, closing the file
+		 */
+		~WavWriter();
+
+		/**
+		 * @brief Create a WAV file
+		 *
+		 * @param path : Path of the WAV file
+		 * @param sampleRate : Sample rate in Hz
+		 * @return std::expected<void, std::string> : Error message if the file could not be created
+		 */
+		std::expected<void, std::string> Open(const std::string &path, uint32_t sampleRate);
+
+		/**
+		 * @brief Append samples
+		 *
+		 * @param samples : Samples to append
+		 * @return std::expected<void, std::string> : Error message if the samples could not be written
+		 */
+		std::expected<void, std::string> Write(std::span<const int16_t> samples);
+
+		/**
+		 * @brief Fill in the header and close the file
+		 *
+		 * @return std::expected<void, std::string> : Error message if the header could not be written
+		 */
+		std::expected<void, std::string> Close();
+
+		/**
+		 * @brief Get the number of samples written
+		 *
+		 * @return uint64_t : Number of samples
+		 */
+		uint64_t GetSampleCount() const
+		{
+			return samplesWritten;
+		}
+	};
+}
+
+#endif /* _CHIP8_AUDIO_HPP_ */
@@ -0,0 +1,126 @@
+#include "beeperlog.hpp"
+#include "audio.hpp"
+#include <algorithm>
+#include <format>
+
+using namespace CHIP8;
+
+namespace
+{
+	/** @brief Samples rendered per WAV write */
+	constexpr size_t RENDER_CHUNK = 4096;
+
+	/** @brief Amplitude of the rendered square wave */
+	constexpr int16_t RENDER_AMPLITUDE = 8192;
+}
+
+BeeperLog::BeeperLog(size_t capacity) : events(capacity)
+{
+}
+
+void BeeperLog::DecrementTimers()
+{
+	// The tick ends the frame, a beep running out in it is silent from the next one on
+	frame++;
+	Timers::DecrementTimers();
+}
+
+void BeeperLog::UpdateBeeper(bool beeperState)
+{
+	if (beeperState != this->beeperState)
+	{
+		if (count < events.size())
+		{
+			events[count++] = {frame, beeperState};
+		}
+		else
+		{
+			dropped++;
+		}
+	}
+	Timers::UpdateBeeper(beeperState);
+}
+
+void BeeperLog::Clear()
+{
+	count = 0;
+	dropped = 0;
+	frame = 0;
+	if (beeperState)
+	{
+		// A beep running over the clear starts the new log, the same as a recorded one
+		if (count < events.size())
+		{
+			events[count++] = {0, true};
+		}
+		else
+		{
+			dropped++;
+		}
+	}
+}
+
+std::expected<uint64_t, std::string> BeeperLog::RenderWav(const std::string &path, std::span<const BeeperEvent_t> events,
+	uint64_t frames, uint32_t sampleRate, uint32_t frequency, uint32_t frameRate)
+{
+	if (sampleRate == 0 || frameRate == 0 || frequency == 0 || frequency * 2 > sampleRate)
+	{
+		return std::unexpected(std::format("Invalid rates: {}Hz beep at {}Hz sample rate and {} frames per second",
+			frequency, sampleRate, frameRate));
+	}
+
+	WavWriter wav;
+	auto opened = wav.Open(path, sampleRate);
+	if (!opened)
+	{
+		return std::unexpected(opened.error());
+	}
+
+	// Frame boundaries land on the sample they start in, the square wave runs
+	// on from sample zero so a beep split by a state change stays in phase
+	const uint64_t totalSamples = frames * sampleRate / frameRate;
+	std::vector<int16_t> chunk(RENDER_CHUNK);
+	uint64_t sample = 0;
+	bool on = false;
+	size_t next = 0;
+
+	while (sample < totalSamples)
+	{
+		// Apply every event starting at or before the current sample
+		while (next < events.size() && events[next].frame * sampleRate / frameRate <= sample)
+		{
+			on = events[next++].on;
+		}
+		const uint64_t runEnd = (next < events.size())
+			? std::min(totalSamples, events[next].frame * sampleRate / frameRate) : totalSamples;
+		const size_t length = size_t(std::min<uint64_t>(runEnd - sample, RENDER_CHUNK));
+
+		if (on)
+		{
+			for (size_t i = 0; i < length; i++)
+			{
+				// Half periods since sample zero, odd ones are low
+				const uint64_t halfPeriod = (sample + i) * frequency * 2 / sampleRate;
+				chunk[i] = (halfPeriod & 1) ? -RENDER_AMPLITUDE : RENDER_AMPLITUDE;
+			}
+		}
+		else
+		{
+			std::fill_n(chunk.begin(), length, 0);
+		}
+
+		auto written = wav.Write(std::span<const int16_t>(chunk.data(), length));
+		if (!written)
+		{
+			return std::unexpected(written.error());
+		}
+		sample += length;
+	}
+
+	auto closed = wav.Close();
+	if (!closed)
+	{
+		return std::unexpected(closed.error());
+	}
+	return wav.GetSampleCount();
+}
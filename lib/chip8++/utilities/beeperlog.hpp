@@ -0,0 +1,115 @@
+#ifndef _CHIP8_BEEPERLOG_HPP_
+#define _CHIP8_BEEPERLOG_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <span>
+#include <expected>
+#include "timers.hpp"
+
+namespace CHIP8
+{
+	/**
+	 * @brief Beeper Log
+	 *
+	 * Timers recording every time the beeper turns on or off, stamped with the
+	 * frame (timer tick) it happened in. Pass it as the timers of the CPU and
+	 * keep calling DecrementTimers() once per frame as usual.
+	 *
+	 * The event buffer is allocated once in the constructor, recording never
+	 * allocates. When the buffer is full, further events are counted as dropped.
+	 */
+	class BeeperLog : public Timers
+	{
+	public:
+		/**
+		 * @brief Beeper Event
+		 *
+		 * A change of the beeper state. A beep turned on in frame N and off in
+		 * frame M sounds for the frames N to M - 1.
+		 */
+		typedef struct
+		{
+			uint64_t frame;		/**< Frame the beeper changed in, counted from the construction or Clear() */
+			bool on;			/**< New state of the beeper */
+		} BeeperEvent_t;
+
+		/**
+		 * @brief Construct a new Beeper Log object
+		 *
+		 * @param capacity : Maximum number of events to record
+		 */
+		BeeperLog(size_t capacity = 1 << 16);
+
+		/**
+		 * @brief Decrement the timers and advance to the next frame
+		 */
+		void DecrementTimers() override;
+
+		/**
+		 * @brief Update the beeper, recording the change
+		 *
+		 * @param beeperState : New state of the beeper
+		 */
+		void UpdateBeeper(bool beeperState) override;
+
+		/**
+		 * @brief Get the recorded events
+		 *
+		 * @return std::span<const BeeperEvent_t> : Events in the order they happened
+		 */
+		std::span<const BeeperEvent_t> GetEvents() const
+		{
+			return {events.data(), count};
+		}
+
+		/**
+		 * @brief Get the current frame
+		 *
+		 * @return uint64_t : Number of DecrementTimers() calls since the construction or Clear()
+		 */
+		uint64_t GetFrame() const
+		{
+			return frame;
+		}
+
+		/**
+		 * @brief Get the number of events that did not fit into the buffer
+		 *
+		 * @return uint64_t : Number of dropped events
+		 */
+		uint64_t GetDropped() const
+		{
+			return dropped;
+		}
+
+		/**
+		 * @brief Forget the recorded events and restart counting frames at zero
+		 *
+		 * A beep still sounding gets recorded again as turned on in frame zero.
+		 */
+		void Clear();
+
+		/**
+		 * @brief Render beeper events into a square wave WAV file
+		 *
+		 * @param path : Path of the WAV file
+		 * @param events : Events to render, e.g. GetEvents()
+		 * @param frames : Length of the recording in frames, e.g. GetFrame()
+		 * @param sampleRate : Sample rate of the WAV file in Hz
+		 * @param frequency : Frequency of the beep in Hz
+		 * @param frameRate : Frames per second the events were recorded at
+		 * @return std::expected<uint64_t, std::string> : Number of samples written or an error message
+		 */
+		static std::expected<uint64_t, std::string> RenderWav(const std::string &path, std::span<const BeeperEvent_t> events,
+			uint64_t frames, uint32_t sampleRate = 44100, uint32_t frequency = 440, uint32_t frameRate = 60);
+	private:
+		std::vector<BeeperEvent_t> events;
+		size_t count = 0;
+		uint64_t dropped = 0;
+		uint64_t frame = 0;
+	};
+}
+
+#endif /* _CHIP8_BEEPERLOG_HPP_ */
@@ -0,0 +1,376 @@
+#include "chip8pp.h"
+#include <memory>
+#include <string>
+#include <format>
+#include <exception>
+#include "cpu.hpp"
+#include "Instructions/Instruction.hpp"
+#ifdef USE_SCHIP
+#include "extensions/SCHIP8/schip8.hpp"
+#endif
+#ifdef USE_XOCHIP
+#include "extensions/XOCHIP/xochip.hpp"
+#endif
+
+/**
+ * @brief Emulator instance behind the C interface
+ *
+ * Owns a headless CPU of a platform. The C functions only forward to it and
+ * turn errors and exceptions into status codes, no exception leaves them.
+ */
+struct chip8pp_instance
+{
+	std::shared_ptr<CHIP8::HeadlessKeypad> keypad;
+	std::shared_ptr<CHIP8::Display> display;
+	std::shared_ptr<CHIP8::Timers> timers;
+	std::unique_ptr<CHIP8::CPU> cpu;
+
+	/** @brief Message of the last failed call, zero terminated */
+	mutable char lastError[CHIP8PP_ERROR_LENGTH] = {};
+
+	/**
+	 * @brief Format an error message into lastError, cut off if too long
+	 *
+	 * @return int : CHIP8PP_ERROR
+	 */
+	template <typename... Args>
+	int Fail(std::format_string<Args...> format, Args &&...args) const
+	{
+		const auto result = std::format_to_n(lastError, CHIP8PP_ERROR_LENGTH - 1, format, std::forward<Args>(args)...);
+		*result.out = '\0';
+		return CHIP8PP_ERROR;
+	}
+};
+
+namespace
+{
+	/**
+	 * @brief Run the body of a C function, turning exceptions into an error
+	 *
+	 * @param instance : Instance receiving the error message, may be NULL
+	 * @param failed : Value returned if the body throws
+	 * @param body : Body of the function
+	 * @return Result : Result of the body, failed if it threw
+	 */
+	template <typename Result, typename Body>
+	Result Guard(const chip8pp_instance *instance, Result failed, Body body) noexcept
+	{
+		try
+		{
+			return body();
+		}
+		catch (const std::exception &exception)
+		{
+			if (instance != nullptr)
+			{
+				instance->Fail("Exception: {}", exception.what());
+			}
+		}
+		catch (...)
+		{
+			if (instance != nullptr)
+			{
+				instance->Fail("Unknown exception");
+			}
+		}
+		return failed;
+	}
+}
+
+int chip8pp_api_version(void)
+{
+	return CHIP8PP_API_VERSION;
+}
+
+chip8pp_instance *chip8pp_create(int platform)
+{
+	try
+	{
+		auto instance = std::make_unique<chip8pp_instance>();
+		instance->keypad = std::make_shared<CHIP8::HeadlessKeypad>();
+		instance->timers = std::make_shared<CHIP8::Timers>();
+		std::shared_ptr<CHIP8::InstructionDecoder> decoder;
+		std::shared_ptr<CHIP8::Memory> memory = std::make_shared<CHIP8::Memory>();
+
+		switch (platform)
+		{
+			case CHIP8PP_PLATFORM_CHIP8:
+				instance->display = std::make_shared<CHIP8::HeadlessDisplay>();
+				break;
+#ifdef USE_SCHIP
+			case CHIP8PP_PLATFORM_SCHIP:
+				instance->display = std::make_shared<CHIP8::SCHIP8::HeadlessSCHIP8Display>();
+				decoder = CHIP8::SCHIP8::CreateDecoder();
+				break;
+#endif
+#ifdef USE_XOCHIP
+			case CHIP8PP_PLATFORM_XOCHIP:
+				instance->display = std::make_shared<CHIP8::XOCHIP::HeadlessXOCHIPDisplay>();
+				decoder = CHIP8::XOCHIP::CreateDecoder();
+				memory = CHIP8::XOCHIP::CreateMemory();
+				break;
+#endif
+			default:
+				return nullptr;
+		}
+
+		instance->cpu = std::make_unique<CHIP8::CPU>(instance->keypad, instance->display, decoder, memory, instance->timers);
+		return instance.release();
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+
+void chip8pp_destroy(chip8pp_instance *instance)
+{
+	delete instance;
+}
+
+const char *chip8pp_last_error(const chip8pp_instance *instance)
+{
+	return instance ? instance->lastError : "";
+}
+
+int chip8pp_load_rom(chip8pp_instance *instance, const uint8_t *rom, size_t size)
+{
+	if (instance == nullptr || (rom == nullptr && size != 0))
+	{
+		return CHIP8PP_INVALID;
+	}
+
+	return Guard(instance, CHIP8PP_ERROR, [&]
+	{
+		instance->cpu->Reset(true);
+		instance->timers->Reset();
+		instance->display->SetHighRes(false);
+		instance->display->SelectPlanes(1);
+		instance->keypad->SetKeyMask(0);
+
+		auto loaded = instance->cpu->GetMemory()->LoadRom(std::span<const uint8_t>(rom, size));
+		if (!loaded)
+		{
+			return instance->Fail("ROM does not fit into memory: {} > {}", loaded.error().address, loaded.error().limit);
+		}
+		instance->lastError[0] = '\0';
+		return CHIP8PP_OK;
+	});
+}
+
+void chip8pp_set_quirks(chip8pp_instance *instance, uint16_t quirks)
+{
+	if (instance != nullptr)
+	{
+		Guard(instance, false, [&]
+		{
+			instance->cpu->GetQuirks().FromBits(quirks);
+			return true;
+		});
+	}
+}
+
+void chip8pp_seed(chip8pp_instance *instance, uint64_t seed)
+{
+	if (instance != nullptr)
+	{
+		Guard(instance, false, [&]
+		{
+			instance->cpu->SeedRandom(seed);
+			return true;
+		});
+	}
+}
+
+void chip8pp_set_keys(chip8pp_instance *instance, uint16_t mask)
+{
+	if (instance != nullptr)
+	{
+		Guard(instance, false, [&]
+		{
+			instance->keypad->SetKeyMask(mask);
+			return true;
+		});
+	}
+}
+
+int chip8pp_run_frames(chip8pp_instance *instance, uint32_t frames, uint32_t instructions_per_frame)
+{
+	if (instance == nullptr)
+	{
+		return CHIP8PP_INVALID;
+	}
+
+	return Guard(instance, CHIP8PP_ERROR, [&]
+	{
+		CHIP8::CPU &cpu = *instance->cpu;
+		for (uint32_t frame = 0; frame < frames; frame++)
+		{
+			for (uint32_t i = 0; i < instructions_per_frame; i++)
+			{
+				auto result = cpu.RunCycle();
+				if (!result)
+				{
+					return instance->Fail("{}", cpu.GetCycleError());
+				}
+				if (!result.value())
+				{
+					const auto trap = cpu.GetTrap();
+					if (trap == CHIP8::TrapCode::EndlessLoop || trap == CHIP8::TrapCode::Exit)
+					{
+						return CHIP8PP_HALTED;
+					}
+					return instance->Fail("{}", cpu.GetCurrentInstruction()->GetAbortReason());
+				}
+			}
+			instance->timers->DecrementTimers();
+			instance->display->VBlank();
+		}
+		return CHIP8PP_OK;
+	});
+}
+
+const uint64_t *chip8pp_framebuffer(chip8pp_instance *instance, chip8pp_framebuffer_info *info)
+{
+	if (instance == nullptr)
+	{
+		return nullptr;
+	}
+
+	return Guard(instance, static_cast<const uint64_t *>(nullptr), [&]
+	{
+		CHIP8::Display &display = *instance->display;
+		if (info != nullptr)
+		{
+			info->width = display.GetWidth();
+			info->height = display.GetHeight();
+			info->planes = display.GetPlanes();
+			info->row_words = display.GetRowWords();
+		}
+		return display.GetBuffer().data();
+	});
+}
+
+uint64_t chip8pp_frame_hash(const chip8pp_instance *instance)
+{
+	if (instance == nullptr)
+	{
+		return 0;
+	}
+	return Guard(instance, uint64_t(0), [&]
+	{
+		return instance->display->GetFrameHash();
+	});
+}
+
+int chip8pp_beeper(const chip8pp_instance *instance)
+{
+	if (instance == nullptr)
+	{
+		return 0;
+	}
+	return Guard(instance, 0, [&]
+	{
+		return instance->timers->GetBeeperState() ? 1 : 0;
+	});
+}
+
+size_t chip8pp_memory_size(const chip8pp_instance *instance)
+{
+	if (instance == nullptr)
+	{
+		return 0;
+	}
+	return Guard(instance, size_t(0), [&]
+	{
+		return instance->cpu->GetMemory()->GetSize();
+	});
+}
+
+size_t chip8pp_memory_page_size(void)
+{
+	return CHIP8::Memory::GetPageSize();
+}
+
+const uint8_t *chip8pp_memory_page(const chip8pp_instance *instance, size_t page)
+{
+	if (instance == nullptr || page >= chip8pp_memory_size(instance) / chip8pp_memory_page_size())
+	{
+		return nullptr;
+	}
+	return Guard(instance, static_cast<const uint8_t *>(nullptr), [&]
+	{
+		return instance->cpu->GetMemory()->GetPage(page).data();
+	});
+}
+
+int chip8pp_memory_write(chip8pp_instance *instance, uint32_t address, const uint8_t *data, size_t size)
+{
+	if (instance == nullptr || (data == nullptr && size != 0))
+	{
+		return CHIP8PP_INVALID;
+	}
+
+	return Guard(instance, CHIP8PP_ERROR, [&]
+	{
+		auto &memory = *instance->cpu->GetMemory();
+		if (address > memory.GetSize() || size > memory.GetSize() - address)
+		{
+			return instance->Fail("Memory out of bounds: {} bytes at {}", size, address);
+		}
+		auto written = memory.SetBytes(uint16_t(address), std::span<const uint8_t>(data, size));
+		if (!written)
+		{
+			return instance->Fail("Memory out of bounds: {} > {}", written.error().address, written.error().limit);
+		}
+		return CHIP8PP_OK;
+	});
+}
+
+size_t chip8pp_state_size(chip8pp_instance *instance)
+{
+	if (instance == nullptr)
+	{
+		return 0;
+	}
+	return Guard(instance, size_t(0), [&]
+	{
+		return instance->cpu->GetSaveStateSize();
+	});
+}
+
+int chip8pp_save_state(chip8pp_instance *instance, uint8_t *buffer, size_t size)
+{
+	if (instance == nullptr || buffer == nullptr || size < chip8pp_state_size(instance))
+	{
+		return CHIP8PP_INVALID;
+	}
+
+	return Guard(instance, CHIP8PP_ERROR, [&]
+	{
+		auto saved = instance->cpu->SaveState(std::span<uint8_t>(buffer, size));
+		if (!saved)
+		{
+			return instance->Fail("{}", saved.error());
+		}
+		return CHIP8PP_OK;
+	});
+}
+
+int chip8pp_load_state(chip8pp_instance *instance, const uint8_t *buffer, size_t size)
+{
+	if (instance == nullptr || buffer == nullptr)
+	{
+		return CHIP8PP_INVALID;
+	}
+
+	return Guard(instance, CHIP8PP_ERROR, [&]
+	{
+		auto loaded = instance->cpu->LoadState(std::span<const uint8_t>(buffer, size));
+		if (!loaded)
+		{
+			return instance->Fail("{}", loaded.error());
+		}
+		return CHIP8PP_OK;
+	});
+}
@@ -0,0 +1,240 @@
+#ifndef _CHIP8PP_H_
+#define _CHIP8PP_H_
+
+/**
+ * @file chip8pp.h
+ * @brief C interface of the chip8++ library
+ *
+ * A stable C ABI around the C++ classes, for embedding the emulator into
+ * other languages and runtimes. Every instance runs headless on its own, the
+ * functions of different instances may be called from different threads.
+ *
+ * Functions returning int report CHIP8PP_OK or a negative status code, the
+ * message of the last error of an instance is returned by chip8pp_last_error().
+ * No exception leaves a function, they are reported as CHIP8PP_ERROR. Running
+ * frames, setting keys and reading the framebuffer or memory do not allocate,
+ * failing calls write their message into a fixed buffer of the instance.
+ * Pointers into the framebuffer and memory point at the emulator's own storage.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Version of this interface, increased on incompatible changes */
+#define CHIP8PP_API_VERSION		1
+
+/** @brief Status codes */
+#define CHIP8PP_OK				0	/**< Success */
+#define CHIP8PP_HALTED			1	/**< The program ended (endless jump or SCHIP-8 exit), see chip8pp_run_frames() */
+#define CHIP8PP_ERROR			-1	/**< The call failed, see chip8pp_last_error() */
+#define CHIP8PP_INVALID			-2	/**< Invalid argument, e.g. a NULL instance or a too small buffer */
+
+/** @brief Size of the error message buffer of an instance, including the terminating zero */
+#define CHIP8PP_ERROR_LENGTH	256
+
+/** @brief Platforms */
+#define CHIP8PP_PLATFORM_CHIP8	0	/**< CHIP-8, 64x32 pixels, 4 KiB of memory */
+#define CHIP8PP_PLATFORM_SCHIP	1	/**< SCHIP-8, 128x64 pixels, needs a library built with USE_SCHIP */
+#define CHIP8PP_PLATFORM_XOCHIP	2	/**< XO-CHIP, two bit planes and 64 KiB, needs a library built with USE_XOCHIP */
+
+/** @brief Emulator instance, opaque */
+typedef struct chip8pp_instance chip8pp_instance;
+
+/**
+ * @brief Layout of the framebuffer
+ *
+ * The framebuffer holds `height` rows, every row holds `planes` runs of
+ * `row_words` 64 bit words in native byte order, one run per bit plane. The
+ * most significant bit of a word is the leftmost pixel, bits past the width
+ * are zero. SCHIP-8 and XO-CHIP always use 128x64 pixels, low resolution
+ * pixels are drawn as 2x2 blocks.
+ */
+typedef struct
+{
+	int32_t width;			/**< Width in pixels */
+	int32_t height;			/**< Height in pixels */
+	int32_t planes;			/**< Number of bit planes */
+	int32_t row_words;		/**< 64 bit words per row of a plane */
+} chip8pp_framebuffer_info;
+
+/**
+ * @brief Get the version of the interface the library implements
+ *
+ * @return int : CHIP8PP_API_VERSION of the library
+ */
+int chip8pp_api_version(void);
+
+/**
+ * @brief Create an instance
+ *
+ * @param platform : CHIP8PP_PLATFORM_*
+ * @return chip8pp_instance* : The instance, NULL if the platform is not built into the library
+ */
+chip8pp_instance *chip8pp_create(int platform);
+
+/**
+ * @brief Destroy an instance
+ *
+ * @param instance : Instance to destroy, NULL is ignored
+ */
+void chip8pp_destroy(chip8pp_instance *instance);
+
+/**
+ * @brief Get the message of the last error
+ *
+ * @param instance : The instance
+ * @return const char* : Message of the last failed call, empty if none failed, valid until the next call,
+ *                       cut off after CHIP8PP_ERROR_LENGTH - 1 characters
+ */
+const char *chip8pp_last_error(const chip8pp_instance *instance);
+
+/**
+ * @brief Reset the instance and load a ROM
+ *
+ * The SCHIP-8 RPL user flags are kept, like the flags of a calculator survive
+ * loading another program.
+ *
+ * @param instance : The instance
+ * @param rom : Bytes of the ROM
+ * @param size : Size of the ROM in bytes
+ * @return int : CHIP8PP_OK, or CHIP8PP_ERROR if the ROM does not fit into memory
+ */
+int chip8pp_load_rom(chip8pp_instance *instance, const uint8_t *rom, size_t size);
+
+/**
+ * @brief Set the quirks
+ *
+ * @param instance : The instance
+ * @param quirks : Quirk bits as written by CHIP8::Quirks::ToBits()
+ */
+void chip8pp_set_quirks(chip8pp_instance *instance, uint16_t quirks);
+
+/**
+ * @brief Seed the random number generator
+ *
+ * @param instance : The instance
+ * @param seed : Seed, runs with the same seed and input are reproducible
+ */
+void chip8pp_seed(chip8pp_instance *instance, uint64_t seed);
+
+/**
+ * @brief Set the pressed keys
+ *
+ * @param instance : The instance
+ * @param mask : Bit n is set if key n is pressed
+ */
+void chip8pp_set_keys(chip8pp_instance *instance, uint16_t mask);
+
+/**
+ * @brief Run frames
+ *
+ * Runs the given number of instructions per frame, then ticks the timers.
+ *
+ * @param instance : The instance
+ * @param frames : Number of frames to run
+ * @param instructions_per_frame : Instructions per frame, e.g. 15 for the original speed
+ * @return int : CHIP8PP_OK, CHIP8PP_HALTED once the program ended or CHIP8PP_ERROR on an emulation error
+ */
+int chip8pp_run_frames(chip8pp_instance *instance, uint32_t frames, uint32_t instructions_per_frame);
+
+/**
+ * @brief Get the framebuffer
+ *
+ * @param instance : The instance
+ * @param info : Receives the layout of the framebuffer, may be NULL
+ * @return const uint64_t* : First word of the framebuffer, valid until the next call running or loading the instance
+ */
+const uint64_t *chip8pp_framebuffer(chip8pp_instance *instance, chip8pp_framebuffer_info *info);
+
+/**
+ * @brief Get the frame hash
+ *
+ * @param instance : The instance
+ * @return uint64_t : Hash of the framebuffer, equal hashes mean equal frames
+ */
+uint64_t chip8pp_frame_hash(const chip8pp_instance *instance);
+
+/**
+ * @brief Get the beeper state
+ *
+ * @param instance : The instance
+ * @return int : 1 while the beeper sounds, 0 otherwise
+ */
+int chip8pp_beeper(const chip8pp_instance *instance);
+
+/**
+ * @brief Get the size of the memory
+ *
+ * @param instance : The instance
+ * @return size_t : Size of the memory in bytes
+ */
+size_t chip8pp_memory_size(const chip8pp_instance *instance);
+
+/**
+ * @brief Get the size of a memory page
+ *
+ * @return size_t : Size of a page in bytes
+ */
+size_t chip8pp_memory_page_size(void);
+
+/**
+ * @brief Get a page of the memory
+ *
+ * The memory is stored in pages shared copy-on-write with cloned instances,
+ * so it is accessed a page at a time.
+ *
+ * @param instance : The instance
+ * @param page : Index of the page
+ * @return const uint8_t* : The bytes of the page, NULL past the end of the memory,
+ *                          valid until the next call running or loading the instance
+ */
+const uint8_t *chip8pp_memory_page(const chip8pp_instance *instance, size_t page);
+
+/**
+ * @brief Write to the memory
+ *
+ * @param instance : The instance
+ * @param address : Address of the first byte
+ * @param data : Bytes to write
+ * @param size : Number of bytes
+ * @return int : CHIP8PP_OK, or CHIP8PP_ERROR if the bytes do not fit into memory
+ */
+int chip8pp_memory_write(chip8pp_instance *instance, uint32_t address, const uint8_t *data, size_t size);
+
+/**
+ * @brief Get the size of a save state
+ *
+ * @param instance : The instance
+ * @return size_t : Number of bytes chip8pp_save_state() writes
+ */
+size_t chip8pp_state_size(chip8pp_instance *instance);
+
+/**
+ * @brief Save the state
+ *
+ * @param instance : The instance
+ * @param buffer : Buffer of at least chip8pp_state_size() bytes
+ * @param size : Size of the buffer
+ * @return int : CHIP8PP_OK, CHIP8PP_INVALID if the buffer is too small or CHIP8PP_ERROR
+ */
+int chip8pp_save_state(chip8pp_instance *instance, uint8_t *buffer, size_t size);
+
+/**
+ * @brief Load a state
+ *
+ * @param instance : The instance
+ * @param buffer : State written by chip8pp_save_state() of an instance of the same platform
+ * @param size : Size of the state
+ * @return int : CHIP8PP_OK, or CHIP8PP_ERROR if the state is invalid
+ */
+int chip8pp_load_state(chip8pp_instance *instance, const uint8_t *buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CHIP8PP_H_ */
@@ -0,0 +1,478 @@
+#include "debugger.hpp"
+#include "Instructions/Instruction.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cctype>
+#include <format>
+
+using namespace CHIP8;
+
+namespace
+{
+	/**
+	 * @brief Tokenizer for condition expressions
+	 */
+	class Tokenizer
+	{
+		std::string_view text;
+		size_t position = 0;
+	public:
+		Tokenizer(std::string_view text) : text(text) {};
+
+		void SkipSpaces()
+		{
+			while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position])))
+			{
+				position++;
+			}
+		}
+
+		bool AtEnd()
+		{
+			SkipSpaces();
+			return position >= text.size();
+		}
+
+		size_t GetPosition() const
+		{
+			return position;
+		}
+
+		/** @brief Consume the symbol if the text continues with it */
+		bool Accept(std::string_view symbol)
+		{
+			SkipSpaces();
+			if (text.substr(position, symbol.size()) == symbol)
+			{
+				position += symbol.size();
+				return true;
+			}
+			return false;
+		}
+
+		/** @brief Consume a word of letters and digits */
+		std::string_view Word()
+		{
+			SkipSpaces();
+			const size_t start = position;
+			while (position < text.size() && std::isalnum(static_cast<unsigned char>(text[position])))
+			{
+				position++;
+			}
+			return text.substr(start, position - start);
+		}
+	};
+
+	std::string Upper(std::string_view word)
+	{
+		std::string upper(word);
+		std::transform(upper.begin(), upper.end(), upper.begin(),
+			[](unsigned char character) { return char(std::toupper(character)); });
+		return upper;
+	}
+
+	/** @brief Parse an operand, returns false if the word is not one */
+	bool ParseOperand(std::string_view word, Condition::Operand &operand, uint16_t &number)
+	{
+		const std::string upper = Upper(word);
+		number = 0;
+
+		if (upper.size() == 2 && upper[0] == 'V' && std::isxdigit(static_cast<unsigned char>(upper[1])))
+		{
+			operand = static_cast<Condition::Operand>(std::stoi(upper.substr(1), nullptr, 16));
+			return true;
+		}
+
+		static const std::pair<const char *, Condition::Operand> names[] = {
+			{"I", Condition::OPERAND_I}, {"PC", Condition::OPERAND_PC}, {"SP", Condition::OPERAND_SP},
+			{"DT", Condition::OPERAND_DT}, {"ST", Condition::OPERAND_ST},
+			{"ADDRESS", Condition::OPERAND_ADDRESS}, {"VALUE", Condition::OPERAND_VALUE}
+		};
+		for (const auto &[name, value] : names)
+		{
+			if (upper == name)
+			{
+				operand = value;
+				return true;
+			}
+		}
+
+		int base = 10;
+		std::string_view digits = word;
+		if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X'))
+		{
+			base = 16;
+			digits.remove_prefix(2);
+		}
+		unsigned value;
+		auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), value, base);
+		if (digits.empty() || error != std::errc() || end != digits.data() + digits.size() || value > 0xFFFF)
+		{
+			return false;
+		}
+		operand = Condition::OPERAND_NUMBER;
+		number = uint16_t(value);
+		return true;
+	}
+}
+
+std::expected<Condition, std::string> Condition::Parse(std::string_view expression)
+{
+	// Longer operators first, so "<=" is not taken for "<"
+	static const std::pair<const char *, Comparison> comparisons[] = {
+		{"==", COMPARE_EQUAL}, {"!=", COMPARE_NOT_EQUAL}, {"<=", COMPARE_LESS_EQUAL},
+		{">=", COMPARE_GREATER_EQUAL}, {"<", COMPARE_LESS}, {">", COMPARE_GREATER}
+	};
+
+	Condition condition;
+	Tokenizer tokens(expression);
+	bool startsClause = false;
+
+	while (!tokens.AtEnd())
+	{
+		Term_t term{};
+		term.startsClause = startsClause;
+
+		std::string_view word = tokens.Word();
+		if (!ParseOperand(word, term.left, term.leftNumber))
+		{
+			return std::unexpected(std::format("Condition: invalid operand '{}' at {}", word, tokens.GetPosition()));
+		}
+
+		bool found = false;
+		for (const auto &[symbol, comparison] : comparisons)
+		{
+			if (tokens.Accept(symbol))
+			{
+				term.comparison = comparison;
+				found = true;
+				break;
+			}
+		}
+		if (!found)
+		{
+			return std::unexpected(std::format("Condition: comparison expected at {}", tokens.GetPosition()));
+		}
+
+		word = tokens.Word();
+		if (!ParseOperand(word, term.right, term.rightNumber))
+		{
+			return std::unexpected(std::format("Condition: invalid operand '{}' at {}", word, tokens.GetPosition()));
+		}
+		condition.terms.push_back(term);
+
+		if (tokens.AtEnd())
+		{
+			break;
+		}
+		else if (tokens.Accept("&&"))
+		{
+			startsClause = false;
+		}
+		else if (tokens.Accept("||"))
+		{
+			startsClause = true;
+		}
+		else
+		{
+			return std::unexpected(std::format("Condition: '&&' or '||' expected at {}", tokens.GetPosition()));
+		}
+
+		if (tokens.AtEnd())
+		{
+			return std::unexpected("Condition: comparison expected after the last operator");
+		}
+	}
+
+	return condition;
+}
+
+bool Condition::Evaluate(CPU &cpu, uint16_t address, uint8_t value) const
+{
+	auto read = [&](Operand operand, uint16_t number) -> uint16_t {
+		switch (operand)
+		{
+			case OPERAND_I:			return cpu.GetIndex();
+			case OPERAND_PC:		return cpu.GetPC();
+			case OPERAND_SP:		return uint16_t(cpu.GetStackPointer());
+			case OPERAND_DT:		return cpu.GetTimers()->GetDelayTimer();
+			case OPERAND_ST:		return cpu.GetTimers()->GetSoundTimer();
+			case OPERAND_ADDRESS:	return address;
+			case OPERAND_VALUE:		return value;
+			case OPERAND_NUMBER:	return number;
+			default:				return cpu.GetRegister(operand);
+		}
+	};
+
+	// Disjunction of conjunctions: a clause fails at its first false term
+	bool clause = true;
+	for (size_t i = 0; i < terms.size(); i++)
+	{
+		const Term_t &term = terms[i];
+		if (term.startsClause)
+		{
+			if (clause)
+			{
+				return true;
+			}
+			clause = true;
+		}
+		if (!clause)
+		{
+			continue;
+		}
+
+		const uint16_t left = read(term.left, term.leftNumber);
+		const uint16_t right = read(term.right, term.rightNumber);
+		switch (term.comparison)
+		{
+			case COMPARE_EQUAL:			clause = left == right; break;
+			case COMPARE_NOT_EQUAL:		clause = left != right; break;
+			case COMPARE_LESS:			clause = left < right; break;
+			case COMPARE_LESS_EQUAL:	clause = left <= right; break;
+			case COMPARE_GREATER:		clause = left > right; break;
+			case COMPARE_GREATER_EQUAL:	clause = left >= right; break;
+		}
+	}
+	return clause;
+}
+
+Debugger::Debugger(CPU &cpu)
+ : cpu(cpu), memory(cpu.GetMemory()), addressMask(uint16_t(memory->GetSize() - 1)),
+   breakpoints((memory->GetSize() + 63) / 64), readWatched(breakpoints.size()), writeWatched(breakpoints.size())
+{
+}
+
+Debugger::~Debugger()
+{
+	memory->SetAccessHook(nullptr);
+}
+
+std::expected<void, std::string> Debugger::AddBreakpoint(uint16_t address, std::string_view condition)
+{
+	auto parsed = Condition::Parse(condition);
+	if (!parsed)
+	{
+		return std::unexpected(parsed.error());
+	}
+
+	address &= addressMask;
+	if (!HasBreakpoint(address))
+	{
+		breakpoints[address / 64] |= uint64_t(1) << (address % 64);
+		breakpointCount++;
+	}
+
+	if (parsed->IsEmpty())
+	{
+		breakpointConditions.erase(address);
+	}
+	else
+	{
+		breakpointConditions[address] = std::move(parsed.value());
+	}
+	return std::expected<void, std::string>();
+}
+
+bool Debugger::RemoveBreakpoint(uint16_t address)
+{
+	address &= addressMask;
+	if (!HasBreakpoint(address))
+	{
+		return false;
+	}
+	breakpoints[address / 64] &= ~(uint64_t(1) << (address % 64));
+	breakpointConditions.erase(address);
+	breakpointCount--;
+	return true;
+}
+
+bool Debugger::HasBreakpoint(uint16_t address) const
+{
+	return TestBit(breakpoints, address & addressMask);
+}
+
+void Debugger::ClearBreakpoints()
+{
+	std::fill(breakpoints.begin(), breakpoints.end(), 0);
+	breakpointConditions.clear();
+	breakpointCount = 0;
+}
+
+std::expected<unsigned, std::string> Debugger::AddWatchpoint(uint16_t address, uint16_t length, WatchType type,
+	std::string_view condition)
+{
+	if (length == 0 || size_t(address) + length > memory->GetSize())
+	{
+		return std::unexpected(std::format("Debugger: watchpoint 0x{:04X}+{} is out of memory", address, length));
+	}
+
+	auto parsed = Condition::Parse(condition);
+	if (!parsed)
+	{
+		return std::unexpected(parsed.error());
+	}
+
+	watchpoints.push_back({nextWatchpointId, address, length, type, std::move(parsed.value())});
+	RebuildWatchBitmaps();
+	return nextWatchpointId++;
+}
+
+bool Debugger::RemoveWatchpoint(unsigned id)
+{
+	auto watchpoint = std::find_if(watchpoints.begin(), watchpoints.end(),
+		[id](const Watchpoint_t &entry) { return entry.id == id; });
+	if (watchpoint == watchpoints.end())
+	{
+		return false;
+	}
+	watchpoints.erase(watchpoint);
+	RebuildWatchBitmaps();
+	return true;
+}
+
+void Debugger::ClearWatchpoints()
+{
+	watchpoints.clear();
+	RebuildWatchBitmaps();
+}
+
+void Debugger::RebuildWatchBitmaps()
+{
+	std::fill(readWatched.begin(), readWatched.end(), 0);
+	std::fill(writeWatched.begin(), writeWatched.end(), 0);
+	for (const Watchpoint_t &watchpoint : watchpoints)
+	{
+		for (size_t address = watchpoint.address; address < size_t(watchpoint.address) + watchpoint.length; address++)
+		{
+			if (watchpoint.type & WATCH_READ)
+			{
+				readWatched[address / 64] |= uint64_t(1) << (address % 64);
+			}
+			if (watchpoint.type & WATCH_WRITE)
+			{
+				writeWatched[address / 64] |= uint64_t(1) << (address % 64);
+			}
+		}
+	}
+
+	// Only hook the memory while something is watched
+	memory->SetAccessHook(watchpoints.empty() ? nullptr : this);
+}
+
+void Debugger::OnAccess(WatchType access, const std::vector<uint64_t> &watched, uint16_t address, uint8_t value)
+{
+	// Report the first hit of an instruction only
+	if (watchHit.reason != StopReason::None || !TestBit(watched, address))
+	{
+		return;
+	}
+
+	for (const Watchpoint_t &watchpoint : watchpoints)
+	{
+		if ((watchpoint.type & access) && address >= watchpoint.address
+			&& address < size_t(watchpoint.address) + watchpoint.length
+			&& watchpoint.condition.Evaluate(cpu, address, value))
+		{
+			watchHit.reason = StopReason::Watchpoint;
+			watchHit.watchpoint = watchpoint.id;
+			watchHit.access = access;
+			watchHit.address = address;
+			watchHit.value = value;
+			return;
+		}
+	}
+}
+
+void Debugger::OnRead(uint16_t address, uint8_t value)
+{
+	OnAccess(WATCH_READ, readWatched, address, value);
+}
+
+void Debugger::OnWrite(uint16_t address, uint8_t value)
+{
+	OnAccess(WATCH_WRITE, writeWatched, address, value);
+}
+
+bool Debugger::BreakpointHit(uint16_t pc)
+{
+	pc &= addressMask;
+	if (!TestBit(breakpoints, pc))
+	{
+		return false;
+	}
+
+	auto condition = breakpointConditions.find(pc);
+	return condition == breakpointConditions.end() || condition->second.Evaluate(cpu);
+}
+
+bool Debugger::Execute(uint64_t executed, StopInfo_t &stop)
+{
+	watchHit.reason = StopReason::None;
+	auto result = cpu.RunCycle();
+	if (result && result.value() && watchHit.reason == StopReason::None) [[likely]]
+	{
+		return false;
+	}
+
+	stop = watchHit;
+	stop.cycles = executed + 1;
+	if (!result)
+	{
+		stop.reason = StopReason::Error;
+		stop.message = cpu.GetCycleError();
+	}
+	else if (!result.value())
+	{
+		stop.reason = StopReason::InstructionAbort;
+		stop.message = cpu.GetCurrentInstruction()->GetAbortReason();
+	}
+	stop.pc = cpu.GetPC();
+	return true;
+}
+
+Debugger::StopInfo_t Debugger::Run(uint64_t maxCycles)
+{
+	StopInfo_t stop{};
+
+	// Continuing from a breakpoint executes the instruction it stopped on
+	bool skipBreakpoint = stoppedOnBreakpoint == cpu.GetPC();
+	stoppedOnBreakpoint.reset();
+
+	for (uint64_t executed = 0; executed < maxCycles; executed++)
+	{
+		if (breakpointCount > 0 && !skipBreakpoint && BreakpointHit(cpu.GetPC()))
+		{
+			stoppedOnBreakpoint = cpu.GetPC();
+			stop.reason = StopReason::Breakpoint;
+			stop.pc = cpu.GetPC();
+			stop.cycles = executed;
+			return stop;
+		}
+		skipBreakpoint = false;
+
+		if (Execute(executed, stop))
+		{
+			return stop;
+		}
+	}
+
+	stop.reason = StopReason::CycleLimit;
+	stop.pc = cpu.GetPC();
+	stop.cycles = maxCycles;
+	return stop;
+}
+
+Debugger::StopInfo_t Debugger::Step()
+{
+	StopInfo_t stop{};
+	stoppedOnBreakpoint.reset();
+
+	if (!Execute(0, stop))
+	{
+		stop.reason = StopReason::Step;
+		stop.pc = cpu.GetPC();
+		stop.cycles = 1;
+	}
+	return stop;
+}
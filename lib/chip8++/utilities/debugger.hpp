@@ -0,0 +1,314 @@
+#ifndef _CHIP8_DEBUGGER_HPP_
+#define _CHIP8_DEBUGGER_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <expected>
+#include <unordered_map>
+#include <optional>
+#include "cpu.hpp"
+
+namespace CHIP8
+{
+	/**
+	 * @brief Condition
+	 *
+	 * This class holds a parsed conditional expression like "V3 == 0x10 && DT > 0",
+	 * used by conditional breakpoints and watchpoints. A condition is made of
+	 * comparisons joined by "&&" and "||", where "&&" binds stronger.
+	 *
+	 * Operands are the registers V0-VF, I, PC, SP, DT and ST, the accessed ADDRESS
+	 * and VALUE of a watchpoint hit and decimal or 0x prefixed hexadecimal numbers.
+	 * Comparisons are ==, !=, <, <=, > and >=. An empty condition is always true.
+	 */
+	class Condition
+	{
+	public:
+		/**
+		 * @brief Operand
+		 *
+		 * Operands of a comparison, V0 to VF are 0 to 15.
+		 */
+		enum Operand : uint8_t
+		{
+			OPERAND_I = 16,		/**< Index register */
+			OPERAND_PC,			/**< Program counter */
+			OPERAND_SP,			/**< Stack pointer */
+			OPERAND_DT,			/**< Delay timer */
+			OPERAND_ST,			/**< Sound timer */
+			OPERAND_ADDRESS,	/**< Address of the watchpoint access */
+			OPERAND_VALUE,		/**< Value of the watchpoint access */
+			OPERAND_NUMBER		/**< Constant number */
+		};
+
+		/**
+		 * @brief Comparison
+		 *
+		 * Comparison operators of a comparison.
+		 */
+		enum Comparison : uint8_t
+		{
+			COMPARE_EQUAL = 0,
+			COMPARE_NOT_EQUAL,
+			COMPARE_LESS,
+			COMPARE_LESS_EQUAL,
+			COMPARE_GREATER,
+			COMPARE_GREATER_EQUAL
+		};
+
+		/**
+		 * @brief Parse a condition
+		 *
+		 * @param expression : The expression, empty for a condition that is always true
+		 * @return std::expected<Condition, std::string> : The condition or an error message
+		 */
+		static std::expected<Condition, std::string> Parse(std::string_view expression);
+
+		/**
+		 * @brief Evaluate the condition
+		 *
+		 * @param cpu : CPU to read the registers from
+		 * @param address : Address of the watchpoint access
+		 * @param value : Value of the watchpoint access
+		 * @return bool : True if the condition is met
+		 */
+		bool Evaluate(CPU &cpu, uint16_t address = 0, uint8_t value = 0) const;
+
+		/**
+		 * @brief Check if the condition is always true
+		 *
+		 * @return bool : True if the condition has no comparisons
+		 */
+		bool IsEmpty() const
+		{
+			return terms.empty();
+		}
+	private:
+		/**
+		 * @brief Comparison Term
+		 *
+		 * A single comparison, terms are evaluated in order.
+		 */
+		typedef struct
+		{
+			Operand left;			/**< Left operand */
+			Operand right;			/**< Right operand */
+			uint16_t leftNumber;	/**< Value of the left operand if it is a number */
+			uint16_t rightNumber;	/**< Value of the right operand if it is a number */
+			Comparison comparison;	/**< Comparison operator */
+			bool startsClause;		/**< Preceded by "||" */
+		} Term_t;
+
+		std::vector<Term_t> terms;
+	};
+
+	/**
+	 * @brief Debugger
+	 *
+	 * This class runs a CPU with PC breakpoints and memory watchpoints. Breakpoints
+	 * live in a bitmap with one bit per address and are only looked up while at
+	 * least one is armed. Watchpoints attach a MemoryAccessHook to the memory of the
+	 * CPU as long as at least one is set. Hosts not using a debugger, or a debugger
+	 * without breakpoints, run CPU::RunCycle() exactly as before.
+	 */
+	class Debugger : public MemoryAccessHook
+	{
+	public:
+		/**
+		 * @brief Stop Reason
+		 *
+		 * Reasons Run() and Step() returned.
+		 */
+		enum class StopReason
+		{
+			None = 0,			/**< Nothing stopped the CPU */
+			Step,				/**< A single instruction was stepped */
+			CycleLimit,			/**< The cycle budget ran out */
+			Breakpoint,			/**< The PC reached a breakpoint */
+			Watchpoint,			/**< An instruction accessed a watched byte */
+			InstructionAbort,	/**< An instruction aborted, see Instruction::GetAbortReason() */
+			Error				/**< RunCycle() returned an error */
+		};
+
+		/**
+		 * @brief Watch Type
+		 *
+		 * Accesses a watchpoint triggers on.
+		 */
+		enum WatchType : uint8_t
+		{
+			WATCH_READ = 1,
+			WATCH_WRITE = 2,
+			WATCH_ACCESS = WATCH_READ | WATCH_WRITE
+		};
+
+		/**
+		 * @brief Stop Information
+		 *
+		 * Result of Run() and Step().
+		 */
+		typedef struct
+		{
+			StopReason reason;		/**< Why the CPU stopped */
+			uint16_t pc;			/**< PC of the next instruction to execute */
+			uint64_t cycles;		/**< Number of instructions executed */
+			unsigned watchpoint;	/**< ID of the watchpoint hit */
+			WatchType access;		/**< Access that triggered the watchpoint */
+			uint16_t address;		/**< Address of the access that triggered the watchpoint */
+			uint8_t value;			/**< Value read or written by the access */
+			std::string message;	/**< Abort reason or error message */
+		} StopInfo_t;
+
+		/**
+		 * @brief Construct a new Debugger object
+		 *
+		 * @param cpu : CPU to debug, has to outlive the debugger
+		 */
+		Debugger(CPU &cpu);
+
+		/**
+		 * @brief Destroy the Debugger object, detaches it from the memory
+		 */
+		~Debugger();
+
+		Debugger(const Debugger &) = delete;
+		Debugger &operator=(const Debugger &) = delete;
+
+		/**
+		 * @brief Set a breakpoint
+		 *
+		 * Setting a breakpoint on an address with a breakpoint replaces its condition.
+		 *
+		 * @param address : Address of the instruction
+		 * @param condition : Condition the breakpoint only stops on, empty to always stop
+		 * @return std::expected<void, std::string> : Error message if the condition is invalid
+		 */
+		std::expected<void, std::string> AddBreakpoint(uint16_t address, std::string_view condition = "");
+
+		/**
+		 * @brief Remove a breakpoint
+		 *
+		 * @param address : Address of the instruction
+		 * @return bool : True if a breakpoint was removed
+		 */
+		bool RemoveBreakpoint(uint16_t address);
+
+		/**
+		 * @brief Check if a breakpoint is set
+		 *
+		 * @param address : Address of the instruction
+		 * @return bool : True if a breakpoint is set on the address
+		 */
+		bool HasBreakpoint(uint16_t address) const;
+
+		/**
+		 * @brief Remove all breakpoints
+		 */
+		void ClearBreakpoints();
+
+		/**
+		 * @brief Set a watchpoint
+		 *
+		 * @param address : First address watched
+		 * @param length : Number of bytes watched
+		 * @param type : Accesses to stop on
+		 * @param condition : Condition the watchpoint only stops on, empty to always stop
+		 * @return std::expected<unsigned, std::string> : ID of the watchpoint or an error message
+		 */
+		std::expected<unsigned, std::string> AddWatchpoint(uint16_t address, uint16_t length, WatchType type,
+			std::string_view condition = "");
+
+		/**
+		 * @brief Remove a watchpoint
+		 *
+		 * @param id : ID returned by AddWatchpoint()
+		 * @return bool : True if a watchpoint was removed
+		 */
+		bool RemoveWatchpoint(unsigned id);
+
+		/**
+		 * @brief Remove all watchpoints
+		 */
+		void ClearWatchpoints();
+
+		/**
+		 * @brief Run the CPU until something stops it
+		 *
+		 * A breakpoint on the current PC that stopped the previous run is stepped over.
+		 *
+		 * @param maxCycles : Maximum number of instructions to execute
+		 * @return StopInfo_t : Why and where the CPU stopped
+		 */
+		StopInfo_t Run(uint64_t maxCycles);
+
+		/**
+		 * @brief Execute a single instruction
+		 *
+		 * Breakpoints are ignored, watchpoints still report their hits.
+		 *
+		 * @return StopInfo_t : Step or the reason the instruction stopped the CPU
+		 */
+		StopInfo_t Step();
+
+		void OnRead(uint16_t address, uint8_t value) override;
+		void OnWrite(uint16_t address, uint8_t value) override;
+	private:
+		/**
+		 * @brief Watchpoint
+		 *
+		 * A watched memory range.
+		 */
+		typedef struct
+		{
+			unsigned id;			/**< ID returned by AddWatchpoint() */
+			uint16_t address;		/**< First address watched */
+			uint16_t length;		/**< Number of bytes watched */
+			WatchType type;			/**< Accesses to stop on */
+			Condition condition;	/**< Condition to stop on */
+		} Watchpoint_t;
+
+		CPU &cpu;
+		std::shared_ptr<Memory> memory;
+
+		/** @brief Address mask, the memory size is a power of two */
+		uint16_t addressMask;
+
+		/** @brief Breakpoint bitmap, one bit per address */
+		std::vector<uint64_t> breakpoints;
+
+		/** @brief Number of breakpoints set */
+		size_t breakpointCount = 0;
+
+		/** @brief Conditions of the conditional breakpoints */
+		std::unordered_map<uint16_t, Condition> breakpointConditions;
+
+		/** @brief Watchpoints */
+		std::vector<Watchpoint_t> watchpoints;
+
+		/** @brief Bitmaps of the addresses with read and write watchpoints */
+		std::vector<uint64_t> readWatched;
+		std::vector<uint64_t> writeWatched;
+
+		unsigned nextWatchpointId = 1;
+
+		/** @brief Watchpoint hit of the current instruction */
+		StopInfo_t watchHit;
+
+		/** @brief PC of the breakpoint the last run stopped on */
+		std::optional<uint16_t> stoppedOnBreakpoint;
+
+		static bool TestBit(const std::vector<uint64_t> &bitmap, uint16_t address)
+		{
+			return (bitmap[address / 64] >> (address % 64)) & 1;
+		}
+
+		bool BreakpointHit(uint16_t pc);
+		void OnAccess(WatchType access, const std::vector<uint64_t> &watched, uint16_t address, uint8_t value);
+		void RebuildWatchBitmaps();
+		bool Execute(uint64_t executed, StopInfo_t &stop);
+	};
+}
+
+#endif /* _CHIP8_DEBUGGER_HPP_ */
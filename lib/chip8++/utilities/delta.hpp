@@ -0,0 +1,118 @@
+#ifndef _CHIP8_DELTA_HPP_
+#define _CHIP8_DELTA_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <algorithm>
+#include "varint.hpp"
+
+namespace CHIP8::Delta
+{
+	/**
+	 * @brief Worst case size of an encoded delta
+	 *
+	 * Alternating single changed and unchanged bytes cost three bytes per two input bytes,
+	 * the bound adds room for the varint headers on top.
+	 *
+	 * @param stateSize : Size of the states the delta is computed between
+	 * @return size_t : Maximum number of bytes EncodeXor() can write
+	 */
+	constexpr size_t MaxEncodedSize(size_t stateSize)
+	{
+		return stateSize * 2 + 2 * Varint::MAX_LENGTH;
+	}
+
+	/**
+	 * @brief Encode the XOR delta between two equally sized states
+	 *
+	 * The delta is a sequence of (varint unchanged run, varint literal run, XORed literal bytes).
+	 * Unchanged bytes cost nothing but the run length, so a frame that only touches a few
+	 * bytes of memory and display encodes into a handful of bytes. Encoding against an
+	 * all-zero previous state (an empty span) stores the current state itself.
+	 *
+	 * @param current : State to encode
+	 * @param previous : State the delta is relative to, empty for all zeros
+	 * @param out : Output buffer, MaxEncodedSize() bytes are always sufficient
+	 * @return size_t : Number of bytes written, 0 if the output buffer is too small
+	 */
+	inline size_t EncodeXor(std::span<const uint8_t> current, std::span<const uint8_t> previous, std::span<uint8_t> out)
+	{
+		auto delta = [&](size_t i) -> uint8_t {
+			return previous.empty() ? current[i] : uint8_t(current[i] ^ previous[i]);
+		};
+
+		size_t position = 0;
+		size_t i = 0;
+		while (i < current.size())
+		{
+			// Unchanged run
+			size_t runStart = i;
+			while (i < current.size() && delta(i) == 0)
+			{
+				i++;
+			}
+			if (i == current.size())
+			{
+				break;
+			}
+			size_t unchanged = i - runStart;
+
+			// Literal run, ends at the next run of at least two unchanged bytes
+			size_t literalStart = i;
+			while (i < current.size() && (delta(i) != 0 || (i + 1 < current.size() && delta(i + 1) != 0)))
+			{
+				i++;
+			}
+			size_t literal = i - literalStart;
+
+			if (!Varint::Put(unchanged, out, position) || !Varint::Put(literal, out, position) ||
+				position + literal > out.size())
+			{
+				return 0;
+			}
+			for (size_t j = literalStart; j < literalStart + literal; j++)
+			{
+				out[position++] = delta(j);
+			}
+		}
+		return position;
+	}
+
+	/**
+	 * @brief Apply an encoded XOR delta onto a state
+	 *
+	 * @param encoded : Delta written by EncodeXor()
+	 * @param state : State to apply the delta onto, modified in place
+	 * @return bool : False if the delta is malformed or does not fit the state
+	 */
+	inline bool ApplyXor(std::span<const uint8_t> encoded, std::span<uint8_t> state)
+	{
+		size_t position = 0;
+		size_t offset = 0;
+		while (position < encoded.size())
+		{
+			uint64_t unchanged, literal;
+			if (!Varint::Get(encoded, position, unchanged) || !Varint::Get(encoded, position, literal))
+			{
+				return false;
+			}
+			if (unchanged > state.size() - offset)
+			{
+				return false;
+			}
+			offset += unchanged;
+			if (literal > state.size() - offset || literal > encoded.size() - position)
+			{
+				return false;
+			}
+			for (size_t j = 0; j < literal; j++)
+			{
+				state[offset++] ^= encoded[position++];
+			}
+		}
+		return true;
+	}
+}
+
+#endif /* _CHIP8_DELTA_HPP_ */
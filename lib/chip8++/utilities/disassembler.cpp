@@ -0,0 +1,277 @@
+#include "disassembler.hpp"
+
+using namespace CHIP8;
+
+namespace
+{
+	/**
+	 * @brief Mnemonic templates, indexed by operation
+	 *
+	 * Placeholders: %X/%Y register, %K byte, %A address, %a address without
+	 * leading zeros, %N decimal nibble, %O opcode.
+	 */
+	constexpr const char *MNEMONICS[] = {
+		"CLR", "RET", "JP 0x%A", "CALL 0x%a", "SE V%X, 0x%K", "SNE V%X, 0x%K", "SE V%X, V%Y", "LD V%X, 0x%K",
+		"ADD V%X, %K", "LD V%X, V%Y", "OR V%X, V%Y", "AND V%X, V%Y", "XOR V%X, V%Y", "ADD V%X, V%Y", "SUB V%X, V%Y", "SHR V%X",
+		"SUBN V%X, V%Y", "SHL V%X", "SNE V%X, V%Y", "LD I, 0x%A", "JP V0, 0x%A", "RND V%X, 0x%K", "DRAW V%X, V%Y, %N", "SKP V%X",
+		"SKNP V%X", "LD V%X, DT", "LD V%X, K", "LD DT, V%X", "LD ST, V%X", "ADD I, V%X", "LD F, V%X", "LD BCD, V%X",
+		"LD [I], V%X", "LD V%X, [I]", "ILLEGAL: 0x%O"
+	};
+	static_assert(sizeof(MNEMONICS) / sizeof(MNEMONICS[0]) == DecodedOp::OP_ILLEGAL + 1);
+
+	constexpr std::string_view EDGE_NAMES[] = { "next", "jump", "call", "skip" };
+}
+
+void DecodedOp::WriteMnemonic(TextBuffer &out) const
+{
+	for (const char *character = MNEMONICS[operation]; *character != '\0'; character++)
+	{
+		if (*character != '%')
+		{
+			out.Put(*character);
+			continue;
+		}
+
+		switch (*++character)
+		{
+			case 'X': out.PutHex(x); break;
+			case 'Y': out.PutHex(y); break;
+			case 'K': out.PutHex(kk, 2); break;
+			case 'A': out.PutHex(nnn, 3); break;
+			case 'a': out.PutHex(nnn); break;
+			case 'N': out.PutDecimal(n); break;
+			case 'O': out.PutHex(opcode, 4); break;
+		}
+	}
+}
+
+void ControlFlowGraph::AddTarget(size_t address, uint8_t flag)
+{
+	if (address + 1 >= flags.size())
+	{
+		return;
+	}
+	flags[address] |= FLAG_LEADER | flag;
+	if (!(flags[address] & FLAG_INSTRUCTION))
+	{
+		worklist.push_back(uint16_t(address));
+	}
+}
+
+void ControlFlowGraph::AddEdge(uint16_t from, size_t to, EdgeKind kind)
+{
+	if (IsInstruction(to))
+	{
+		edges.push_back({uint32_t(blocks.size() - 1), from, uint16_t(to), kind});
+	}
+}
+
+void ControlFlowGraph::Analyze(std::span<const uint8_t> image, uint16_t entry)
+{
+	memory = image;
+	entryPoint = entry;
+	flags.assign(image.size(), 0);
+	worklist.clear();
+	blocks.clear();
+	edges.clear();
+	indirectJumps.clear();
+	incoming.clear();
+
+	// Walk every path, marking instructions and the addresses blocks start at
+	AddTarget(entry, FLAG_ENTRY);
+	while (!worklist.empty())
+	{
+		size_t address = worklist.back();
+		worklist.pop_back();
+
+		while (address + 1 < flags.size() && !(flags[address] & FLAG_INSTRUCTION))
+		{
+			flags[address] |= FLAG_INSTRUCTION;
+			const DecodedOp op = DecodeAt(address);
+			const size_t next = address + 2;
+
+			const DecodedOp::Flow flow = op.GetFlow();
+			if (flow == DecodedOp::FLOW_NEXT)
+			{
+				address = next;
+				continue;
+			}
+
+			switch (flow)
+			{
+				case DecodedOp::FLOW_JUMP:
+					AddTarget(op.nnn, 0);
+					break;
+				case DecodedOp::FLOW_CALL:
+					AddTarget(op.nnn, FLAG_CALL_TARGET);
+					AddTarget(next, 0);
+					break;
+				case DecodedOp::FLOW_SKIP:
+					AddTarget(next, 0);
+					AddTarget(next + 2, 0);
+					break;
+				case DecodedOp::FLOW_INDIRECT:
+					indirectJumps.push_back(uint16_t(address));
+					break;
+				default:
+					break;
+			}
+			break;
+		}
+	}
+	std::sort(indirectJumps.begin(), indirectJumps.end());
+
+	// Split the code into blocks, every block starts at a leader
+	for (size_t start = 0; start < flags.size(); start++)
+	{
+		if (!(flags[start] & FLAG_LEADER) || !(flags[start] & FLAG_INSTRUCTION))
+		{
+			continue;
+		}
+
+		size_t address = start;
+		DecodedOp op = DecodeAt(address);
+		while (op.GetFlow() == DecodedOp::FLOW_NEXT && IsInstruction(address + 2) && !(flags[address + 2] & FLAG_LEADER))
+		{
+			address += 2;
+			op = DecodeAt(address);
+		}
+
+		blocks.push_back({uint16_t(start), uint16_t(address + 2), bool(flags[start] & FLAG_CALL_TARGET)});
+		const uint16_t last = uint16_t(address);
+		switch (op.GetFlow())
+		{
+			case DecodedOp::FLOW_NEXT:
+				AddEdge(last, address + 2, EDGE_FALLTHROUGH);
+				break;
+			case DecodedOp::FLOW_JUMP:
+				AddEdge(last, op.nnn, EDGE_JUMP);
+				break;
+			case DecodedOp::FLOW_CALL:
+				AddEdge(last, op.nnn, EDGE_CALL);
+				AddEdge(last, address + 2, EDGE_FALLTHROUGH);
+				break;
+			case DecodedOp::FLOW_SKIP:
+				AddEdge(last, address + 2, EDGE_FALLTHROUGH);
+				AddEdge(last, address + 4, EDGE_SKIP);
+				break;
+			default:
+				break;
+		}
+	}
+
+	incoming.resize(edges.size());
+	for (uint32_t i = 0; i < incoming.size(); i++)
+	{
+		incoming[i] = i;
+	}
+	std::stable_sort(incoming.begin(), incoming.end(),
+		[this](uint32_t a, uint32_t b) { return edges[a].to < edges[b].to; });
+}
+
+const ControlFlowGraph::BasicBlock_t *ControlFlowGraph::FindBlock(uint16_t address) const
+{
+	auto block = std::upper_bound(blocks.begin(), blocks.end(), address,
+		[](uint16_t value, const BasicBlock_t &entry) { return value < entry.start; });
+	if (block == blocks.begin() || address >= (block - 1)->end)
+	{
+		return nullptr;
+	}
+	return &*(block - 1);
+}
+
+void ControlFlowGraph::WriteListing(uint16_t start, uint16_t end, TextBuffer &out) const
+{
+	auto edge = std::lower_bound(incoming.begin(), incoming.end(), start,
+		[this](uint32_t index, uint16_t value) { return edges[index].to < value; });
+
+	for (size_t address = start; address < end && address < flags.size(); )
+	{
+		if (!IsInstruction(address))
+		{
+			// Unreached bytes, the second byte of an instruction is part of it
+			out.Put("    0x").PutHex(uint32_t(address), 3).Put("  ").PutHex(memory[address], 2)
+				.Put("      DB 0x").PutHex(memory[address], 2).Put('\n');
+			address++;
+			continue;
+		}
+
+		if (flags[address] & FLAG_LEADER)
+		{
+			out.Put('\n');
+			// Transfers entering the block
+			while (edge != incoming.end() && edges[*edge].to < address)
+			{
+				edge++;
+			}
+			bool first = true;
+			for (; edge != incoming.end() && edges[*edge].to == address; edge++)
+			{
+				const Edge_t &entering = edges[*edge];
+				out.Put(first ? "; from " : ", ").Put(EDGE_NAMES[entering.kind]).Put(" 0x").PutHex(entering.from, 3);
+				first = false;
+			}
+			if (!first)
+			{
+				out.Put('\n');
+			}
+			if (flags[address] & FLAG_ENTRY)
+			{
+				out.Put("; entry\n");
+			}
+			out.Put(flags[address] & FLAG_CALL_TARGET ? "sub_" : "L").PutHex(uint32_t(address), 3).Put(":\n");
+		}
+
+		const DecodedOp op = DecodeAt(address);
+		out.Put("    0x").PutHex(uint32_t(address), 3).Put("  ").PutHex(op.opcode, 4).Put("    ");
+		op.WriteMnemonic(out);
+		if (op.GetFlow() == DecodedOp::FLOW_INDIRECT)
+		{
+			out.Put("    ; computed jump");
+		}
+		out.Put('\n');
+		address += 2;
+	}
+}
+
+void ControlFlowGraph::WriteDot(std::string_view name, TextBuffer &out) const
+{
+	out.Put("digraph \"").Put(name).Put("\" {\n");
+	out.Put("    node [shape=box fontname=\"monospace\"];\n");
+
+	for (const BasicBlock_t &block : blocks)
+	{
+		out.Put("    b").PutHex(block.start, 3).Put(" [label=\"");
+		for (size_t address = block.start; address < block.end; address += 2)
+		{
+			const DecodedOp op = DecodeAt(address);
+			out.Put("0x").PutHex(uint32_t(address), 3).Put(": ");
+			op.WriteMnemonic(out);
+			out.Put("\\l");
+		}
+		out.Put('"');
+		if (block.start == entryPoint)
+		{
+			out.Put(" style=bold");
+		}
+		else if (block.callTarget)
+		{
+			out.Put(" style=rounded");
+		}
+		out.Put("];\n");
+	}
+
+	for (const Edge_t &edge : edges)
+	{
+		out.Put("    b").PutHex(blocks[edge.fromBlock].start, 3).Put(" -> b").PutHex(edge.to, 3);
+		switch (edge.kind)
+		{
+			case EDGE_CALL: out.Put(" [style=dashed label=\"call\"]"); break;
+			case EDGE_SKIP: out.Put(" [label=\"skip\"]"); break;
+			case EDGE_JUMP: out.Put(" [label=\"jump\"]"); break;
+			default: break;
+		}
+		out.Put(";\n");
+	}
+	out.Put("}\n");
+}
@@ -0,0 +1,443 @@
+#ifndef _CHIP8_DISASSEMBLER_HPP_
+#define _CHIP8_DISASSEMBLER_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <string_view>
+#include <algorithm>
+
+namespace CHIP8
+{
+	/**
+	 * @brief Text Buffer
+	 *
+	 * This class is a reusable character buffer the disassembler writes into.
+	 * Clear() keeps the storage, so a buffer reused across ROMs stops allocating
+	 * once it grew to the largest output.
+	 */
+	class TextBuffer
+	{
+		std::vector<char> storage;
+		size_t length = 0;
+
+		char *Reserve(size_t count)
+		{
+			if (length + count > storage.size())
+			{
+				storage.resize(std::max(storage.size() * 2, length + count));
+			}
+			char *position = storage.data() + length;
+			length += count;
+			return position;
+		}
+	public:
+		/**
+		 * @brief Construct a new Text Buffer object
+		 *
+		 * @param capacity : Initial size of the storage in bytes
+		 */
+		TextBuffer(size_t capacity = 1 << 16) : storage(capacity) {};
+
+		/**
+		 * @brief Empty the buffer, keeping its storage
+		 */
+		void Clear()
+		{
+			length = 0;
+		}
+
+		/**
+		 * @brief Append text
+		 *
+		 * @param text : The text to append
+		 * @return TextBuffer& : The buffer
+		 */
+		TextBuffer &Put(std::string_view text)
+		{
+			std::copy(text.begin(), text.end(), Reserve(text.size()));
+			return *this;
+		}
+
+		/**
+		 * @brief Append a character
+		 *
+		 * @param character : The character to append
+		 * @return TextBuffer& : The buffer
+		 */
+		TextBuffer &Put(char character)
+		{
+			*Reserve(1) = character;
+			return *this;
+		}
+
+		/**
+		 * @brief Append a number as uppercase hexadecimal
+		 *
+		 * @param value : The number
+		 * @param digits : Minimum number of digits, padded with zeros
+		 * @return TextBuffer& : The buffer
+		 */
+		TextBuffer &PutHex(uint32_t value, unsigned digits = 1)
+		{
+			unsigned count = 1;
+			while (count < 8 && (value >> (4 * count)) != 0)
+			{
+				count++;
+			}
+			count = std::max(count, digits);
+
+			char *position = Reserve(count);
+			for (unsigned i = 0; i < count; i++)
+			{
+				position[count - 1 - i] = "0123456789ABCDEF"[(value >> (4 * i)) & 0xF];
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Append a number as decimal
+		 *
+		 * @param value : The number
+		 * @return TextBuffer& : The buffer
+		 */
+		TextBuffer &PutDecimal(uint32_t value)
+		{
+			char digits[10];
+			unsigned count = 0;
+			do
+			{
+				digits[count++] = char('0' + value % 10);
+				value /= 10;
+			} while (value != 0);
+
+			char *position = Reserve(count);
+			for (unsigned i = 0; i < count; i++)
+			{
+				position[i] = digits[count - 1 - i];
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Get the text written so far
+		 *
+		 * @return std::string_view : The text, valid until the buffer is written to again
+		 */
+		std::string_view View() const
+		{
+			return std::string_view(storage.data(), length);
+		}
+	};
+
+	/**
+	 * @brief Decoded Opcode
+	 *
+	 * This class is a plain decoded CHIP-8 opcode. Unlike the Instruction objects
+	 * of the InstructionDecoder, decoding does not touch any shared state, so any
+	 * number of opcodes can be decoded and kept at the same time.
+	 */
+	class DecodedOp
+	{
+	public:
+		/**
+		 * @brief Operation
+		 *
+		 * Operations of the base instruction set, named after their opcodes.
+		 */
+		enum Operation : uint8_t
+		{
+			OP_00E0 = 0, OP_00EE, OP_1NNN, OP_2NNN, OP_3XKK, OP_4XKK, OP_5XY0, OP_6XKK,
+			OP_7XKK, OP_8XY0, OP_8XY1, OP_8XY2, OP_8XY3, OP_8XY4, OP_8XY5, OP_8XY6,
+			OP_8XY7, OP_8XYE, OP_9XY0, OP_ANNN, OP_BNNN, OP_CXKK, OP_DXYN, OP_EX9E,
+			OP_EXA1, OP_FX07, OP_FX0A, OP_FX15, OP_FX18, OP_FX1E, OP_FX29, OP_FX33,
+			OP_FX55, OP_FX65, OP_ILLEGAL
+		};
+
+		/**
+		 * @brief Control Flow
+		 *
+		 * How an operation continues the program.
+		 */
+		enum Flow : uint8_t
+		{
+			FLOW_NEXT = 0,	/**< Continues with the next instruction */
+			FLOW_JUMP,		/**< Jumps to NNN */
+			FLOW_CALL,		/**< Calls NNN, returns to the next instruction */
+			FLOW_RETURN,	/**< Returns from a subroutine */
+			FLOW_SKIP,		/**< Continues with the next or the one after it */
+			FLOW_INDIRECT,	/**< Jumps to a computed address */
+			FLOW_STOP		/**< Illegal opcode, execution does not continue */
+		};
+
+		uint16_t opcode;		/**< The raw opcode */
+		Operation operation;	/**< The decoded operation */
+		uint8_t x;				/**< Register X, bits 8-11 */
+		uint8_t y;				/**< Register Y, bits 4-7 */
+		uint8_t n;				/**< Nibble N, bits 0-3 */
+		uint8_t kk;				/**< Byte KK, bits 0-7 */
+		uint16_t nnn;			/**< Address NNN, bits 0-11 */
+
+		/**
+		 * @brief Decode an opcode
+		 *
+		 * @param opcode : The opcode
+		 * @return DecodedOp : The decoded opcode, OP_ILLEGAL if unknown
+		 */
+		static constexpr DecodedOp Decode(uint16_t opcode)
+		{
+			DecodedOp op{opcode, OP_ILLEGAL, uint8_t((opcode >> 8) & 0xF), uint8_t((opcode >> 4) & 0xF),
+				uint8_t(opcode & 0xF), uint8_t(opcode & 0xFF), uint16_t(opcode & 0xFFF)};
+
+			switch (opcode >> 12)
+			{
+				case 0x0:
+					op.operation = (opcode == 0x00E0) ? OP_00E0 : (opcode == 0x00EE) ? OP_00EE : OP_ILLEGAL;
+					break;
+				case 0x1: op.operation = OP_1NNN; break;
+				case 0x2: op.operation = OP_2NNN; break;
+				case 0x3: op.operation = OP_3XKK; break;
+				case 0x4: op.operation = OP_4XKK; break;
+				case 0x5: op.operation = (op.n == 0) ? OP_5XY0 : OP_ILLEGAL; break;
+				case 0x6: op.operation = OP_6XKK; break;
+				case 0x7: op.operation = OP_7XKK; break;
+				case 0x8:
+				{
+					constexpr Operation alu[16] = {
+						OP_8XY0, OP_8XY1, OP_8XY2, OP_8XY3, OP_8XY4, OP_8XY5, OP_8XY6, OP_8XY7,
+						OP_ILLEGAL, OP_ILLEGAL, OP_ILLEGAL, OP_ILLEGAL, OP_ILLEGAL, OP_ILLEGAL, OP_8XYE, OP_ILLEGAL
+					};
+					op.operation = alu[op.n];
+					break;
+				}
+				case 0x9: op.operation = (op.n == 0) ? OP_9XY0 : OP_ILLEGAL; break;
+				case 0xA: op.operation = OP_ANNN; break;
+				case 0xB: op.operation = OP_BNNN; break;
+				case 0xC: op.operation = OP_CXKK; break;
+				case 0xD: op.operation = OP_DXYN; break;
+				case 0xE:
+					op.operation = (op.kk == 0x9E) ? OP_EX9E : (op.kk == 0xA1) ? OP_EXA1 : OP_ILLEGAL;
+					break;
+				case 0xF:
+					switch (op.kk)
+					{
+						case 0x07: op.operation = OP_FX07; break;
+						case 0x0A: op.operation = OP_FX0A; break;
+						case 0x15: op.operation = OP_FX15; break;
+						case 0x18: op.operation = OP_FX18; break;
+						case 0x1E: op.operation = OP_FX1E; break;
+						case 0x29: op.operation = OP_FX29; break;
+						case 0x33: op.operation = OP_FX33; break;
+						case 0x55: op.operation = OP_FX55; break;
+						case 0x65: op.operation = OP_FX65; break;
+						default: break;
+					}
+					break;
+			}
+			return op;
+		}
+
+		/**
+		 * @brief Get the control flow of the operation
+		 *
+		 * @return Flow : How the program continues after the operation
+		 */
+		constexpr Flow GetFlow() const
+		{
+			switch (operation)
+			{
+				case OP_1NNN:		return FLOW_JUMP;
+				case OP_2NNN:		return FLOW_CALL;
+				case OP_00EE:		return FLOW_RETURN;
+				case OP_BNNN:		return FLOW_INDIRECT;
+				case OP_ILLEGAL:	return FLOW_STOP;
+				case OP_3XKK:
+				case OP_4XKK:
+				case OP_5XY0:
+				case OP_9XY0:
+				case OP_EX9E:
+				case OP_EXA1:		return FLOW_SKIP;
+				default:			return FLOW_NEXT;
+			}
+		}
+
+		/**
+		 * @brief Write the mnemonic
+		 *
+		 * Writes the same text as Instruction::GetMnemonic() without allocating.
+		 *
+		 * @param out : Buffer to append the mnemonic to
+		 */
+		void WriteMnemonic(TextBuffer &out) const;
+	};
+
+	/**
+	 * @brief Control Flow Graph
+	 *
+	 * This class recovers the code of a ROM by walking it from the entry point,
+	 * following jumps, calls and both paths of skips, and splits the reached code
+	 * into basic blocks. Computed jumps (BNNN) end their block without successors
+	 * and are listed by GetIndirectJumps().
+	 *
+	 * Analyze() reuses the storage of the previous run, so a single graph can be
+	 * used to process any number of ROMs.
+	 */
+	class ControlFlowGraph
+	{
+	public:
+		/**
+		 * @brief Edge Kind
+		 *
+		 * How control gets from one block to the other.
+		 */
+		enum EdgeKind : uint8_t
+		{
+			EDGE_FALLTHROUGH = 0,	/**< Continues with the next instruction, also the return from a call */
+			EDGE_JUMP,				/**< Jump */
+			EDGE_CALL,				/**< Subroutine call */
+			EDGE_SKIP				/**< Skip taken */
+		};
+
+		/**
+		 * @brief Basic Block
+		 *
+		 * A straight run of instructions with a single entry and a single exit.
+		 */
+		typedef struct
+		{
+			uint16_t start;		/**< Address of the first instruction */
+			uint16_t end;		/**< Address after the last instruction */
+			bool callTarget;	/**< Entered by a call */
+		} BasicBlock_t;
+
+		/**
+		 * @brief Edge
+		 *
+		 * A control transfer from the last instruction of a block to another block.
+		 */
+		typedef struct
+		{
+			uint32_t fromBlock;	/**< Index of the block the edge leaves */
+			uint16_t from;		/**< Address of the instruction transferring control */
+			uint16_t to;		/**< Address of the block entered */
+			EdgeKind kind;		/**< Kind of the transfer */
+		} Edge_t;
+
+		/**
+		 * @brief Analyze a memory image
+		 *
+		 * @param image : Memory image, index 0 is address 0, has to stay valid while the graph is used
+		 * @param entry : Address execution starts at
+		 */
+		void Analyze(std::span<const uint8_t> image, uint16_t entry = 0x200);
+
+		/**
+		 * @brief Get the basic blocks
+		 *
+		 * @return const std::vector<BasicBlock_t>& : The blocks, sorted by address
+		 */
+		const std::vector<BasicBlock_t> &GetBlocks() const
+		{
+			return blocks;
+		}
+
+		/**
+		 * @brief Get the edges
+		 *
+		 * @return const std::vector<Edge_t>& : The edges, sorted by the block they leave
+		 */
+		const std::vector<Edge_t> &GetEdges() const
+		{
+			return edges;
+		}
+
+		/**
+		 * @brief Get the computed jumps
+		 *
+		 * @return const std::vector<uint16_t>& : Addresses of the reached BNNN instructions
+		 */
+		const std::vector<uint16_t> &GetIndirectJumps() const
+		{
+			return indirectJumps;
+		}
+
+		/**
+		 * @brief Check if an instruction starts at an address
+		 *
+		 * @param address : The address
+		 * @return bool : True if the walk reached an instruction at the address
+		 */
+		bool IsInstruction(size_t address) const
+		{
+			return address < flags.size() && (flags[address] & FLAG_INSTRUCTION);
+		}
+
+		/**
+		 * @brief Check if an address holds reached code
+		 *
+		 * @param address : The address
+		 * @return bool : True if the address is either byte of a reached instruction
+		 */
+		bool IsCode(size_t address) const
+		{
+			return IsInstruction(address) || (address > 0 && IsInstruction(address - 1));
+		}
+
+		/**
+		 * @brief Find the block containing an address
+		 *
+		 * @param address : The address
+		 * @return const BasicBlock_t* : The block, nullptr if the address is no code
+		 */
+		const BasicBlock_t *FindBlock(uint16_t address) const;
+
+		/**
+		 * @brief Write an annotated listing
+		 *
+		 * Reached instructions are listed with labels on block starts and the
+		 * transfers entering them, all other bytes as data.
+		 *
+		 * @param start : First address listed
+		 * @param end : Address after the last one listed
+		 * @param out : Buffer to append the listing to
+		 */
+		void WriteListing(uint16_t start, uint16_t end, TextBuffer &out) const;
+
+		/**
+		 * @brief Write the graph in Graphviz DOT format
+		 *
+		 * @param name : Name of the graph
+		 * @param out : Buffer to append the graph to
+		 */
+		void WriteDot(std::string_view name, TextBuffer &out) const;
+	private:
+		enum : uint8_t
+		{
+			FLAG_INSTRUCTION = 1,	/**< An instruction starts here */
+			FLAG_LEADER = 2,		/**< A block starts here */
+			FLAG_CALL_TARGET = 4,	/**< A call enters here */
+			FLAG_ENTRY = 8			/**< Execution starts here */
+		};
+
+		std::span<const uint8_t> memory;
+		uint16_t entryPoint = 0;
+		std::vector<uint8_t> flags;
+		std::vector<uint16_t> worklist;
+		std::vector<BasicBlock_t> blocks;
+		std::vector<Edge_t> edges;
+		std::vector<uint16_t> indirectJumps;
+
+		/** @brief Edge indices sorted by target, for the listing cross references */
+		std::vector<uint32_t> incoming;
+
+		DecodedOp DecodeAt(size_t address) const
+		{
+			return DecodedOp::Decode(uint16_t((memory[address] << 8) | memory[address + 1]));
+		}
+
+		void AddTarget(size_t address, uint8_t flag);
+		void AddEdge(uint16_t from, size_t to, EdgeKind kind);
+	};
+}
+
+#endif /* _CHIP8_DISASSEMBLER_HPP_ */
@@ -0,0 +1,382 @@
+#include "engine.hpp"
+#include <format>
+
+using namespace CHIP8;
+
+PredecodedEngine::PredecodedEngine(CPU &cpu) : cpu(cpu)
+{
+	Flush();
+}
+
+void PredecodedEngine::Flush()
+{
+	cache.assign(cpu.memory->GetSize(), {0, 0, Op::Undecoded, 0, 0, 0});
+}
+
+PredecodedEngine::Decoded_t PredecodedEngine::Decode(uint16_t opcode)
+{
+	Decoded_t decoded{opcode, uint16_t(opcode & 0x0FFF), Op::Illegal,
+		uint8_t((opcode >> 8) & 0x0F), uint8_t((opcode >> 4) & 0x0F), uint8_t(opcode & 0x0F)};
+
+	switch (opcode >> 12)
+	{
+	case 0x0:
+		decoded.op = (opcode == 0x00E0) ? Op::Clear : (opcode == 0x00EE) ? Op::Return : Op::Illegal;
+		break;
+	case 0x1: decoded.op = Op::Jump; break;
+	case 0x2: decoded.op = Op::Call; break;
+	case 0x3: decoded.op = Op::SkipEqualImmediate; break;
+	case 0x4: decoded.op = Op::SkipNotEqualImmediate; break;
+	case 0x5: decoded.op = (decoded.n == 0) ? Op::SkipEqual : Op::Illegal; break;
+	case 0x6: decoded.op = Op::LoadImmediate; break;
+	case 0x7: decoded.op = Op::AddImmediate; break;
+	case 0x8:
+		switch (decoded.n)
+		{
+		case 0x0: decoded.op = Op::Move; break;
+		case 0x1: decoded.op = Op::Or; break;
+		case 0x2: decoded.op = Op::And; break;
+		case 0x3: decoded.op = Op::Xor; break;
+		case 0x4: decoded.op = Op::Add; break;
+		case 0x5: decoded.op = Op::Subtract; break;
+		case 0x6: decoded.op = Op::ShiftRight; break;
+		case 0x7: decoded.op = Op::SubtractReverse; break;
+		case 0xE: decoded.op = Op::ShiftLeft; break;
+		default: break;
+		}
+		break;
+	case 0x9: decoded.op = (decoded.n == 0) ? Op::SkipNotEqual : Op::Illegal; break;
+	case 0xA: decoded.op = Op::LoadIndex; break;
+	case 0xB: decoded.op = Op::JumpOffset; break;
+	case 0xC: decoded.op = Op::Random; break;
+	case 0xD: decoded.op = Op::Draw; break;
+	case 0xE:
+		decoded.op = ((opcode & 0xFF) == 0x9E) ? Op::SkipKey : ((opcode & 0xFF) == 0xA1) ? Op::SkipNotKey : Op::Illegal;
+		break;
+	case 0xF:
+		switch (opcode & 0xFF)
+		{
+		case 0x07: decoded.op = Op::GetDelay; break;
+		case 0x0A: decoded.op = Op::WaitKey; break;
+		case 0x15: decoded.op = Op::SetDelay; break;
+		case 0x18: decoded.op = Op::SetSound; break;
+		case 0x1E: decoded.op = Op::AddIndex; break;
+		case 0x29: decoded.op = Op::Font; break;
+		case 0x33: decoded.op = Op::Bcd; break;
+		case 0x55: decoded.op = Op::Store; break;
+		case 0x65: decoded.op = Op::Load; break;
+		default: break;
+		}
+		break;
+	}
+	return decoded;
+}
+
+std::expected<bool, TrapCode> PredecodedEngine::RunCycle()
+{
+	cpu.trap = TrapCode::None;
+	cpu.instructionPC = cpu.PC;
+	auto opcode = cpu.memory->GetWord(cpu.PC);
+
+	if (!opcode)
+	{
+		cpu.fetchFault = opcode.error();
+		cpu.RaiseTrap(TrapCode::MemoryFault);
+		return std::unexpected(TrapCode::MemoryFault);
+	}
+
+	// A successful fetch guarantees PC is inside the memory
+	Decoded_t &instruction = cache[cpu.PC];
+	if (instruction.op == Op::Undecoded || instruction.opcode != opcode.value())
+	{
+		instruction = Decode(opcode.value());
+	}
+
+	cpu.PC += 2;
+	const bool successfulInstruction = Execute(instruction);
+	if (!successfulInstruction)
+	{
+		aborted = instruction;
+		abortedPC = cpu.instructionPC;
+	}
+	cpu.cycleCount++;
+	return successfulInstruction;
+}
+
+std::string PredecodedEngine::GetAbortReason() const
+{
+	switch (cpu.GetTrap())
+	{
+	case TrapCode::StackUnderflow:
+		return "Stack underflow, return without a subroutine call";
+	case TrapCode::StackOverflow:
+		return std::format("Stack overflow, call to 0x{:X} exceeds the stack depth of {}", aborted.address, CPU::GetStackDepth());
+	case TrapCode::EndlessLoop:
+		return "Endless loop detected, emulation aborted due to enabled Quirk flag";
+	case TrapCode::MemoryFault:
+		return DescribeMemoryFault(memoryFault);
+	case TrapCode::IllegalInstruction:
+		return std::format("Illegal instruction with opcode 0x{:04X} at address 0x{:04X}", aborted.opcode, abortedPC);
+	default:
+		return std::string(TRAP_NAMES[size_t(cpu.GetTrap())]);
+	}
+}
+
+bool PredecodedEngine::Execute(const Decoded_t &instruction)
+{
+	auto &V = cpu.V;
+	const uint8_t x = instruction.x;
+	const uint8_t y = instruction.y;
+	const uint8_t kk = uint8_t(instruction.address);
+	const Quirks &quirks = cpu.quirks;
+
+	switch (instruction.op)
+	{
+	case Op::Clear:
+		cpu.display->Clear();
+		break;
+	case Op::Return:
+	{
+		auto address = cpu.PopStack();
+		if (!address)
+		{
+			return false;
+		}
+		cpu.PC = address.value();
+		break;
+	}
+	case Op::Jump:
+		if (quirks.CatchEndlessJump && instruction.address == uint16_t(cpu.PC - 2))
+		{
+			cpu.RaiseTrap(TrapCode::EndlessLoop);
+			return false;
+		}
+		cpu.PC = instruction.address;
+		break;
+	case Op::Call:
+		if (!cpu.PushStack(cpu.PC))
+		{
+			return false;
+		}
+		cpu.PC = instruction.address;
+		break;
+	case Op::SkipEqualImmediate:
+		cpu.PC += (V[x] == kk) ? 2 : 0;
+		break;
+	case Op::SkipNotEqualImmediate:
+		cpu.PC += (V[x] != kk) ? 2 : 0;
+		break;
+	case Op::SkipEqual:
+		cpu.PC += (V[x] == V[y]) ? 2 : 0;
+		break;
+	case Op::LoadImmediate:
+		V[x] = kk;
+		break;
+	case Op::AddImmediate:
+		V[x] = uint8_t(V[x] + kk);
+		break;
+	case Op::Move:
+		V[x] = V[y];
+		break;
+	case Op::Or:
+		V[x] |= V[y];
+		V[0xF] = quirks.VFreset ? 0 : V[0xF];
+		break;
+	case Op::And:
+		V[x] &= V[y];
+		V[0xF] = quirks.VFreset ? 0 : V[0xF];
+		break;
+	case Op::Xor:
+		V[x] ^= V[y];
+		V[0xF] = quirks.VFreset ? 0 : V[0xF];
+		break;
+	case Op::Add:
+	{
+		const uint16_t value = uint16_t(V[x] + V[y]);
+		V[x] = uint8_t(value);
+		V[0xF] = (value > 0xFF) ? 1 : 0;
+		break;
+	}
+	case Op::Subtract:
+	{
+		const bool notBorrow = V[x] >= V[y];
+		V[x] = uint8_t(V[x] - V[y]);
+		V[0xF] = notBorrow;
+		break;
+	}
+	case Op::ShiftRight:
+	{
+		const uint8_t source = quirks.Shift ? V[x] : V[y];
+		V[x] = source >> 1;
+		V[0xF] = source & 0x01;
+		break;
+	}
+	case Op::SubtractReverse:
+	{
+		const bool notBorrow = V[y] >= V[x];
+		V[x] = uint8_t(V[y] - V[x]);
+		V[0xF] = notBorrow;
+		break;
+	}
+	case Op::ShiftLeft:
+	{
+		const uint8_t source = quirks.Shift ? V[x] : V[y];
+		V[x] = uint8_t(source << 1);
+		V[0xF] = source >> 7;
+		break;
+	}
+	case Op::SkipNotEqual:
+		cpu.PC += (V[x] != V[y]) ? 2 : 0;
+		break;
+	case Op::LoadIndex:
+		cpu.I = instruction.address;
+		break;
+	case Op::JumpOffset:
+		cpu.PC = uint16_t(instruction.address + V[quirks.Jump ? x : 0]);
+		break;
+	case Op::Random:
+		V[x] = cpu.GetRandomByte() & kk;
+		break;
+	case Op::Draw:
+		return Draw(instruction);
+	case Op::SkipKey:
+		cpu.PC += cpu.keypad->IsKeyPressed(Keypad::Key(V[x] & 0x0F)) ? 2 : 0;
+		break;
+	case Op::SkipNotKey:
+		cpu.PC += cpu.keypad->IsKeyPressed(Keypad::Key(V[x] & 0x0F)) ? 0 : 2;
+		break;
+	case Op::GetDelay:
+		V[x] = cpu.timers->GetDelayTimer();
+		break;
+	case Op::WaitKey:
+	{
+		const Keypad::Key key = cpu.keypad->WaitForKeyPress();
+		if (key != Keypad::Key::KEY_INVALID)
+		{
+			V[x] = uint8_t(key);
+		}
+		else
+		{
+			// Repeat the instruction until a key is pressed
+			cpu.PC -= 2;
+		}
+		break;
+	}
+	case Op::SetDelay:
+		cpu.timers->SetDelayTimer(V[x]);
+		break;
+	case Op::SetSound:
+		cpu.timers->SetSoundTimer(V[x]);
+		break;
+	case Op::AddIndex:
+		cpu.I = uint16_t(cpu.I + V[x]);
+		break;
+	case Op::Font:
+		cpu.I = uint16_t((V[x] & 0x0F) * 5 + cpu.memory->GetFontStart());
+		break;
+	case Op::Bcd:
+	{
+		uint8_t value = V[x];
+		for (int i = 2; i >= 0; i--)
+		{
+			auto written = cpu.memory->SetByte(uint16_t(cpu.I + i), value % 10);
+			value /= 10;
+			if (!written)
+			{
+				memoryFault = written.error();
+				cpu.RaiseTrap(TrapCode::MemoryFault);
+				return false;
+			}
+		}
+		break;
+	}
+	case Op::Store:
+	{
+		bool successful = true;
+		for (uint8_t i = 0; i <= x; i++)
+		{
+			auto address = cpu.memory->GetAddress(cpu.I, i);
+			auto written = address ? cpu.memory->SetByte(address.value(), V[i]) : std::unexpected(address.error());
+			if (!written)
+			{
+				memoryFault = written.error();
+				cpu.RaiseTrap(TrapCode::MemoryFault);
+				successful = false;
+				break;
+			}
+		}
+		if (!quirks.MemoryLeaveIunchanged)
+		{
+			cpu.I = uint16_t(cpu.I + x + (quirks.MemoryIncrementByX ? 0 : 1));
+		}
+		return successful;
+	}
+	case Op::Load:
+	{
+		bool successful = true;
+		for (uint8_t i = 0; i <= x; i++)
+		{
+			auto address = cpu.memory->GetAddress(cpu.I, i);
+			auto value = address ? cpu.memory->GetByte(address.value()) : std::unexpected(address.error());
+			if (!value)
+			{
+				memoryFault = value.error();
+				cpu.RaiseTrap(TrapCode::MemoryFault);
+				successful = false;
+				break;
+			}
+			V[i] = value.value();
+		}
+		if (quirks.MemoryIncrementByX)
+		{
+			cpu.I = uint16_t(cpu.I + x + 1);
+		}
+		return successful;
+	}
+	case Op::Undecoded:
+	case Op::Illegal:
+		cpu.RaiseTrap(TrapCode::IllegalInstruction);
+		return false;
+	}
+	return true;
+}
+
+bool PredecodedEngine::Draw(const Decoded_t &instruction)
+{
+	Display &display = *cpu.display;
+	const int width = display.GetWidth();
+	const int height = display.GetHeight();
+	const int displayX = cpu.V[instruction.x] % width;
+	const int displayY = cpu.V[instruction.y] % height;
+	const bool wrap = cpu.quirks.WrapSprite;
+	bool collision = false;
+	bool successful = true;
+
+	for (int iy = 0; iy < instruction.n; iy++)
+	{
+		auto row = cpu.memory->GetByte(uint16_t(cpu.I + iy));
+		if (!row)
+		{
+			memoryFault = row.error();
+			cpu.RaiseTrap(TrapCode::MemoryFault);
+			successful = false;
+			break;
+		}
+
+		int spriteY = displayY + iy;
+		if (wrap)
+		{
+			spriteY %= height;
+		}
+		else if (spriteY >= height)
+		{
+			continue;
+		}
+
+		collision |= display.XorRow(displayX, spriteY, row.value(), 8, wrap);
+	}
+
+	display.SetUpdateRequired();
+	cpu.V[0xF] = collision ? 1 : 0;
+	return successful;
+}
@@ -0,0 +1,101 @@
+#ifndef _CHIP8_ENGINE_HPP_
+#define _CHIP8_ENGINE_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <expected>
+#include "cpu.hpp"
+
+namespace CHIP8
+{
+	/**
+	 * @brief Predecoded Engine
+	 *
+	 * Alternate execution engine for the base CHIP-8 instruction set. Instead of
+	 * going through the InstructionDecoder and a virtual Execute() per cycle, it
+	 * keeps every opcode it has seen decoded per address and dispatches with a
+	 * switch directly on the state of the CPU it is attached to.
+	 *
+	 * A cached entry is only used while the opcode at its address is unchanged,
+	 * so self-modifying code stays correct. The engine is meant to behave exactly
+	 * like CPU::RunCycle(), which the engine fuzzer checks instruction by
+	 * instruction. Instructions of extensions registered with the decoder are
+	 * not known to this engine and abort as illegal.
+	 */
+	class PredecodedEngine
+	{
+	public:
+		/**
+		 * @brief Attach the engine to a CPU
+		 *
+		 * @param cpu : CPU whose state the engine executes on, has to outlive the engine
+		 */
+		explicit PredecodedEngine(CPU &cpu);
+
+		/**
+		 * @brief Run a cycle
+		 *
+		 * Same contract as CPU::RunCycle(). The CPU's current instruction is not
+		 * updated, use GetAbortReason() if an instruction returns false.
+		 *
+		 * @return std::expected<bool, TrapCode> : True if the instruction was successful, false if it aborted,
+		 *                                         the trap if the opcode could not be fetched
+		 */
+		std::expected<bool, TrapCode> RunCycle();
+
+		/**
+		 * @brief Get the reason the last aborted instruction gave
+		 *
+		 * The message is built from the pending trap of the CPU on request, so
+		 * aborting does not allocate.
+		 *
+		 * @return std::string : Message in the wording of the instruction classes
+		 */
+		std::string GetAbortReason() const;
+
+		/**
+		 * @brief Drop all decoded instructions
+		 */
+		void Flush();
+	private:
+		enum class Op : uint8_t
+		{
+			Undecoded = 0,
+			Clear, Return, Jump, Call,
+			SkipEqualImmediate, SkipNotEqualImmediate, SkipEqual, LoadImmediate, AddImmediate,
+			Move, Or, And, Xor, Add, Subtract, ShiftRight, SubtractReverse, ShiftLeft,
+			SkipNotEqual, LoadIndex, JumpOffset, Random, Draw,
+			SkipKey, SkipNotKey, GetDelay, WaitKey, SetDelay, SetSound,
+			AddIndex, Font, Bcd, Store, Load,
+			Illegal
+		};
+
+		/**
+		 * @brief Decoded instruction
+		 *
+		 * The opcode it was decoded from and its operands.
+		 */
+		typedef struct
+		{
+			uint16_t opcode;
+			uint16_t address;		/**< NNN, KK is its lower byte */
+			Op op;
+			uint8_t x;
+			uint8_t y;
+			uint8_t n;
+		} Decoded_t;
+
+		CPU &cpu;
+		std::vector<Decoded_t> cache;		/**< Indexed by address */
+		Decoded_t aborted = {};				/**< Last instruction that returned false */
+		uint16_t abortedPC = 0;
+		MemoryFault_t memoryFault = {};		/**< Access of the last memory fault */
+
+		static Decoded_t Decode(uint16_t opcode);
+		bool Execute(const Decoded_t &instruction);
+		bool Draw(const Decoded_t &instruction);
+	};
+}
+
+#endif /* _CHIP8_ENGINE_HPP_ */
@@ -0,0 +1,524 @@
+#include "frameserver.hpp"
+#include "delta.hpp"
+#include <algorithm>
+#include <format>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using namespace CHIP8;
+
+namespace
+{
+	/** @brief Events handled per epoll_wait() */
+	constexpr int MAX_EVENTS = 32;
+
+	/** @brief Type of the key message of a viewer */
+	constexpr uint8_t KEY_MESSAGE = 'K';
+
+	/**
+	 * @brief Store a number little endian
+	 */
+	void PutLE(uint8_t *out, uint64_t value, size_t bytes)
+	{
+		for (size_t i = 0; i < bytes; i++)
+		{
+			out[i] = uint8_t(value >> (8 * i));
+		}
+	}
+
+	/**
+	 * @brief Build a message out of the header of a frame and a payload
+	 */
+	void BuildMessage(std::vector<uint8_t> &message, const uint8_t *header, uint8_t type, std::span<const uint8_t> payload)
+	{
+		message.assign(header, header + FrameServer::HEADER_SIZE);
+		message[0] = type;
+		PutLE(&message[16], payload.size(), 4);
+		message.insert(message.end(), payload.begin(), payload.end());
+	}
+}
+
+FrameServer::FrameServer(std::shared_ptr<Timers> timers) : timers(timers)
+{
+}
+
+FrameServer::~FrameServer()
+{
+	Stop();
+}
+
+void FrameServer::WriteFrame(std::span<const uint8_t> packed, int width, int height, int planes)
+{
+	if (width != this->width || height != this->height || planes != this->planes)
+	{
+		this->width = width;
+		this->height = height;
+		this->planes = planes;
+		previousPublished = false;
+	}
+
+	if (viewerCount.load(std::memory_order_relaxed) > 0)
+	{
+		Publish(packed, timers != nullptr && timers->GetBeeperState());
+	}
+	else
+	{
+		// Skip a number, so nobody takes the next frame for a delta of this one
+		frameNumber++;
+		previousPublished = false;
+	}
+	previous.assign(packed.begin(), packed.end());
+}
+
+void FrameServer::RepeatFrame()
+{
+	if (viewerCount.load(std::memory_order_relaxed) == 0)
+	{
+		previousPublished = false;
+		return;
+	}
+
+	// New viewers wait for a frame and the beeper may change without a new frame
+	const bool beeper = timers != nullptr && timers->GetBeeperState();
+	if (!previous.empty() && (!previousPublished || beeper != publishedBeeper))
+	{
+		Publish(previous, beeper);
+	}
+}
+
+void FrameServer::Publish(std::span<const uint8_t> packed, bool beeper)
+{
+	auto frame = std::make_shared<Frame_t>();
+	frame->number = ++frameNumber;
+	frame->packed.assign(packed.begin(), packed.end());
+
+	uint8_t *header = frame->header;
+	std::memset(header, 0, HEADER_SIZE);
+	header[1] = beeper ? 1 : 0;
+	header[2] = uint8_t(planes);
+	PutLE(&header[4], uint16_t(width), 2);
+	PutLE(&header[6], uint16_t(height), 2);
+	PutLE(&header[8], frame->number, 8);
+
+	if (previousPublished)
+	{
+		scratch.resize(Delta::MaxEncodedSize(packed.size()));
+		const size_t size = Delta::EncodeXor(frame->packed, previous, scratch);
+		BuildMessage(frame->delta, header, 'D', std::span<const uint8_t>(scratch.data(), size));
+	}
+	previousPublished = true;
+	publishedBeeper = beeper;
+
+	{
+		std::lock_guard lock(frameMutex);
+		latest = std::move(frame);
+	}
+#ifdef __linux__
+	const uint64_t signal = 1;
+	if (wakeup >= 0)
+	{
+		(void)!write(wakeup, &signal, sizeof(signal));
+	}
+#endif
+}
+
+#ifdef __linux__
+
+std::expected<uint16_t, std::string> FrameServer::Start(uint16_t port)
+{
+	if (listener >= 0)
+	{
+		return std::unexpected("Frame server: server is already running");
+	}
+
+	const int socket = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (socket < 0)
+	{
+		return std::unexpected("Frame server: failed to create the socket");
+	}
+
+	const int enable = 1;
+	setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = htons(port);
+	socklen_t length = sizeof(address);
+	if (bind(socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0
+		|| getsockname(socket, reinterpret_cast<sockaddr *>(&address), &length) < 0)
+	{
+		close(socket);
+		return std::unexpected(std::format("Frame server: failed to listen on port {}", port));
+	}
+
+	auto listening = Listen(socket);
+	if (!listening)
+	{
+		return std::unexpected(listening.error());
+	}
+	return ntohs(address.sin_port);
+}
+
+std::expected<void, std::string> FrameServer::StartUnix(const std::string &path)
+{
+	if (listener >= 0)
+	{
+		return std::unexpected("Frame server: server is already running");
+	}
+
+	sockaddr_un address{};
+	if (path.empty() || path.size() >= sizeof(address.sun_path))
+	{
+		return std::unexpected(std::format("Frame server: invalid socket path: {}", path));
+	}
+	address.sun_family = AF_UNIX;
+	std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+	const int socket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (socket < 0)
+	{
+		return std::unexpected("Frame server: failed to create the socket");
+	}
+
+	unlink(path.c_str());
+	if (bind(socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+	{
+		close(socket);
+		return std::unexpected(std::format("Frame server: failed to listen on {}", path));
+	}
+
+	auto listening = Listen(socket);
+	if (!listening)
+	{
+		unlink(path.c_str());
+		return listening;
+	}
+	unixPath = path;
+	return std::expected<void, std::string>();
+}
+
+std::expected<void, std::string> FrameServer::Listen(int socket)
+{
+	epoll = epoll_create1(EPOLL_CLOEXEC);
+	wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (listen(socket, SOMAXCONN) < 0 || epoll < 0 || wakeup < 0)
+	{
+		close(socket);
+		if (epoll >= 0)
+		{
+			close(epoll);
+		}
+		if (wakeup >= 0)
+		{
+			close(wakeup);
+		}
+		epoll = -1;
+		wakeup = -1;
+		return std::unexpected("Frame server: failed to listen");
+	}
+
+	epoll_event event{};
+	event.events = EPOLLIN;
+	event.data.fd = socket;
+	epoll_ctl(epoll, EPOLL_CTL_ADD, socket, &event);
+	event.data.fd = wakeup;
+	epoll_ctl(epoll, EPOLL_CTL_ADD, wakeup, &event);
+
+	listener = socket;
+	stopping = false;
+	thread = std::thread(&FrameServer::Serve, this);
+	return std::expected<void, std::string>();
+}
+
+void FrameServer::Stop()
+{
+	if (listener < 0)
+	{
+		return;
+	}
+
+	stopping = true;
+	const uint64_t signal = 1;
+	(void)!write(wakeup, &signal, sizeof(signal));
+	thread.join();
+
+	while (!viewers.empty())
+	{
+		Disconnect(viewers.size() - 1);
+	}
+	close(listener);
+	close(wakeup);
+	close(epoll);
+	listener = -1;
+	wakeup = -1;
+	epoll = -1;
+	if (!unixPath.empty())
+	{
+		unlink(unixPath.c_str());
+		unixPath.clear();
+	}
+	previousPublished = false;
+}
+
+void FrameServer::Serve()
+{
+	epoll_event events[MAX_EVENTS];
+	while (!stopping)
+	{
+		const int count = epoll_wait(epoll, events, MAX_EVENTS, -1);
+		if (count < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return;
+		}
+
+		for (int i = 0; i < count && !stopping; i++)
+		{
+			const int fd = events[i].data.fd;
+			if (fd == listener)
+			{
+				Accept();
+				continue;
+			}
+			if (fd == wakeup)
+			{
+				uint64_t signals;
+				(void)!read(wakeup, &signals, sizeof(signals));
+				continue;
+			}
+
+			auto viewer = std::find_if(viewers.begin(), viewers.end(), [fd](const Viewer_t &v) { return v.socket == fd; });
+			if (viewer == viewers.end())
+			{
+				continue;
+			}
+			if ((events[i].events & EPOLLIN) && !Receive(*viewer))
+			{
+				Disconnect(size_t(viewer - viewers.begin()));
+				continue;
+			}
+			if (events[i].events & (EPOLLERR | EPOLLHUP))
+			{
+				Disconnect(size_t(viewer - viewers.begin()));
+				continue;
+			}
+			if ((events[i].events & EPOLLOUT) && viewer->waiting)
+			{
+				// Writable again, stop watching for it until the socket fills up again
+				epoll_event event{};
+				event.events = EPOLLIN;
+				event.data.fd = fd;
+				epoll_ctl(epoll, EPOLL_CTL_MOD, fd, &event);
+				viewer->waiting = false;
+			}
+		}
+
+		// Send every idle viewer the newest frame, one encoded message for all
+		std::shared_ptr<Frame_t> newest;
+		{
+			std::lock_guard lock(frameMutex);
+			newest = latest;
+		}
+		for (size_t i = viewers.size(); i-- > 0;)
+		{
+			if (!Pump(viewers[i], newest))
+			{
+				Disconnect(i);
+			}
+		}
+	}
+}
+
+void FrameServer::Accept()
+{
+	while (true)
+	{
+		const int socket = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (socket < 0)
+		{
+			return;
+		}
+		if (viewers.size() >= MAX_VIEWERS)
+		{
+			close(socket);
+			continue;
+		}
+
+		// Fails on Unix domain sockets, which do not need it
+		const int enable = 1;
+		setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+		epoll_event event{};
+		event.events = EPOLLIN;
+		event.data.fd = socket;
+		if (epoll_ctl(epoll, EPOLL_CTL_ADD, socket, &event) < 0)
+		{
+			close(socket);
+			continue;
+		}
+
+		Viewer_t viewer{};
+		viewer.socket = socket;
+		viewers.push_back(std::move(viewer));
+		viewerCount.store(viewers.size(), std::memory_order_relaxed);
+	}
+}
+
+bool FrameServer::Receive(Viewer_t &viewer)
+{
+	uint8_t buffer[256];
+	while (true)
+	{
+		const ssize_t received = recv(viewer.socket, buffer, sizeof(buffer), 0);
+		if (received == 0)
+		{
+			return false;
+		}
+		if (received < 0)
+		{
+			return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+		}
+
+		for (ssize_t i = 0; i < received; i++)
+		{
+			viewer.input[viewer.inputSize++] = buffer[i];
+			if (viewer.inputSize < KEY_MESSAGE_SIZE)
+			{
+				continue;
+			}
+			if (viewer.input[0] != KEY_MESSAGE)
+			{
+				return false;
+			}
+			viewer.keys = uint16_t(viewer.input[1] | (viewer.input[2] << 8));
+			viewer.inputSize = 0;
+			UpdateKeyMask();
+		}
+	}
+}
+
+bool FrameServer::Pump(Viewer_t &viewer, const std::shared_ptr<Frame_t> &newest)
+{
+	while (!viewer.waiting)
+	{
+		if (viewer.frame == nullptr)
+		{
+			if (newest == nullptr || newest->number == viewer.received)
+			{
+				return true;
+			}
+
+			if (!newest->delta.empty() && viewer.received + 1 == newest->number)
+			{
+				viewer.message = &newest->delta;
+			}
+			else
+			{
+				if (viewer.received != 0 && newest->number > viewer.received + 1)
+				{
+					droppedFrames.fetch_add(newest->number - viewer.received - 1, std::memory_order_relaxed);
+				}
+				if (newest->key.empty())
+				{
+					keyScratch.resize(Delta::MaxEncodedSize(newest->packed.size()));
+					const size_t size = Delta::EncodeXor(newest->packed, {}, keyScratch);
+					BuildMessage(newest->key, newest->header, 'K', std::span<const uint8_t>(keyScratch.data(), size));
+				}
+				viewer.message = &newest->key;
+			}
+			viewer.frame = newest;
+			viewer.offset = 0;
+		}
+
+		const std::vector<uint8_t> &message = *viewer.message;
+		const ssize_t sent = send(viewer.socket, message.data() + viewer.offset, message.size() - viewer.offset, MSG_NOSIGNAL | MSG_DONTWAIT);
+		if (sent < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+			{
+				return false;
+			}
+
+			// Full, the rest of the message goes out once the socket drained
+			epoll_event event{};
+			event.events = EPOLLIN | EPOLLOUT;
+			event.data.fd = viewer.socket;
+			epoll_ctl(epoll, EPOLL_CTL_MOD, viewer.socket, &event);
+			viewer.waiting = true;
+			return true;
+		}
+
+		viewer.offset += size_t(sent);
+		if (viewer.offset == message.size())
+		{
+			viewer.received = viewer.frame->number;
+			viewer.frame = nullptr;
+			viewer.message = nullptr;
+		}
+	}
+	return true;
+}
+
+void FrameServer::Disconnect(size_t index)
+{
+	const int socket = viewers[index].socket;
+	epoll_ctl(epoll, EPOLL_CTL_DEL, socket, nullptr);
+	close(socket);
+	viewers.erase(viewers.begin() + std::ptrdiff_t(index));
+	viewerCount.store(viewers.size(), std::memory_order_relaxed);
+	UpdateKeyMask();
+
+	if (viewers.empty())
+	{
+		// The next viewer starts with a fresh frame, not the one of the last session
+		std::lock_guard lock(frameMutex);
+		latest.reset();
+	}
+}
+
+void FrameServer::UpdateKeyMask()
+{
+	uint16_t mask = 0;
+	for (const auto &viewer : viewers)
+	{
+		mask |= viewer.keys;
+	}
+	keyMask.store(mask, std::memory_order_relaxed);
+}
+
+#else
+
+std::expected<uint16_t, std::string> FrameServer::Start(uint16_t)
+{
+	return std::unexpected("Frame server: the server is not supported on this platform");
+}
+
+std::expected<void, std::string> FrameServer::StartUnix(const std::string &)
+{
+	return std::unexpected("Frame server: the server is not supported on this platform");
+}
+
+void FrameServer::Stop()
+{
+}
+
+#endif
@@ -0,0 +1,288 @@
+#ifndef _CHIP8_FRAMESERVER_HPP_
+#define _CHIP8_FRAMESERVER_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <span>
+#include <expected>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include "display.hpp"
+#include "keypad.hpp"
+#include "timers.hpp"
+
+namespace CHIP8
+{
+	/**
+	 * @brief Frame Server
+	 *
+	 * A frame sink publishing the frames of a running instance to remote
+	 * viewers over a localhost TCP port or a Unix domain socket, and taking
+	 * their key presses in return. Any number of viewers can watch the same
+	 * instance, every frame is encoded once and the same bytes are sent to all
+	 * of them.
+	 *
+	 * Every message to a viewer is a 20 byte header followed by the payload,
+	 * all numbers little endian:
+	 *
+	 *     0  u8   'K' key frame or 'D' delta
+	 *     1  u8   flags, bit 0 is set while the beeper sounds
+	 *     2  u8   number of bit planes
+	 *     3  u8   reserved, 0
+	 *     4  u16  width in pixels
+	 *     6  u16  height in pixels
+	 *     8  u64  frame number
+	 *    16  u32  payload size in bytes
+	 *
+	 * The payload is Delta::EncodeXor() of the frame in the PackBuffer()
+	 * layout, against the previous frame for a delta and against a blank frame
+	 * for a key frame, so Delta::ApplyXor() onto the last frame or a zeroed
+	 * buffer decodes it. A viewer gets a delta only if it received the frame
+	 * right before, otherwise a key frame. Viewers send 3 byte messages, 'K'
+	 * followed by the u16 mask of the keys they hold; the keys of all viewers
+	 * are combined.
+	 *
+	 * The emulation thread only encodes the delta and hands it over, the
+	 * sockets are served by an epoll loop on a thread of the server. A viewer
+	 * still busy receiving a frame skips all frames published meanwhile and
+	 * continues with a key frame of the newest one, so a slow viewer never
+	 * stalls the instance or queues up stale frames. Without viewers frames
+	 * are not encoded at all.
+	 *
+	 * The server is only available on Linux, Start() fails elsewhere.
+	 */
+	class FrameServer : public FrameSink
+	{
+	public:
+		/** @brief Size of the header of a message to a viewer */
+		static constexpr size_t HEADER_SIZE = 20;
+
+		/** @brief Size of a message from a viewer */
+		static constexpr size_t KEY_MESSAGE_SIZE = 3;
+
+		/** @brief Viewers served at once, further connections are closed */
+		static constexpr size_t MAX_VIEWERS = 64;
+
+		/**
+		 * @brief Construct a new Frame Server object
+		 *
+		 * @param timers : Timers the beeper state is taken from, nullptr to always report it off
+		 */
+		explicit FrameServer(std::shared_ptr<Timers> timers = nullptr);
+
+		/**
+		 * @brief Destroy the Frame Server object, stops the server
+		 */
+		~FrameServer() override;
+
+		FrameServer(const FrameServer &) = delete;
+		FrameServer &operator=(const FrameServer &) = delete;
+
+		/**
+		 * @brief Start listening on a localhost TCP port
+		 *
+		 * @param port : TCP port to listen on, 0 to pick a free one
+		 * @return std::expected<uint16_t, std::string> : The port listened on or an error message
+		 */
+		std::expected<uint16_t, std::string> Start(uint16_t port);
+
+		/**
+		 * @brief Start listening on a Unix domain socket
+		 *
+		 * An existing socket file at the path is replaced, the file is removed by Stop().
+		 *
+		 * @param path : Path of the socket file
+		 * @return std::expected<void, std::string> : Error message if the socket could not be created
+		 */
+		std::expected<void, std::string> StartUnix(const std::string &path);
+
+		/**
+		 * @brief Stop listening and disconnect all viewers
+		 */
+		void Stop();
+
+		/**
+		 * @brief Publish a frame to the viewers
+		 */
+		void WriteFrame(std::span<const uint8_t> packed, int width, int height, int planes) override;
+
+		/**
+		 * @brief Publish the last frame again if the beeper changed or a viewer waits for it
+		 */
+		void RepeatFrame() override;
+
+		/**
+		 * @brief Get the keys held by the viewers
+		 *
+		 * @return uint16_t : Bit n is set if a viewer holds key n
+		 */
+		uint16_t GetKeyMask() const
+		{
+			return keyMask.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Get the number of connected viewers
+		 *
+		 * @return size_t : Number of viewers
+		 */
+		size_t GetViewerCount() const
+		{
+			return viewerCount.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Get the number of frames skipped by slow viewers
+		 *
+		 * @return uint64_t : Frames not sent to a viewer because a newer one was published, summed over all viewers
+		 */
+		uint64_t GetDroppedFrames() const
+		{
+			return droppedFrames.load(std::memory_order_relaxed);
+		}
+	private:
+		/**
+		 * @brief Published frame
+		 *
+		 * Written by the emulation thread before it is published, afterwards
+		 * only the server thread touches it.
+		 */
+		typedef struct
+		{
+			uint64_t number;
+			std::vector<uint8_t> packed;	/**< Frame in the PackBuffer() layout */
+			std::vector<uint8_t> delta;		/**< Delta message, empty if the previous frame was not published */
+			std::vector<uint8_t> key;		/**< Key frame message, encoded by the first viewer that needs it */
+			uint8_t header[HEADER_SIZE];	/**< Header without type and payload size */
+		} Frame_t;
+
+		/**
+		 * @brief Connected viewer, only used by the server thread
+		 */
+		typedef struct
+		{
+			int socket;
+			std::shared_ptr<Frame_t> frame;		/**< Frame being sent, nullptr if idle */
+			const std::vector<uint8_t> *message;	/**< Message of the frame being sent */
+			size_t offset;						/**< Bytes of the message already sent */
+			uint64_t received;					/**< Number of the last frame sent completely, 0 for none */
+			bool waiting;						/**< Waiting for the socket to become writable */
+			uint16_t keys;
+			uint8_t input[KEY_MESSAGE_SIZE];
+			size_t inputSize;
+		} Viewer_t;
+
+		std::shared_ptr<Timers> timers;
+
+		/** @brief Sockets and descriptors of the server thread, -1 if not open */
+		int listener = -1;
+		int epoll = -1;
+		int wakeup = -1;
+		std::string unixPath;
+
+		std::thread thread;
+		std::atomic<bool> stopping = false;
+
+		/** @brief Newest published frame, guarded by frameMutex */
+		std::shared_ptr<Frame_t> latest;
+		std::mutex frameMutex;
+
+		std::atomic<size_t> viewerCount = 0;
+		std::atomic<uint16_t> keyMask = 0;
+		std::atomic<uint64_t> droppedFrames = 0;
+
+		/** @brief State of the emulation thread */
+		std::vector<uint8_t> previous;		/**< Last frame received */
+		std::vector<uint8_t> scratch;		/**< Encoding buffer */
+		int width = 0;
+		int height = 0;
+		int planes = 0;
+		uint64_t frameNumber = 0;
+		bool previousPublished = false;		/**< Previous frame was published, so a delta against it is usable */
+		bool publishedBeeper = false;
+
+		/** @brief State of the server thread */
+		std::vector<Viewer_t> viewers;
+		std::vector<uint8_t> keyScratch;	/**< Encoding buffer of the key frames */
+
+		std::expected<void, std::string> Listen(int socket);
+		void Publish(std::span<const uint8_t> packed, bool beeper);
+		void Serve();
+		void Accept();
+		bool Receive(Viewer_t &viewer);
+		bool Pump(Viewer_t &viewer, const std::shared_ptr<Frame_t> &newest);
+		void Disconnect(size_t index);
+		void UpdateKeyMask();
+	};
+
+	/**
+	 * @brief Remote Keypad
+	 *
+	 * This keypad wraps the real keypad of the host and adds the keys held by
+	 * the viewers of a FrameServer. Like the RecordingKeypad, it samples both
+	 * into a key mask whenever the keys are updated.
+	 */
+	class RemoteKeypad : public HeadlessKeypad
+	{
+		std::shared_ptr<Keypad> keypad;
+		const FrameServer *server = nullptr;
+	public:
+		/**
+		 * @brief Construct a new Remote Keypad object
+		 *
+		 * @param keypad : The real keypad of the host
+		 */
+		RemoteKeypad(std::shared_ptr<Keypad> keypad) : keypad(keypad) {};
+
+		/**
+		 * @brief Set the server whose viewers add keys
+		 *
+		 * @param server : The server, nullptr to only use the wrapped keypad
+		 */
+		void SetServer(const FrameServer *server)
+		{
+			this->server = server;
+		}
+
+		/**
+		 * @brief Return the lowest pressed key without blocking
+		 *
+		 * Polls the keypads once if no key is pressed.
+		 *
+		 * @return enum Key : The pressed key or KEY_INVALID if no key is pressed
+		 */
+		enum Key WaitForKeyPress() override
+		{
+			enum Key key = HeadlessKeypad::WaitForKeyPress();
+			if (key == Key::KEY_INVALID)
+			{
+				UpdateKeys();
+				key = HeadlessKeypad::WaitForKeyPress();
+			}
+			return key;
+		}
+
+		/**
+		 * @brief Sample the wrapped keypad and the keys of the viewers
+		 */
+		void UpdateKeys() override
+		{
+			keypad->UpdateKeys();
+
+			uint16_t mask = (server != nullptr) ? server->GetKeyMask() : 0;
+			for (int i = 0; i < 16; i++)
+			{
+				if (keypad->IsKeyPressed(static_cast<enum Key>(i)))
+				{
+					mask |= uint16_t(1 << i);
+				}
+			}
+			SetKeyMask(mask);
+		}
+	};
+}
+
+#endif /* _CHIP8_FRAMESERVER_HPP_ */
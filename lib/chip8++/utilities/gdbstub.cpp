@@ -0,0 +1,766 @@
+#include "gdbstub.hpp"
+#include <charconv>
+#include <format>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+using namespace CHIP8;
+
+namespace
+{
+	/** @brief Number of registers: V0-VF, I, PC, SP, DT, ST and 16 stack entries */
+	constexpr unsigned REGISTER_COUNT = 16 + 5 + 16;
+
+	constexpr unsigned REGISTER_I = 16;
+	constexpr unsigned REGISTER_PC = 17;
+	constexpr unsigned REGISTER_SP = 18;
+	constexpr unsigned REGISTER_DT = 19;
+	constexpr unsigned REGISTER_ST = 20;
+	constexpr unsigned REGISTER_STACK = 21;
+
+	/** @brief Internal packets queued by the network thread */
+	constexpr std::string_view PACKET_CONNECT = "\x01" "connect";
+	constexpr std::string_view PACKET_DISCONNECT = "\x01" "disconnect";
+	constexpr std::string_view PACKET_INTERRUPT = "\x03";
+
+	unsigned RegisterSize(unsigned number)
+	{
+		return (number == REGISTER_I || number == REGISTER_PC || number >= REGISTER_STACK) ? 2 : 1;
+	}
+
+	bool ParseHex(std::string_view text, uint32_t &value)
+	{
+		auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value, 16);
+		return !text.empty() && error == std::errc() && end == text.data() + text.size();
+	}
+
+	/** @brief Encode a value as little endian hex bytes */
+	std::string HexBytes(uint32_t value, unsigned size)
+	{
+		std::string hex;
+		for (unsigned i = 0; i < size; i++)
+		{
+			hex += std::format("{:02x}", (value >> (8 * i)) & 0xFF);
+		}
+		return hex;
+	}
+
+	/** @brief Decode little endian hex bytes */
+	bool ParseHexBytes(std::string_view hex, unsigned size, uint32_t &value)
+	{
+		if (hex.size() != size * 2)
+		{
+			return false;
+		}
+		value = 0;
+		for (unsigned i = 0; i < size; i++)
+		{
+			uint32_t byte;
+			if (!ParseHex(hex.substr(i * 2, 2), byte))
+			{
+				return false;
+			}
+			value |= byte << (8 * i);
+		}
+		return true;
+	}
+
+	const std::string &TargetDescription()
+	{
+		static const std::string description = [] {
+			std::string xml = "<?xml version=\"1.0\"?>\n<!DOCTYPE target SYSTEM \"gdb-target.dtd\">\n"
+				"<target version=\"1.0\">\n<feature name=\"org.chip8pp.cpu\">\n";
+			for (unsigned i = 0; i < 16; i++)
+			{
+				xml += std::format("<reg name=\"v{:x}\" bitsize=\"8\" regnum=\"{}\"/>\n", i, i);
+			}
+			xml += "<reg name=\"i\" bitsize=\"16\" type=\"data_ptr\"/>\n"
+				"<reg name=\"pc\" bitsize=\"16\" type=\"code_ptr\"/>\n"
+				"<reg name=\"sp\" bitsize=\"8\"/>\n"
+				"<reg name=\"dt\" bitsize=\"8\"/>\n"
+				"<reg name=\"st\" bitsize=\"8\"/>\n";
+			for (unsigned i = 0; i < 16; i++)
+			{
+				xml += std::format("<reg name=\"stack{}\" bitsize=\"16\" type=\"code_ptr\"/>\n", i);
+			}
+			xml += "</feature>\n</target>\n";
+			return xml;
+		}();
+		return description;
+	}
+}
+
+GdbServer::GdbServer(CPU &cpu) : cpu(cpu), debugger(cpu)
+{
+}
+
+GdbServer::~GdbServer()
+{
+	Stop();
+}
+
+#ifndef _WIN32
+
+std::expected<uint16_t, std::string> GdbServer::Start(uint16_t port)
+{
+	if (listener >= 0)
+	{
+		return std::unexpected("GDB: server is already running");
+	}
+
+	listener = socket(AF_INET, SOCK_STREAM, 0);
+	if (listener < 0)
+	{
+		return std::unexpected("GDB: failed to create the socket");
+	}
+
+	const int enable = 1;
+	setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = htons(port);
+	socklen_t length = sizeof(address);
+	if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || listen(listener, 1) < 0
+		|| getsockname(listener, reinterpret_cast<sockaddr *>(&address), &length) < 0)
+	{
+		close(listener);
+		listener = -1;
+		return std::unexpected(std::format("GDB: failed to listen on port {}", port));
+	}
+
+	stopping = false;
+	thread = std::thread(&GdbServer::Serve, this);
+	return ntohs(address.sin_port);
+}
+
+void GdbServer::Stop()
+{
+	if (listener < 0)
+	{
+		return;
+	}
+
+	stopping = true;
+	shutdown(listener, SHUT_RDWR);
+	{
+		std::lock_guard<std::mutex> lock(sendMutex);
+		if (client >= 0)
+		{
+			shutdown(client, SHUT_RDWR);
+		}
+	}
+	queueSignal.notify_all();
+	thread.join();
+	close(listener);
+	listener = -1;
+
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		queue.clear();
+		pending = false;
+	}
+	Detach();
+}
+
+void GdbServer::Serve()
+{
+	while (!stopping)
+	{
+		const int socket = accept(listener, nullptr, nullptr);
+		if (socket < 0)
+		{
+			continue;
+		}
+
+		const int enable = 1;
+		setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+		noAck = false;
+		client = socket;
+		Enqueue(std::string(PACKET_CONNECT));
+
+		Receive(socket);
+
+		{
+			std::lock_guard<std::mutex> lock(sendMutex);
+			client = -1;
+			close(socket);
+		}
+		Enqueue(std::string(PACKET_DISCONNECT));
+	}
+}
+
+void GdbServer::Receive(int socket)
+{
+	enum { IDLE, DATA, CHECKSUM_HIGH, CHECKSUM_LOW } parser = IDLE;
+	std::string packet;
+	uint8_t sum = 0;
+	uint32_t checksum = 0;
+	char buffer[1024];
+
+	while (!stopping)
+	{
+		const ssize_t received = recv(socket, buffer, sizeof(buffer), 0);
+		if (received <= 0)
+		{
+			return;
+		}
+
+		for (ssize_t i = 0; i < received; i++)
+		{
+			const char character = buffer[i];
+			switch (parser)
+			{
+				case IDLE:
+					// Acknowledgements are ignored, Ctrl-C interrupts the CPU
+					if (character == '$')
+					{
+						packet.clear();
+						sum = 0;
+						parser = DATA;
+					}
+					else if (character == PACKET_INTERRUPT[0])
+					{
+						Enqueue(std::string(PACKET_INTERRUPT));
+					}
+					break;
+				case DATA:
+					if (character == '#')
+					{
+						parser = CHECKSUM_HIGH;
+					}
+					else
+					{
+						packet += character;
+						sum = uint8_t(sum + uint8_t(character));
+					}
+					break;
+				case CHECKSUM_HIGH:
+				case CHECKSUM_LOW:
+				{
+					uint32_t digit;
+					if (!ParseHex(std::string_view(&character, 1), digit))
+					{
+						digit = 0x100;
+					}
+					checksum = (parser == CHECKSUM_HIGH) ? digit << 4 : checksum | digit;
+					if (parser == CHECKSUM_HIGH)
+					{
+						parser = CHECKSUM_LOW;
+						break;
+					}
+
+					parser = IDLE;
+					const bool valid = checksum == sum;
+					if (!noAck)
+					{
+						Send(valid ? "+" : "-");
+					}
+					if (valid)
+					{
+						// The reply to the request is the first packet without acknowledgement
+						noAck = noAck || packet == "QStartNoAckMode";
+						Enqueue(packet);
+					}
+					break;
+				}
+			}
+		}
+	}
+}
+
+void GdbServer::Send(std::string_view data)
+{
+	std::lock_guard<std::mutex> lock(sendMutex);
+	if (client < 0)
+	{
+		return;
+	}
+
+	int flags = 0;
+#ifdef MSG_NOSIGNAL
+	flags = MSG_NOSIGNAL;
+#endif
+	while (!data.empty())
+	{
+		const ssize_t sent = send(client, data.data(), data.size(), flags);
+		if (sent <= 0)
+		{
+			return;
+		}
+		data.remove_prefix(size_t(sent));
+	}
+}
+
+#else
+
+std::expected<uint16_t, std::string> GdbServer::Start(uint16_t)
+{
+	return std::unexpected("GDB: the server is not supported on this platform");
+}
+
+void GdbServer::Stop()
+{
+}
+
+void GdbServer::Serve()
+{
+}
+
+void GdbServer::Receive(int)
+{
+}
+
+void GdbServer::Send(std::string_view)
+{
+}
+
+#endif
+
+void GdbServer::Enqueue(std::string packet)
+{
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		queue.push_back(std::move(packet));
+		pending.store(true, std::memory_order_release);
+	}
+	queueSignal.notify_one();
+}
+
+void GdbServer::SendPacket(std::string_view payload)
+{
+	std::string packet = "$";
+	uint8_t sum = 0;
+	for (char character : payload)
+	{
+		// Escape the characters framing packets and marking run lengths
+		if (character == '$' || character == '#' || character == '}' || character == '*')
+		{
+			packet += '}';
+			sum = uint8_t(sum + '}');
+			character ^= 0x20;
+		}
+		packet += character;
+		sum = uint8_t(sum + uint8_t(character));
+	}
+	packet += std::format("#{:02x}", sum);
+	Send(packet);
+}
+
+void GdbServer::Halt(std::string stopReply)
+{
+	// Without a debugger there is nobody to continue the CPU
+	if (client < 0)
+	{
+		state = RunState::Running;
+		return;
+	}
+	state = RunState::Halted;
+	lastStop = std::move(stopReply);
+	SendPacket(lastStop);
+}
+
+void GdbServer::Detach()
+{
+	debugger.ClearBreakpoints();
+	debugger.ClearWatchpoints();
+	watchpoints.clear();
+	state = RunState::Running;
+}
+
+void GdbServer::Service()
+{
+	while (true)
+	{
+		std::string packet;
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			if (state == RunState::Halted)
+			{
+				queueSignal.wait(lock, [this] { return !queue.empty() || stopping; });
+			}
+			if (queue.empty())
+			{
+				pending = false;
+				if (stopping)
+				{
+					state = RunState::Running;
+				}
+				return;
+			}
+			packet = std::move(queue.front());
+			queue.pop_front();
+			pending = !queue.empty();
+		}
+
+		if (packet == PACKET_CONNECT)
+		{
+			lastStop = "S05";
+			state = RunState::Halted;
+		}
+		else if (packet == PACKET_DISCONNECT)
+		{
+			Detach();
+		}
+		else if (packet == PACKET_INTERRUPT)
+		{
+			if (state != RunState::Halted)
+			{
+				Halt("S02");
+			}
+		}
+		else
+		{
+			// Continue and step reply with a stop packet once the CPU halts again
+			const std::optional<std::string> reply = Handle(packet);
+			if (reply)
+			{
+				SendPacket(reply.value());
+			}
+		}
+
+		if (state != RunState::Halted && !pending)
+		{
+			return;
+		}
+	}
+}
+
+std::expected<bool, TrapCode> GdbServer::RunCycle()
+{
+	if (pending.load(std::memory_order_acquire) || state != RunState::Running) [[unlikely]]
+	{
+		Service();
+	}
+
+	const Debugger::StopInfo_t stop = (state == RunState::Stepping) ? debugger.Step() : debugger.Run(1);
+	switch (stop.reason)
+	{
+		case Debugger::StopReason::Step:
+		case Debugger::StopReason::Breakpoint:
+			Halt("S05");
+			return true;
+		case Debugger::StopReason::Watchpoint:
+		{
+			const char *kind = (stop.access == Debugger::WATCH_READ) ? "rwatch" : "watch";
+			for (const auto &[key, id] : watchpoints)
+			{
+				if (id == stop.watchpoint && key[1] == '4')
+				{
+					kind = "awatch";
+				}
+			}
+			Halt(std::format("T05{}:{:x};", kind, stop.address));
+			return true;
+		}
+		case Debugger::StopReason::InstructionAbort:
+			// Report the trap as the signal a native program would get
+			switch (cpu.GetTrap())
+			{
+				case TrapCode::StackOverflow:
+				case TrapCode::StackUnderflow:
+				case TrapCode::MemoryFault:	Halt("S0b"); break;
+				case TrapCode::EndlessLoop:	Halt("S05"); break;
+				case TrapCode::Exit:		Halt("W00"); break;
+				default:					Halt("S04"); break;
+			}
+			return false;
+		case Debugger::StopReason::Error:
+			Halt("S0b");
+			return std::unexpected(cpu.GetTrap());
+		default:
+			return true;
+	}
+}
+
+std::string GdbServer::ReadRegister(unsigned number)
+{
+	uint32_t value;
+	if (number < 16)
+	{
+		value = cpu.GetRegister(uint8_t(number));
+	}
+	else if (number >= REGISTER_STACK)
+	{
+		value = cpu.GetStackEntry(number - REGISTER_STACK);
+	}
+	else
+	{
+		switch (number)
+		{
+			case REGISTER_I:	value = cpu.GetIndex(); break;
+			case REGISTER_PC:	value = cpu.GetPC(); break;
+			case REGISTER_SP:	value = uint32_t(cpu.GetStackPointer()); break;
+			case REGISTER_DT:	value = cpu.GetTimers()->GetDelayTimer(); break;
+			default:			value = cpu.GetTimers()->GetSoundTimer(); break;
+		}
+	}
+	return HexBytes(value, RegisterSize(number));
+}
+
+bool GdbServer::WriteRegister(unsigned number, std::string_view hex)
+{
+	uint32_t value;
+	if (number >= REGISTER_COUNT || !ParseHexBytes(hex, RegisterSize(number), value))
+	{
+		return false;
+	}
+
+	if (number < 16)
+	{
+		cpu.SetRegister(uint8_t(number), uint8_t(value));
+		return true;
+	}
+	switch (number)
+	{
+		case REGISTER_I:	cpu.SetIndex(uint16_t(value)); return true;
+		case REGISTER_PC:	cpu.SetPC(uint16_t(value)); return true;
+		case REGISTER_DT:	cpu.GetTimers()->SetDelayTimer(uint8_t(value)); return true;
+		case REGISTER_ST:	cpu.GetTimers()->SetSoundTimer(uint8_t(value)); return true;
+		default:
+			// The stack pointer and the stack are read only, accept writes that change nothing
+			return ReadRegister(number) == hex;
+	}
+}
+
+std::string GdbServer::HandleBreakpoint(const std::string &packet)
+{
+	// Z/z type,address,kind
+	const bool insert = packet[0] == 'Z';
+	const size_t comma1 = packet.find(',');
+	const size_t comma2 = packet.find(',', comma1 + 1);
+	uint32_t type, address, kind;
+	if (comma1 == std::string::npos || comma2 == std::string::npos
+		|| !ParseHex(std::string_view(packet).substr(1, comma1 - 1), type)
+		|| !ParseHex(std::string_view(packet).substr(comma1 + 1, comma2 - comma1 - 1), address)
+		|| !ParseHex(std::string_view(packet).substr(comma2 + 1), kind) || type > 4)
+	{
+		return "E01";
+	}
+
+	if (type <= 1)
+	{
+		if (insert)
+		{
+			return debugger.AddBreakpoint(uint16_t(address)) ? "OK" : "E01";
+		}
+		debugger.RemoveBreakpoint(uint16_t(address));
+		return "OK";
+	}
+
+	// Watchpoints are identified by the packet without the Z/z
+	const std::string key = "Z" + packet.substr(1);
+	if (insert)
+	{
+		static const Debugger::WatchType types[] = { Debugger::WATCH_WRITE, Debugger::WATCH_READ, Debugger::WATCH_ACCESS };
+		auto id = debugger.AddWatchpoint(uint16_t(address), uint16_t(kind), types[type - 2]);
+		if (!id)
+		{
+			return "E01";
+		}
+		watchpoints.emplace_back(key, id.value());
+		return "OK";
+	}
+	for (auto watchpoint = watchpoints.begin(); watchpoint != watchpoints.end(); watchpoint++)
+	{
+		if (watchpoint->first == key)
+		{
+			debugger.RemoveWatchpoint(watchpoint->second);
+			watchpoints.erase(watchpoint);
+			break;
+		}
+	}
+	return "OK";
+}
+
+std::string GdbServer::HandleXfer(const std::string &packet)
+{
+	// qXfer:features:read:target.xml:offset,length
+	constexpr std::string_view prefix = "qXfer:features:read:target.xml:";
+	if (!packet.starts_with(prefix))
+	{
+		return "E00";
+	}
+	const size_t comma = packet.find(',', prefix.size());
+	uint32_t offset, length;
+	if (comma == std::string::npos
+		|| !ParseHex(std::string_view(packet).substr(prefix.size(), comma - prefix.size()), offset)
+		|| !ParseHex(std::string_view(packet).substr(comma + 1), length))
+	{
+		return "E01";
+	}
+
+	const std::string &description = TargetDescription();
+	if (offset >= description.size())
+	{
+		return "l";
+	}
+	const std::string chunk = description.substr(offset, length);
+	return (offset + chunk.size() >= description.size() ? "l" : "m") + chunk;
+}
+
+std::optional<std::string> GdbServer::Handle(const std::string &packet)
+{
+	if (packet.empty())
+	{
+		return "";
+	}
+
+	switch (packet[0])
+	{
+		case '?':
+			return lastStop;
+		case 'g':
+		{
+			std::string registers;
+			for (unsigned i = 0; i < REGISTER_COUNT; i++)
+			{
+				registers += ReadRegister(i);
+			}
+			return registers;
+		}
+		case 'G':
+		{
+			size_t position = 1;
+			for (unsigned i = 0; i < REGISTER_COUNT && position < packet.size(); i++)
+			{
+				const size_t length = RegisterSize(i) * 2;
+				if (!WriteRegister(i, std::string_view(packet).substr(position, length)))
+				{
+					return "E01";
+				}
+				position += length;
+			}
+			return "OK";
+		}
+		case 'p':
+		{
+			uint32_t number;
+			if (!ParseHex(std::string_view(packet).substr(1), number) || number >= REGISTER_COUNT)
+			{
+				return "E01";
+			}
+			return ReadRegister(number);
+		}
+		case 'P':
+		{
+			const size_t equals = packet.find('=');
+			uint32_t number;
+			if (equals == std::string::npos || !ParseHex(std::string_view(packet).substr(1, equals - 1), number)
+				|| !WriteRegister(number, std::string_view(packet).substr(equals + 1)))
+			{
+				return "E01";
+			}
+			return "OK";
+		}
+		case 'm':
+		case 'M':
+		{
+			// m address,length / M address,length:data
+			const size_t comma = packet.find(',');
+			const size_t colon = packet.find(':');
+			uint32_t address, length;
+			if (comma == std::string::npos
+				|| !ParseHex(std::string_view(packet).substr(1, comma - 1), address)
+				|| !ParseHex(std::string_view(packet).substr(comma + 1, colon == std::string::npos ? std::string::npos : colon - comma - 1), length)
+				|| size_t(address) + length > cpu.GetMemory()->GetSize())
+			{
+				return "E01";
+			}
+
+			std::vector<uint8_t> bytes(length);
+			if (packet[0] == 'm')
+			{
+				cpu.GetMemory()->GetBytes(uint16_t(address), bytes);
+				std::string hex;
+				for (uint8_t byte : bytes)
+				{
+					hex += HexBytes(byte, 1);
+				}
+				return hex;
+			}
+
+			const std::string_view data = colon == std::string::npos ? std::string_view() : std::string_view(packet).substr(colon + 1);
+			for (uint32_t i = 0; i < length; i++)
+			{
+				uint32_t byte;
+				if (data.size() < (i + 1) * 2 || !ParseHex(data.substr(i * 2, 2), byte))
+				{
+					return "E01";
+				}
+				bytes[i] = uint8_t(byte);
+			}
+			cpu.GetMemory()->SetBytes(uint16_t(address), bytes);
+			return "OK";
+		}
+		case 'c':
+		case 's':
+		{
+			// Optional resume address
+			uint32_t address;
+			if (packet.size() > 1)
+			{
+				if (!ParseHex(std::string_view(packet).substr(1), address))
+				{
+					return "E01";
+				}
+				cpu.SetPC(uint16_t(address));
+			}
+			state = (packet[0] == 'c') ? RunState::Running : RunState::Stepping;
+			return std::nullopt;
+		}
+		case 'Z':
+		case 'z':
+			return HandleBreakpoint(packet);
+		case 'D':
+			Detach();
+			return "OK";
+		case 'k':
+			Detach();
+			return std::nullopt;
+		case 'H':
+		case 'T':
+			return "OK";
+		case 'q':
+			if (packet.starts_with("qSupported"))
+			{
+				return "PacketSize=4000;qXfer:features:read+;QStartNoAckMode+";
+			}
+			else if (packet == "qAttached")
+			{
+				return "1";
+			}
+			else if (packet == "qC")
+			{
+				return "QC1";
+			}
+			else if (packet == "qfThreadInfo")
+			{
+				return "m1";
+			}
+			else if (packet == "qsThreadInfo")
+			{
+				return "l";
+			}
+			else if (packet == "qSymbol::")
+			{
+				return "OK";
+			}
+			else if (packet.starts_with("qXfer:"))
+			{
+				return HandleXfer(packet);
+			}
+			return "";
+		case 'Q':
+			return (packet == "QStartNoAckMode") ? "OK" : "";
+		default:
+			return "";
+	}
+}
@@ -0,0 +1,153 @@
+#ifndef _CHIP8_GDBSTUB_HPP_
+#define _CHIP8_GDBSTUB_HPP_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <expected>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <optional>
+#include "cpu.hpp"
+#include "debugger.hpp"
+
+namespace CHIP8
+{
+	/**
+	 * @brief GDB Server
+	 *
+	 * This class exposes a CPU over the GDB remote serial protocol on a localhost
+	 * TCP port, so debuggers can inspect a live session. Every CPU gets its own
+	 * server, halting one session leaves all other instances on the host running.
+	 *
+	 * The server receives packets on its own thread and queues them. The CPU is only
+	 * touched by the emulation thread, which handles the queued packets at
+	 * instruction boundaries in RunCycle(). While the debugger halted the CPU,
+	 * RunCycle() blocks until it is continued or stepped.
+	 *
+	 * Registers are numbered V0-VF (0-15, 8 bit), I (16), PC (17), SP (18, 8 bit),
+	 * DT (19, 8 bit), ST (20, 8 bit) and the stack entries (21-36), all little
+	 * endian. The layout is also served as target.xml. Memory addresses are
+	 * CHIP-8 addresses. Software and hardware breakpoints as well as read, write
+	 * and access watchpoints are supported.
+	 */
+	class GdbServer
+	{
+	public:
+		/**
+		 * @brief Construct a new GDB Server object
+		 *
+		 * @param cpu : CPU to expose, has to outlive the server
+		 */
+		GdbServer(CPU &cpu);
+
+		/**
+		 * @brief Destroy the GDB Server object, stops the server
+		 */
+		~GdbServer();
+
+		GdbServer(const GdbServer &) = delete;
+		GdbServer &operator=(const GdbServer &) = delete;
+
+		/**
+		 * @brief Start listening
+		 *
+		 * Only connections from localhost are accepted, one at a time. The CPU
+		 * is halted as soon as a debugger connects.
+		 *
+		 * @param port : TCP port to listen on, 0 to pick a free one
+		 * @return std::expected<uint16_t, std::string> : The port listened on or an error message
+		 */
+		std::expected<uint16_t, std::string> Start(uint16_t port);
+
+		/**
+		 * @brief Stop listening and disconnect the debugger
+		 *
+		 * Has to be called from the emulation thread or while it is not in RunCycle().
+		 */
+		void Stop();
+
+		/**
+		 * @brief Execute a cycle
+		 *
+		 * Drop-in replacement for CPU::RunCycle(). Handles pending debugger requests,
+		 * blocks while the CPU is halted and then executes one instruction, stopping
+		 * on breakpoints and watchpoints.
+		 *
+		 * @return std::expected<bool, TrapCode> : Same as CPU::RunCycle()
+		 */
+		std::expected<bool, TrapCode> RunCycle();
+
+		/**
+		 * @brief Check if a debugger is connected
+		 *
+		 * @return bool : True if a debugger is connected
+		 */
+		bool IsConnected() const
+		{
+			return client.load() >= 0;
+		}
+	private:
+		/**
+		 * @brief Run State
+		 *
+		 * What RunCycle() does next, only used by the emulation thread.
+		 */
+		enum class RunState
+		{
+			Running,	/**< Run freely */
+			Halted,		/**< Wait for the debugger */
+			Stepping	/**< Execute one instruction, then halt */
+		};
+
+		CPU &cpu;
+		Debugger debugger;
+
+		/** @brief Sockets, -1 if not open */
+		int listener = -1;
+		std::atomic<int> client = -1;
+
+		std::thread thread;
+		std::atomic<bool> stopping = false;
+
+		/** @brief Packets received, guarded by queueMutex */
+		std::deque<std::string> queue;
+		std::mutex queueMutex;
+		std::condition_variable queueSignal;
+
+		/** @brief Set when packets are queued, checked by RunCycle() without locking */
+		std::atomic<bool> pending = false;
+
+		/** @brief Guards writes to the client socket */
+		std::mutex sendMutex;
+		std::atomic<bool> noAck = false;
+
+		RunState state = RunState::Running;
+
+		/** @brief Stop reply of the last halt, reported on "?" */
+		std::string lastStop = "S05";
+
+		/** @brief Watchpoint IDs by the packet that set them */
+		std::vector<std::pair<std::string, unsigned>> watchpoints;
+
+		void Serve();
+		void Receive(int socket);
+		void Enqueue(std::string packet);
+		void Service();
+		void Send(std::string_view data);
+		void SendPacket(std::string_view payload);
+		void Halt(std::string stopReply);
+		std::optional<std::string> Handle(const std::string &packet);
+		std::string ReadRegister(unsigned number);
+		bool WriteRegister(unsigned number, std::string_view hex);
+		std::string HandleBreakpoint(const std::string &packet);
+		std::string HandleXfer(const std::string &packet);
+		void Detach();
+	};
+}
+
+#endif /* _CHIP8_GDBSTUB_HPP_ */
@@ -0,0 +1,393 @@
+#include "inflate.hpp"
+#include <array>
+#include <format>
+
+using namespace CHIP8;
+
+namespace
+{
+	constexpr unsigned MAX_BITS = 15;
+	constexpr unsigned MAX_LITERAL_CODES = 288;
+	constexpr unsigned MAX_DISTANCE_CODES = 30;
+
+	constexpr uint16_t LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+		35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	constexpr uint8_t LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+		3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	constexpr uint16_t DISTANCE_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+		257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	constexpr uint8_t DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+		7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+	/** @brief Order the code length code lengths are stored in */
+	constexpr uint8_t CODE_LENGTH_ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+	/**
+	 * @brief Canonical Huffman code
+	 *
+	 * Number of codes per length and the symbols ordered by code.
+	 */
+	typedef struct
+	{
+		std::array<uint16_t, MAX_BITS + 1> counts;
+		std::array<uint16_t, MAX_LITERAL_CODES> symbols;
+	} Huffman_t;
+
+	class Decoder
+	{
+	public:
+		Decoder(std::span<const uint8_t> in, std::span<uint8_t> out) : in(in), out(out) {}
+
+		std::expected<size_t, std::string> Run();
+	private:
+		std::span<const uint8_t> in;
+		std::span<uint8_t> out;
+		size_t inPosition = 0;
+		size_t outPosition = 0;
+		uint32_t bitBuffer = 0;
+		unsigned bitCount = 0;
+		bool truncated = false;
+
+		uint32_t Bits(unsigned count);
+		int Decode(const Huffman_t &code);
+		std::expected<void, std::string> Stored();
+		std::expected<void, std::string> Codes(const Huffman_t &literals, const Huffman_t &distances);
+		std::expected<void, std::string> Dynamic();
+		std::expected<void, std::string> Fixed();
+	};
+
+	/**
+	 * @brief Build a canonical Huffman code from code lengths
+	 *
+	 * @return int : 0 for a complete code, positive for an incomplete one, negative if over-subscribed
+	 */
+	int Build(Huffman_t &code, const uint8_t *lengths, unsigned count)
+	{
+		code.counts.fill(0);
+		for (unsigned symbol = 0; symbol < count; symbol++)
+		{
+			code.counts[lengths[symbol]]++;
+		}
+		if (code.counts[0] == count)
+		{
+			return 0;
+		}
+
+		int left = 1;
+		for (unsigned length = 1; length <= MAX_BITS; length++)
+		{
+			left <<= 1;
+			left -= code.counts[length];
+			if (left < 0)
+			{
+				return left;
+			}
+		}
+
+		std::array<uint16_t, MAX_BITS + 1> offsets;
+		offsets[1] = 0;
+		for (unsigned length = 1; length < MAX_BITS; length++)
+		{
+			offsets[length + 1] = uint16_t(offsets[length] + code.counts[length]);
+		}
+		for (unsigned symbol = 0; symbol < count; symbol++)
+		{
+			if (lengths[symbol] != 0)
+			{
+				code.symbols[offsets[lengths[symbol]]++] = uint16_t(symbol);
+			}
+		}
+		return left;
+	}
+}
+
+uint32_t Decoder::Bits(unsigned count)
+{
+	uint32_t value = bitBuffer;
+	while (bitCount < count)
+	{
+		if (inPosition == in.size())
+		{
+			truncated = true;
+			return 0;
+		}
+		value |= uint32_t(in[inPosition++]) << bitCount;
+		bitCount += 8;
+	}
+	bitBuffer = value >> count;
+	bitCount -= count;
+	return value & ((1u << count) - 1);
+}
+
+int Decoder::Decode(const Huffman_t &code)
+{
+	// Codes are stored most significant bit first, walk them one bit at a time
+	int value = 0;
+	int first = 0;
+	int index = 0;
+	for (unsigned length = 1; length <= MAX_BITS; length++)
+	{
+		value |= int(Bits(1));
+		if (truncated)
+		{
+			return -1;
+		}
+		const int count = code.counts[length];
+		if (value - count < first)
+		{
+			return code.symbols[size_t(index + (value - first))];
+		}
+		index += count;
+		first += count;
+		first <<= 1;
+		value <<= 1;
+	}
+	return -1;
+}
+
+std::expected<void, std::string> Decoder::Stored()
+{
+	// Stored blocks start at a byte boundary
+	bitBuffer = 0;
+	bitCount = 0;
+	if (inPosition + 4 > in.size())
+	{
+		return std::unexpected("Deflate stream truncated");
+	}
+	const unsigned length = in[inPosition] | in[inPosition + 1] << 8;
+	const unsigned complement = in[inPosition + 2] | in[inPosition + 3] << 8;
+	inPosition += 4;
+	if (length != (~complement & 0xFFFF))
+	{
+		return std::unexpected("Deflate stored block length mismatch");
+	}
+	if (inPosition + length > in.size())
+	{
+		return std::unexpected("Deflate stream truncated");
+	}
+	if (outPosition + length > out.size())
+	{
+		return std::unexpected(std::format("Inflated data exceeds {} bytes", out.size()));
+	}
+	std::copy_n(in.begin() + inPosition, length, out.begin() + outPosition);
+	inPosition += length;
+	outPosition += length;
+	return std::expected<void, std::string>();
+}
+
+std::expected<void, std::string> Decoder::Codes(const Huffman_t &literals, const Huffman_t &distances)
+{
+	while (true)
+	{
+		int symbol = Decode(literals);
+		if (symbol < 0)
+		{
+			return std::unexpected("Invalid deflate literal code");
+		}
+		if (symbol < 256)
+		{
+			if (outPosition == out.size())
+			{
+				return std::unexpected(std::format("Inflated data exceeds {} bytes", out.size()));
+			}
+			out[outPosition++] = uint8_t(symbol);
+			continue;
+		}
+		if (symbol == 256)
+		{
+			return std::expected<void, std::string>();
+		}
+
+		symbol -= 257;
+		if (symbol >= 29)
+		{
+			return std::unexpected("Invalid deflate length code");
+		}
+		const size_t length = LENGTH_BASE[symbol] + Bits(LENGTH_EXTRA[symbol]);
+
+		symbol = Decode(distances);
+		if (symbol < 0 || symbol >= int(MAX_DISTANCE_CODES))
+		{
+			return std::unexpected("Invalid deflate distance code");
+		}
+		const size_t distance = DISTANCE_BASE[symbol] + Bits(DISTANCE_EXTRA[symbol]);
+		if (truncated)
+		{
+			return std::unexpected("Deflate stream truncated");
+		}
+		if (distance > outPosition)
+		{
+			return std::unexpected("Deflate distance too far back");
+		}
+		if (outPosition + length > out.size())
+		{
+			return std::unexpected(std::format("Inflated data exceeds {} bytes", out.size()));
+		}
+
+		// Copies may overlap their own output, copy byte by byte
+		for (size_t i = 0; i < length; i++, outPosition++)
+		{
+			out[outPosition] = out[outPosition - distance];
+		}
+	}
+}
+
+std::expected<void, std::string> Decoder::Fixed()
+{
+	static const auto codes = []() {
+		std::array<uint8_t, MAX_LITERAL_CODES + MAX_DISTANCE_CODES> lengths;
+		for (unsigned symbol = 0; symbol < MAX_LITERAL_CODES; symbol++)
+		{
+			lengths[symbol] = (symbol < 144) ? 8 : (symbol < 256) ? 9 : (symbol < 280) ? 7 : 8;
+		}
+		std::fill(lengths.begin() + MAX_LITERAL_CODES, lengths.end(), 5);
+
+		std::array<Huffman_t, 2> built;
+		Build(built[0], lengths.data(), MAX_LITERAL_CODES);
+		Build(built[1], lengths.data() + MAX_LITERAL_CODES, MAX_DISTANCE_CODES);
+		return built;
+	}();
+	return Codes(codes[0], codes[1]);
+}
+
+std::expected<void, std::string> Decoder::Dynamic()
+{
+	const unsigned literalCount = Bits(5) + 257;
+	const unsigned distanceCount = Bits(5) + 1;
+	const unsigned codeLengthCount = Bits(4) + 4;
+	if (literalCount > 286 || distanceCount > MAX_DISTANCE_CODES)
+	{
+		return std::unexpected("Invalid deflate code counts");
+	}
+
+	std::array<uint8_t, MAX_LITERAL_CODES + MAX_DISTANCE_CODES> lengths{};
+	for (unsigned i = 0; i < codeLengthCount; i++)
+	{
+		lengths[CODE_LENGTH_ORDER[i]] = uint8_t(Bits(3));
+	}
+	Huffman_t lengthCode;
+	if (Build(lengthCode, lengths.data(), 19) != 0)
+	{
+		return std::unexpected("Invalid deflate code length code");
+	}
+
+	// Literal/length and distance code lengths, run length encoded
+	for (unsigned index = 0; index < literalCount + distanceCount; )
+	{
+		const int symbol = Decode(lengthCode);
+		if (symbol < 0)
+		{
+			return std::unexpected("Invalid deflate code length");
+		}
+		if (symbol < 16)
+		{
+			lengths[index++] = uint8_t(symbol);
+			continue;
+		}
+
+		uint8_t length = 0;
+		unsigned repeat;
+		if (symbol == 16)
+		{
+			if (index == 0)
+			{
+				return std::unexpected("Deflate repeat without a previous length");
+			}
+			length = lengths[index - 1];
+			repeat = 3 + Bits(2);
+		}
+		else if (symbol == 17)
+		{
+			repeat = 3 + Bits(3);
+		}
+		else
+		{
+			repeat = 11 + Bits(7);
+		}
+		if (index + repeat > literalCount + distanceCount)
+		{
+			return std::unexpected("Deflate code lengths overflow");
+		}
+		std::fill_n(lengths.begin() + index, repeat, length);
+		index += repeat;
+	}
+	if (truncated)
+	{
+		return std::unexpected("Deflate stream truncated");
+	}
+	if (lengths[256] == 0)
+	{
+		return std::unexpected("Deflate code without end of block");
+	}
+
+	// Incomplete codes are only allowed for a single length
+	Huffman_t literals, distances;
+	const int literalResult = Build(literals, lengths.data(), literalCount);
+	if (literalResult < 0 || (literalResult > 0 && literalCount - literals.counts[0] != 1))
+	{
+		return std::unexpected("Invalid deflate literal/length code");
+	}
+	const int distanceResult = Build(distances, lengths.data() + literalCount, distanceCount);
+	if (distanceResult < 0 || (distanceResult > 0 && distanceCount - distances.counts[0] != 1))
+	{
+		return std::unexpected("Invalid deflate distance code");
+	}
+	return Codes(literals, distances);
+}
+
+std::expected<size_t, std::string> Decoder::Run()
+{
+	bool last;
+	do
+	{
+		last = Bits(1) != 0;
+		const uint32_t type = Bits(2);
+		if (truncated)
+		{
+			return std::unexpected("Deflate stream truncated");
+		}
+
+		std::expected<void, std::string> result;
+		switch (type)
+		{
+			case 0: result = Stored(); break;
+			case 1: result = Fixed(); break;
+			case 2: result = Dynamic(); break;
+			default: return std::unexpected("Invalid deflate block type");
+		}
+		if (!result)
+		{
+			return std::unexpected(result.error());
+		}
+	} while (!last);
+	return outPosition;
+}
+
+std::expected<size_t, std::string> CHIP8::Inflate(std::span<const uint8_t> in, std::span<uint8_t> out)
+{
+	return Decoder(in, out).Run();
+}
+
+uint32_t CHIP8::Crc32(std::span<const uint8_t> data, uint32_t crc)
+{
+	static const auto table = []() {
+		std::array<uint32_t, 256> entries;
+		for (uint32_t index = 0; index < entries.size(); index++)
+		{
+			uint32_t value = index;
+			for (int bit = 0; bit < 8; bit++)
+			{
+				value = (value & 1) ? (value >> 1) ^ 0xEDB88320 : value >> 1;
+			}
+			entries[index] = value;
+		}
+		return entries;
+	}();
+
+	crc = ~crc;
+	for (uint8_t byte : data)
+	{
+		crc = table[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+	}
+	return ~crc;
+}
@@ -0,0 +1,37 @@
+#ifndef _CHIP8_INFLATE_HPP_
+#define _CHIP8_INFLATE_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <expected>
+
+namespace CHIP8
+{
+	/**
+	 * @brief Inflate raw DEFLATE data
+	 *
+	 * Minimal decoder for RFC 1951 streams (stored, fixed and dynamic Huffman
+	 * blocks) as found in zip archives. It decodes into a caller provided buffer
+	 * without allocating, which suits the few kilobytes of a ROM.
+	 *
+	 * @param in : Compressed stream without zlib or gzip header
+	 * @param out : Buffer for the decompressed data
+	 * @return std::expected<size_t, std::string> : Number of decompressed bytes, error message if the stream is invalid or does not fit
+	 */
+	std::expected<size_t, std::string> Inflate(std::span<const uint8_t> in, std::span<uint8_t> out);
+
+	/**
+	 * @brief Compute the CRC-32 of data
+	 *
+	 * CRC-32 as used by zip (reflected polynomial 0xEDB88320).
+	 *
+	 * @param data : Data to checksum
+	 * @param crc : CRC of the preceding data, 0 to start
+	 * @return uint32_t : CRC of the preceding data and this data
+	 */
+	uint32_t Crc32(std::span<const uint8_t> data, uint32_t crc = 0);
+}
+
+#endif /* _CHIP8_INFLATE_HPP_ */
@@ -0,0 +1,151 @@
+#ifndef _CHIP8_MAPPEDFILE_HPP_
+#define _CHIP8_MAPPEDFILE_HPP_
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include <utility>
+#include <expected>
+#include <format>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace CHIP8
+{
+	/**
+	 * @brief Mapped File
+	 *
+	 * Read-only memory mapping of a file. The pages are shared with the page
+	 * cache, so opening large files is cheap and several mappings of the same
+	 * file take no extra memory. Without mmap the file is read into a buffer.
+	 */
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile &) = delete;
+		MappedFile &operator=(const MappedFile &) = delete;
+
+		MappedFile(MappedFile &&other) noexcept
+		{
+			*this = std::move(other);
+		}
+
+		MappedFile &operator=(MappedFile &&other) noexcept
+		{
+			if (this != &other)
+			{
+				Close();
+				data = std::exchange(other.data, nullptr);
+				size = std::exchange(other.size, 0);
+				buffer = std::move(other.buffer);
+			}
+			return *this;
+		}
+
+		~MappedFile()
+		{
+			Close();
+		}
+
+		/**
+		 * @brief Map a file
+		 *
+		 * A previously mapped file is unmapped first.
+		 *
+		 * @param path : Path of the file
+		 * @return std::expected<void, std::string> : Error message if the file could not be mapped
+		 */
+		std::expected<void, std::string> Open(const std::string &path)
+		{
+			Close();
+#ifndef _WIN32
+			const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd < 0)
+			{
+				return std::unexpected(std::format("Failed to open file: {}", path));
+			}
+
+			struct stat info;
+			if (::fstat(fd, &info) != 0)
+			{
+				::close(fd);
+				return std::unexpected(std::format("Failed to read the size of file: {}", path));
+			}
+
+			size = size_t(info.st_size);
+			if (size > 0)
+			{
+				void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (mapping == MAP_FAILED)
+				{
+					::close(fd);
+					size = 0;
+					return std::unexpected(std::format("Failed to map file: {}", path));
+				}
+				data = static_cast<const uint8_t *>(mapping);
+			}
+			// The mapping stays valid after the descriptor is closed
+			::close(fd);
+#else
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file.is_open())
+			{
+				return std::unexpected(std::format("Failed to open file: {}", path));
+			}
+			buffer.resize(size_t(file.tellg()));
+			file.seekg(0, std::ios::beg);
+			file.read(reinterpret_cast<char *>(buffer.data()), std::streamsize(buffer.size()));
+			if (!file)
+			{
+				buffer.clear();
+				return std::unexpected(std::format("Failed to read file: {}", path));
+			}
+			data = buffer.data();
+			size = buffer.size();
+#endif
+			return std::expected<void, std::string>();
+		}
+
+		/**
+		 * @brief Unmap the file
+		 */
+		void Close()
+		{
+#ifndef _WIN32
+			if (data != nullptr)
+			{
+				::munmap(const_cast<uint8_t *>(data), size);
+			}
+#endif
+			buffer.clear();
+			data = nullptr;
+			size = 0;
+		}
+
+		/**
+		 * @brief Get the content of the file
+		 *
+		 * @return std::span<const uint8_t> : The mapped bytes, empty if nothing is mapped
+		 */
+		std::span<const uint8_t> GetData() const
+		{
+			return std::span<const uint8_t>(data, size);
+		}
+	private:
+		const uint8_t *data = nullptr;
+		size_t size = 0;
+
+		/** @brief File content if the platform has no mmap */
+		std::vector<uint8_t> buffer;
+	};
+}
+
+#endif /* _CHIP8_MAPPEDFILE_HPP_ */
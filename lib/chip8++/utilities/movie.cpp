@@ -0,0 +1,245 @@
+#include "movie.hpp"
+#include "varint.hpp"
+#include <fstream>
+#include <algorithm>
+#include <iterator>
+#include <format>
+
+using namespace CHIP8;
+
+std::expected<void, std::string> Movie::Save(const std::string &path) const
+{
+	std::array<uint8_t, 6 + 3 * Varint::MAX_LENGTH + Sha1::DIGEST_SIZE> header;
+	size_t position = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		header[position++] = uint8_t(MAGIC >> (8 * i));
+	}
+	header[position++] = VERSION;
+	Varint::Put(seed, header, position);
+	Varint::Put(quirks, header, position);
+	header[position++] = uint8_t(capability);
+	Varint::Put(memorySize, header, position);
+	std::copy(romHash.begin(), romHash.end(), header.begin() + std::ptrdiff_t(position));
+	position += romHash.size();
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return std::unexpected(std::format("Failed to open movie file: {}", path));
+	}
+	file.write(reinterpret_cast<const char *>(header.data()), std::streamsize(position));
+	file.write(reinterpret_cast<const char *>(events.data()), std::streamsize(events.size()));
+	if (!file)
+	{
+		return std::unexpected(std::format("Failed to write movie file: {}", path));
+	}
+	return std::expected<void, std::string>();
+}
+
+std::expected<Movie, std::string> Movie::Load(const std::string &path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open())
+	{
+		return std::unexpected(std::format("Failed to open movie file: {}", path));
+	}
+	std::vector<uint8_t> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	uint32_t magic = 0;
+	for (size_t i = 0; i < 4 && i < content.size(); i++)
+	{
+		magic |= uint32_t(content[i]) << (8 * i);
+	}
+	if (content.size() < 5 || magic != MAGIC)
+	{
+		return std::unexpected(std::format("Not a movie file: {}", path));
+	}
+	if (content[4] != VERSION)
+	{
+		return std::unexpected(std::format("Unsupported movie version: {} != {}", content[4], VERSION));
+	}
+
+	Movie movie;
+	size_t position = 5;
+	uint64_t quirks;
+	uint64_t memorySize;
+	if (!Varint::Get(content, position, movie.seed) || !Varint::Get(content, position, quirks) ||
+		position >= content.size())
+	{
+		return std::unexpected(std::format("Movie header truncated: {}", path));
+	}
+	const uint8_t capability = content[position++];
+	if (!Varint::Get(content, position, memorySize) || content.size() - position < Sha1::DIGEST_SIZE)
+	{
+		return std::unexpected(std::format("Movie header truncated: {}", path));
+	}
+	std::copy_n(content.begin() + std::ptrdiff_t(position), Sha1::DIGEST_SIZE, movie.romHash.begin());
+	position += Sha1::DIGEST_SIZE;
+	if (capability > uint8_t(DisplayCapability::XOCHIP))
+	{
+		return std::unexpected(std::format("Unknown display capability in movie: {}", capability));
+	}
+	movie.quirks = uint16_t(quirks);
+	movie.capability = DisplayCapability(capability);
+	movie.memorySize = uint32_t(memorySize);
+	movie.events.assign(content.begin() + std::ptrdiff_t(position), content.end());
+	return movie;
+}
+
+Sha1::Digest_t Movie::HashRom(const Memory &memory)
+{
+	// ROMs start on a page boundary, the pages are hashed without copying them
+	Sha1 sha;
+	const size_t pages = memory.GetSize() / Memory::GetPageSize();
+	for (size_t page = memory.GetRomStart() / Memory::GetPageSize(); page < pages; page++)
+	{
+		sha.Update(memory.GetPage(page));
+	}
+	return sha.Finish();
+}
+
+MovieRecorder::MovieRecorder(CPU &cpu, uint64_t seed)
+ : cpu(cpu), lastCycle(cpu.GetCycleCount())
+{
+	cpu.SeedRandom(seed);
+	movie.seed = seed;
+	movie.quirks = cpu.GetQuirks().ToBits();
+	movie.capability = cpu.GetDisplay()->GetCapability();
+	movie.memorySize = uint32_t(cpu.GetMemory()->GetSize());
+	movie.romHash = Movie::HashRom(*cpu.GetMemory());
+}
+
+void MovieRecorder::PutEvent(Movie::EventType type, uint64_t cycle)
+{
+	std::array<uint8_t, Varint::MAX_LENGTH> encoded;
+	size_t position = 0;
+	Varint::Put(((cycle - lastCycle) << 2) | type, encoded, position);
+	movie.events.insert(movie.events.end(), encoded.begin(), encoded.begin() + std::ptrdiff_t(position));
+	lastCycle = cycle;
+}
+
+void MovieRecorder::RecordKeys(uint16_t mask)
+{
+	if (mask == lastMask)
+	{
+		return;
+	}
+
+	std::array<uint8_t, Varint::MAX_LENGTH> encoded;
+	size_t position = 0;
+	PutEvent(Movie::EVENT_KEYS, cpu.GetCycleCount());
+	Varint::Put(mask, encoded, position);
+	movie.events.insert(movie.events.end(), encoded.begin(), encoded.begin() + std::ptrdiff_t(position));
+	lastMask = mask;
+}
+
+void MovieRecorder::TickTimers()
+{
+	cpu.GetTimers()->DecrementTimers();
+	PutEvent(Movie::EVENT_TIMER_TICK, cpu.GetCycleCount());
+}
+
+const Movie &MovieRecorder::Finish()
+{
+	PutEvent(Movie::EVENT_END, cpu.GetCycleCount());
+	return movie;
+}
+
+void RecordingKeypad::UpdateKeys()
+{
+	keypad->UpdateKeys();
+
+	uint16_t mask = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		if (keypad->IsKeyPressed(static_cast<enum Key>(i)))
+		{
+			mask |= uint16_t(1 << i);
+		}
+	}
+	SetKeyMask(mask);
+
+	if (recorder != nullptr)
+	{
+		recorder->RecordKeys(mask);
+	}
+}
+
+std::expected<uint64_t, std::string> MoviePlayer::Play(CPU &cpu, HeadlessKeypad &keypad,
+	const std::function<void(CPU &)> &onTimerTick)
+{
+	// The same inputs on another platform do not reproduce the session
+	if (cpu.GetDisplay()->GetCapability() != movie.capability)
+	{
+		return std::unexpected(std::format("Movie recorded with display capability {}, the CPU has {}",
+			uint8_t(movie.capability), uint8_t(cpu.GetDisplay()->GetCapability())));
+	}
+	if (cpu.GetMemory()->GetSize() != movie.memorySize)
+	{
+		return std::unexpected(std::format("Movie recorded with {} bytes of memory, the CPU has {}",
+			movie.memorySize, cpu.GetMemory()->GetSize()));
+	}
+	const Sha1::Digest_t romHash = Movie::HashRom(*cpu.GetMemory());
+	if (romHash != movie.romHash)
+	{
+		return std::unexpected(std::format("Movie recorded with ROM {}, the CPU has {} loaded",
+			Sha1::ToHex(movie.romHash), Sha1::ToHex(romHash)));
+	}
+
+	const uint64_t startCycle = cpu.GetCycleCount();
+	uint64_t eventCycle = startCycle;
+	size_t position = 0;
+
+	cpu.SeedRandom(movie.seed);
+	cpu.GetQuirks().FromBits(movie.quirks);
+	keypad.SetKeyMask(0);
+
+	while (position < movie.events.size())
+	{
+		uint64_t header;
+		if (!Varint::Get(movie.events, position, header))
+		{
+			return std::unexpected(std::format("Movie event stream truncated at byte {}", position));
+		}
+		eventCycle += header >> 2;
+
+		// Run up to the cycle the event happened before. Instructions reporting
+		// an abort are replayed as well, the recording host carried on after them.
+		while (cpu.GetCycleCount() < eventCycle)
+		{
+			auto cycleStatus = cpu.RunCycle();
+			if (!cycleStatus)
+			{
+				return std::unexpected(cpu.GetCycleError());
+			}
+		}
+
+		switch (header & 3)
+		{
+			case Movie::EVENT_KEYS:
+			{
+				uint64_t mask;
+				if (!Varint::Get(movie.events, position, mask))
+				{
+					return std::unexpected(std::format("Movie event stream truncated at byte {}", position));
+				}
+				keypad.SetKeyMask(uint16_t(mask));
+				break;
+			}
+			case Movie::EVENT_TIMER_TICK:
+				if (onTimerTick)
+				{
+					onTimerTick(cpu);
+				}
+				cpu.GetTimers()->DecrementTimers();
+				break;
+			case Movie::EVENT_END:
+				return cpu.GetCycleCount() - startCycle;
+			default:
+				return std::unexpected(std::format("Unknown movie event type {}", header & 3));
+		}
+	}
+
+	return cpu.GetCycleCount() - startCycle;
+}
@@ -0,0 +1,232 @@
+#ifndef _CHIP8_MOVIE_HPP_
+#define _CHIP8_MOVIE_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <memory>
+#include <expected>
+#include <functional>
+#include "cpu.hpp"
+#include "sha1.hpp"
+
+namespace CHIP8
+{
+	/**
+	 * @brief Movie
+	 *
+	 * This class holds a recorded input session: the random seed, the quirks, the
+	 * platform and ROM it ran on and a compact event stream. Every event is pinned
+	 * to the exact CPU cycle it happened before, so a replay reproduces the session
+	 * bit-exactly without depending on the wall clock of the recording host.
+	 *
+	 * File layout: "C8MV", version byte, varint seed, varint quirk bits, display
+	 * capability byte, varint memory size, 20 bytes ROM hash, followed by the
+	 * events. An event is varint((cycle delta << 2) | type), key events are
+	 * followed by a varint key mask.
+	 */
+	class Movie
+	{
+	public:
+		/** @brief Movie file magic ("C8MV") */
+		static constexpr uint32_t MAGIC		= 0x564D3843;
+
+		/** @brief Movie file version */
+		static constexpr uint8_t VERSION	= 3;
+
+		/**
+		 * @brief Event Type
+		 *
+		 * Types of the events stored in a movie.
+		 */
+		enum EventType
+		{
+			EVENT_KEYS = 0,		/**< Key mask changed, followed by the new mask */
+			EVENT_TIMER_TICK,	/**< The 60Hz timers were decremented */
+			EVENT_END			/**< End of the recording */
+		};
+
+		/** @brief Random seed the CPU was seeded with */
+		uint64_t seed = 0;
+
+		/** @brief Quirks the session was recorded with, see Quirks::ToBits() */
+		uint16_t quirks = 0;
+
+		/** @brief Capability of the display the session was recorded with */
+		DisplayCapability capability = DisplayCapability::Chip8;
+
+		/** @brief Size of the memory the session was recorded with, in bytes */
+		uint32_t memorySize = 0;
+
+		/** @brief Hash of the ROM the session was recorded with, see HashRom() */
+		Sha1::Digest_t romHash = {};
+
+		/** @brief Encoded event stream */
+		std::vector<uint8_t> events;
+
+		/**
+		 * @brief Save the movie to a file
+		 *
+		 * @param path : Path of the movie file
+		 * @return std::expected<void, std::string> : Error message if the file could not be written
+		 */
+		std::expected<void, std::string> Save(const std::string &path) const;
+
+		/**
+		 * @brief Load a movie from a file
+		 *
+		 * @param path : Path of the movie file
+		 * @return std::expected<Movie, std::string> : The movie or an error message
+		 */
+		static std::expected<Movie, std::string> Load(const std::string &path);
+
+		/**
+		 * @brief Hash the ROM loaded into a memory
+		 *
+		 * Hashes the memory from the ROM start address on, so it has to be called
+		 * before the ROM runs. The trailing zeros make it differ from the hash of
+		 * the ROM file, but equal ROMs always hash equal in equal memory sizes.
+		 *
+		 * @param memory : Memory the ROM was loaded into
+		 * @return Sha1::Digest_t : SHA-1 of the memory from the ROM start address on
+		 */
+		static Sha1::Digest_t HashRom(const Memory &memory);
+	};
+
+	/**
+	 * @brief Movie Recorder
+	 *
+	 * This class records the key changes and timer ticks of a session into a Movie.
+	 * The recorder seeds the CPU and captures its quirks, display capability,
+	 * memory size and ROM hash when it is created, so it has to be created
+	 * before the ROM starts running.
+	 */
+	class MovieRecorder
+	{
+		CPU &cpu;
+		Movie movie;
+		uint64_t lastCycle;
+		uint16_t lastMask = 0;
+
+		void PutEvent(Movie::EventType type, uint64_t cycle);
+	public:
+		/**
+		 * @brief Construct a new Movie Recorder object
+		 *
+		 * @param cpu : CPU the session runs on
+		 * @param seed : Random seed, the CPU is seeded with it
+		 */
+		MovieRecorder(CPU &cpu, uint64_t seed);
+
+		/**
+		 * @brief Record the current key mask
+		 *
+		 * Only changes of the mask are stored.
+		 *
+		 * @param mask : Bit N set means key N is pressed
+		 */
+		void RecordKeys(uint16_t mask);
+
+		/**
+		 * @brief Decrement the CPU timers and record the tick
+		 *
+		 * Hosts call this instead of Timers::DecrementTimers() while recording.
+		 */
+		void TickTimers();
+
+		/**
+		 * @brief Finish the recording
+		 *
+		 * @return const Movie& : The recorded movie, ends at the current cycle
+		 */
+		const Movie &Finish();
+	};
+
+	/**
+	 * @brief Recording Keypad
+	 *
+	 * This keypad wraps the real keypad of the host. Whenever the keys are updated,
+	 * it samples the wrapped keypad into a key mask, records changes and then
+	 * behaves exactly like the HeadlessKeypad a replay uses.
+	 */
+	class RecordingKeypad : public HeadlessKeypad
+	{
+		std::shared_ptr<Keypad> keypad;
+		MovieRecorder *recorder = nullptr;
+	public:
+		/**
+		 * @brief Construct a new Recording Keypad object
+		 *
+		 * @param keypad : The real keypad of the host
+		 */
+		RecordingKeypad(std::shared_ptr<Keypad> keypad) : keypad(keypad) {};
+
+		/**
+		 * @brief Set the recorder key changes are recorded with
+		 *
+		 * @param recorder : The recorder, nullptr to stop recording
+		 */
+		void SetRecorder(MovieRecorder *recorder)
+		{
+			this->recorder = recorder;
+		}
+
+		/**
+		 * @brief Return the lowest pressed key without blocking
+		 *
+		 * Polls the wrapped keypad once if no key is pressed.
+		 *
+		 * @return enum Key : The pressed key or KEY_INVALID if no key is pressed
+		 */
+		enum Key WaitForKeyPress() override
+		{
+			enum Key key = HeadlessKeypad::WaitForKeyPress();
+			if (key == Key::KEY_INVALID)
+			{
+				UpdateKeys();
+				key = HeadlessKeypad::WaitForKeyPress();
+			}
+			return key;
+		}
+
+		/**
+		 * @brief Sample the wrapped keypad and record changes
+		 */
+		void UpdateKeys() override;
+	};
+
+	/**
+	 * @brief Movie Player
+	 *
+	 * This class replays a Movie headlessly at maximum speed.
+	 */
+	class MoviePlayer
+	{
+		const Movie &movie;
+	public:
+		/**
+		 * @brief Construct a new Movie Player object
+		 *
+		 * @param movie : The movie to replay, has to outlive the player
+		 */
+		MoviePlayer(const Movie &movie) : movie(movie) {};
+
+		/**
+		 * @brief Replay the movie
+		 *
+		 * Seeds the CPU, applies the quirks and runs it, feeding the recorded keys into
+		 * the keypad and ticking the timers at the recorded cycles. The ROM has to be
+		 * loaded already and the CPU must use the given keypad. A CPU whose display
+		 * capability, memory size or ROM differs from the recording is rejected.
+		 *
+		 * @param cpu : CPU to replay on
+		 * @param keypad : Keypad of the CPU
+		 * @param onTimerTick : Called at every recorded timer tick before the timers are decremented, e.g. to render a frame of audio
+		 * @return std::expected<uint64_t, std::string> : Number of cycles replayed or an error message
+		 */
+		std::expected<uint64_t, std::string> Play(CPU &cpu, HeadlessKeypad &keypad,
+			const std::function<void(CPU &)> &onTimerTick = nullptr);
+	};
+}
+
+#endif /* _CHIP8_MOVIE_HPP_ */
@@ -0,0 +1,150 @@
+#include "rewind.hpp"
+#include "delta.hpp"
+#include <format>
+
+using namespace CHIP8;
+
+RewindBuffer::RewindBuffer(size_t stateSize, size_t arenaSize, size_t maxFrames, unsigned keyframeInterval)
+ : arena(arenaSize), entries(maxFrames > 0 ? maxFrames : 1), keyframeInterval(keyframeInterval > 0 ? keyframeInterval : 1),
+   previous(stateSize), scratch(stateSize)
+{
+}
+
+void RewindBuffer::DropOldest()
+{
+	// Drop the oldest frame and every delta depending on it, until the next keyframe
+	do
+	{
+		first = (first + 1) % entries.size();
+		count--;
+	} while (count > 0 && !At(0).keyframe);
+}
+
+std::optional<size_t> RewindBuffer::Find(uint64_t frame) const
+{
+	size_t low = 0;
+	size_t high = count;
+	while (low < high)
+	{
+		size_t middle = low + (high - low) / 2;
+		if (At(middle).frame < frame)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	if (low < count && At(low).frame == frame)
+	{
+		return low;
+	}
+	return std::nullopt;
+}
+
+size_t RewindBuffer::Reserve(size_t length)
+{
+	const bool wrap = arenaHead + length > arena.size();
+	const size_t offset = wrap ? 0 : arenaHead;
+
+	// Frames are stored in the arena in capture order, so the frames in the way
+	// of the new one are always the oldest ones. When wrapping around, the frames
+	// behind the head are from the previous lap and have to go first.
+	while (count > 0)
+	{
+		const Entry_t &oldest = At(0);
+		const bool behindHead = wrap && oldest.offset >= arenaHead;
+		const bool overlaps = oldest.offset < offset + length && offset < oldest.offset + oldest.length;
+		if (!behindHead && !overlaps)
+		{
+			break;
+		}
+		DropOldest();
+	}
+	return offset;
+}
+
+std::expected<void, std::string> RewindBuffer::Capture(CPU &cpu, uint64_t frame)
+{
+	if (count > 0 && frame <= At(count - 1).frame)
+	{
+		return std::unexpected(std::format("Rewind: frame {} is not newer than frame {}", frame, At(count - 1).frame));
+	}
+
+	const size_t bound = Delta::MaxEncodedSize(scratch.size());
+	if (bound > arena.size())
+	{
+		return std::unexpected(std::format("Rewind: arena too small for a keyframe: {} < {}", arena.size(), bound));
+	}
+
+	auto saved = cpu.SaveState(scratch);
+	if (!saved)
+	{
+		return std::unexpected(saved.error());
+	}
+	if (saved.value() != scratch.size())
+	{
+		return std::unexpected(std::format("Rewind: save state size changed: {} != {}", saved.value(), scratch.size()));
+	}
+
+	if (count == entries.size())
+	{
+		DropOldest();
+	}
+
+	const size_t offset = Reserve(bound);
+	// Evicting frames can leave the buffer empty, a delta would have nothing to apply to
+	const bool keyframe = count == 0 || sinceKeyframe + 1 >= keyframeInterval;
+	const size_t length = Delta::EncodeXor(scratch, keyframe ? std::span<const uint8_t>() : std::span<const uint8_t>(previous),
+		std::span<uint8_t>(arena).subspan(offset, bound));
+
+	At(count) = {frame, offset, length, keyframe};
+	count++;
+	arenaHead = offset + length;
+	sinceKeyframe = keyframe ? 0 : sinceKeyframe + 1;
+	std::swap(previous, scratch);
+
+	return std::expected<void, std::string>();
+}
+
+std::expected<void, std::string> RewindBuffer::Restore(CPU &cpu, uint64_t frame)
+{
+	auto index = Find(frame);
+	if (!index)
+	{
+		return std::unexpected(std::format("Rewind: frame {} is not available", frame));
+	}
+
+	// The oldest stored frame is always a keyframe
+	size_t keyframe = index.value();
+	while (!At(keyframe).keyframe)
+	{
+		keyframe--;
+	}
+
+	std::fill(scratch.begin(), scratch.end(), 0);
+	for (size_t i = keyframe; i <= index.value(); i++)
+	{
+		const Entry_t &entry = At(i);
+		if (!Delta::ApplyXor(std::span<const uint8_t>(arena).subspan(entry.offset, entry.length), scratch))
+		{
+			return std::unexpected(std::format("Rewind: frame {} is corrupted", entry.frame));
+		}
+	}
+
+	auto loaded = cpu.LoadState(scratch);
+	if (!loaded)
+	{
+		return std::unexpected(loaded.error());
+	}
+
+	// Continue the timeline from the restored frame
+	count = index.value() + 1;
+	arenaHead = At(index.value()).offset + At(index.value()).length;
+	sinceKeyframe = unsigned(index.value() - keyframe);
+	std::swap(previous, scratch);
+
+	return std::expected<void, std::string>();
+}
@@ -0,0 +1,166 @@
+#ifndef _CHIP8_REWIND_HPP_
+#define _CHIP8_REWIND_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <expected>
+#include <optional>
+#include "cpu.hpp"
+
+namespace CHIP8
+{
+	/**
+	 * @brief Rewind Buffer
+	 *
+	 * This class keeps the machine state of the most recent frames in a fixed size
+	 * arena, so any of them can be restored again. Every N frames a keyframe is
+	 * stored, the frames in between only store the XOR delta to the previous frame
+	 * with unchanged runs collapsed, which usually is only a few bytes per frame.
+	 *
+	 * Nothing is allocated after construction. When the arena or the frame index
+	 * runs full, the oldest keyframe and its deltas are dropped.
+	 */
+	class RewindBuffer
+	{
+		/**
+		 * @brief Frame Entry
+		 *
+		 * Location of a stored frame in the arena.
+		 */
+		typedef struct
+		{
+			uint64_t frame;		/**< Frame number as passed to Capture() */
+			size_t offset;		/**< Offset of the encoded state in the arena */
+			size_t length;		/**< Length of the encoded state */
+			bool keyframe;		/**< Encoded against an all-zero state instead of the previous frame */
+		} Entry_t;
+
+		/** @brief Arena holding the encoded frames, used as a ring */
+		std::vector<uint8_t> arena;
+
+		/** @brief Offset in the arena the next frame is written to */
+		size_t arenaHead = 0;
+
+		/** @brief Frame index, used as a ring */
+		std::vector<Entry_t> entries;
+
+		/** @brief Index of the oldest frame in the frame index */
+		size_t first = 0;
+
+		/** @brief Number of frames stored */
+		size_t count = 0;
+
+		/** @brief Number of frames between keyframes */
+		unsigned keyframeInterval;
+
+		/** @brief Number of deltas stored since the last keyframe */
+		unsigned sinceKeyframe = 0;
+
+		/** @brief Save state of the newest frame, deltas are encoded against it */
+		std::vector<uint8_t> previous;
+
+		/** @brief Scratch buffer for saving and reconstructing states */
+		std::vector<uint8_t> scratch;
+
+		Entry_t &At(size_t index)
+		{
+			return entries[(first + index) % entries.size()];
+		}
+
+		const Entry_t &At(size_t index) const
+		{
+			return entries[(first + index) % entries.size()];
+		}
+
+		void DropOldest();
+		std::optional<size_t> Find(uint64_t frame) const;
+		size_t Reserve(size_t length);
+	public:
+		/**
+		 * @brief Construct a new Rewind Buffer object
+		 *
+		 * @param stateSize : Save state size of the CPU, see CPU::GetSaveStateSize()
+		 * @param arenaSize : Size of the arena holding the encoded frames in bytes
+		 * @param maxFrames : Maximum number of frames kept
+		 * @param keyframeInterval : Number of frames between keyframes
+		 */
+		RewindBuffer(size_t stateSize, size_t arenaSize = 4 << 20, size_t maxFrames = 4096,
+			unsigned keyframeInterval = 60);
+
+		/**
+		 * @brief Capture the state of a frame
+		 *
+		 * @param cpu : CPU to capture the state of
+		 * @param frame : Frame number, has to increase with every capture
+		 * @return std::expected<void, std::string> : Error message if the state could not be captured
+		 */
+		std::expected<void, std::string> Capture(CPU &cpu, uint64_t frame);
+
+		/**
+		 * @brief Restore the state of a frame
+		 *
+		 * Restores the CPU to the captured frame and drops all newer frames, so
+		 * capturing continues from the restored frame on.
+		 *
+		 * @param cpu : CPU to restore the state into
+		 * @param frame : Frame number to restore
+		 * @return std::expected<void, std::string> : Error message if the frame is not available
+		 */
+		std::expected<void, std::string> Restore(CPU &cpu, uint64_t frame);
+
+		/**
+		 * @brief Check if a frame can be restored
+		 *
+		 * @param frame : Frame number
+		 * @return bool : True if the frame is stored
+		 */
+		bool Contains(uint64_t frame) const
+		{
+			return Find(frame).has_value();
+		}
+
+		/**
+		 * @brief Get the oldest frame that can be restored
+		 *
+		 * @return std::optional<uint64_t> : Frame number, empty if no frame is stored
+		 */
+		std::optional<uint64_t> GetOldestFrame() const
+		{
+			return count > 0 ? std::optional<uint64_t>(At(0).frame) : std::nullopt;
+		}
+
+		/**
+		 * @brief Get the newest frame that can be restored
+		 *
+		 * @return std::optional<uint64_t> : Frame number, empty if no frame is stored
+		 */
+		std::optional<uint64_t> GetNewestFrame() const
+		{
+			return count > 0 ? std::optional<uint64_t>(At(count - 1).frame) : std::nullopt;
+		}
+
+		/**
+		 * @brief Get the number of frames stored
+		 *
+		 * @return size_t : Number of frames that can be restored
+		 */
+		size_t GetFrameCount() const
+		{
+			return count;
+		}
+
+		/**
+		 * @brief Drop all stored frames
+		 */
+		void Clear()
+		{
+			first = 0;
+			count = 0;
+			arenaHead = 0;
+			sinceKeyframe = 0;
+		}
+	};
+}
+
+#endif /* _CHIP8_REWIND_HPP_ */
@@ -0,0 +1,80 @@
+#include "romcache.hpp"
+#include <mutex>
+
+using namespace CHIP8;
+
+std::expected<std::shared_ptr<const RomCache::Entry_t>, std::string> RomCache::GetEntry(const std::string &romPath)
+{
+	{
+		std::shared_lock lock(mutex);
+		auto entry = entries.find(romPath);
+		if (entry != entries.end())
+		{
+			return entry->second;
+		}
+	}
+
+	std::unique_lock lock(mutex);
+	// Another thread may have mapped the ROM in the meantime
+	auto entry = entries.find(romPath);
+	if (entry != entries.end())
+	{
+		return entry->second;
+	}
+
+	auto created = std::make_shared<Entry_t>();
+	auto mapped = created->file.Open(romPath);
+	if (!mapped)
+	{
+		return std::unexpected(mapped.error());
+	}
+	// ROMs too large for the default memory get loaded into the memory of their platform directly
+	created->imageValid = created->image.LoadRom(created->file.GetData()).has_value();
+	entries.emplace(romPath, created);
+	return created;
+}
+
+std::expected<void, std::string> RomCache::Load(const std::string &romPath, Memory &memory)
+{
+	auto entry = GetEntry(romPath);
+	if (!entry)
+	{
+		return std::unexpected(entry.error());
+	}
+	// The image only fits memories of the default size
+	const Entry_t &cached = *entry.value();
+	if (!cached.imageValid || memory.GetSize() != cached.image.GetSize())
+	{
+		memory.Reset();
+		auto loaded = memory.LoadRom(cached.file.GetData());
+		if (!loaded)
+		{
+			return std::unexpected(DescribeMemoryFault(loaded.error()));
+		}
+		return std::expected<void, std::string>();
+	}
+	memory.LoadImage(cached.image);
+	return std::expected<void, std::string>();
+}
+
+std::expected<std::span<const uint8_t>, std::string> RomCache::GetRom(const std::string &romPath)
+{
+	auto entry = GetEntry(romPath);
+	if (!entry)
+	{
+		return std::unexpected(entry.error());
+	}
+	return entry.value()->file.GetData();
+}
+
+size_t RomCache::GetSize() const
+{
+	std::shared_lock lock(mutex);
+	return entries.size();
+}
+
+void RomCache::Clear()
+{
+	std::unique_lock lock(mutex);
+	entries.clear();
+}
@@ -0,0 +1,96 @@
+#ifndef _CHIP8_ROMCACHE_HPP_
+#define _CHIP8_ROMCACHE_HPP_
+
+#include <cstdint>
+#include <string>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <expected>
+#include "memory.hpp"
+#include "mappedfile.hpp"
+
+namespace CHIP8
+{
+	/**
+	 * @brief ROM Cache
+	 *
+	 * This class keeps every ROM file it was asked for memory-mapped, together
+	 * with a prepared memory image of the ROM and the font. Loading a cached ROM
+	 * into an instance shares the pages of the image copy-on-write, so a session
+	 * starts without touching the filesystem and only pays for the pages it
+	 * writes to.
+	 *
+	 * The cache is thread-safe, a process-wide instance is available through
+	 * Global(). Cached files are expected not to change while the process runs.
+	 */
+	class RomCache
+	{
+	public:
+		/**
+		 * @brief Get the process-wide cache
+		 *
+		 * @return RomCache& : The cache shared by all instances of the process
+		 */
+		static RomCache &Global()
+		{
+			static RomCache cache;
+			return cache;
+		}
+
+		/**
+		 * @brief Load a ROM file into memory
+		 *
+		 * Maps the file on first use, later loads of the same path into a memory
+		 * of the default size only share the pages of the cached image. Larger
+		 * memories, like the one of XO-CHIP, get the ROM copied in.
+		 *
+		 * @param romPath : Path of the ROM file
+		 * @param memory : Memory to load the ROM into, its whole content is replaced
+		 * @return std::expected<void, std::string> : Error message if the ROM could not be loaded
+		 */
+		std::expected<void, std::string> Load(const std::string &romPath, Memory &memory);
+
+		/**
+		 * @brief Get the content of a ROM file
+		 *
+		 * @param romPath : Path of the ROM file
+		 * @return std::expected<std::span<const uint8_t>, std::string> : The mapped file, valid until the cache is cleared
+		 */
+		std::expected<std::span<const uint8_t>, std::string> GetRom(const std::string &romPath);
+
+		/**
+		 * @brief Get the number of cached ROMs
+		 *
+		 * @return size_t : Number of cached ROM files
+		 */
+		size_t GetSize() const;
+
+		/**
+		 * @brief Drop all cached ROMs
+		 *
+		 * Memories the ROMs were loaded into keep their pages, loads running
+		 * concurrently finish with the entry they found.
+		 */
+		void Clear();
+	private:
+		/**
+		 * @brief Entry
+		 *
+		 * A mapped ROM file and its prepared memory image of the default size.
+		 */
+		typedef struct
+		{
+			MappedFile file;
+			Memory image;
+			bool imageValid;		/**< False if the ROM only fits into a larger memory */
+		} Entry_t;
+
+		mutable std::shared_mutex mutex;
+		std::map<std::string, std::shared_ptr<const Entry_t>, std::less<>> entries;
+
+		std::expected<std::shared_ptr<const Entry_t>, std::string> GetEntry(const std::string &romPath);
+	};
+}
+
+#endif /* _CHIP8_ROMCACHE_HPP_ */
@@ -0,0 +1,229 @@
+#include "romdb.hpp"
+#include <cstring>
+#include <charconv>
+#include <fstream>
+#include <format>
+
+using namespace CHIP8;
+
+namespace
+{
+	uint32_t GetLittle32(const uint8_t *data)
+	{
+		return uint32_t(data[0]) | uint32_t(data[1]) << 8 | uint32_t(data[2]) << 16 | uint32_t(data[3]) << 24;
+	}
+
+	void PutLittle(uint8_t *data, uint32_t value, size_t bytes)
+	{
+		for (size_t i = 0; i < bytes; i++)
+		{
+			data[i] = uint8_t(value >> (8 * i));
+		}
+	}
+
+	/**
+	 * @brief Parse a decimal or 0x prefixed hex number
+	 */
+	bool ParseNumber(std::string_view text, uint32_t &value)
+	{
+		int base = 10;
+		if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X'))
+		{
+			text.remove_prefix(2);
+			base = 16;
+		}
+		auto result = std::from_chars(text.data(), text.data() + text.size(), value, base);
+		return result.ec == std::errc() && result.ptr == text.data() + text.size();
+	}
+}
+
+std::expected<void, std::string> RomDatabase::Open(const std::string &path)
+{
+	entries = nullptr;
+	count = 0;
+
+	auto mapped = file.Open(path);
+	if (!mapped)
+	{
+		return mapped;
+	}
+
+	const auto data = file.GetData();
+	if (data.size() < HEADER_SIZE || GetLittle32(data.data()) != MAGIC)
+	{
+		file.Close();
+		return std::unexpected(std::format("Not a ROM database: {}", path));
+	}
+	if (data[4] != VERSION)
+	{
+		file.Close();
+		return std::unexpected(std::format("Unsupported ROM database version: {} != {}", data[4], VERSION));
+	}
+
+	const size_t entryCount = GetLittle32(data.data() + 8);
+	if ((data.size() - HEADER_SIZE) / ENTRY_SIZE != entryCount || (data.size() - HEADER_SIZE) % ENTRY_SIZE != 0)
+	{
+		file.Close();
+		return std::unexpected(std::format("ROM database truncated: {}", path));
+	}
+
+	entries = data.data() + HEADER_SIZE;
+	count = entryCount;
+	return std::expected<void, std::string>();
+}
+
+std::optional<RomProfile_t> RomDatabase::Find(const Sha1::Digest_t &digest) const
+{
+	// Binary search over the mapped entries, only log2(count) pages are touched
+	size_t low = 0;
+	size_t high = count;
+	while (low < high)
+	{
+		const size_t middle = low + (high - low) / 2;
+		const uint8_t *entry = entries + middle * ENTRY_SIZE;
+		const int order = std::memcmp(entry, digest.data(), Sha1::DIGEST_SIZE);
+		if (order < 0)
+		{
+			low = middle + 1;
+		}
+		else if (order > 0)
+		{
+			high = middle;
+		}
+		else
+		{
+			const uint8_t *fields = entry + Sha1::DIGEST_SIZE;
+			RomProfile_t profile;
+			profile.quirks = uint16_t(fields[0] | fields[1] << 8);
+			profile.instructionsPerFrame = uint16_t(fields[2] | fields[3] << 8);
+			// Engines of newer databases fall back to the reference engine
+			profile.engine = (fields[4] <= uint8_t(EngineKind::Predecoded)) ? EngineKind(fields[4]) : EngineKind::Reference;
+			return profile;
+		}
+	}
+	return std::nullopt;
+}
+
+std::expected<std::optional<RomProfile_t>, std::string> RomDatabase::FindRomFile(const std::string &romPath) const
+{
+	MappedFile rom;
+	auto mapped = rom.Open(romPath);
+	if (!mapped)
+	{
+		return std::unexpected(mapped.error());
+	}
+	return FindRom(rom.GetData());
+}
+
+std::expected<std::vector<RomDatabase::Entry_t>, std::string> RomDatabase::ParseListing(std::string_view text)
+{
+	std::vector<Entry_t> parsed;
+	size_t lineNumber = 0;
+
+	while (!text.empty())
+	{
+		const size_t lineEnd = std::min(text.find('\n'), text.size());
+		std::string_view line = text.substr(0, lineEnd);
+		text.remove_prefix(std::min(lineEnd + 1, text.size()));
+		lineNumber++;
+
+		line = line.substr(0, std::min(line.find('#'), line.size()));
+
+		// Split the line into whitespace separated fields
+		std::array<std::string_view, 4> fields;
+		size_t fieldCount = 0;
+		while (true)
+		{
+			const size_t start = line.find_first_not_of(" \t\r");
+			if (start == std::string_view::npos)
+			{
+				break;
+			}
+			line.remove_prefix(start);
+			const size_t end = std::min(line.find_first_of(" \t\r"), line.size());
+			if (fieldCount == fields.size())
+			{
+				return std::unexpected(std::format("Line {}: too many fields", lineNumber));
+			}
+			fields[fieldCount++] = line.substr(0, end);
+			line.remove_prefix(end);
+		}
+
+		if (fieldCount == 0)
+		{
+			continue;
+		}
+		if (fieldCount != fields.size())
+		{
+			return std::unexpected(std::format("Line {}: expected <sha1> <quirk bits> <instructions per frame> <engine>", lineNumber));
+		}
+
+		Entry_t entry;
+		uint32_t quirks, instructionsPerFrame;
+		if (!Sha1::FromHex(fields[0], entry.digest))
+		{
+			return std::unexpected(std::format("Line {}: invalid SHA-1: {}", lineNumber, fields[0]));
+		}
+		if (!ParseNumber(fields[1], quirks) || quirks > 0xFFFF)
+		{
+			return std::unexpected(std::format("Line {}: invalid quirk bits: {}", lineNumber, fields[1]));
+		}
+		if (!ParseNumber(fields[2], instructionsPerFrame) || instructionsPerFrame == 0 || instructionsPerFrame > 0xFFFF)
+		{
+			return std::unexpected(std::format("Line {}: invalid instructions per frame: {}", lineNumber, fields[2]));
+		}
+
+		const auto engine = std::find(std::begin(ENGINE_NAMES), std::end(ENGINE_NAMES), fields[3]);
+		if (engine == std::end(ENGINE_NAMES))
+		{
+			return std::unexpected(std::format("Line {}: unknown engine: {}", lineNumber, fields[3]));
+		}
+
+		entry.profile.quirks = uint16_t(quirks);
+		entry.profile.instructionsPerFrame = uint16_t(instructionsPerFrame);
+		entry.profile.engine = EngineKind(engine - std::begin(ENGINE_NAMES));
+		parsed.push_back(entry);
+	}
+	return parsed;
+}
+
+std::expected<void, std::string> RomDatabase::Write(const std::string &path, std::vector<Entry_t> entries)
+{
+	std::sort(entries.begin(), entries.end(),
+		[](const Entry_t &a, const Entry_t &b) { return a.digest < b.digest; });
+	for (size_t i = 1; i < entries.size(); i++)
+	{
+		if (entries[i].digest == entries[i - 1].digest)
+		{
+			return std::unexpected(std::format("ROM listed twice: {}", Sha1::ToHex(entries[i].digest)));
+		}
+	}
+
+	std::vector<uint8_t> content(HEADER_SIZE + entries.size() * ENTRY_SIZE, 0);
+	PutLittle(content.data(), MAGIC, 4);
+	content[4] = VERSION;
+	PutLittle(content.data() + 8, uint32_t(entries.size()), 4);
+
+	uint8_t *entry = content.data() + HEADER_SIZE;
+	for (const Entry_t &source : entries)
+	{
+		std::copy(source.digest.begin(), source.digest.end(), entry);
+		uint8_t *fields = entry + Sha1::DIGEST_SIZE;
+		PutLittle(fields, source.profile.quirks, 2);
+		PutLittle(fields + 2, source.profile.instructionsPerFrame, 2);
+		fields[4] = uint8_t(source.profile.engine);
+		entry += ENTRY_SIZE;
+	}
+
+	std::ofstream output(path, std::ios::binary | std::ios::trunc);
+	if (!output.is_open())
+	{
+		return std::unexpected(std::format("Failed to open ROM database: {}", path));
+	}
+	output.write(reinterpret_cast<const char *>(content.data()), std::streamsize(content.size()));
+	if (!output)
+	{
+		return std::unexpected(std::format("Failed to write ROM database: {}", path));
+	}
+	return std::expected<void, std::string>();
+}
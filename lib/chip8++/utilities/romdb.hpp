@@ -0,0 +1,158 @@
+#ifndef _CHIP8_ROMDB_HPP_
+#define _CHIP8_ROMDB_HPP_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <expected>
+#include "sha1.hpp"
+#include "mappedfile.hpp"
+#include "analyzer.hpp"
+#include "cpu.hpp"
+
+namespace CHIP8
+{
+	/**
+	 * @brief ROM Profile
+	 *
+	 * Settings a ROM is known to run correctly with.
+	 */
+	typedef struct
+	{
+		uint16_t quirks;				/**< Quirks, see Quirks::ToBits() */
+		uint16_t instructionsPerFrame;	/**< Instructions executed per 60Hz frame */
+		EngineKind engine;				/**< Engine that runs the ROM fastest */
+	} RomProfile_t;
+
+	/**
+	 * @brief ROM Database
+	 *
+	 * This class maps the SHA-1 of ROM files to their profile. The database file
+	 * is memory-mapped and searched in place, opening it costs the same for a few
+	 * or thousands of ROMs and a lookup is a binary search over the sorted entries.
+	 *
+	 * File layout: "C8DB", version byte, three reserved bytes, little-endian uint32
+	 * entry count and a reserved uint32, followed by the entries sorted by hash.
+	 * An entry is 32 bytes: SHA-1, uint16 quirk bits, uint16 instructions per frame,
+	 * engine byte and seven reserved bytes.
+	 *
+	 * Databases are built from a text listing with one ROM per line,
+	 * `<sha1> <quirk bits> <instructions per frame> <engine>`, where the engine is
+	 * reference or predecoded. Everything after a '#' is a comment.
+	 */
+	class RomDatabase
+	{
+	public:
+		/** @brief Database file magic ("C8DB") */
+		static constexpr uint32_t MAGIC			= 0x42443843;
+
+		/** @brief Database file version */
+		static constexpr uint8_t VERSION		= 1;
+
+		/** @brief Size of the file header */
+		static constexpr size_t HEADER_SIZE		= 16;
+
+		/** @brief Size of an entry */
+		static constexpr size_t ENTRY_SIZE		= 32;
+
+		/**
+		 * @brief Entry
+		 *
+		 * A ROM hash with its profile.
+		 */
+		typedef struct
+		{
+			Sha1::Digest_t digest;
+			RomProfile_t profile;
+		} Entry_t;
+
+		/**
+		 * @brief Open a database file
+		 *
+		 * The header is checked, the entries are only read by lookups.
+		 *
+		 * @param path : Path of the database file
+		 * @return std::expected<void, std::string> : Error message if the file is not a database
+		 */
+		std::expected<void, std::string> Open(const std::string &path);
+
+		/**
+		 * @brief Get the number of ROMs in the database
+		 *
+		 * @return size_t : Number of entries
+		 */
+		size_t GetSize() const
+		{
+			return count;
+		}
+
+		/**
+		 * @brief Look up a ROM by its hash
+		 *
+		 * @param digest : SHA-1 of the ROM file
+		 * @return std::optional<RomProfile_t> : The profile, nothing if the ROM is unknown
+		 */
+		std::optional<RomProfile_t> Find(const Sha1::Digest_t &digest) const;
+
+		/**
+		 * @brief Look up a ROM by its content
+		 *
+		 * @param rom : Content of the ROM file
+		 * @return std::optional<RomProfile_t> : The profile, nothing if the ROM is unknown
+		 */
+		std::optional<RomProfile_t> FindRom(std::span<const uint8_t> rom) const
+		{
+			return Find(Sha1::Hash(rom));
+		}
+
+		/**
+		 * @brief Look up a ROM file
+		 *
+		 * Hashes the same file Memory::LoadRomFile() loads.
+		 *
+		 * @param romPath : Path of the ROM file
+		 * @return std::expected<std::optional<RomProfile_t>, std::string> : The profile or nothing, error message if the file could not be read
+		 */
+		std::expected<std::optional<RomProfile_t>, std::string> FindRomFile(const std::string &romPath) const;
+
+		/**
+		 * @brief Apply a profile to a CPU
+		 *
+		 * Sets the quirks, the instructions per frame and the engine are up to the host.
+		 *
+		 * @param profile : Profile to apply
+		 * @param cpu : CPU to configure
+		 */
+		static void Apply(const RomProfile_t &profile, CPU &cpu)
+		{
+			cpu.GetQuirks().FromBits(profile.quirks);
+		}
+
+		/**
+		 * @brief Parse a text listing
+		 *
+		 * @param text : Listing, see the class description
+		 * @return std::expected<std::vector<Entry_t>, std::string> : The entries, error message with the line number otherwise
+		 */
+		static std::expected<std::vector<Entry_t>, std::string> ParseListing(std::string_view text);
+
+		/**
+		 * @brief Write a database file
+		 *
+		 * The entries are sorted, a hash listed twice is an error.
+		 *
+		 * @param path : Path of the database file
+		 * @param entries : Entries to write
+		 * @return std::expected<void, std::string> : Error message if the file could not be written
+		 */
+		static std::expected<void, std::string> Write(const std::string &path, std::vector<Entry_t> entries);
+	private:
+		MappedFile file;
+		const uint8_t *entries = nullptr;
+		size_t count = 0;
+	};
+}
+
+#endif /* _CHIP8_ROMDB_HPP_ */
@@ -0,0 +1,237 @@
+#ifndef _CHIP8_SHA1_HPP_
+#define _CHIP8_SHA1_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <span>
+#include <string>
+#include <string_view>
+#include <algorithm>
+
+namespace CHIP8
+{
+	/**
+	 * @brief SHA-1
+	 *
+	 * Incremental SHA-1 (FIPS 180-4), used to identify ROM files. The digest
+	 * matches the hashes of the community CHIP-8 database.
+	 */
+	class Sha1
+	{
+	public:
+		/** @brief Digest size in bytes */
+		static constexpr size_t DIGEST_SIZE = 20;
+
+		typedef std::array<uint8_t, DIGEST_SIZE> Digest_t;
+
+		/**
+		 * @brief Hash data
+		 *
+		 * @param data : Data to hash
+		 * @return Digest_t : SHA-1 of the data
+		 */
+		static Digest_t Hash(std::span<const uint8_t> data)
+		{
+			Sha1 sha;
+			sha.Update(data);
+			return sha.Finish();
+		}
+
+		/**
+		 * @brief Format a digest as lowercase hex
+		 *
+		 * @param digest : Digest to format
+		 * @return std::string : 40 hex digits
+		 */
+		static std::string ToHex(const Digest_t &digest)
+		{
+			static constexpr char DIGITS[] = "0123456789abcdef";
+			std::string text(DIGEST_SIZE * 2, '0');
+			for (size_t i = 0; i < DIGEST_SIZE; i++)
+			{
+				text[i * 2] = DIGITS[digest[i] >> 4];
+				text[i * 2 + 1] = DIGITS[digest[i] & 0x0F];
+			}
+			return text;
+		}
+
+		/**
+		 * @brief Parse a digest from hex
+		 *
+		 * @param text : 40 hex digits, either case
+		 * @param digest : Parsed digest
+		 * @return bool : False if the text is not a digest
+		 */
+		static bool FromHex(std::string_view text, Digest_t &digest)
+		{
+			if (text.size() != DIGEST_SIZE * 2)
+			{
+				return false;
+			}
+			for (size_t i = 0; i < text.size(); i++)
+			{
+				const char character = text[i];
+				uint8_t nibble;
+				if (character >= '0' && character <= '9')
+				{
+					nibble = uint8_t(character - '0');
+				}
+				else if ((character | 0x20) >= 'a' && (character | 0x20) <= 'f')
+				{
+					nibble = uint8_t((character | 0x20) - 'a' + 10);
+				}
+				else
+				{
+					return false;
+				}
+				digest[i / 2] = uint8_t((i % 2 == 0) ? nibble << 4 : digest[i / 2] | nibble);
+			}
+			return true;
+		}
+
+		/**
+		 * @brief Add data to the hash
+		 *
+		 * @param data : Data to add
+		 */
+		void Update(std::span<const uint8_t> data)
+		{
+			size_t position = 0;
+			const size_t buffered = size_t(length % BLOCK_SIZE);
+			length += data.size();
+
+			// Complete a partially filled block first
+			if (buffered > 0)
+			{
+				const size_t count = std::min(BLOCK_SIZE - buffered, data.size());
+				std::copy_n(data.begin(), count, block.begin() + buffered);
+				position = count;
+				if (buffered + count < BLOCK_SIZE)
+				{
+					return;
+				}
+				Compress(block.data());
+			}
+
+			for (; position + BLOCK_SIZE <= data.size(); position += BLOCK_SIZE)
+			{
+				Compress(data.data() + position);
+			}
+			std::copy(data.begin() + position, data.end(), block.begin());
+		}
+
+		/**
+		 * @brief Finish the hash
+		 *
+		 * The object has to be reset before it can be reused.
+		 *
+		 * @return Digest_t : SHA-1 of all added data
+		 */
+		Digest_t Finish()
+		{
+			const uint64_t bits = length * 8;
+			size_t buffered = size_t(length % BLOCK_SIZE);
+
+			// Padding: a one bit, zeros and the message length in bits
+			block[buffered++] = 0x80;
+			if (buffered > BLOCK_SIZE - 8)
+			{
+				std::fill(block.begin() + buffered, block.end(), 0);
+				Compress(block.data());
+				buffered = 0;
+			}
+			std::fill(block.begin() + buffered, block.end() - 8, 0);
+			for (size_t i = 0; i < 8; i++)
+			{
+				block[BLOCK_SIZE - 1 - i] = uint8_t(bits >> (i * 8));
+			}
+			Compress(block.data());
+
+			Digest_t digest;
+			for (size_t i = 0; i < DIGEST_SIZE; i++)
+			{
+				digest[i] = uint8_t(state[i / 4] >> (24 - (i % 4) * 8));
+			}
+			return digest;
+		}
+
+		/**
+		 * @brief Reset the hash to its initial state
+		 */
+		void Reset()
+		{
+			state = INITIAL_STATE;
+			length = 0;
+		}
+	private:
+		static constexpr size_t BLOCK_SIZE = 64;
+		static constexpr std::array<uint32_t, 5> INITIAL_STATE = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+
+		std::array<uint32_t, 5> state = INITIAL_STATE;
+		std::array<uint8_t, BLOCK_SIZE> block{};
+		uint64_t length = 0;
+
+		static constexpr uint32_t Rotate(uint32_t value, unsigned count)
+		{
+			return (value << count) | (value >> (32 - count));
+		}
+
+		void Compress(const uint8_t *data)
+		{
+			std::array<uint32_t, 16> w;
+			for (size_t i = 0; i < 16; i++)
+			{
+				w[i] = uint32_t(data[i * 4]) << 24 | uint32_t(data[i * 4 + 1]) << 16 |
+					uint32_t(data[i * 4 + 2]) << 8 | uint32_t(data[i * 4 + 3]);
+			}
+
+			uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+			for (size_t i = 0; i < 80; i++)
+			{
+				// The message schedule is kept as a rolling window of 16 words
+				if (i >= 16)
+				{
+					w[i % 16] = Rotate(w[(i + 13) % 16] ^ w[(i + 8) % 16] ^ w[(i + 2) % 16] ^ w[i % 16], 1);
+				}
+
+				uint32_t f, k;
+				if (i < 20)
+				{
+					f = (b & c) | (~b & d);
+					k = 0x5A827999;
+				}
+				else if (i < 40)
+				{
+					f = b ^ c ^ d;
+					k = 0x6ED9EBA1;
+				}
+				else if (i < 60)
+				{
+					f = (b & c) | (b & d) | (c & d);
+					k = 0x8F1BBCDC;
+				}
+				else
+				{
+					f = b ^ c ^ d;
+					k = 0xCA62C1D6;
+				}
+
+				const uint32_t temp = Rotate(a, 5) + f + e + k + w[i % 16];
+				e = d;
+				d = c;
+				c = Rotate(b, 30);
+				b = a;
+				a = temp;
+			}
+
+			state[0] += a;
+			state[1] += b;
+			state[2] += c;
+			state[3] += d;
+			state[4] += e;
+		}
+	};
+}
+
+#endif /* _CHIP8_SHA1_HPP_ */
@@ -0,0 +1,81 @@
+#include "trace.hpp"
+#include <fstream>
+#include <format>
+
+using namespace CHIP8;
+
+TraceRecorder::TraceRecorder(size_t capacity, uint32_t threadId)
+ : threadId(threadId)
+{
+	events.reserve(capacity);
+}
+
+std::expected<void, std::string> TraceRecorder::WriteJson(const std::string &path) const
+{
+	const TraceRecorder *self = this;
+	return WriteJson(path, std::span<const TraceRecorder * const>(&self, 1));
+}
+
+std::expected<void, std::string> TraceRecorder::WriteJson(const std::string &path,
+	std::span<const TraceRecorder * const> recorders)
+{
+	std::ofstream file(path, std::ios::out | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return std::unexpected(std::format("Failed to open trace file: {}", path));
+	}
+
+	// Chrome trace timestamps are in microseconds, fractions are allowed
+	auto toMicroseconds = [](int64_t ns) {
+		return std::format("{}.{:03}", ns / 1000, ns % 1000);
+	};
+
+	bool first = true;
+	file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+	for (const TraceRecorder *recorder : recorders)
+	{
+		if (recorder == nullptr)
+		{
+			continue;
+		}
+
+		for (const TraceEvent_t &event : recorder->events)
+		{
+			file << (first ? "" : ",\n");
+			first = false;
+
+			file << std::format("{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"{}\",\"pid\":1,\"tid\":{},\"ts\":{}",
+				event.name, event.category, event.phase, recorder->threadId, toMicroseconds(event.timestamp));
+
+			switch (event.phase)
+			{
+				case 'X':
+					file << ",\"dur\":" << toMicroseconds(event.value);
+					break;
+				case 'C':
+					file << std::format(",\"args\":{{\"value\":{}}}", event.value);
+					break;
+				case 'i':
+					file << ",\"s\":\"t\"";
+					break;
+			}
+			file << "}";
+		}
+
+		if (recorder->dropped > 0)
+		{
+			file << (first ? "" : ",\n");
+			first = false;
+			file << std::format("{{\"name\":\"dropped_events\",\"ph\":\"C\",\"pid\":1,\"tid\":{},\"ts\":{},"
+				"\"args\":{{\"value\":{}}}}}", recorder->threadId,
+				toMicroseconds(recorder->events.empty() ? 0 : recorder->events.back().timestamp), recorder->dropped);
+		}
+	}
+	file << "\n]}\n";
+
+	if (!file)
+	{
+		return std::unexpected(std::format("Failed to write trace file: {}", path));
+	}
+	return std::expected<void, std::string>();
+}
@@ -0,0 +1,223 @@
+#ifndef _CHIP8_TRACE_HPP_
+#define _CHIP8_TRACE_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <span>
+#include <chrono>
+#include <expected>
+
+namespace CHIP8
+{
+	/**
+	 * @brief Trace Recorder
+	 *
+	 * This class records host loop phases (execute, key polling, display update,
+	 * timer tick, ...) as Chrome trace events which can be opened in Perfetto
+	 * or chrome://tracing.
+	 *
+	 * The event buffer is allocated once in the constructor, recording never
+	 * allocates. When the buffer is full, further events are counted as dropped.
+	 * A recorder is meant to be used by a single thread, batch runners should use
+	 * one recorder per worker thread and write them out together.
+	 */
+	class TraceRecorder
+	{
+	public:
+		/**
+		 * @brief Trace Event
+		 *
+		 * A single recorded event. Names and categories have to be string literals
+		 * (or otherwise outlive the recorder), as only the pointers are stored.
+		 */
+		typedef struct
+		{
+			const char *name;		/**< Name of the event */
+			const char *category;	/**< Category of the event */
+			int64_t timestamp;		/**< Start of the event in nanoseconds since the trace epoch */
+			int64_t value;			/**< Duration in nanoseconds ('X') or counter value ('C') */
+			char phase;				/**< Chrome trace event phase: 'X', 'C' or 'i' */
+		} TraceEvent_t;
+
+		/**
+		 * @brief Construct a new Trace Recorder object
+		 *
+		 * @param capacity : Maximum number of events to record
+		 * @param threadId : Thread id the events are reported on
+		 */
+		TraceRecorder(size_t capacity = 1 << 20, uint32_t threadId = 1);
+
+		/**
+		 * @brief Get the current time
+		 *
+		 * @return int64_t : Nanoseconds since the process wide trace epoch
+		 */
+		static int64_t Now()
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - epoch).count();
+		}
+
+		/**
+		 * @brief Record a complete event
+		 *
+		 * @param name : Name of the event
+		 * @param category : Category of the event
+		 * @param start : Start time as returned by Now()
+		 * @param duration : Duration in nanoseconds
+		 */
+		void AddComplete(const char *name, const char *category, int64_t start, int64_t duration)
+		{
+			Add({name, category, start, duration, 'X'});
+		}
+
+		/**
+		 * @brief Record a counter value
+		 *
+		 * @param name : Name of the counter
+		 * @param value : Value of the counter
+		 */
+		void AddCounter(const char *name, int64_t value)
+		{
+			Add({name, "counter", Now(), value, 'C'});
+		}
+
+		/**
+		 * @brief Record an instant event
+		 *
+		 * @param name : Name of the event
+		 * @param category : Category of the event
+		 */
+		void AddInstant(const char *name, const char *category)
+		{
+			Add({name, category, Now(), 0, 'i'});
+		}
+
+		/**
+		 * @brief Clear all recorded events
+		 */
+		void Clear()
+		{
+			events.clear();
+			dropped = 0;
+		}
+
+		/**
+		 * @brief Get the recorded events
+		 *
+		 * @return std::span<const TraceEvent_t> : The recorded events
+		 */
+		std::span<const TraceEvent_t> GetEvents() const
+		{
+			return events;
+		}
+
+		/**
+		 * @brief Get the number of events dropped because the buffer was full
+		 *
+		 * @return size_t : Number of dropped events
+		 */
+		size_t GetDroppedCount() const
+		{
+			return dropped;
+		}
+
+		/**
+		 * @brief Get the thread id of the recorder
+		 *
+		 * @return uint32_t : Thread id the events are reported on
+		 */
+		uint32_t GetThreadId() const
+		{
+			return threadId;
+		}
+
+		/**
+		 * @brief Write the recorded events as Chrome trace JSON
+		 *
+		 * @param path : Path of the JSON file to write
+		 * @return std::expected<void, std::string> : Error message if the file could not be written
+		 */
+		std::expected<void, std::string> WriteJson(const std::string &path) const;
+
+		/**
+		 * @brief Write the events of multiple recorders into one Chrome trace JSON
+		 *
+		 * @param path : Path of the JSON file to write
+		 * @param recorders : Recorders to merge, each one shows up as its own thread
+		 * @return std::expected<void, std::string> : Error message if the file could not be written
+		 */
+		static std::expected<void, std::string> WriteJson(const std::string &path,
+			std::span<const TraceRecorder * const> recorders);
+
+	private:
+		/** @brief Trace epoch shared by all recorders of the process */
+		static inline const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+		/** @brief Preallocated event buffer */
+		std::vector<TraceEvent_t> events;
+
+		/** @brief Number of events that did not fit into the buffer */
+		size_t dropped = 0;
+
+		/** @brief Thread id the events are reported on */
+		uint32_t threadId;
+
+		void Add(const TraceEvent_t &event)
+		{
+			if (events.size() < events.capacity()) [[likely]]
+			{
+				events.push_back(event);
+			}
+			else
+			{
+				dropped++;
+			}
+		}
+	};
+
+	/**
+	 * @brief Scoped Trace
+	 *
+	 * RAII helper that records a complete event spanning its lifetime.
+	 * If no recorder is given (tracing disabled), neither the constructor nor
+	 * the destructor read the clock, so the only cost is a null pointer check.
+	 */
+	class ScopedTrace
+	{
+		TraceRecorder *recorder;
+		const char *name;
+		const char *category;
+		int64_t start = 0;
+	public:
+		/**
+		 * @brief Construct a new Scoped Trace object
+		 *
+		 * @param recorder : Recorder to write to, or nullptr if tracing is disabled
+		 * @param name : Name of the event
+		 * @param category : Category of the event
+		 */
+		ScopedTrace(TraceRecorder *recorder, const char *name, const char *category = "host")
+		 : recorder(recorder), name(name), category(category)
+		{
+			if (recorder != nullptr) [[unlikely]]
+			{
+				start = TraceRecorder::Now();
+			}
+		}
+
+		ScopedTrace(const ScopedTrace &) = delete;
+		ScopedTrace &operator=(const ScopedTrace &) = delete;
+
+		~ScopedTrace()
+		{
+			if (recorder != nullptr) [[unlikely]]
+			{
+				recorder->AddComplete(name, category, start, TraceRecorder::Now() - start);
+			}
+		}
+	};
+}
+
+#endif /* _CHIP8_TRACE_HPP_ */
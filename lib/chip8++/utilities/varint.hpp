@@ -0,0 +1,66 @@
+#ifndef _CHIP8_VARINT_HPP_
+#define _CHIP8_VARINT_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+namespace CHIP8::Varint
+{
+	/** @brief Maximum number of bytes a 64-bit varint can take */
+	static constexpr size_t MAX_LENGTH = 10;
+
+	/**
+	 * @brief Encode an unsigned LEB128 varint
+	 *
+	 * Seven bits per byte, the most significant bit marks a following byte.
+	 *
+	 * @param value : Value to encode
+	 * @param out : Output buffer, needs up to MAX_LENGTH bytes
+	 * @param position : Write position, advanced past the encoded value
+	 * @return bool : False if the output buffer is too small
+	 */
+	inline bool Put(uint64_t value, std::span<uint8_t> out, size_t &position)
+	{
+		do
+		{
+			if (position >= out.size())
+			{
+				return false;
+			}
+			uint8_t byte = value & 0x7F;
+			value >>= 7;
+			out[position++] = byte | (value != 0 ? 0x80 : 0x00);
+		} while (value != 0);
+		return true;
+	}
+
+	/**
+	 * @brief Decode an unsigned LEB128 varint
+	 *
+	 * @param in : Input buffer
+	 * @param position : Read position, advanced past the decoded value
+	 * @param value : Decoded value
+	 * @return bool : False if the input ended early or the varint is too long
+	 */
+	inline bool Get(std::span<const uint8_t> in, size_t &position, uint64_t &value)
+	{
+		value = 0;
+		for (unsigned shift = 0; shift < 64; shift += 7)
+		{
+			if (position >= in.size())
+			{
+				return false;
+			}
+			uint8_t byte = in[position++];
+			value |= uint64_t(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+#endif /* _CHIP8_VARINT_HPP_ */
@@ -0,0 +1,205 @@
+#include "vectorenv.hpp"
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+using namespace CHIP8;
+
+VectorEnv::VectorEnv(CPU &prototype, const Config_t &config, const DecoderFactory &createDecoder) : config(config)
+{
+	if (config.count == 0)
+		throw std::invalid_argument("VectorEnv : At least one instance is required");
+	if (config.framesPerStep == 0)
+		throw std::invalid_argument("VectorEnv : At least one frame per step is required");
+
+	Display &display = *prototype.GetDisplay();
+	// Without a factory the workers would silently run extension ROMs as plain CHIP-8
+	if (!createDecoder && display.GetCapability() != DisplayCapability::Chip8)
+		throw std::invalid_argument("VectorEnv : A decoder factory is required for a prototype with an extended display");
+	observationSize = (config.format == ObservationFormat::Packed) ? display.GetPackedSize() : size_t(display.GetWidth()) * size_t(display.GetHeight());
+
+	// Every worker gets its own decoder, the instructions hold per-run state
+	const size_t threadCount = std::clamp<size_t>(config.threads ? config.threads : std::thread::hardware_concurrency(), 1, config.count);
+	std::vector<uint8_t> state(prototype.GetSaveStateSize());
+	auto saved = prototype.SaveState(state);
+	if (!saved)
+		throw std::invalid_argument(std::format("VectorEnv : Failed to save the prototype: {}", saved.error()));
+
+	for (size_t worker = 0; worker < threadCount; worker++)
+	{
+		auto copy = std::make_unique<CPU>(std::make_shared<HeadlessKeypad>(), display.CreateHeadless(),
+			createDecoder ? createDecoder() : nullptr, prototype.GetMemory()->Clone(), std::make_shared<Timers>());
+		auto loaded = copy->LoadState(state);
+		if (!loaded)
+			throw std::invalid_argument(std::format("VectorEnv : Failed to copy the prototype: {}", loaded.error()));
+		prototypes.push_back(std::move(copy));
+	}
+
+	instances.resize(config.count);
+	for (auto &instance : instances)
+	{
+		instance.keypad = std::make_shared<HeadlessKeypad>();
+		instance.frames = 0;
+		instance.episode = 0;
+		instance.done = true;
+	}
+
+	for (size_t worker = 0; worker < threadCount; worker++)
+	{
+		workers.emplace_back(&VectorEnv::WorkerLoop, this, worker);
+	}
+}
+
+VectorEnv::~VectorEnv()
+{
+	{
+		std::lock_guard lock(mutex);
+		stopping = true;
+	}
+	changed.notify_all();
+	for (auto &worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void VectorEnv::Reset(std::span<uint8_t> observations)
+{
+	if (observations.size() < observationSize * instances.size())
+		throw std::invalid_argument(std::format("VectorEnv : Observation buffer of {} bytes, {} required", observations.size(), observationSize * instances.size()));
+
+	Job_t next{};
+	next.observations = observations;
+	next.reset = true;
+	RunJob(next);
+}
+
+void VectorEnv::Step(std::span<const uint16_t> actions, std::span<uint8_t> observations, std::span<float> rewards, std::span<uint8_t> dones)
+{
+	const size_t count = instances.size();
+	if (actions.size() < count || rewards.size() < count || dones.size() < count)
+		throw std::invalid_argument(std::format("VectorEnv : Actions, rewards and dones need {} elements", count));
+	if (observations.size() < observationSize * count)
+		throw std::invalid_argument(std::format("VectorEnv : Observation buffer of {} bytes, {} required", observations.size(), observationSize * count));
+
+	Job_t next{};
+	next.actions = actions;
+	next.observations = observations;
+	next.rewards = rewards;
+	next.dones = dones;
+	next.reset = false;
+	RunJob(next);
+}
+
+void VectorEnv::RunJob(const Job_t &next)
+{
+	std::unique_lock lock(mutex);
+	job = next;
+	running = workers.size();
+	generation++;
+	changed.notify_all();
+	changed.wait(lock, [this]() { return running == 0; });
+}
+
+void VectorEnv::WorkerLoop(size_t worker)
+{
+	const size_t count = instances.size();
+	const size_t first = worker * count / prototypes.size();
+	const size_t last = (worker + 1) * count / prototypes.size();
+	uint64_t seen = 0;
+
+	std::unique_lock lock(mutex);
+	while (true)
+	{
+		changed.wait(lock, [&]() { return stopping || generation != seen; });
+		if (stopping)
+		{
+			return;
+		}
+		seen = generation;
+		const Job_t current = job;
+		lock.unlock();
+
+		for (size_t index = first; index < last; index++)
+		{
+			Instance_t &instance = instances[index];
+			if (current.reset || instance.done)
+			{
+				Restart(index, worker);
+			}
+			if (current.reset)
+			{
+				Observe(index, current.observations);
+				continue;
+			}
+
+			CPU &cpu = *instance.cpu;
+			instance.keypad->SetKeyMask(current.actions[index]);
+			bool done = false;
+			for (uint32_t frame = 0; frame < config.framesPerStep && !done; frame++)
+			{
+				for (uint32_t i = 0; i < config.instructionsPerFrame; i++)
+				{
+					// Halts and aborted instructions end the episode
+					auto result = cpu.RunCycle();
+					if (!result || !result.value())
+					{
+						done = true;
+						break;
+					}
+				}
+				cpu.GetTimers()->DecrementTimers();
+				cpu.GetDisplay()->VBlank();
+				instance.frames++;
+			}
+
+			if (config.maxFrames != 0 && instance.frames >= config.maxFrames)
+			{
+				done = true;
+			}
+			current.rewards[index] = rewardHook ? rewardHook(cpu, index) : 0.0f;
+			if (doneHook && doneHook(cpu, index))
+			{
+				done = true;
+			}
+
+			Observe(index, current.observations);
+			instance.done = done;
+			current.dones[index] = done ? 1 : 0;
+		}
+
+		lock.lock();
+		if (--running == 0)
+		{
+			changed.notify_all();
+		}
+	}
+}
+
+void VectorEnv::Restart(size_t index, size_t worker)
+{
+	Instance_t &instance = instances[index];
+	instance.keypad->SetKeyMask(0);
+	// Clones run on the thread of the worker and use the decoder of its prototype
+	instance.cpu = prototypes[worker]->Clone(prototypes[worker]->GetDecoder(), instance.keypad, nullptr, std::make_shared<Timers>());
+
+	// Derived seeds keep the instances apart while runs stay reproducible
+	instance.cpu->SeedRandom(config.seed + index + instance.episode * instances.size());
+	instance.frames = 0;
+	instance.done = false;
+	instance.episode++;
+}
+
+void VectorEnv::Observe(size_t index, std::span<uint8_t> observations)
+{
+	auto observation = observations.subspan(index * observationSize, observationSize);
+	const Display &display = *instances[index].cpu->GetDisplay();
+	if (config.format == ObservationFormat::Packed)
+	{
+		display.PackBuffer(observation);
+	}
+	else
+	{
+		display.UnpackPixels(observation);
+	}
+}
@@ -0,0 +1,235 @@
+#ifndef _CHIP8_VECTORENV_HPP_
+#define _CHIP8_VECTORENV_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <span>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "cpu.hpp"
+
+namespace CHIP8
+{
+	/**
+	 * @brief Vector Environment
+	 *
+	 * Runs N headless instances of a prototype CPU in lockstep for training
+	 * agents. Step() applies one key mask per instance, runs a fixed number of
+	 * frames on every instance in parallel and writes all observations into a
+	 * single caller-provided buffer, instance after instance, without any
+	 * per-instance allocation or display callback.
+	 *
+	 * The instances are split into fixed blocks, one per worker thread. Every
+	 * worker has its own instruction decoder, the instances of a block are
+	 * clones of a per-worker copy of the prototype, sharing its memory pages
+	 * copy-on-write, so resetting an instance is a clone as well.
+	 *
+	 * An instance is done when the done hook says so, the program halts
+	 * (endless jump or SCHIP-8 exit), an instruction aborts or the episode
+	 * reaches the frame limit. Its observation is the last frame of the
+	 * episode, it starts over from the prototype at the beginning of the next
+	 * Step().
+	 */
+	class VectorEnv
+	{
+	public:
+		/** @brief Observation Format */
+		enum class ObservationFormat : uint8_t
+		{
+			Packed,		/**< Display::PackBuffer() layout, GetPackedSize() bytes */
+			Unpacked	/**< One byte per pixel, [height][width], bit n is bit plane n */
+		};
+
+		/**
+		 * @brief Configuration
+		 */
+		typedef struct Config
+		{
+			size_t count = 1;							/**< Number of instances */
+			uint32_t framesPerStep = 4;					/**< Frames each Step() runs (frame skip) */
+			uint32_t instructionsPerFrame = 15;			/**< Instructions per frame before the timer tick */
+			uint64_t maxFrames = 0;						/**< Frames after which an episode is done, 0 for no limit */
+			unsigned threads = 0;						/**< Worker threads, 0 for one per hardware thread */
+			uint64_t seed = 0;							/**< Random seed, every instance and episode gets its own derived seed */
+			ObservationFormat format = ObservationFormat::Unpacked;
+		} Config_t;
+
+		/**
+		 * @brief Reward hook
+		 *
+		 * Called once per instance and Step() after its frames ran, on the
+		 * worker thread running the instance, so it has to be thread-safe.
+		 * Receives the CPU and the index of the instance.
+		 */
+		typedef std::function<float(CPU &, size_t)> RewardHook;
+
+		/**
+		 * @brief Done hook
+		 *
+		 * Called like the reward hook, returns true if the episode is over.
+		 */
+		typedef std::function<bool(CPU &, size_t)> DoneHook;
+
+		/**
+		 * @brief Decoder factory
+		 *
+		 * Creates the instruction decoder of a worker, e.g. CHIP8::SCHIP8::CreateDecoder.
+		 * The CHIP-8 decoder is used if empty, which only suits a prototype with a
+		 * CHIP-8 display.
+		 */
+		typedef std::function<std::shared_ptr<InstructionDecoder>()> DecoderFactory;
+
+		/**
+		 * @brief Construct a new Vector Env object
+		 *
+		 * @param prototype : CPU with the ROM loaded and quirks set, its state at this point is the start of every episode
+		 * @param config : Configuration
+		 * @param createDecoder : Decoder factory of the platform of the prototype, required unless it has a CHIP-8 display
+		 */
+		VectorEnv(CPU &prototype, const Config_t &config, const DecoderFactory &createDecoder = nullptr);
+
+		/**
+		 * @brief Destroy the Vector Env object, stopping the workers
+		 */
+		~VectorEnv();
+
+		VectorEnv(const VectorEnv &) = delete;
+		VectorEnv &operator=(const VectorEnv &) = delete;
+
+		/**
+		 * @brief Set the reward hook
+		 *
+		 * @param hook : Hook computing the reward of a step, all rewards are zero without one
+		 */
+		void SetRewardHook(RewardHook hook)
+		{
+			rewardHook = std::move(hook);
+		}
+
+		/**
+		 * @brief Set the done hook
+		 *
+		 * @param hook : Hook ending episodes, nullptr to only end them on halts, errors and the frame limit
+		 */
+		void SetDoneHook(DoneHook hook)
+		{
+			doneHook = std::move(hook);
+		}
+
+		/**
+		 * @brief Restart every instance from the prototype
+		 *
+		 * @param observations : Buffer of GetObservationSize() * count bytes receiving the first frames
+		 */
+		void Reset(std::span<uint8_t> observations);
+
+		/**
+		 * @brief Run a step on every instance
+		 *
+		 * @param actions : Key mask of every instance, bit n is key n
+		 * @param observations : Buffer of GetObservationSize() * count bytes
+		 * @param rewards : Reward of every instance
+		 * @param dones : Set to 1 for every instance whose episode ended in this step, 0 otherwise
+		 */
+		void Step(std::span<const uint16_t> actions, std::span<uint8_t> observations, std::span<float> rewards, std::span<uint8_t> dones);
+
+		/**
+		 * @brief Get the number of instances
+		 *
+		 * @return size_t : Number of instances
+		 */
+		size_t GetCount() const
+		{
+			return instances.size();
+		}
+
+		/**
+		 * @brief Get the size of the observation of an instance
+		 *
+		 * @return size_t : Number of bytes per instance in the observation buffer
+		 */
+		size_t GetObservationSize() const
+		{
+			return observationSize;
+		}
+
+		/**
+		 * @brief Get an instance
+		 *
+		 * Only valid between calls of Reset() and Step(), which may replace it.
+		 *
+		 * @param index : Index of the instance
+		 * @return CPU& : CPU of the instance
+		 */
+		CPU &GetInstance(size_t index)
+		{
+			return *instances[index].cpu;
+		}
+	private:
+		/**
+		 * @brief Instance
+		 */
+		typedef struct
+		{
+			std::shared_ptr<HeadlessKeypad> keypad;
+			std::unique_ptr<CPU> cpu;
+			uint64_t frames;		/**< Frames of the current episode */
+			uint64_t episode;		/**< Number of the current episode */
+			bool done;				/**< Episode ended, restart at the next step */
+		} Instance_t;
+
+		/**
+		 * @brief Work handed to the workers
+		 */
+		typedef struct
+		{
+			std::span<const uint16_t> actions;
+			std::span<uint8_t> observations;
+			std::span<float> rewards;
+			std::span<uint8_t> dones;
+			bool reset;				/**< Restart every instance instead of running a step */
+		} Job_t;
+
+		Config_t config;
+		size_t observationSize;
+		RewardHook rewardHook;
+		DoneHook doneHook;
+
+		/** @brief Per-worker copies of the prototype, with the decoder of their worker */
+		std::vector<std::unique_ptr<CPU>> prototypes;
+		std::vector<Instance_t> instances;
+
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable changed;
+		Job_t job;
+		uint64_t generation = 0;	/**< Number of the job handed out last */
+		size_t running = 0;			/**< Workers still busy with the current job */
+		bool stopping = false;
+
+		/**
+		 * @brief Worker thread, runs its block of instances for every job
+		 */
+		void WorkerLoop(size_t worker);
+
+		/**
+		 * @brief Hand a job to the workers and wait until all finished it
+		 */
+		void RunJob(const Job_t &next);
+
+		/**
+		 * @brief Restart an instance from the prototype of its worker
+		 */
+		void Restart(size_t index, size_t worker);
+
+		/**
+		 * @brief Write the observation of an instance
+		 */
+		void Observe(size_t index, std::span<uint8_t> observations);
+	};
+}
+
+#endif /* _CHIP8_VECTORENV_HPP_ */
@@ -0,0 +1,305 @@
+#include "video.hpp"
+#include <bit>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace CHIP8;
+
+namespace
+{
+	/** @brief Largest pixel size of the video sinks */
+	constexpr int MAX_SCALE = 16;
+
+	/**
+	 * @brief Repeat every byte twice
+	 */
+	void DoubleBytes(const uint8_t *input, size_t count, uint8_t *output)
+	{
+		size_t i = 0;
+#if defined(__SSE2__)
+		for (; i + 16 <= count; i += 16)
+		{
+			const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(output + 2 * i), _mm_unpacklo_epi8(bytes, bytes));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(output + 2 * i + 16), _mm_unpackhi_epi8(bytes, bytes));
+		}
+#endif
+		for (; i < count; i++)
+		{
+			output[2 * i] = input[i];
+			output[2 * i + 1] = input[i];
+		}
+	}
+}
+
+BufferedWriter::~BufferedWriter()
+{
+	(void)Close();
+}
+
+std::expected<void, std::string> BufferedWriter::Open(const std::string &path, size_t bufferSize)
+{
+	(void)Close();
+	file.open(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return std::unexpected(std::format("Failed to create file: {}", path));
+	}
+
+	this->bufferSize = std::max<size_t>(bufferSize, 1);
+	filling.clear();
+	filling.reserve(this->bufferSize);
+	flushing.clear();
+	flushing.reserve(this->bufferSize);
+	bytesWritten = 0;
+	pending = false;
+	stopping = false;
+	failed = false;
+	flusher = std::thread(&BufferedWriter::FlushLoop, this);
+	return std::expected<void, std::string>();
+}
+
+void BufferedWriter::FlushLoop()
+{
+	std::unique_lock lock(mutex);
+	while (true)
+	{
+		changed.wait(lock, [this]() { return pending || stopping; });
+		if (!pending)
+		{
+			return;
+		}
+
+		// The buffer belongs to this thread until pending is cleared
+		lock.unlock();
+		file.write(reinterpret_cast<const char *>(flushing.data()), std::streamsize(flushing.size()));
+		const bool written = bool(file);
+		lock.lock();
+
+		failed |= !written;
+		flushing.clear();
+		pending = false;
+		changed.notify_all();
+	}
+}
+
+void BufferedWriter::HandOver()
+{
+	std::unique_lock lock(mutex);
+	changed.wait(lock, [this]() { return !pending; });
+	std::swap(filling, flushing);
+	pending = true;
+	changed.notify_all();
+}
+
+void BufferedWriter::Write(std::span<const uint8_t> data)
+{
+	if (!flusher.joinable())
+	{
+		return;
+	}
+
+	while (!data.empty())
+	{
+		const size_t count = std::min(data.size(), bufferSize - filling.size());
+		filling.insert(filling.end(), data.begin(), data.begin() + std::ptrdiff_t(count));
+		data = data.subspan(count);
+		bytesWritten += count;
+		if (filling.size() == bufferSize)
+		{
+			HandOver();
+		}
+	}
+}
+
+std::expected<void, std::string> BufferedWriter::Close()
+{
+	if (!flusher.joinable())
+	{
+		return std::expected<void, std::string>();
+	}
+
+	if (!filling.empty())
+	{
+		HandOver();
+	}
+	{
+		std::lock_guard lock(mutex);
+		stopping = true;
+	}
+	changed.notify_all();
+	flusher.join();
+
+	file.close();
+	if (failed || file.fail())
+	{
+		return std::unexpected("Failed to write to the file");
+	}
+	return std::expected<void, std::string>();
+}
+
+VideoSink::VideoSink(int scale) : scale(scale)
+{
+	if (scale < 1 || scale > MAX_SCALE)
+		throw std::invalid_argument(std::format("VideoSink : Scale {} out of range (1 to {})", scale, MAX_SCALE));
+}
+
+std::expected<void, std::string> VideoSink::Open(const std::string &path)
+{
+	frames = 0;
+	lastFrame.clear();
+	return writer.Open(path);
+}
+
+void VideoSink::ScaleRow(std::span<const uint8_t> input, int scale, std::span<uint8_t> output, std::span<uint8_t> scratch)
+{
+	if (scale == 1)
+	{
+		std::copy(input.begin(), input.end(), output.begin());
+		return;
+	}
+
+	if (std::has_single_bit(unsigned(scale)))
+	{
+		// Ping-pong between the buffers so the last doubling lands in the output
+		const int passes = std::countr_zero(unsigned(scale));
+		const uint8_t *source = input.data();
+		size_t count = input.size();
+		for (int pass = 0; pass < passes; pass++)
+		{
+			uint8_t *target = ((passes - pass) % 2 == 1) ? output.data() : scratch.data();
+			DoubleBytes(source, count, target);
+			source = target;
+			count *= 2;
+		}
+		return;
+	}
+
+	for (size_t i = 0; i < input.size(); i++)
+	{
+		std::fill_n(output.begin() + std::ptrdiff_t(i * size_t(scale)), scale, input[i]);
+	}
+}
+
+void VideoSink::RepeatFrame()
+{
+	// The frame is written again without converting it
+	if (!lastFrame.empty())
+	{
+		frames++;
+		writer.Write(lastFrame);
+	}
+}
+
+std::span<const uint8_t> VideoSink::ConvertRow(std::span<const uint8_t> packed, int width, int height, int planes, int y)
+{
+	const size_t planeSize = (size_t(width) * size_t(height) + 7) / 8;
+	sourceRow.assign(size_t(width) + 8, 0);
+	indexRow.resize(size_t(width) * size_t(scale));
+	scratchRow.resize(size_t(width) * size_t(scale));
+
+	for (int plane = 0; plane < planes; plane++)
+	{
+		const uint8_t *bits = packed.data() + size_t(plane) * planeSize;
+		const size_t first = size_t(y) * size_t(width);
+		if (first % 8 == 0)
+		{
+			// Rows start on a byte, spread 8 pixels at a time. The padding of
+			// sourceRow takes the pixels of the next row the last byte may hold.
+			const uint8_t *rowBits = bits + first / 8;
+			for (size_t i = 0; i < (size_t(width) + 7) / 8; i++)
+			{
+				uint64_t pixels;
+				std::memcpy(&pixels, &sourceRow[8 * i], 8);
+				pixels |= Display::PIXEL_BYTES[rowBits[i]] << plane;
+				std::memcpy(&sourceRow[8 * i], &pixels, 8);
+			}
+		}
+		else
+		{
+			for (size_t x = 0; x < size_t(width); x++)
+			{
+				const size_t i = first + x;
+				sourceRow[x] |= uint8_t(((bits[i >> 3] >> (7 - (i & 7))) & 1) << plane);
+			}
+		}
+	}
+
+	ScaleRow(std::span<const uint8_t>(sourceRow.data(), size_t(width)), scale, indexRow, scratchRow);
+	return indexRow;
+}
+
+Y4MSink::Y4MSink(int scale) : VideoSink(scale)
+{
+	// BT.601 luma, the full range matches the RGB of the PPM sink
+	for (size_t i = 0; i < 16; i++)
+	{
+		const uint32_t color = PALETTE[i];
+		luma[i] = uint8_t((299 * ((color >> 16) & 0xFF) + 587 * ((color >> 8) & 0xFF) + 114 * (color & 0xFF)) / 1000);
+	}
+}
+
+void Y4MSink::WriteFrame(std::span<const uint8_t> packed, int width, int height, int planes)
+{
+	if (frames++ == 0)
+	{
+		// The stream header, every frame has the size of the first one
+		writer.Write(std::format("YUV4MPEG2 W{} H{} F60:1 Ip A1:1 Cmono XCOLORRANGE=FULL\n", width * scale, height * scale));
+	}
+	const std::string_view frameHeader = "FRAME\n";
+	lastFrame.assign(frameHeader.begin(), frameHeader.end());
+
+	lumaRow.resize(size_t(width) * size_t(scale));
+	for (int y = 0; y < height; y++)
+	{
+		auto indices = ConvertRow(packed, width, height, planes, y);
+		for (size_t x = 0; x < indices.size(); x++)
+		{
+			lumaRow[x] = luma[indices[x] & 15];
+		}
+		for (int repeat = 0; repeat < scale; repeat++)
+		{
+			lastFrame.insert(lastFrame.end(), lumaRow.begin(), lumaRow.end());
+		}
+	}
+	writer.Write(lastFrame);
+}
+
+void PPMSink::WriteFrame(std::span<const uint8_t> packed, int width, int height, int planes)
+{
+	frames++;
+	const std::string header = std::format("P6\n{} {}\n255\n", width * scale, height * scale);
+	lastFrame.assign(header.begin(), header.end());
+
+	rgbRow.resize(size_t(width) * size_t(scale) * 3);
+	for (int y = 0; y < height; y++)
+	{
+		auto indices = ConvertRow(packed, width, height, planes, y);
+		for (size_t x = 0; x < indices.size(); x++)
+		{
+			const uint32_t color = PALETTE[indices[x] & 15];
+			rgbRow[3 * x] = uint8_t(color >> 16);
+			rgbRow[3 * x + 1] = uint8_t(color >> 8);
+			rgbRow[3 * x + 2] = uint8_t(color);
+		}
+		for (int repeat = 0; repeat < scale; repeat++)
+		{
+			lastFrame.insert(lastFrame.end(), rgbRow.begin(), rgbRow.end());
+		}
+	}
+	writer.Write(lastFrame);
+}
+
+void RawSink::WriteFrame(std::span<const uint8_t> packed, int width, int height, int planes)
+{
+	(void)width;
+	(void)height;
+	(void)planes;
+	frames++;
+	lastFrame.assign(packed.begin(), packed.end());
+	writer.Write(lastFrame);
+}
@@ -0,0 +1,269 @@
+#ifndef _CHIP8_VIDEO_HPP_
+#define _CHIP8_VIDEO_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <span>
+#include <fstream>
+#include <expected>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "display.hpp"
+
+namespace CHIP8
+{
+	/**
+	 * @brief Buffered Writer
+	 *
+	 * Writes a file through two buffers: the caller fills one while a
+	 * background thread writes the other to the file. The caller only waits
+	 * if the thread is still busy with the previous buffer when the next one
+	 * is full. Write errors are reported by Close().
+	 */
+	class BufferedWriter
+	{
+		std::ofstream file;
+		std::thread flusher;
+		std::mutex mutex;
+		std::condition_variable changed;
+
+		/** @brief Buffer the caller writes to */
+		std::vector<uint8_t> filling;
+
+		/** @brief Buffer the flush thread writes to the file, owned by it while pending */
+		std::vector<uint8_t> flushing;
+
+		size_t bufferSize = 0;
+		uint64_t bytesWritten = 0;
+		bool pending = false;
+		bool stopping = false;
+		bool failed = false;
+
+		/**
+		 * @brief Flush thread, writes every handed over buffer to the file
+		 */
+		void FlushLoop();
+
+		/**
+		 * @brief Hand the filled buffer over to the flush thread
+		 */
+		void HandOver();
+	public:
+		BufferedWriter() = default;
+
+		/**
+		 * @brief Destroy the Buffered Writer object, closing the file
+		 */
+		~BufferedWriter();
+
+		/**
+		 * @brief Create a file and start the flush thread
+		 *
+		 * @param path : Path of the file
+		 * @param bufferSize : Size of each of the two buffers in bytes
+		 * @return std::expected<void, std::string> : Error message if the file could not be created
+		 */
+		std::expected<void, std::string> Open(const std::string &path, size_t bufferSize = 1 << 22);
+
+		/**
+		 * @brief Append bytes
+		 *
+		 * @param data : Bytes to append
+		 */
+		void Write(std::span<const uint8_t> data);
+
+		/**
+		 * @brief Append a string
+		 *
+		 * @param text : Text to append
+		 */
+		void Write(std::string_view text)
+		{
+			Write(std::span<const uint8_t>(reinterpret_cast<const uint8_t *>(text.data()), text.size()));
+		}
+
+		/**
+		 * @brief Write out the remaining bytes, stop the flush thread and close the file
+		 *
+		 * @return std::expected<void, std::string> : Error message if writing to the file failed
+		 */
+		std::expected<void, std::string> Close();
+
+		/**
+		 * @brief Get the number of bytes appended since the file was opened
+		 *
+		 * @return uint64_t : Number of bytes
+		 */
+		uint64_t GetBytesWritten() const
+		{
+			return bytesWritten;
+		}
+	};
+
+	/**
+	 * @brief Video Sink
+	 *
+	 * Base of the frame sinks writing a video file through a BufferedWriter.
+	 * Frames are converted a row at a time into palette indices (bit n of an
+	 * index is the pixel of bit plane n) and scaled up by a whole number with
+	 * nearest neighbour sampling. Repeated frames are written again from the
+	 * last encoded one without converting them.
+	 */
+	class VideoSink : public FrameSink
+	{
+	protected:
+		BufferedWriter writer;
+
+		/** @brief Pixel size of the output */
+		int scale;
+
+		/** @brief Number of frames written */
+		uint64_t frames = 0;
+
+		/** @brief Encoded bytes of the last frame, written again for a repeated frame */
+		std::vector<uint8_t> lastFrame;
+
+		/** @brief Palette indices of a row, at the frame width */
+		std::vector<uint8_t> sourceRow;
+
+		/** @brief Palette indices of a row, at the output width */
+		std::vector<uint8_t> indexRow;
+
+		/** @brief Scratch row of the upscaling passes */
+		std::vector<uint8_t> scratchRow;
+
+		/**
+		 * @brief Convert a row of a packed frame into scaled palette indices
+		 *
+		 * @param packed : Bit-packed frame
+		 * @param width : Width of the frame in pixels
+		 * @param height : Height of the frame in pixels
+		 * @param planes : Number of bit planes of the frame
+		 * @param y : Row to convert
+		 * @return std::span<const uint8_t> : Width * scale palette indices, valid until the next call
+		 */
+		std::span<const uint8_t> ConvertRow(std::span<const uint8_t> packed, int width, int height, int planes, int y);
+	public:
+		/** @brief Colors of the palette indices as 0xRRGGBB, the XO-CHIP default colors */
+		static constexpr uint32_t PALETTE[16] = {
+			0x000000, 0xFFFFFF, 0xAAAAAA, 0x555555, 0xFF0000, 0x00FF00, 0x0000FF, 0xFFFF00,
+			0x880000, 0x008800, 0x000088, 0x888800, 0xFF00FF, 0x00FFFF, 0x880088, 0x008888
+		};
+
+		/**
+		 * @brief Construct a new Video Sink object
+		 *
+		 * @param scale : Pixel size of the output, 1 to 16
+		 */
+		explicit VideoSink(int scale = 1);
+
+		/**
+		 * @brief Create the video file
+		 *
+		 * @param path : Path of the file
+		 * @return std::expected<void, std::string> : Error message if the file could not be created
+		 */
+		std::expected<void, std::string> Open(const std::string &path);
+
+		/**
+		 * @brief Write the last frame again, keeping the frame rate constant
+		 */
+		void RepeatFrame() override;
+
+		/**
+		 * @brief Write out the remaining frames and close the file
+		 *
+		 * @return std::expected<void, std::string> : Error message if writing the file failed
+		 */
+		std::expected<void, std::string> Close()
+		{
+			return writer.Close();
+		}
+
+		/**
+		 * @brief Get the number of frames written
+		 *
+		 * @return uint64_t : Number of frames
+		 */
+		uint64_t GetFrameCount() const
+		{
+			return frames;
+		}
+
+		/**
+		 * @brief Scale a row up with nearest neighbour sampling
+		 *
+		 * Powers of two are scaled with SSE2 where available, by interleaving
+		 * the bytes with themselves once per doubling.
+		 *
+		 * @param input : Bytes of the row
+		 * @param scale : Number of times every byte is repeated
+		 * @param output : Buffer of input.size() * scale bytes
+		 * @param scratch : Buffer of input.size() * scale bytes for the intermediate passes
+		 */
+		static void ScaleRow(std::span<const uint8_t> input, int scale, std::span<uint8_t> output, std::span<uint8_t> scratch);
+	};
+
+	/**
+	 * @brief Y4M Sink
+	 *
+	 * Writes the frames as a YUV4MPEG2 stream of 60 monochrome (luma only)
+	 * frames per second, which ffmpeg and most encoders read directly.
+	 */
+	class Y4MSink : public VideoSink
+	{
+		/** @brief Luma of the palette indices */
+		uint8_t luma[16];
+
+		/** @brief Luma of a row */
+		std::vector<uint8_t> lumaRow;
+	public:
+		/**
+		 * @brief Construct a new Y4M Sink object
+		 *
+		 * @param scale : Pixel size of the output, 1 to 16
+		 */
+		explicit Y4MSink(int scale = 1);
+
+		void WriteFrame(std::span<const uint8_t> packed, int width, int height, int planes) override;
+	};
+
+	/**
+	 * @brief PPM Sink
+	 *
+	 * Writes the frames as a sequence of binary RGB PPM images one after the
+	 * other, as read by netpbm tools and `ffmpeg -f image2pipe`.
+	 */
+	class PPMSink : public VideoSink
+	{
+		/** @brief RGB of a row */
+		std::vector<uint8_t> rgbRow;
+	public:
+		/**
+		 * @brief Construct a new PPM Sink object
+		 *
+		 * @param scale : Pixel size of the output, 1 to 16
+		 */
+		explicit PPMSink(int scale = 1) : VideoSink(scale) {}
+
+		void WriteFrame(std::span<const uint8_t> packed, int width, int height, int planes) override;
+	};
+
+	/**
+	 * @brief Raw Bitplane Sink
+	 *
+	 * Writes the packed frames unchanged one after the other, the most compact
+	 * stream to post-process later. The scale is ignored.
+	 */
+	class RawSink : public VideoSink
+	{
+	public:
+		RawSink() : VideoSink(1) {}
+
+		void WriteFrame(std::span<const uint8_t> packed, int width, int height, int planes) override;
+	};
+}
+
+#endif /* _CHIP8_VIDEO_HPP_ */
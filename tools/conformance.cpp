@@ -0,0 +1,540 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <charconv>
+#include <optional>
+#include <memory>
+#include "cpu.hpp"
+#include "Instructions/Instruction.hpp"
+#include "romcache.hpp"
+#include "sha1.hpp"
+#include "beeperlog.hpp"
+#include "trace.hpp"
+#ifdef USE_SCHIP
+#include "extensions/SCHIP8/schip8.hpp"
+#endif
+#ifdef USE_XOCHIP
+#include "extensions/XOCHIP/xochip.hpp"
+#endif
+
+/** @brief Instructions executed per 60Hz timer tick, fixed so the runs are reproducible */
+static constexpr uint64_t INSTRUCTIONS_PER_FRAME = 15;
+
+/** @brief Random seed of every run */
+static constexpr uint64_t RANDOM_SEED = 0;
+
+/** @brief Address the test suite reads its preset from */
+static constexpr uint16_t PRESET_ADDRESS = 0x1FF;
+
+/** @brief Trace events a worker records at most, a case takes a handful */
+static constexpr size_t TRACE_CAPACITY = 1 << 14;
+
+/**
+ * @brief Key Event
+ *
+ * The keys pressed from an instruction count on.
+ */
+typedef struct
+{
+	uint64_t instruction;
+	uint16_t keyMask;
+} KeyEvent_t;
+
+/**
+ * @brief Test Case
+ *
+ * A line of the manifest and the result of its run.
+ */
+typedef struct
+{
+	std::string name;
+	std::string rom;
+	int preset;						/**< Value stored at 0x1FF, -1 for none */
+	uint16_t quirks;
+	uint64_t budget;				/**< Instructions to run at most */
+	std::vector<KeyEvent_t> keys;
+	std::string keyScript;			/**< Key events as written in the manifest */
+	std::string expectedEnd;
+	std::string expectedHash;
+	std::string platform;			/**< chip8, schip or xochip */
+
+	std::string end;				/**< How the run ended: halted, budget, abort or skipped */
+	std::string hash;				/**< SHA-1 of the packed framebuffer and the beeper events */
+	std::string error;
+	uint64_t instructions;
+	size_t beeps;					/**< Number of times the beeper turned on */
+	std::string screen;
+} Case_t;
+
+/**
+ * @brief Parse a decimal or 0x prefixed hex number
+ */
+static bool parseNumber(std::string_view text, uint64_t &value)
+{
+	int base = 10;
+	if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X'))
+	{
+		text.remove_prefix(2);
+		base = 16;
+	}
+	auto result = std::from_chars(text.data(), text.data() + text.size(), value, base);
+	return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+/**
+ * @brief Parse a key script
+ *
+ * Comma separated `<instruction>=<key mask>` events, `-` for none.
+ */
+static bool parseKeys(const std::string &script, std::vector<KeyEvent_t> &keys)
+{
+	if (script == "-")
+	{
+		return true;
+	}
+
+	std::stringstream events(script);
+	std::string event;
+	while (std::getline(events, event, ','))
+	{
+		const size_t separator = event.find('=');
+		uint64_t instruction, mask;
+		if (separator == std::string::npos || !parseNumber(event.substr(0, separator), instruction) ||
+			!parseNumber(event.substr(separator + 1), mask) || mask > 0xFFFF ||
+			(!keys.empty() && keys.back().instruction > instruction))
+		{
+			return false;
+		}
+		keys.push_back({instruction, uint16_t(mask)});
+	}
+	return true;
+}
+
+/**
+ * @brief Read the manifest
+ *
+ * One case per line: name, ROM, 0x1FF preset (- for none), quirk bits,
+ * instruction budget, key script, expected end, expected framebuffer hash
+ * and optionally the platform.
+ */
+static bool readManifest(const std::filesystem::path &path, std::vector<Case_t> &cases, std::vector<std::string> &lines)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		std::cerr << "Error: failed to open " << path.string() << std::endl;
+		return false;
+	}
+
+	std::string line;
+	for (size_t number = 1; std::getline(file, line); number++)
+	{
+		lines.push_back(line);
+		if (line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+
+		Case_t entry{};
+		std::string preset, quirks, budget;
+		uint64_t value;
+		std::istringstream fields(line);
+		if (!(fields >> entry.name >> entry.rom >> preset >> quirks >> budget >> entry.keyScript >> entry.expectedEnd >> entry.expectedHash))
+		{
+			std::cerr << "Error: " << path.string() << ":" << number << ": expected 8 fields" << std::endl;
+			return false;
+		}
+		if (!(fields >> entry.platform))
+		{
+			entry.platform = "chip8";
+		}
+		if (entry.platform != "chip8" && entry.platform != "schip" && entry.platform != "xochip")
+		{
+			std::cerr << "Error: " << path.string() << ":" << number << ": unknown platform " << entry.platform << std::endl;
+			return false;
+		}
+
+		entry.preset = -1;
+		if (preset != "-")
+		{
+			if (!parseNumber(preset, value) || value > 0xFF)
+			{
+				std::cerr << "Error: " << path.string() << ":" << number << ": invalid preset " << preset << std::endl;
+				return false;
+			}
+			entry.preset = int(value);
+		}
+		if (!parseNumber(quirks, value) || value > 0xFFFF)
+		{
+			std::cerr << "Error: " << path.string() << ":" << number << ": invalid quirks " << quirks << std::endl;
+			return false;
+		}
+		entry.quirks = uint16_t(value);
+		if (!parseNumber(budget, entry.budget))
+		{
+			std::cerr << "Error: " << path.string() << ":" << number << ": invalid budget " << budget << std::endl;
+			return false;
+		}
+		if (!parseKeys(entry.keyScript, entry.keys))
+		{
+			std::cerr << "Error: " << path.string() << ":" << number << ": invalid key script " << entry.keyScript << std::endl;
+			return false;
+		}
+		cases.push_back(std::move(entry));
+	}
+	return true;
+}
+
+/**
+ * @brief Render the display as text, two rows per line
+ */
+static std::string renderScreen(CHIP8::Display &display)
+{
+	std::string text;
+	const int width = display.GetWidth();
+	const int height = display.GetHeight();
+	for (int y = 0; y < height; y += 2)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			const bool upper = display.GetColor(uint8_t(x), uint8_t(y)) != 0;
+			const bool lower = (y + 1 < height) && display.GetColor(uint8_t(x), uint8_t(y + 1)) != 0;
+			text += (upper && lower) ? "█" : upper ? "▀" : lower ? "▄" : " ";
+		}
+		text += '\n';
+	}
+	return text;
+}
+
+/**
+ * @brief Run a case headlessly on the reference interpreter
+ *
+ * With a trace recorder the case and its load, execute, hash and WAV phases
+ * are recorded like the phases of the demo host loop, plus the instruction
+ * count of the case as a counter.
+ */
+static void runCase(Case_t &entry, const std::filesystem::path &romDirectory, const std::filesystem::path &wavDirectory,
+	CHIP8::TraceRecorder *trace)
+{
+	// The case outlives the recorder, so its name can name the event
+	CHIP8::ScopedTrace caseScope(trace, entry.name.c_str(), "case");
+	auto keypad = std::make_shared<CHIP8::HeadlessKeypad>();
+	std::shared_ptr<CHIP8::Display> display;
+	std::shared_ptr<CHIP8::InstructionDecoder> decoder;
+	std::shared_ptr<CHIP8::Memory> memory = std::make_shared<CHIP8::Memory>();
+	if (entry.platform == "xochip")
+	{
+#ifdef USE_XOCHIP
+		display = std::make_shared<CHIP8::XOCHIP::HeadlessXOCHIPDisplay>();
+		decoder = CHIP8::XOCHIP::CreateDecoder();
+		memory = CHIP8::XOCHIP::CreateMemory();
+#else
+		entry.end = "skipped";
+		return;
+#endif
+	}
+	else if (entry.platform == "schip")
+	{
+#ifdef USE_SCHIP
+		display = std::make_shared<CHIP8::SCHIP8::HeadlessSCHIP8Display>();
+		decoder = CHIP8::SCHIP8::CreateDecoder();
+#else
+		entry.end = "skipped";
+		return;
+#endif
+	}
+	else
+	{
+		display = std::make_shared<CHIP8::HeadlessDisplay>();
+	}
+	auto beeper = std::make_shared<CHIP8::BeeperLog>();
+	CHIP8::CPU cpu(keypad, display, decoder, memory, beeper);
+	cpu.SeedRandom(RANDOM_SEED);
+	cpu.GetQuirks().FromBits(entry.quirks);
+
+	std::expected<void, std::string> loaded;
+	{
+		CHIP8::ScopedTrace scope(trace, "load ROM", "io");
+		loaded = CHIP8::RomCache::Global().Load((romDirectory / entry.rom).string(), *cpu.GetMemory());
+	}
+	if (!loaded)
+	{
+		entry.end = "abort";
+		entry.error = loaded.error();
+		return;
+	}
+	if (entry.preset >= 0)
+	{
+		cpu.GetMemory()->SetByte(PRESET_ADDRESS, uint8_t(entry.preset));
+	}
+
+	entry.end = "budget";
+	size_t nextKey = 0;
+	std::optional<CHIP8::ScopedTrace> executeScope(std::in_place, trace, "execute", "emulation");
+	for (entry.instructions = 0; entry.instructions < entry.budget; entry.instructions++)
+	{
+		while (nextKey < entry.keys.size() && entry.keys[nextKey].instruction <= entry.instructions)
+		{
+			keypad->SetKeyMask(entry.keys[nextKey++].keyMask);
+		}
+		if (entry.instructions % INSTRUCTIONS_PER_FRAME == 0 && entry.instructions != 0)
+		{
+			cpu.GetTimers()->DecrementTimers();
+		}
+
+		auto result = cpu.RunCycle();
+		if (!result)
+		{
+			entry.end = "abort";
+			entry.error = cpu.GetCycleError();
+			break;
+		}
+		if (!result.value())
+		{
+			// The endless jump quirk or the SCHIP-8 exit instruction mark the end of a test
+			const auto trap = cpu.GetTrap();
+			entry.end = (trap == CHIP8::TrapCode::EndlessLoop || trap == CHIP8::TrapCode::Exit) ? "halted" : "abort";
+			entry.error = cpu.GetCurrentInstruction()->GetAbortReason();
+			entry.instructions++;
+			break;
+		}
+	}
+
+	executeScope.reset();
+	if (trace != nullptr)
+	{
+		trace->AddCounter("instructions", int64_t(entry.instructions));
+	}
+
+	std::optional<CHIP8::ScopedTrace> hashScope(std::in_place, trace, "hash", "emulation");
+	std::vector<uint8_t> packed(display->GetPackedSize());
+	display->PackBuffer(packed);
+	CHIP8::Sha1 sha;
+	sha.Update(packed);
+
+	// Runs that never beep keep the plain framebuffer hash
+	const auto events = beeper->GetEvents();
+	entry.beeps = 0;
+	for (const auto &event : events)
+	{
+		uint8_t serialized[9];
+		for (int i = 0; i < 8; i++)
+		{
+			serialized[i] = uint8_t(event.frame >> (8 * i));
+		}
+		serialized[8] = event.on ? 1 : 0;
+		sha.Update(serialized);
+		entry.beeps += event.on ? 1 : 0;
+	}
+	entry.hash = CHIP8::Sha1::ToHex(sha.Finish());
+	entry.screen = renderScreen(*display);
+	hashScope.reset();
+
+	if (!wavDirectory.empty() && !events.empty())
+	{
+		CHIP8::ScopedTrace scope(trace, "render WAV", "io");
+		auto rendered = CHIP8::BeeperLog::RenderWav((wavDirectory / (entry.name + ".wav")).string(), events, beeper->GetFrame());
+		if (!rendered)
+		{
+			entry.end = "abort";
+			entry.error = rendered.error();
+		}
+	}
+}
+
+/**
+ * @brief Write the manifest with the results as the new expectations
+ */
+static bool updateManifest(const std::filesystem::path &path, const std::vector<std::string> &lines, const std::vector<Case_t> &cases)
+{
+	std::ofstream file(path, std::ios::trunc);
+	size_t index = 0;
+	for (const auto &line : lines)
+	{
+		if (line.empty() || line[0] == '#')
+		{
+			file << line << '\n';
+			continue;
+		}
+		// Skipped cases keep their expectations
+		const Case_t &entry = cases[index++];
+		const bool skipped = (entry.end == "skipped");
+		file << entry.name << ' ' << entry.rom << ' ' << (entry.preset < 0 ? std::string("-") : std::to_string(entry.preset))
+			<< " 0x" << std::hex << entry.quirks << std::dec << ' ' << entry.budget << ' ' << entry.keyScript
+			<< ' ' << (skipped ? entry.expectedEnd : entry.end) << ' ' << (skipped ? entry.expectedHash : entry.hash);
+		if (entry.platform != "chip8")
+		{
+			file << ' ' << entry.platform;
+		}
+		file << '\n';
+	}
+	return bool(file);
+}
+
+int main(int argc, char *argv[])
+{
+	std::filesystem::path manifest = CHIP8PP_CONFORMANCE_MANIFEST;
+	std::filesystem::path romDirectory = CHIP8PP_CONFORMANCE_ROMS;
+	unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+	bool update = false;
+	bool show = false;
+	std::filesystem::path wavDirectory;
+	std::filesystem::path tracePath;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--update")
+		{
+			update = true;
+		}
+		else if (arg == "--show")
+		{
+			show = true;
+		}
+		else if (arg == "--jobs" && i + 1 < argc)
+		{
+			jobs = std::max(1, std::stoi(argv[++i]));
+		}
+		else if (arg == "--roms" && i + 1 < argc)
+		{
+			romDirectory = argv[++i];
+		}
+		else if (arg == "--wav" && i + 1 < argc)
+		{
+			wavDirectory = argv[++i];
+		}
+		else if (arg == "--trace" && i + 1 < argc)
+		{
+			tracePath = argv[++i];
+		}
+		else if (arg[0] != '-')
+		{
+			manifest = arg;
+		}
+		else
+		{
+			std::cout << "Usage: " << argv[0] << " [--jobs <n>] [--roms <directory>] [--wav <directory>] [--trace <trace.json>] [--show] [--update] [manifest]" << std::endl;
+			std::cout << "Runs the test suite headlessly and compares the framebuffer and beeper hashes with the goldens of the manifest," << std::endl;
+			std::cout << "--show prints the final screens, --wav renders the beeper of every beeping case to <name>.wav," << std::endl;
+			std::cout << "--trace writes the phases of every case as Chrome trace JSON, one thread per worker," << std::endl;
+			std::cout << "--update writes the results as the new goldens" << std::endl;
+			return 0;
+		}
+	}
+
+	std::vector<Case_t> cases;
+	std::vector<std::string> lines;
+	if (!readManifest(manifest, cases, lines))
+	{
+		return 1;
+	}
+
+	// Every worker takes the next case until all are done, tracing into a recorder of its own
+	const size_t workerCount = std::min<size_t>(jobs, cases.size());
+	std::vector<std::unique_ptr<CHIP8::TraceRecorder>> recorders;
+	if (!tracePath.empty())
+	{
+		for (size_t i = 0; i < workerCount; i++)
+		{
+			recorders.push_back(std::make_unique<CHIP8::TraceRecorder>(TRACE_CAPACITY, uint32_t(i + 1)));
+		}
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	std::atomic<size_t> next = 0;
+	std::vector<std::thread> workers;
+	for (size_t i = 0; i < workerCount; i++)
+	{
+		CHIP8::TraceRecorder *trace = recorders.empty() ? nullptr : recorders[i].get();
+		workers.emplace_back([&, trace]() {
+			for (size_t index = next++; index < cases.size(); index = next++)
+			{
+				runCase(cases[index], romDirectory, wavDirectory, trace);
+			}
+		});
+	}
+	for (auto &worker : workers)
+	{
+		worker.join();
+	}
+	const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+	int failed = 0;
+	int skipped = 0;
+	uint64_t instructions = 0;
+	for (const Case_t &entry : cases)
+	{
+		if (entry.end == "skipped")
+		{
+			std::cout << "SKIP " << entry.name << " (" << entry.platform << " support not built in)" << std::endl;
+			skipped++;
+			continue;
+		}
+
+		const bool passed = (entry.end == entry.expectedEnd && entry.hash == entry.expectedHash);
+		failed += passed ? 0 : 1;
+		instructions += entry.instructions;
+
+		std::cout << (passed ? "PASS " : "FAIL ") << entry.name << " (" << entry.end << " after " << entry.instructions << " instructions";
+		if (entry.beeps != 0)
+		{
+			std::cout << ", " << entry.beeps << " beeps";
+		}
+		std::cout << ")";
+		if (!passed)
+		{
+			std::cout << ": expected " << entry.expectedEnd << " " << entry.expectedHash << ", got " << entry.end << " " << entry.hash;
+		}
+		if (entry.end == "abort")
+		{
+			std::cout << ": " << entry.error;
+		}
+		std::cout << std::endl;
+		if (show)
+		{
+			std::cout << entry.screen;
+		}
+	}
+	std::cout << cases.size() - size_t(failed + skipped) << "/" << cases.size() - size_t(skipped) << " passed";
+	if (skipped != 0)
+	{
+		std::cout << " (" << skipped << " skipped)";
+	}
+	std::cout << ", " << instructions << " instructions in "
+		<< elapsed.count() << " ms on " << workers.size() << " threads" << std::endl;
+
+	if (!recorders.empty())
+	{
+		std::vector<const CHIP8::TraceRecorder *> traces;
+		for (const auto &recorder : recorders)
+		{
+			traces.push_back(recorder.get());
+		}
+		auto written = CHIP8::TraceRecorder::WriteJson(tracePath.string(), traces);
+		if (!written)
+		{
+			std::cerr << "Error: " << written.error() << std::endl;
+			return 1;
+		}
+	}
+
+	if (update)
+	{
+		if (!updateManifest(manifest, lines, cases))
+		{
+			std::cerr << "Error: failed to write " << manifest.string() << std::endl;
+			return 1;
+		}
+		std::cout << "Goldens written to " << manifest.string() << std::endl;
+		return 0;
+	}
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "memory.hpp"
+#include "disassembler.hpp"
+#include "analyzer.hpp"
+
+/**
+ * @brief Write a text buffer to a file or stdout
+ *
+ * @param text The text to write
+ * @param path Path of the file, empty for stdout
+ * @return bool : true if the text was written
+ */
+static bool writeOutput(std::string_view text, const std::filesystem::path &path)
+{
+	if (path.empty())
+	{
+		std::cout.write(text.data(), std::streamsize(text.size()));
+		return bool(std::cout);
+	}
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(text.data(), std::streamsize(text.size()));
+	return bool(file);
+}
+
+int main(int argc, char *argv[])
+{
+	bool dot = false;
+	bool analyze = false;
+	std::filesystem::path outputDir;
+	std::vector<std::filesystem::path> roms;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--dot")
+		{
+			dot = true;
+		}
+		else if (arg == "--analyze")
+		{
+			analyze = true;
+		}
+		else if (arg == "--output" && i + 1 < argc)
+		{
+			outputDir = argv[++i];
+		}
+		else
+		{
+			roms.push_back(arg);
+		}
+	}
+
+	if (roms.empty())
+	{
+		std::cout << "Usage: " << argv[0] << " [--dot | --analyze] [--output <directory>] <rom file>..." << std::endl;
+		std::cout << "Writes an annotated listing (a DOT graph with --dot, an analysis report with --analyze)" << std::endl;
+		std::cout << "of every ROM, to stdout or to <directory>/<rom name>.asm/.dot/.txt" << std::endl;
+		return 0;
+	}
+
+	// The graph, the text buffer and the image are reused for every ROM
+	CHIP8::ControlFlowGraph graph;
+	CHIP8::RomAnalyzer analyzer;
+	CHIP8::Quirks quirks;
+	CHIP8::TextBuffer text(1 << 20);
+	std::vector<uint8_t> image;
+	size_t blocks = 0;
+	int failed = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (const auto &rom : roms)
+	{
+		CHIP8::Memory memory;
+		auto result = memory.LoadRomFile(rom.string());
+		if (!result)
+		{
+			std::cerr << "Error: " << rom.string() << ": " << result.error() << std::endl;
+			failed++;
+			continue;
+		}
+		image.resize(memory.GetSize());
+		memory.GetBytes(0, image);
+		const size_t romEnd = std::min<size_t>(memory.GetRomStart() + std::filesystem::file_size(rom), image.size());
+
+		graph.Analyze(image, memory.GetRomStart());
+		blocks += graph.GetBlocks().size();
+
+		text.Clear();
+		if (analyze)
+		{
+			text.Put("; ").Put(rom.filename().string()).Put('\n');
+			analyzer.Analyze(memory, romEnd - memory.GetRomStart(), quirks);
+			analyzer.WriteReport(text);
+		}
+		else if (dot)
+		{
+			graph.WriteDot(rom.stem().string(), text);
+		}
+		else
+		{
+			text.Put("; ").Put(rom.filename().string()).Put('\n');
+			graph.WriteListing(memory.GetRomStart(), uint16_t(romEnd), text);
+		}
+
+		const auto path = outputDir.empty() ? std::filesystem::path() : outputDir / (rom.stem().string() + (analyze ? ".txt" : dot ? ".dot" : ".asm"));
+		if (!writeOutput(text.View(), path))
+		{
+			std::cerr << "Error: failed to write " << path.string() << std::endl;
+			failed++;
+		}
+	}
+	const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+	std::cerr << roms.size() - size_t(failed) << " ROMs, " << blocks << " blocks in " << elapsed.count() << " ms" << std::endl;
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "memory.hpp"
+#include "analyzer.hpp"
+#include "romdb.hpp"
+
+/** @brief Instructions per frame suggested for ROMs without a known speed */
+static constexpr unsigned DEFAULT_INSTRUCTIONS_PER_FRAME = 15;
+
+/**
+ * @brief Print a listing line for every ROM
+ *
+ * The quirks are the defaults and the engine is the one the analyzer picks,
+ * so the lines only need to be reviewed before building a database.
+ */
+static int hashRoms(const std::vector<std::string> &roms)
+{
+	CHIP8::RomAnalyzer analyzer;
+	const CHIP8::Quirks quirks;
+	int failed = 0;
+
+	for (const auto &rom : roms)
+	{
+		CHIP8::MappedFile file;
+		CHIP8::Memory memory;
+		auto mapped = file.Open(rom);
+		auto loaded = mapped ? memory.LoadRomFile(rom) : mapped;
+		if (!loaded)
+		{
+			std::cerr << "Error: " << rom << ": " << loaded.error() << std::endl;
+			failed++;
+			continue;
+		}
+
+		const auto &report = analyzer.Analyze(memory, file.GetData().size(), quirks);
+		std::cout << CHIP8::Sha1::ToHex(CHIP8::Sha1::Hash(file.GetData())) << " 0x" << std::hex << quirks.ToBits() << std::dec
+			<< " " << DEFAULT_INSTRUCTIONS_PER_FRAME << " " << CHIP8::ENGINE_NAMES[size_t(report.engine)] << " # " << rom << std::endl;
+	}
+	return failed == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Build a database file from a text listing
+ */
+static int buildDatabase(const std::string &listingPath, const std::string &databasePath)
+{
+	std::ifstream listing(listingPath, std::ios::binary);
+	if (!listing.is_open())
+	{
+		std::cerr << "Error: failed to open " << listingPath << std::endl;
+		return 1;
+	}
+	const std::string text((std::istreambuf_iterator<char>(listing)), std::istreambuf_iterator<char>());
+
+	auto entries = CHIP8::RomDatabase::ParseListing(text);
+	if (!entries)
+	{
+		std::cerr << "Error: " << listingPath << ": " << entries.error() << std::endl;
+		return 1;
+	}
+	const size_t count = entries->size();
+	auto written = CHIP8::RomDatabase::Write(databasePath, std::move(entries.value()));
+	if (!written)
+	{
+		std::cerr << "Error: " << written.error() << std::endl;
+		return 1;
+	}
+	std::cerr << count << " ROMs written to " << databasePath << std::endl;
+	return 0;
+}
+
+/**
+ * @brief Print the profile of every ROM found in the database
+ */
+static int lookupRoms(const std::string &databasePath, const std::vector<std::string> &roms)
+{
+	CHIP8::RomDatabase database;
+	auto opened = database.Open(databasePath);
+	if (!opened)
+	{
+		std::cerr << "Error: " << opened.error() << std::endl;
+		return 1;
+	}
+
+	int failed = 0;
+	for (const auto &rom : roms)
+	{
+		auto profile = database.FindRomFile(rom);
+		if (!profile)
+		{
+			std::cerr << "Error: " << profile.error() << std::endl;
+			failed++;
+		}
+		else if (!profile->has_value())
+		{
+			std::cout << rom << ": unknown" << std::endl;
+		}
+		else
+		{
+			const CHIP8::RomProfile_t &found = profile->value();
+			std::cout << rom << ": quirks 0x" << std::hex << found.quirks << std::dec << ", " << found.instructionsPerFrame
+				<< " instructions per frame, " << CHIP8::ENGINE_NAMES[size_t(found.engine)] << " engine" << std::endl;
+		}
+	}
+	return failed == 0 ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+	const std::string command = (argc > 1) ? argv[1] : "";
+	const std::vector<std::string> arguments(argv + std::min(argc, 2), argv + argc);
+
+	if (command == "hash" && !arguments.empty())
+	{
+		return hashRoms(arguments);
+	}
+	else if (command == "build" && arguments.size() == 2)
+	{
+		return buildDatabase(arguments[0], arguments[1]);
+	}
+	else if (command == "lookup" && arguments.size() >= 2)
+	{
+		return lookupRoms(arguments[0], std::vector<std::string>(arguments.begin() + 1, arguments.end()));
+	}
+
+	std::cout << "Usage: " << argv[0] << " hash <rom file>..." << std::endl;
+	std::cout << "       " << argv[0] << " build <listing> <database>" << std::endl;
+	std::cout << "       " << argv[0] << " lookup <database> <rom file>..." << std::endl;
+	std::cout << "hash prints a listing line per ROM, build writes the database of a listing" << std::endl;
+	return 0;
+}